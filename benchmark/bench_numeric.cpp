@@ -0,0 +1,123 @@
+#include <cstdio>
+#include <stdint.h>
+#include <time.h>
+#include "vector.h"
+#include "numeric.h"
+
+// 对比 numeric.h 的算法与手写循环的耗时
+
+uint64_t next_random(uint64_t& seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+double now() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 防止结果被优化掉
+volatile double sink;
+
+template <class Loop, class Library>
+void run(const char* name, int rounds, Loop loop, Library library) {
+    double t0 = now();
+    for (int r = 0; r < rounds; ++r) {
+        sink = loop();
+    }
+    double t1 = now();
+    for (int r = 0; r < rounds; ++r) {
+        sink = library();
+    }
+    double t2 = now();
+    printf("%-28s loop %8.2f ms   numeric %8.2f ms   %5.2fx\n", name,
+        (t1 - t0) * 1000 / rounds, (t2 - t1) * 1000 / rounds, (t1 - t0) / (t2 - t1));
+}
+
+int main() {
+
+    const int n = 1 << 22;
+    const int rounds = 20;
+    uint64_t seed = 88172645463325252ull;
+
+    HxSTL::vector<int> a(n), out(n);
+    HxSTL::vector<double> x(n), y(n);
+    HxSTL::vector<float> f(n), g(n);
+    for (int i = 0; i < n; ++i) {
+        a[i] = static_cast<int>(next_random(seed) % 1000);
+        x[i] = static_cast<double>(next_random(seed) % 1000) / 7.0;
+        y[i] = static_cast<double>(next_random(seed) % 1000) / 3.0;
+        f[i] = static_cast<float>(x[i]);
+        g[i] = static_cast<float>(y[i]);
+    }
+
+    run("accumulate int", rounds, [&]() {
+        int s = 0;
+        for (int i = 0; i < n; ++i) s += a[i];
+        return static_cast<double>(s);
+    }, [&]() {
+        return static_cast<double>(HxSTL::accumulate(a.begin(), a.end(), 0));
+    });
+
+    run("reduce double", rounds, [&]() {
+        double s = 0;
+        for (int i = 0; i < n; ++i) s += x[i];
+        return s;
+    }, [&]() {
+        return HxSTL::reduce(x.begin(), x.end(), 0.0);
+    });
+
+    run("reduce double par", rounds, [&]() {
+        double s = 0;
+        for (int i = 0; i < n; ++i) s += x[i];
+        return s;
+    }, [&]() {
+        return HxSTL::reduce(HxSTL::execution::par, x.begin(), x.end(), 0.0);
+    });
+
+    run("transform_reduce double", rounds, [&]() {
+        double s = 0;
+        for (int i = 0; i < n; ++i) s += x[i] * y[i];
+        return s;
+    }, [&]() {
+        return HxSTL::transform_reduce(x.begin(), x.end(), y.begin(), 0.0);
+    });
+
+    run("transform_reduce float", rounds, [&]() {
+        float s = 0;
+        for (int i = 0; i < n; ++i) s += f[i] * g[i];
+        return static_cast<double>(s);
+    }, [&]() {
+        return static_cast<double>(HxSTL::transform_reduce(f.begin(), f.end(), g.begin(), 0.0f));
+    });
+
+    run("inclusive_scan int", rounds, [&]() {
+        int s = 0;
+        for (int i = 0; i < n; ++i) out[i] = s += a[i];
+        return static_cast<double>(out[n - 1]);
+    }, [&]() {
+        HxSTL::inclusive_scan(a.begin(), a.end(), out.begin());
+        return static_cast<double>(out[n - 1]);
+    });
+
+    run("inclusive_scan int par", rounds, [&]() {
+        int s = 0;
+        for (int i = 0; i < n; ++i) out[i] = s += a[i];
+        return static_cast<double>(out[n - 1]);
+    }, [&]() {
+        HxSTL::inclusive_scan(HxSTL::execution::par, a.begin(), a.end(), out.begin());
+        return static_cast<double>(out[n - 1]);
+    });
+
+    run("iota int", rounds, [&]() {
+        for (int i = 0; i < n; ++i) out[i] = i;
+        return static_cast<double>(out[n - 1]);
+    }, [&]() {
+        HxSTL::iota(out.begin(), out.end(), 0);
+        return static_cast<double>(out[n - 1]);
+    });
+
+}
@@ -0,0 +1,90 @@
+#include <cstdio>
+#include <cstdlib>
+#include <stdint.h>
+#include <time.h>
+#include "vector.h"
+#include "random.h"
+#include "execution.h"
+
+// 对比 rand() 取模的洗牌与 random.h 引擎加 Lemire 取界的 shuffle
+
+double now() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 防止结果被优化掉
+volatile uint64_t sink;
+
+template <class Body>
+double run(int rounds, Body body) {
+    double t0 = now();
+    for (int r = 0; r < rounds; ++r) {
+        body();
+    }
+    return (now() - t0) * 1000 / rounds;
+}
+
+int main() {
+
+    const int n = 1 << 22;
+    const int rounds = 10;
+
+    HxSTL::vector<int> a(n);
+    for (int i = 0; i < n; ++i) {
+        a[i] = i;
+    }
+
+    // 引擎本身的吞吐
+    HxSTL::xoshiro256starstar x(1);
+    HxSTL::pcg32 p(1);
+    double t_rand = run(rounds, [&]() {
+        uint64_t s = 0;
+        for (int i = 0; i < n; ++i) s += rand();
+        sink = s;
+    });
+    double t_xoshiro = run(rounds, [&]() {
+        uint64_t s = 0;
+        for (int i = 0; i < n; ++i) s += x();
+        sink = s;
+    });
+    double t_pcg = run(rounds, [&]() {
+        uint64_t s = 0;
+        for (int i = 0; i < n; ++i) s += p();
+        sink = s;
+    });
+    printf("%-28s rand %8.2f ms   xoshiro %8.2f ms   pcg32 %8.2f ms\n", "generate",
+        t_rand, t_xoshiro, t_pcg);
+
+    // 取界
+    double t_mod = run(rounds, [&]() {
+        uint64_t s = 0;
+        for (int i = 1; i <= n; ++i) s += rand() % i;
+        sink = s;
+    });
+    double t_lemire = run(rounds, [&]() {
+        uint64_t s = 0;
+        for (int i = 1; i <= n; ++i) s += HxSTL::__random_uniform(x, static_cast<uint64_t>(i - 1));
+        sink = s;
+    });
+    printf("%-28s rand %% %6.2f ms   lemire  %8.2f ms   %5.2fx\n", "bounded",
+        t_mod, t_lemire, t_mod / t_lemire);
+
+    // 洗牌
+    double t_old = run(rounds, [&]() {
+        for (int i = n - 1; i > 0; --i) {
+            int j = rand() % (i + 1);
+            int t = a[i]; a[i] = a[j]; a[j] = t;
+        }
+    });
+    double t_new = run(rounds, [&]() {
+        HxSTL::shuffle(a.begin(), a.end(), x);
+    });
+    double t_par = run(rounds, [&]() {
+        HxSTL::shuffle(HxSTL::execution::par, a.begin(), a.end(), x);
+    });
+    printf("%-28s rand %% %6.2f ms   shuffle %8.2f ms   %5.2fx   par %8.2f ms   %5.2fx\n", "shuffle",
+        t_old, t_new, t_old / t_new, t_par, t_old / t_par);
+
+}
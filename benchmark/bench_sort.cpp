@@ -0,0 +1,93 @@
+#include <cstdio>
+#include <stdint.h>
+#include <time.h>
+#include "vector.h"
+#include "algorithm.h"
+#include "basic_string.h"
+
+// 对比 sort (pdqsort) 与原先的 introsort 在不同输入模式下的耗时
+
+typedef HxSTL::basic_string<char> string;
+
+uint64_t next_random(uint64_t& seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+double now() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+template <class RandomAccessIterator>
+void introsort(RandomAccessIterator first, RandomAccessIterator last) {
+    if (first != last) {
+        HxSTL::__introsort(first, last, HxSTL::__lg(last - first) * 2);
+        HxSTL::__final_insertion_sort(first, last);
+    }
+}
+
+template <class T>
+void run(const char* name, const HxSTL::vector<T>& input, int rounds) {
+    double t_intro = 0, t_pdq = 0;
+    for (int r = 0; r < rounds; ++r) {
+        HxSTL::vector<T> v1 = input;
+        HxSTL::vector<T> v2 = input;
+        double t0 = now();
+        introsort(v1.begin(), v1.end());
+        double t1 = now();
+        HxSTL::sort(v2.begin(), v2.end());
+        double t2 = now();
+        t_intro += t1 - t0;
+        t_pdq += t2 - t1;
+        if (!(v1 == v2)) {
+            printf("%s: result mismatch\n", name);
+        }
+    }
+    printf("%-16s introsort %8.2f ms   pdqsort %8.2f ms   %5.2fx\n", name,
+        t_intro * 1000 / rounds, t_pdq * 1000 / rounds, t_intro / t_pdq);
+}
+
+int main() {
+
+    const int n = 1000000;
+    const int rounds = 5;
+    uint64_t seed = 88172645463325252ull;
+
+    HxSTL::vector<int> random, sorted, reversed, few_unique, organ_pipe, sorted_tail;
+    for (int i = 0; i < n; ++i) {
+        random.push_back(static_cast<int>(next_random(seed)));
+        sorted.push_back(i);
+        reversed.push_back(n - i);
+        few_unique.push_back(static_cast<int>(next_random(seed) % 16));
+        organ_pipe.push_back(i < n / 2 ? i : n - i);
+        sorted_tail.push_back(i < n - 1000 ? i : static_cast<int>(next_random(seed) % n));
+    }
+
+    run("random", random, rounds);
+    run("sorted", sorted, rounds);
+    run("reversed", reversed, rounds);
+    run("few_unique", few_unique, rounds);
+    run("organ_pipe", organ_pipe, rounds);
+    run("sorted_tail", sorted_tail, rounds);
+
+    HxSTL::vector<double> random_double;
+    for (int i = 0; i < n; ++i) {
+        random_double.push_back(static_cast<double>(next_random(seed) % 1000000007) / 13.0);
+    }
+    run("random_double", random_double, rounds);
+
+    HxSTL::vector<string> random_string;
+    for (int i = 0; i < n / 5; ++i) {
+        string s;
+        for (int k = 4 + next_random(seed) % 12; k > 0; --k) {
+            s += static_cast<char>('a' + next_random(seed) % 26);
+        }
+        random_string.push_back(s);
+    }
+    run("random_string", random_string, rounds);
+
+}
@@ -4,13 +4,32 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <new>
 #include "utility.h"
 #include "type_traits.h"
 #include "iterator.h"
+#include "random.h"
+#include "simd.h"
 
 
 namespace HxSTL {
 
+    // 分段迭代器
+    // 区间由若干块连续内存拼成 (如 deque) 时特化本模板, copy / fill / find / for_each / uninitialized_copy
+    // 会把区间拆成逐块的指针区间处理, 块内循环没有跨块检查, 可以走 memmove 或被向量化
+    // 特化需要提供:
+    //   is_segmented                   true_type
+    //   segment_iterator               在块之间移动的迭代器
+    //   local_iterator                 块内的指针
+    //   segment(it) / local(it)        it 所在的块与块内位置
+    //   begin(seg) / end(seg)          块的首尾
+    //   compose(seg, local)            由块与块内位置组合回迭代器, local 可以等于 end(seg)
+    template <class Iterator>
+    struct __segmented_iterator_traits {
+        typedef false_type is_segmented;
+    };
+
     /*
      * Non-modifying sequence operations
      */
@@ -57,24 +76,98 @@ namespace HxSTL {
     // for_each
 
     template <class InputIt, class Function>
-    Function for_each(InputIt first, InputIt last, Function fn) {
+    inline Function __for_each(InputIt first, InputIt last, Function fn, false_type) {
+        while (first != last) {
+            fn(*first);
+            ++first;
+        }
+        return fn;
+    }
+
+    template <class InputIt, class Function>
+    inline void __for_each_segment(InputIt first, InputIt last, Function& fn) {
         while (first != last) {
             fn(*first);
             ++first;
         }
+    }
+
+    // 函数对象以引用贯穿各段, 避免对闭包类型做拷贝赋值
+    template <class SegmentedIt, class Function>
+    Function __for_each(SegmentedIt first, SegmentedIt last, Function fn, true_type) {
+        typedef __segmented_iterator_traits<SegmentedIt> traits;
+        typename traits::segment_iterator sfirst = traits::segment(first);
+        typename traits::segment_iterator slast = traits::segment(last);
+        if (sfirst == slast) {
+            __for_each_segment(traits::local(first), traits::local(last), fn);
+            return fn;
+        }
+        __for_each_segment(traits::local(first), traits::end(sfirst), fn);
+        for (++sfirst; sfirst != slast; ++sfirst) {
+            __for_each_segment(traits::begin(sfirst), traits::end(sfirst), fn);
+        }
+        __for_each_segment(traits::begin(slast), traits::local(last), fn);
         return fn;
     }
 
+    template <class InputIt, class Function>
+    Function for_each(InputIt first, InputIt last, Function fn) {
+        return __for_each(first, last, fn, typename __segmented_iterator_traits<InputIt>::is_segmented());
+    }
+
     // find
 
     template <class InputIt, class T>
-    InputIt find(InputIt first, InputIt last, const T& val) {
+    inline InputIt __find_dispatch(InputIt first, InputIt last, const T& val, false_type) {
         while (first != last && *first != val) {
             ++first;
         }
         return first;
     }
 
+    // 算术类型的指针区间走向量化内核
+    template <class T, class U>
+    inline T* __find_dispatch(T* first, T* last, const U& val, true_type) {
+        typedef typename remove_cv<T>::type element_type;
+        if (!__simd_representable<element_type>(val)) {
+            while (first != last && !__simd_equal(*first, val)) {
+                ++first;
+            }
+            return first;
+        }
+        return first + (__simd_find<element_type>(first, last, static_cast<element_type>(val)) - first);
+    }
+
+    template <class InputIt, class T>
+    inline InputIt __find(InputIt first, InputIt last, const T& val, false_type) {
+        return __find_dispatch(first, last, val, typename __simd_compare_dispatch<InputIt, T>::type());
+    }
+
+    template <class SegmentedIt, class T>
+    SegmentedIt __find(SegmentedIt first, SegmentedIt last, const T& val, true_type) {
+        typedef __segmented_iterator_traits<SegmentedIt> traits;
+        typedef typename traits::local_iterator local_iterator;
+        typename traits::segment_iterator sfirst = traits::segment(first);
+        typename traits::segment_iterator slast = traits::segment(last);
+        if (sfirst == slast) {
+            return traits::compose(sfirst, __find(traits::local(first), traits::local(last), val, false_type()));
+        }
+        local_iterator end = traits::end(sfirst);
+        local_iterator it = __find(traits::local(first), end, val, false_type());
+        if (it != end) return traits::compose(sfirst, it);
+        for (++sfirst; sfirst != slast; ++sfirst) {
+            end = traits::end(sfirst);
+            it = __find(traits::begin(sfirst), end, val, false_type());
+            if (it != end) return traits::compose(sfirst, it);
+        }
+        return traits::compose(slast, __find(traits::begin(slast), traits::local(last), val, false_type()));
+    }
+
+    template <class InputIt, class T>
+    InputIt find(InputIt first, InputIt last, const T& val) {
+        return __find(first, last, val, typename __segmented_iterator_traits<InputIt>::is_segmented());
+    }
+
     // find_if
 
     template <class InputIt, class UnaryPredicate>
@@ -257,7 +350,7 @@ namespace HxSTL {
 
     template <class InputIt, class T>
     typename iterator_traits<InputIt>::difference_type
-    count(InputIt first, InputIt last, const T& val) {
+    __count(InputIt first, InputIt last, const T& val, false_type) {
         typename iterator_traits<InputIt>::difference_type result = 0;
         while (first != last) {
             if (*first == val) {
@@ -268,6 +361,25 @@ namespace HxSTL {
         return result;
     }
 
+    template <class T, class U>
+    ptrdiff_t __count(T* first, T* last, const U& val, true_type) {
+        typedef typename remove_cv<T>::type element_type;
+        if (!__simd_representable<element_type>(val)) {
+            ptrdiff_t result = 0;
+            for (; first != last; ++first) {
+                if (__simd_equal(*first, val)) ++result;
+            }
+            return result;
+        }
+        return static_cast<ptrdiff_t>(__simd_count<element_type>(first, last, static_cast<element_type>(val)));
+    }
+
+    template <class InputIt, class T>
+    typename iterator_traits<InputIt>::difference_type
+    count(InputIt first, InputIt last, const T& val) {
+        return __count(first, last, val, typename __simd_compare_dispatch<InputIt, T>::type());
+    }
+
     // count_if
 
     template <class InputIt, class UnaryPredicate>
@@ -287,8 +399,8 @@ namespace HxSTL {
 
     template <class InputIt1, class InputIt2>
     pair<InputIt1, InputIt2>
-    mismatch(InputIt1 first1, InputIt1 last1, 
-            InputIt2 first2) {
+    __mismatch(InputIt1 first1, InputIt1 last1, 
+            InputIt2 first2, false_type) {
         while (first1 != last1 && *first1 == *first2) {
             ++first1;
             ++first2;
@@ -296,6 +408,20 @@ namespace HxSTL {
         return make_pair(first1, first2);
     }
 
+    template <class T1, class T2>
+    pair<T1*, T2*> __mismatch(T1* first1, T1* last1, T2* first2, true_type) {
+        typedef typename remove_cv<T1>::type element_type;
+        ptrdiff_t n = __simd_mismatch<element_type>(first1, last1, first2);
+        return make_pair(first1 + n, first2 + n);
+    }
+
+    template <class InputIt1, class InputIt2>
+    pair<InputIt1, InputIt2>
+    mismatch(InputIt1 first1, InputIt1 last1, 
+            InputIt2 first2) {
+        return __mismatch(first1, last1, first2, typename __simd_mismatch_dispatch<InputIt1, InputIt2>::type());
+    }
+
     template <class InputIt1, class InputIt2, class BinaryPredicate>
     pair<InputIt1, InputIt2>
     mismatch(InputIt1 first1, InputIt1 last1, 
@@ -310,8 +436,8 @@ namespace HxSTL {
     // equal
 
     template <class InputIt1, class InputIt2>
-    bool equal(InputIt1 first1, InputIt1 last1, 
-            InputIt2 first2) {
+    bool __equal(InputIt1 first1, InputIt1 last1, 
+            InputIt2 first2, false_type) {
         while (first1 != last1) {
             if (*first1 != *first2) {
                 return false;
@@ -322,6 +448,22 @@ namespace HxSTL {
         return true;
     }
 
+    // 整数逐字节相等即相等, 交给 memcmp; 浮点数的 0.0 / -0.0 与 NaN 要按值比较
+    template <class T1, class T2>
+    bool __equal(T1* first1, T1* last1, T2* first2, true_type) {
+        typedef typename remove_cv<T1>::type element_type;
+        if (is_integeral<element_type>::value) {
+            return first1 == last1 || memcmp(first1, first2, (last1 - first1) * sizeof(element_type)) == 0;
+        }
+        return __simd_mismatch<element_type>(first1, last1, first2) == last1 - first1;
+    }
+
+    template <class InputIt1, class InputIt2>
+    bool equal(InputIt1 first1, InputIt1 last1, 
+            InputIt2 first2) {
+        return __equal(first1, last1, first2, typename __simd_mismatch_dispatch<InputIt1, InputIt2>::type());
+    }
+
     template <class InputIt1, class InputIt2, class BinaryPredicate>
     bool equal(InputIt1 first1, InputIt1 last1, 
             InputIt2 first2, BinaryPredicate pred) {
@@ -453,6 +595,20 @@ namespace HxSTL {
 
     // copy
 
+    // 可平凡拷贝且相应的赋值是平凡的, 赋值等价于按字节拷贝, 指针区间交给 memmove
+
+    template <class T>
+    struct __is_bitwise_copy_assignable:
+        public integeral_constant<bool,
+        is_trivially_copyable<T>::value &&
+        is_trivially_copy_assignable<T>::value> {};
+
+    template <class T>
+    struct __is_bitwise_move_assignable:
+        public integeral_constant<bool,
+        is_trivially_copyable<T>::value &&
+        is_trivially_move_assignable<T>::value> {};
+
     template <class InputIt, class OutputIterator>
     struct __copy_dispath {
         OutputIterator operator()(InputIt first, InputIt last, OutputIterator result) {
@@ -464,14 +620,14 @@ namespace HxSTL {
     template <class T>
     struct __copy_dispath<T*, T*> {
         T* operator()(T* first, T* last, T* result) {
-            return __copy_ptr(first, last, result, typename is_pod<T>::type());
+            return __copy_ptr(first, last, result, typename __is_bitwise_copy_assignable<T>::type());
         }
     };
 
     template <class T>
     struct __copy_dispath<const T*, T*> {
         T* operator()(const T* first, const T* last, T* result) {
-            return __copy_ptr(first, last, result, typename is_pod<T>::type());
+            return __copy_ptr(first, last, result, typename __is_bitwise_copy_assignable<T>::type());
         }
     };
 
@@ -513,10 +669,82 @@ namespace HxSTL {
         return __copy_rand(first, last, result);
     }
 
+    // 拷贝类算法的分段拆分: 输入是分段迭代器时逐块取出指针区间, 输出是分段迭代器时按输出的块切分输入,
+    // 最终交给 fn 在指针区间上完成实际工作 (memmove 或逐个构造)
+
+    template <class InputIt, class OutputIterator, class Fn>
+    inline OutputIterator __segmented_copy(InputIt first, InputIt last, OutputIterator result, Fn fn) {
+        return __segmented_copy_aux(first, last, result, fn,
+            typename __segmented_iterator_traits<InputIt>::is_segmented(),
+            typename __segmented_iterator_traits<OutputIterator>::is_segmented());
+    }
+
+    template <class SegmentedIt, class OutputIterator, class Fn, class OutputSegmented>
+    OutputIterator __segmented_copy_aux(SegmentedIt first, SegmentedIt last, 
+            OutputIterator result, Fn fn, true_type, OutputSegmented) {
+        typedef __segmented_iterator_traits<SegmentedIt> traits;
+        typename traits::segment_iterator sfirst = traits::segment(first);
+        typename traits::segment_iterator slast = traits::segment(last);
+        if (sfirst == slast) {
+            return __segmented_copy(traits::local(first), traits::local(last), result, fn);
+        }
+        result = __segmented_copy(traits::local(first), traits::end(sfirst), result, fn);
+        for (++sfirst; sfirst != slast; ++sfirst) {
+            result = __segmented_copy(traits::begin(sfirst), traits::end(sfirst), result, fn);
+        }
+        return __segmented_copy(traits::begin(slast), traits::local(last), result, fn);
+    }
+
+    template <class InputIt, class SegmentedIt, class Fn>
+    inline SegmentedIt __segmented_copy_aux(InputIt first, InputIt last, 
+            SegmentedIt result, Fn fn, false_type, true_type) {
+        return __segmented_copy_out(first, last, result, fn,
+            typename iterator_traits<InputIt>::iterator_category());
+    }
+
+    template <class InputIt, class OutputIterator, class Fn>
+    inline OutputIterator __segmented_copy_aux(InputIt first, InputIt last, 
+            OutputIterator result, Fn fn, false_type, false_type) {
+        return fn(first, last, result);
+    }
+
+    template <class InputIt, class SegmentedIt, class Fn>
+    inline SegmentedIt __segmented_copy_out(InputIt first, InputIt last, 
+            SegmentedIt result, Fn fn, input_iterator_tag) {
+        return fn(first, last, result);
+    }
+
+    template <class RandomAccessIterator, class SegmentedIt, class Fn>
+    SegmentedIt __segmented_copy_out(RandomAccessIterator first, RandomAccessIterator last, 
+            SegmentedIt result, Fn fn, random_access_iterator_tag) {
+        typedef __segmented_iterator_traits<SegmentedIt> traits;
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type distance;
+        typename traits::segment_iterator seg = traits::segment(result);
+        typename traits::local_iterator cur = traits::local(result);
+        while (true) {
+            distance n = last - first;
+            distance room = traits::end(seg) - cur;
+            if (n <= room) {
+                return traits::compose(seg, fn(first, last, cur));
+            }
+            fn(first, first + room, cur);
+            first += room;
+            ++seg;
+            cur = traits::begin(seg);
+        }
+    }
+
+    struct __copy_fn {
+        template <class InputIt, class OutputIterator>
+        OutputIterator operator()(InputIt first, InputIt last, OutputIterator result) const {
+            return __copy_dispath<InputIt, OutputIterator>()(first, last, result);
+        }
+    };
+
     template <class InputIt, class OutputIterator>
     OutputIterator copy(InputIt first, InputIt last, 
             OutputIterator result) {
-        return __copy_dispath<InputIt, OutputIterator>()(first, last, result);
+        return __segmented_copy(first, last, result, __copy_fn());
     }
 
     // copy_n
@@ -531,14 +759,14 @@ namespace HxSTL {
     template <class T, class Size>
     struct __copy_n_dispath<T*, Size, T*> {
         T* operator()(T* first, Size n, T* result) {
-            return __copy_n_ptr(first, n, result, typename is_pod<T>::type());
+            return __copy_n_ptr(first, n, result, typename __is_bitwise_copy_assignable<T>::type());
         }
     };
 
     template <class T, class Size>
     struct __copy_n_dispath<const T*, Size, T*> {
         T* operator()(const T* first, Size n, T* result) {
-            return __copy_n_ptr(first, n, result, typename is_pod<T>::type());
+            return __copy_n_ptr(first, n, result, typename __is_bitwise_copy_assignable<T>::type());
         }
     };
 
@@ -550,7 +778,7 @@ namespace HxSTL {
     
     template <class T, class Size>
     inline T* __copy_n_ptr(const T* first, Size n, T* result, false_type) {
-        return __copy_n(first, n, result, static_cast<ptrdiff_t*>(0));
+        return __copy_n(first, n, result);
     }
 
     template <class InputIt, class Size, class OutputIterator>
@@ -597,14 +825,14 @@ namespace HxSTL {
     template <class T>
     struct __copy_backward_dispath<T*, T*> {
         T* operator()(T* first, T* last, T* result) {
-            return __copy_backward_ptr(first, last, result, typename is_pod<T>::type());
+            return __copy_backward_ptr(first, last, result, typename __is_bitwise_copy_assignable<T>::type());
         }
     };
 
     template <class T>
     struct __copy_backward_dispath<const T*, T*> {
         T* operator()(const T* first, const T* last, T* result) {
-            return __copy_backward_ptr(first, last, result, typename is_pod<T>::type());
+            return __copy_backward_ptr(first, last, result, typename __is_bitwise_copy_assignable<T>::type());
         }
     };
 
@@ -652,7 +880,21 @@ namespace HxSTL {
     // move
     
     template <class InputIt, class OutputIterator>
-    OutputIterator move(InputIt first, InputIt last, OutputIterator result) {
+    struct __move_dispath {
+        OutputIterator operator()(InputIt first, InputIt last, OutputIterator result) {
+            return __move(first, last, result);
+        }
+    };
+
+    template <class T>
+    struct __move_dispath<T*, T*> {
+        T* operator()(T* first, T* last, T* result) {
+            return __move_ptr(first, last, result, typename __is_bitwise_move_assignable<T>::type());
+        }
+    };
+
+    template <class InputIt, class OutputIterator>
+    inline OutputIterator __move(InputIt first, InputIt last, OutputIterator result) {
         while (first != last) {
             *result = HxSTL::move(*first);
             ++first;
@@ -661,16 +903,60 @@ namespace HxSTL {
         return result;
     }
 
+    template <class T>
+    inline T* __move_ptr(T* first, T* last, T* result, true_type) {
+        return __copy_ptr(first, last, result, true_type());
+    }
+
+    template <class T>
+    inline T* __move_ptr(T* first, T* last, T* result, false_type) {
+        return __move(first, last, result);
+    }
+
+    template <class InputIt, class OutputIterator>
+    OutputIterator move(InputIt first, InputIt last, OutputIterator result) {
+        return __move_dispath<InputIt, OutputIterator>()(first, last, result);
+    }
+
     // move_backward
 
     template <class BidirIt1, class BidirIt2>
-    BidirIt2 move_backward(BidirIt1 first, BidirIt1 last, BidirIt2 result) {
+    struct __move_backward_dispath {
+        BidirIt2 operator()(BidirIt1 first, BidirIt1 last, BidirIt2 result) {
+            return __move_backward(first, last, result);
+        }
+    };
+
+    template <class T>
+    struct __move_backward_dispath<T*, T*> {
+        T* operator()(T* first, T* last, T* result) {
+            return __move_backward_ptr(first, last, result, typename __is_bitwise_move_assignable<T>::type());
+        }
+    };
+
+    template <class BidirIt1, class BidirIt2>
+    inline BidirIt2 __move_backward(BidirIt1 first, BidirIt1 last, BidirIt2 result) {
         while (first != last) {
             *(--result) = HxSTL::move(*(--last));
         }
         return result;
     }
 
+    template <class T>
+    inline T* __move_backward_ptr(T* first, T* last, T* result, true_type) {
+        return __copy_backward_ptr(first, last, result, true_type());
+    }
+
+    template <class T>
+    inline T* __move_backward_ptr(T* first, T* last, T* result, false_type) {
+        return __move_backward(first, last, result);
+    }
+
+    template <class BidirIt1, class BidirIt2>
+    BidirIt2 move_backward(BidirIt1 first, BidirIt1 last, BidirIt2 result) {
+        return __move_backward_dispath<BidirIt1, BidirIt2>()(first, last, result);
+    }
+
     // swap_range
 
     template <class ForwardIt1, class ForwardIt2>
@@ -696,7 +982,7 @@ namespace HxSTL {
     OutputIterator transform(InputIt first1, InputIt last1, 
             OutputIterator result, UnaryPredicate op) {
         while (first1 != last1) {
-            *result = op(first1);
+            *result = op(*first1);
             ++first1;
             ++result;
         }
@@ -707,7 +993,7 @@ namespace HxSTL {
     OutputIterator transform(InputIt1 first1, InputIt1 last1, 
             InputIt2 first2, OutputIterator result, BinaryPredicate op) {
         while (first1 != last1) {
-            *result = op(first1, first2);
+            *result = op(*first1, *first2);
             ++first1;
             ++first2;
             ++result;
@@ -770,13 +1056,52 @@ namespace HxSTL {
     // fill
 
     template <class ForwardIt, class T>
-    void fill(ForwardIt first, ForwardIt last, const T& val) {
+    inline void __fill_dispatch(ForwardIt first, ForwardIt last, const T& val, false_type) {
         while (first != last) {
             *first = val;
             ++first;
         }
     }
 
+    // 算术类型的指针区间: 先把 val 转换成元素类型, 单字节用 memset, 其余广播后整块写入
+    template <class T, class U>
+    inline void __fill_dispatch(T* first, T* last, const U& val, true_type) {
+        const T v = static_cast<T>(val);
+        if (sizeof(T) == 1) {
+            unsigned char c;
+            memcpy(&c, &v, 1);
+            memset(first, c, last - first);
+        } else {
+            __simd_fill<T>(first, last, v);
+        }
+    }
+
+    template <class ForwardIt, class T>
+    inline void __fill(ForwardIt first, ForwardIt last, const T& val, false_type) {
+        __fill_dispatch(first, last, val, typename __simd_fill_dispatch<ForwardIt, T>::type());
+    }
+
+    template <class SegmentedIt, class T>
+    void __fill(SegmentedIt first, SegmentedIt last, const T& val, true_type) {
+        typedef __segmented_iterator_traits<SegmentedIt> traits;
+        typename traits::segment_iterator sfirst = traits::segment(first);
+        typename traits::segment_iterator slast = traits::segment(last);
+        if (sfirst == slast) {
+            __fill(traits::local(first), traits::local(last), val, false_type());
+            return;
+        }
+        __fill(traits::local(first), traits::end(sfirst), val, false_type());
+        for (++sfirst; sfirst != slast; ++sfirst) {
+            __fill(traits::begin(sfirst), traits::end(sfirst), val, false_type());
+        }
+        __fill(traits::begin(slast), traits::local(last), val, false_type());
+    }
+
+    template <class ForwardIt, class T>
+    void fill(ForwardIt first, ForwardIt last, const T& val) {
+        __fill(first, last, val, typename __segmented_iterator_traits<ForwardIt>::is_segmented());
+    }
+
     // fill_n
 
     template <class OutputIterator, class Size, class T>
@@ -1013,9 +1338,48 @@ namespace HxSTL {
         reverse(first, last);
     }
 
+    // 每轮把较短一段整块交换到位, 剩下的部分继续旋转, 共 O(n) 次交换
     template <class RandomAccessIterator>
     void __rotate(RandomAccessIterator first, RandomAccessIterator middle, 
-            RandomAccessIterator last, random_access_iterator_tag);
+            RandomAccessIterator last, random_access_iterator_tag) {
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+        difference_type n = last - first;
+        difference_type k = middle - first;
+        if (k == 0 || k == n) {
+            return;
+        }
+        RandomAccessIterator p = first;
+        while (true) {
+            if (k < n - k) {
+                RandomAccessIterator q = p + k;
+                for (difference_type i = 0; i < n - k; ++i) {
+                    iter_swap(p, q);
+                    ++p;
+                    ++q;
+                }
+                n %= k;
+                if (n == 0) {
+                    return;
+                }
+                swap(n, k);
+                k = n - k;
+            } else {
+                k = n - k;
+                RandomAccessIterator q = p + n;
+                p = q - k;
+                for (difference_type i = 0; i < n - k; ++i) {
+                    --p;
+                    --q;
+                    iter_swap(p, q);
+                }
+                n %= k;
+                if (n == 0) {
+                    return;
+                }
+                swap(n, k);
+            }
+        }
+    }
 
     // rotate_copy
 
@@ -1026,24 +1390,78 @@ namespace HxSTL {
         return copy(first, middle, result);
     }
 
-    // random_shuffle**
+    // shuffle**
 
-    template <class RandomAccessIterator>
-    void random_shuffle(RandomAccessIterator first, RandomAccessIterator last) {
+    // Fisher-Yates, 下标用 Lemire 的方法无偏地生成; gen 是 UniformRandomBitGenerator
+    template <class RandomAccessIterator, class URBG>
+    void shuffle(RandomAccessIterator first, RandomAccessIterator last, URBG&& gen) {
         typedef typename iterator_traits<RandomAccessIterator>::difference_type distance;
         distance n = last - first;
-        for (int i = 0; i != n; ++i) {
-            swap(first[i], first[rand() % (i + 1)]);
+        for (distance i = n - 1; i > 0; --i) {
+            iter_swap(first + i, first + static_cast<distance>(__random_uniform(gen, static_cast<uint64_t>(i))));
         }
     }
 
+    // random_shuffle**
+
+    // 使用每个线程各自的引擎, 不经过 rand() 的全局锁, 也没有 RAND_MAX 的上限
+    template <class RandomAccessIterator>
+    void random_shuffle(RandomAccessIterator first, RandomAccessIterator last) {
+        shuffle(first, last, __thread_random_engine());
+    }
+
+    // gen(n) 返回 [0, n) 内的随机数
     template <class RandomAccessIterator, class RandomNumberGenerator>
-    void random_shuffle(RandomAccessIterator first, RandomAccessIterator last, RandomNumberGenerator& gen) {
+    void random_shuffle(RandomAccessIterator first, RandomAccessIterator last, RandomNumberGenerator&& gen) {
         typedef typename iterator_traits<RandomAccessIterator>::difference_type distance;
         distance n = last - first;
-        for (int i = 0; i != n; ++i) {
-            swap(first[i], first[gen(i + 1)]);
+        for (distance i = 1; i < n; ++i) {
+            iter_swap(first + i, first + static_cast<distance>(gen(i + 1)));
+        }
+    }
+
+    // sample
+
+    // 可以多次遍历的区间用选择抽样: 依次以 剩余名额 / 剩余元素 的概率选中, 结果保持原有顺序
+    template <class ForwardIt, class OutputIterator, class Distance, class URBG>
+    OutputIterator __sample(ForwardIt first, ForwardIt last, forward_iterator_tag, 
+            OutputIterator result, Distance n, URBG& gen) {
+        typedef typename iterator_traits<ForwardIt>::difference_type distance;
+        distance unsampled = HxSTL::distance(first, last);
+        distance k = n < unsampled ? static_cast<distance>(n) : unsampled;
+        for (; k != 0; ++first) {
+            if (__random_uniform(gen, static_cast<uint64_t>(--unsampled)) < static_cast<uint64_t>(k)) {
+                *result = *first;
+                ++result;
+                --k;
+            }
+        }
+        return result;
+    }
+
+    // 只能遍历一次的区间用蓄水池抽样, 输出需要可随机访问, 结果的顺序是随机的
+    template <class InputIt, class RandomAccessIterator, class Distance, class URBG>
+    RandomAccessIterator __sample(InputIt first, InputIt last, input_iterator_tag, 
+            RandomAccessIterator result, Distance n, URBG& gen) {
+        Distance k = 0;
+        for (; first != last && k < n; ++first, ++k) {
+            result[k] = *first;
         }
+        for (uint64_t seen = static_cast<uint64_t>(k); first != last; ++first, ++seen) {
+            uint64_t r = __random_uniform(gen, seen);
+            if (r < static_cast<uint64_t>(n)) {
+                result[r] = *first;
+            }
+        }
+        return result + k;
+    }
+
+    // 从 [first, last) 中不放回地均匀抽取 min(n, last - first) 个元素写到 result
+    template <class PopulationIterator, class SampleIterator, class Distance, class URBG>
+    SampleIterator sample(PopulationIterator first, PopulationIterator last, 
+            SampleIterator result, Distance n, URBG&& gen) {
+        return __sample(first, last, typename iterator_traits<PopulationIterator>::iterator_category(), 
+            result, n, gen);
     }
 
     /*
@@ -1118,34 +1536,210 @@ namespace HxSTL {
         return first;
     }
 
-    // stable_partition**
+    // 临时缓冲区
+    // 稳定划分 / 原地归并 / 稳定排序借用的额外空间: 申请失败时减半重试, 最终可能一个元素也没有,
+    // 此时调用者退回不用缓冲区的原地算法
+    // 缓冲区一次性构造: 从 *seed 移动出第一个元素, 之后每个元素从前一个移动构造, 最后移回 *seed,
+    // 整个算法期间只做移动赋值, 不必在每次归并时反复构造析构
+    template <class T>
+    class __temporary_buffer {
+    public:
+        typedef T*          pointer;
+        typedef ptrdiff_t   size_type;
+
+    protected:
+        pointer _buffer;
+        size_type _size;
+
+    public:
+        template <class ForwardIt>
+        __temporary_buffer(ForwardIt seed, size_type requested);
+        ~__temporary_buffer();
+
+        pointer begin() const { return _buffer; }
+        pointer end() const { return _buffer + _size; }
+        size_type size() const { return _size; }
+
+    private:
+        __temporary_buffer(const __temporary_buffer&);
+        __temporary_buffer& operator=(const __temporary_buffer&);
+    };
 
-    template <class BidirIt, class UnaryPredicate>
-    BidirIt stable_partition(BidirIt first, BidirIt last, UnaryPredicate pred) {
-        while (pred(*first)) {
-            ++first;
-            if (first == last) {
-                return first;
+    template <class T>
+    template <class ForwardIt>
+    __temporary_buffer<T>::__temporary_buffer(ForwardIt seed, size_type requested): _buffer(nullptr), _size(0) {
+        const size_type max_size = PTRDIFF_MAX / static_cast<size_type>(sizeof(T));
+        if (requested > max_size) {
+            requested = max_size;
+        }
+        while (requested > 0) {
+            _buffer = static_cast<pointer>(::operator new(requested * sizeof(T), std::nothrow));
+            if (_buffer != nullptr) {
+                break;
             }
+            requested /= 2;
         }
-        BidirIt tmp = first;
-        while (first != last) {
-            while (!pred(*tmp)) {
-                ++tmp;
-                if (tmp == last) {
-                    return first;
-                }
+        if (_buffer == nullptr) {
+            return;
+        }
+        pointer cur = _buffer;
+        try {
+            ::new (static_cast<void*>(cur)) T(HxSTL::move(*seed));
+            for (++cur; cur != _buffer + requested; ++cur) {
+                ::new (static_cast<void*>(cur)) T(HxSTL::move(*(cur - 1)));
+            }
+            *seed = HxSTL::move(*(cur - 1));
+        } catch (...) {
+            while (cur != _buffer) {
+                (--cur)->~T();
+            }
+            ::operator delete(_buffer);
+            throw;
+        }
+        _size = requested;
+    }
+
+    template <class T>
+    __temporary_buffer<T>::~__temporary_buffer() {
+        for (pointer cur = _buffer; cur != _buffer + _size; ++cur) {
+            cur->~T();
+        }
+        ::operator delete(_buffer);
+    }
+
+    // 用 < 比较两个元素, 供没有 comp 参数的版本转发
+    struct __iter_less {
+        template <class T, class U>
+        bool operator()(const T& a, const U& b) const { return a < b; }
+    };
+
+    // 第一个不小于 val 的位置
+    template <class ForwardIt, class T, class Compare>
+    ForwardIt __lower_bound(ForwardIt first, ForwardIt last, const T& val, Compare comp) {
+        typedef typename iterator_traits<ForwardIt>::difference_type difference_type;
+        difference_type len = distance(first, last);
+        while (len > 0) {
+            difference_type half = len >> 1;
+            ForwardIt middle = first;
+            advance(middle, half);
+            if (comp(*middle, val)) {
+                first = ++middle;
+                len = len - half - 1;
+            } else {
+                len = half;
             }
-            BidirIt middle = tmp;
-            while (tmp != last && pred(*tmp)) {
-                ++tmp;
+        }
+        return first;
+    }
+
+    // 第一个大于 val 的位置
+    template <class ForwardIt, class T, class Compare>
+    ForwardIt __upper_bound(ForwardIt first, ForwardIt last, const T& val, Compare comp) {
+        typedef typename iterator_traits<ForwardIt>::difference_type difference_type;
+        difference_type len = distance(first, last);
+        while (len > 0) {
+            difference_type half = len >> 1;
+            ForwardIt middle = first;
+            advance(middle, half);
+            if (comp(val, *middle)) {
+                len = half;
+            } else {
+                first = ++middle;
+                len = len - half - 1;
             }
-            rotate(first, middle, tmp);
-            first = middle;
         }
         return first;
     }
 
+    // 借助缓冲区旋转 [first, middle) 与 [middle, last), 返回原 *first 的新位置
+    // 较短的一段放得进缓冲区时只需三次线性移动, 否则退回 rotate
+    template <class BidirIt, class Pointer, class Distance>
+    BidirIt __rotate_adaptive(BidirIt first, BidirIt middle, BidirIt last,
+            Distance len1, Distance len2, Pointer buffer, Distance buffer_size) {
+        if (len2 <= len1 && len2 <= buffer_size) {
+            if (len2 == 0) {
+                return first;
+            }
+            Pointer buffer_end = HxSTL::move(middle, last, buffer);
+            HxSTL::move_backward(first, middle, last);
+            return HxSTL::move(buffer, buffer_end, first);
+        } else if (len1 <= buffer_size) {
+            if (len1 == 0) {
+                return last;
+            }
+            Pointer buffer_end = HxSTL::move(first, middle, buffer);
+            BidirIt result = HxSTL::move(middle, last, first);
+            HxSTL::move(buffer, buffer_end, result);
+            return result;
+        } else {
+            rotate(first, middle, last);
+            advance(first, len2);
+            return first;
+        }
+    }
+
+    // stable_partition**
+
+    // 调用前 *first 不满足 pred, 且 len > 0
+    // 放得进缓冲区: 满足的元素就地前移, 不满足的暂存到缓冲区再接到后面, O(n)
+    // 否则对半递归后把中间两段旋转到一起, 缓冲区再小也能利用, 没有缓冲区时 O(nlogn) 次交换
+    template <class BidirIt, class Pointer, class UnaryPredicate, class Distance>
+    BidirIt __stable_partition_adaptive(BidirIt first, BidirIt last, UnaryPredicate pred,
+            Distance len, Pointer buffer, Distance buffer_size) {
+        if (len == 1) {
+            return first;
+        }
+        if (len <= buffer_size) {
+            BidirIt result1 = first;
+            Pointer result2 = buffer;
+            *result2 = HxSTL::move(*first);
+            ++result2;
+            ++first;
+            for (; first != last; ++first) {
+                if (pred(*first)) {
+                    *result1 = HxSTL::move(*first);
+                    ++result1;
+                } else {
+                    *result2 = HxSTL::move(*first);
+                    ++result2;
+                }
+            }
+            HxSTL::move(buffer, result2, result1);
+            return result1;
+        }
+        BidirIt middle = first;
+        advance(middle, len / 2);
+        BidirIt left_split = __stable_partition_adaptive(first, middle, pred, len / 2, buffer, buffer_size);
+        // 右半部分先跳过开头满足 pred 的元素, 保持递归的前置条件
+        Distance right_len = len - len / 2;
+        BidirIt right_split = middle;
+        while (right_len > 0 && pred(*right_split)) {
+            ++right_split;
+            --right_len;
+        }
+        if (right_len > 0) {
+            right_split = __stable_partition_adaptive(right_split, last, pred, right_len, buffer, buffer_size);
+        }
+        return __rotate_adaptive(left_split, middle, right_split, static_cast<Distance>(distance(left_split, middle)),
+            static_cast<Distance>(distance(middle, right_split)), buffer, buffer_size);
+    }
+
+    template <class BidirIt, class UnaryPredicate>
+    BidirIt stable_partition(BidirIt first, BidirIt last, UnaryPredicate pred) {
+        typedef typename iterator_traits<BidirIt>::value_type value_type;
+        typedef typename iterator_traits<BidirIt>::difference_type difference_type;
+        while (first != last && pred(*first)) {
+            ++first;
+        }
+        if (first == last) {
+            return first;
+        }
+        difference_type len = distance(first, last);
+        __temporary_buffer<value_type> buf(first, len);
+        return __stable_partition_adaptive(first, last, pred, len, buf.begin(),
+            static_cast<difference_type>(buf.size()));
+    }
+
     // partition_copy
 
     template <class InputIt, class OutputIterator1, class OutputIterator2, class UnaryPredicate>
@@ -1486,14 +2080,18 @@ namespace HxSTL {
     template <class RandomAccessIterator>
     void __unguarded_insertion_sort(RandomAccessIterator first, RandomAccessIterator last) {
         for (RandomAccessIterator it = first; it != last; ++it) {
-            __unguarded_linear_insert(it, *it);
+            // val 不能引用 *it, 插入时 *it 会先被覆盖
+            typename iterator_traits<RandomAccessIterator>::value_type val = *it;
+            __unguarded_linear_insert(it, val);
         }
     }
 
     template <class RandomAccessIterator, class Compare>
     void __unguarded_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
         for (RandomAccessIterator it = first; it != last; ++it) {
-            __unguarded_linear_insert(it, *it, comp);
+            // val 不能引用 *it, 插入时 *it 会先被覆盖
+            typename iterator_traits<RandomAccessIterator>::value_type val = *it;
+            __unguarded_linear_insert(it, val, comp);
         }
     }
 
@@ -1642,24 +2240,416 @@ namespace HxSTL {
         }
     }
 
-    // sort
+    // pdqsort (pattern-defeating quicksort)
+    // 在 introsort 的基础上:
+    //   1. 大区间用 ninther (三组三数取中再取中) 选枢轴, 枢轴换到区间首位后移动 (而非复制) 到局部变量
+    //   2. 比较便宜 (算术类型 + 默认比较) 时按块划分: 先无分支地记下两侧放错位置的元素的偏移, 再成批交换
+    //   3. 枢轴等于左侧相邻区间的最后一个元素时, 把等于它的元素划到左边, 大量重复元素的区间线性完成
+    //   4. 划分时没有发生交换, 说明区间可能已经有序, 尝试有限次数的插入排序直接结束
+    //   5. 划分很不平衡时打乱若干元素破坏模式, 不平衡次数超过 logn 改用堆排序保证 O(nlogn)
+    const int __pdq_insertion_sort_threshold = 24;
+    const int __pdq_ninther_threshold = 128;
+    const int __pdq_partial_insertion_sort_limit = 8;
+    const int __pdq_block_size = 64;
+    const int __pdq_cacheline_size = 64;
 
-    template <class RandomAccessIterator>
-    void sort(RandomAccessIterator first, RandomAccessIterator last) {
-        if (first != last) {
-            __introsort(first, last, __lg(last - first) * 2);
-            __final_insertion_sort(first, last);
-        }
-    }
+    template <class T>
+    struct less;
 
-    template <class RandomAccessIterator, class Compare>
-    void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
-        if (first != last) {
-            __introsort(first, last, __lg(last - first) * 2, comp);
-            __final_insertion_sort(first, last, comp);
+    template <class T>
+    struct greater;
+
+    // 比较便宜且没有副作用, 可以用无分支的块划分
+    template <class Compare, class T>
+    struct __pdq_branchless: public false_type {};
+
+    template <class T>
+    struct __pdq_branchless<__iter_less, T>: public integeral_constant<bool, is_arithmetic<T>::value> {};
+
+    template <class T>
+    struct __pdq_branchless<less<T>, T>: public integeral_constant<bool, is_arithmetic<T>::value> {};
+
+    template <class T>
+    struct __pdq_branchless<greater<T>, T>: public integeral_constant<bool, is_arithmetic<T>::value> {};
+
+    template <class RandomAccessIterator, class Compare>
+    void __pdq_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+        if (first == last) {
+            return;
+        }
+        for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+            RandomAccessIterator sift = cur;
+            RandomAccessIterator sift_1 = cur - 1;
+            if (comp(*sift, *sift_1)) {
+                value_type tmp = HxSTL::move(*sift);
+                do {
+                    *sift-- = HxSTL::move(*sift_1);
+                } while (sift != first && comp(tmp, *--sift_1));
+                *sift = HxSTL::move(tmp);
+            }
+        }
+    }
+
+    // 调用前 *(first - 1) 不大于区间内任何元素, 作为哨兵
+    template <class RandomAccessIterator, class Compare>
+    void __pdq_unguarded_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+        if (first == last) {
+            return;
+        }
+        for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+            RandomAccessIterator sift = cur;
+            RandomAccessIterator sift_1 = cur - 1;
+            if (comp(*sift, *sift_1)) {
+                value_type tmp = HxSTL::move(*sift);
+                do {
+                    *sift-- = HxSTL::move(*sift_1);
+                } while (comp(tmp, *--sift_1));
+                *sift = HxSTL::move(tmp);
+            }
         }
     }
 
+    // 移动次数超过上限时放弃并返回 false, 区间此时仍是原元素的一个排列
+    template <class RandomAccessIterator, class Compare>
+    bool __pdq_partial_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+        if (first == last) {
+            return true;
+        }
+        size_t limit = 0;
+        for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+            RandomAccessIterator sift = cur;
+            RandomAccessIterator sift_1 = cur - 1;
+            if (comp(*sift, *sift_1)) {
+                value_type tmp = HxSTL::move(*sift);
+                do {
+                    *sift-- = HxSTL::move(*sift_1);
+                } while (sift != first && comp(tmp, *--sift_1));
+                *sift = HxSTL::move(tmp);
+                limit += cur - sift;
+            }
+            if (limit > static_cast<size_t>(__pdq_partial_insertion_sort_limit)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    inline void __pdq_sort2(RandomAccessIterator a, RandomAccessIterator b, Compare comp) {
+        if (comp(*b, *a)) {
+            iter_swap(a, b);
+        }
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    inline void __pdq_sort3(RandomAccessIterator a, RandomAccessIterator b, RandomAccessIterator c, Compare comp) {
+        __pdq_sort2(a, b, comp);
+        __pdq_sort2(b, c, comp);
+        __pdq_sort2(a, b, comp);
+    }
+
+    // 按偏移成批交换左右两侧放错的元素; 两侧个数相等时逐对交换 (降序输入需要它保持 O(n)),
+    // 否则用一个临时变量做循环移动, 每个元素只移动一次
+    template <class RandomAccessIterator>
+    inline void __pdq_swap_offsets(RandomAccessIterator first, RandomAccessIterator last, 
+            unsigned char* offsets_l, unsigned char* offsets_r, size_t num, bool use_swaps) {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+        if (use_swaps) {
+            for (size_t i = 0; i < num; ++i) {
+                iter_swap(first + offsets_l[i], last - offsets_r[i]);
+            }
+        } else if (num > 0) {
+            RandomAccessIterator l = first + offsets_l[0];
+            RandomAccessIterator r = last - offsets_r[0];
+            value_type tmp(HxSTL::move(*l));
+            *l = HxSTL::move(*r);
+            for (size_t i = 1; i < num; ++i) {
+                l = first + offsets_l[i];
+                *r = HxSTL::move(*l);
+                r = last - offsets_r[i];
+                *l = HxSTL::move(*r);
+            }
+            *r = HxSTL::move(tmp);
+        }
+    }
+
+    // 以 *first 为枢轴划分, 小于枢轴的在左, 其余在右; 返回枢轴的最终位置, 以及是否一次交换都没有发生
+    // 调用前枢轴已经过三数取中, 右侧必有不小于它的元素, 扫描可以不检查边界
+    template <class RandomAccessIterator, class Compare>
+    pair<RandomAccessIterator, bool> __pdq_partition_right(RandomAccessIterator begin, 
+            RandomAccessIterator end, Compare comp, false_type) {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+        value_type pivot(HxSTL::move(*begin));
+        RandomAccessIterator first = begin;
+        RandomAccessIterator last = end;
+
+        while (comp(*++first, pivot)) {}
+        if (first - 1 == begin) {
+            while (first < last && !comp(*--last, pivot)) {}
+        } else {
+            while (!comp(*--last, pivot)) {}
+        }
+
+        bool already_partitioned = first >= last;
+        while (first < last) {
+            iter_swap(first, last);
+            while (comp(*++first, pivot)) {}
+            while (!comp(*--last, pivot)) {}
+        }
+
+        RandomAccessIterator pivot_pos = first - 1;
+        *begin = HxSTL::move(*pivot_pos);
+        *pivot_pos = HxSTL::move(pivot);
+        return make_pair(pivot_pos, already_partitioned);
+    }
+
+    // 块划分 (BlockQuicksort): 每块 64 个元素, 比较结果只用来累加偏移数组的长度, 循环中没有依赖数据的分支
+    template <class RandomAccessIterator, class Compare>
+    pair<RandomAccessIterator, bool> __pdq_partition_right(RandomAccessIterator begin, 
+            RandomAccessIterator end, Compare comp, true_type) {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+        value_type pivot(HxSTL::move(*begin));
+        RandomAccessIterator first = begin;
+        RandomAccessIterator last = end;
+
+        while (comp(*++first, pivot)) {}
+        if (first - 1 == begin) {
+            while (first < last && !comp(*--last, pivot)) {}
+        } else {
+            while (!comp(*--last, pivot)) {}
+        }
+
+        bool already_partitioned = first >= last;
+        if (!already_partitioned) {
+            iter_swap(first, last);
+            ++first;
+
+            unsigned char offsets_l_storage[__pdq_block_size + __pdq_cacheline_size];
+            unsigned char offsets_r_storage[__pdq_block_size + __pdq_cacheline_size];
+            unsigned char* offsets_l = offsets_l_storage + (-reinterpret_cast<uintptr_t>(offsets_l_storage) & (__pdq_cacheline_size - 1));
+            unsigned char* offsets_r = offsets_r_storage + (-reinterpret_cast<uintptr_t>(offsets_r_storage) & (__pdq_cacheline_size - 1));
+
+            RandomAccessIterator offsets_l_base = first;
+            RandomAccessIterator offsets_r_base = last;
+            size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+            const size_t block = __pdq_block_size;
+
+            while (first < last) {
+                // 左右两侧中已经用完的一侧重新装满一块, 未知元素不足两块时两侧平分
+                size_t num_unknown = last - first;
+                size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+                size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+                if (left_split >= block) {
+                    for (size_t i = 0; i < block; ) {
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    }
+                } else {
+                    for (size_t i = 0; i < left_split; ) {
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    }
+                }
+
+                if (right_split >= block) {
+                    for (size_t i = 0; i < block; ) {
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    }
+                } else {
+                    for (size_t i = 0; i < right_split; ) {
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    }
+                }
+
+                size_t num = num_l < num_r ? num_l : num_r;
+                __pdq_swap_offsets(offsets_l_base, offsets_r_base, 
+                    offsets_l + start_l, offsets_r + start_r, num, num_l == num_r);
+                num_l -= num;
+                num_r -= num;
+                start_l += num;
+                start_r += num;
+                if (num_l == 0) {
+                    start_l = 0;
+                    offsets_l_base = first;
+                }
+                if (num_r == 0) {
+                    start_r = 0;
+                    offsets_r_base = last;
+                }
+            }
+
+            // 剩下的一侧逐个交换到中间
+            if (num_l) {
+                offsets_l += start_l;
+                while (num_l--) {
+                    iter_swap(offsets_l_base + offsets_l[num_l], --last);
+                }
+                first = last;
+            }
+            if (num_r) {
+                offsets_r += start_r;
+                while (num_r--) {
+                    iter_swap(offsets_r_base - offsets_r[num_r], first);
+                    ++first;
+                }
+                last = first;
+            }
+        }
+
+        RandomAccessIterator pivot_pos = first - 1;
+        *begin = HxSTL::move(*pivot_pos);
+        *pivot_pos = HxSTL::move(pivot);
+        return make_pair(pivot_pos, already_partitioned);
+    }
+
+    // 与 __pdq_partition_right 相反, 等于枢轴的元素划到左边; 返回枢轴的最终位置
+    template <class RandomAccessIterator, class Compare>
+    RandomAccessIterator __pdq_partition_left(RandomAccessIterator begin, RandomAccessIterator end, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+        value_type pivot(HxSTL::move(*begin));
+        RandomAccessIterator first = begin;
+        RandomAccessIterator last = end;
+
+        while (comp(pivot, *--last)) {}
+        if (last + 1 == end) {
+            while (first < last && !comp(pivot, *++first)) {}
+        } else {
+            while (!comp(pivot, *++first)) {}
+        }
+
+        while (first < last) {
+            iter_swap(first, last);
+            while (comp(pivot, *--last)) {}
+            while (!comp(pivot, *++first)) {}
+        }
+
+        RandomAccessIterator pivot_pos = last;
+        *begin = HxSTL::move(*pivot_pos);
+        *pivot_pos = HxSTL::move(pivot);
+        return pivot_pos;
+    }
+
+    template <class RandomAccessIterator, class Compare, class Branchless>
+    void __pdqsort_loop(RandomAccessIterator begin, RandomAccessIterator end, Compare comp, 
+            int bad_allowed, bool leftmost, Branchless branchless) {
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+        while (true) {
+            difference_type size = end - begin;
+            if (size < __pdq_insertion_sort_threshold) {
+                if (leftmost) {
+                    __pdq_insertion_sort(begin, end, comp);
+                } else {
+                    __pdq_unguarded_insertion_sort(begin, end, comp);
+                }
+                return;
+            }
+
+            // 枢轴换到 begin, 大区间取 ninther
+            difference_type s2 = size / 2;
+            if (size > __pdq_ninther_threshold) {
+                __pdq_sort3(begin, begin + s2, end - 1, comp);
+                __pdq_sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+                __pdq_sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+                __pdq_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+                iter_swap(begin, begin + s2);
+            } else {
+                __pdq_sort3(begin + s2, begin, end - 1, comp);
+            }
+
+            // *(begin - 1) 是上一次划分的枢轴, 不大于区间内任何元素; 枢轴与它相等时,
+            // 等于枢轴的元素全部划到左边, 左边已经有序, 只需继续处理右边
+            if (!leftmost && !comp(*(begin - 1), *begin)) {
+                begin = __pdq_partition_left(begin, end, comp) + 1;
+                continue;
+            }
+
+            pair<RandomAccessIterator, bool> part_result = __pdq_partition_right(begin, end, comp, branchless);
+            RandomAccessIterator pivot_pos = part_result.first;
+            bool already_partitioned = part_result.second;
+
+            difference_type l_size = pivot_pos - begin;
+            difference_type r_size = end - (pivot_pos + 1);
+            bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+            if (highly_unbalanced) {
+                if (--bad_allowed == 0) {
+                    make_heap(begin, end, comp);
+                    sort_heap(begin, end, comp);
+                    return;
+                }
+                // 交换两侧若干固定位置的元素, 破坏造成不平衡的模式
+                if (l_size >= __pdq_insertion_sort_threshold) {
+                    iter_swap(begin, begin + l_size / 4);
+                    iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                    if (l_size > __pdq_ninther_threshold) {
+                        iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                        iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                        iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                        iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                    }
+                }
+                if (r_size >= __pdq_insertion_sort_threshold) {
+                    iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                    iter_swap(end - 1, end - r_size / 4);
+                    if (r_size > __pdq_ninther_threshold) {
+                        iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                        iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                        iter_swap(end - 2, end - (1 + r_size / 4));
+                        iter_swap(end - 3, end - (2 + r_size / 4));
+                    }
+                }
+            } else if (already_partitioned 
+                    && __pdq_partial_insertion_sort(begin, pivot_pos, comp)
+                    && __pdq_partial_insertion_sort(pivot_pos + 1, end, comp)) {
+                // 划分没有交换任何元素, 两侧又都几乎有序, 整个区间已经排好
+                return;
+            }
+
+            // 左侧递归, 右侧循环
+            __pdqsort_loop(begin, pivot_pos, comp, bad_allowed, leftmost, branchless);
+            begin = pivot_pos + 1;
+            leftmost = false;
+        }
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    inline void __pdqsort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+        if (first == last) {
+            return;
+        }
+        __pdqsort_loop(first, last, comp, static_cast<int>(__lg(last - first)), true, 
+            typename __pdq_branchless<Compare, value_type>::type());
+    }
+
+    // sort
+
+    template <class RandomAccessIterator>
+    void sort(RandomAccessIterator first, RandomAccessIterator last) {
+        __pdqsort(first, last, __iter_less());
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        __pdqsort(first, last, comp);
+    }
+
     // partial_sort
 
     template <class RandomAccessIterator>
@@ -1679,14 +2669,530 @@ namespace HxSTL {
     void partial_sort(RandomAccessIterator first, RandomAccessIterator middle, 
             RandomAccessIterator last, Compare comp) {
         typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
-        make_heap(first, middle);
+        make_heap(first, middle, comp);
         for (RandomAccessIterator it = middle; it != last; ++it) {
             if (comp(*it, *first)) {
                 iter_swap(first, it);
-                __maintain_heap(first, static_cast<difference_type>(0), middle - first);
+                __maintain_heap(first, static_cast<difference_type>(0), middle - first, comp);
             }
         }
-        sort_heap(first, middle);
+        sort_heap(first, middle, comp);
+    }
+
+    // partial_sort_copy
+
+    template <class InputIt, class RandomAccessIterator, class Compare>
+    RandomAccessIterator partial_sort_copy(InputIt first, InputIt last, RandomAccessIterator result_first, 
+            RandomAccessIterator result_last, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+        if (result_first == result_last) {
+            return result_first;
+        }
+        RandomAccessIterator result_real_last = result_first;
+        while (first != last && result_real_last != result_last) {
+            *result_real_last = *first;
+            ++result_real_last;
+            ++first;
+        }
+        // 结果区间满了之后, 保留其中最小的若干个: 大顶堆的堆顶是当前的最大者, 更小的元素替换它
+        make_heap(result_first, result_real_last, comp);
+        for (; first != last; ++first) {
+            if (comp(*first, *result_first)) {
+                *result_first = *first;
+                __maintain_heap(result_first, static_cast<difference_type>(0), result_real_last - result_first, comp);
+            }
+        }
+        sort_heap(result_first, result_real_last, comp);
+        return result_real_last;
+    }
+
+    template <class InputIt, class RandomAccessIterator>
+    RandomAccessIterator partial_sort_copy(InputIt first, InputIt last, 
+            RandomAccessIterator result_first, RandomAccessIterator result_last) {
+        return partial_sort_copy(first, last, result_first, result_last, __iter_less());
+    }
+
+    // nth_element
+
+    // 与 __introsort 相同的划分, 但每轮只进入 nth 所在的一侧, 期望 O(n);
+    // 划分轮数超过 2logn 时说明枢轴选得很差, 改用堆选择保证 O(nlogn)
+    template <class RandomAccessIterator, class Size, class Compare>
+    void __introselect(RandomAccessIterator first, RandomAccessIterator nth, 
+            RandomAccessIterator last, Size limit, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+        while (last - first > 3) {
+            if (limit == 0) {
+                // [first, nth] 成为最小的若干个元素组成的大顶堆, 堆顶就是第 nth 小
+                make_heap(first, nth + 1, comp);
+                for (RandomAccessIterator it = nth + 1; it != last; ++it) {
+                    if (comp(*it, *first)) {
+                        iter_swap(first, it);
+                        __maintain_heap(first, static_cast<difference_type>(0), nth + 1 - first, comp);
+                    }
+                }
+                iter_swap(first, nth);
+                return;
+            }
+            --limit;
+
+            value_type pivot = __median(*first, *(first + (last - first) / 2), *(last - 1), comp);
+            RandomAccessIterator cut = __pivot_parition(first, last, pivot, comp);
+            if (cut <= nth) {
+                first = cut;
+            } else {
+                last = cut;
+            }
+        }
+        __insertion_sort(first, last, comp);
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    void nth_element(RandomAccessIterator first, RandomAccessIterator nth, 
+            RandomAccessIterator last, Compare comp) {
+        if (first == last || nth == last) {
+            return;
+        }
+        __introselect(first, nth, last, __lg(last - first) * 2, comp);
+    }
+
+    template <class RandomAccessIterator>
+    void nth_element(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last) {
+        nth_element(first, nth, last, __iter_less());
+    }
+
+    /**
+     * Binary search operations (on sorted ranges)
+     */
+
+    // 随机访问区间用无分支的二分: 每轮只用比较结果选择 base 或 base + half, 编译为条件移动,
+    // 不会因为分支预测失败清空流水线; 循环次数只取决于长度
+    // 指针区间在每轮预取下一轮可能访问的两个位置, 大数组上把缓存缺失与比较重叠起来
+    template <class RandomAccessIterator>
+    inline void __search_prefetch(RandomAccessIterator) {}
+
+    template <class T>
+    inline void __search_prefetch(T* p) {
+        __builtin_prefetch(p);
+    }
+
+    template <class RandomAccessIterator, class T, class Compare>
+    RandomAccessIterator __branchless_lower_bound(RandomAccessIterator first, 
+            RandomAccessIterator last, const T& val, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+        difference_type len = last - first;
+        if (len == 0) {
+            return first;
+        }
+        while (len > 1) {
+            difference_type half = len >> 1;
+            len -= half;
+            __search_prefetch(first + (len >> 1));
+            __search_prefetch(first + half + (len >> 1));
+            first = comp(first[half], val) ? first + half : first;
+        }
+        return comp(*first, val) ? first + 1 : first;
+    }
+
+    template <class RandomAccessIterator, class T, class Compare>
+    RandomAccessIterator __branchless_upper_bound(RandomAccessIterator first, 
+            RandomAccessIterator last, const T& val, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+        difference_type len = last - first;
+        if (len == 0) {
+            return first;
+        }
+        while (len > 1) {
+            difference_type half = len >> 1;
+            len -= half;
+            __search_prefetch(first + (len >> 1));
+            __search_prefetch(first + half + (len >> 1));
+            first = comp(val, first[half]) ? first : first + half;
+        }
+        return comp(val, *first) ? first : first + 1;
+    }
+
+    template <class ForwardIt, class T, class Compare>
+    inline ForwardIt __lower_bound_dispatch(ForwardIt first, ForwardIt last, 
+            const T& val, Compare comp, forward_iterator_tag) {
+        return __lower_bound(first, last, val, comp);
+    }
+
+    template <class RandomAccessIterator, class T, class Compare>
+    inline RandomAccessIterator __lower_bound_dispatch(RandomAccessIterator first, 
+            RandomAccessIterator last, const T& val, Compare comp, random_access_iterator_tag) {
+        return __branchless_lower_bound(first, last, val, comp);
+    }
+
+    template <class ForwardIt, class T, class Compare>
+    inline ForwardIt __upper_bound_dispatch(ForwardIt first, ForwardIt last, 
+            const T& val, Compare comp, forward_iterator_tag) {
+        return __upper_bound(first, last, val, comp);
+    }
+
+    template <class RandomAccessIterator, class T, class Compare>
+    inline RandomAccessIterator __upper_bound_dispatch(RandomAccessIterator first, 
+            RandomAccessIterator last, const T& val, Compare comp, random_access_iterator_tag) {
+        return __branchless_upper_bound(first, last, val, comp);
+    }
+
+    // lower_bound
+
+    template <class ForwardIt, class T, class Compare>
+    ForwardIt lower_bound(ForwardIt first, ForwardIt last, const T& val, Compare comp) {
+        return __lower_bound_dispatch(first, last, val, comp, 
+            typename iterator_traits<ForwardIt>::iterator_category());
+    }
+
+    template <class ForwardIt, class T>
+    ForwardIt lower_bound(ForwardIt first, ForwardIt last, const T& val) {
+        return lower_bound(first, last, val, __iter_less());
+    }
+
+    // upper_bound
+
+    template <class ForwardIt, class T, class Compare>
+    ForwardIt upper_bound(ForwardIt first, ForwardIt last, const T& val, Compare comp) {
+        return __upper_bound_dispatch(first, last, val, comp, 
+            typename iterator_traits<ForwardIt>::iterator_category());
+    }
+
+    template <class ForwardIt, class T>
+    ForwardIt upper_bound(ForwardIt first, ForwardIt last, const T& val) {
+        return upper_bound(first, last, val, __iter_less());
+    }
+
+    // equal_range
+
+    template <class ForwardIt, class T, class Compare>
+    pair<ForwardIt, ForwardIt> equal_range(ForwardIt first, ForwardIt last, const T& val, Compare comp) {
+        ForwardIt lo = lower_bound(first, last, val, comp);
+        return make_pair(lo, upper_bound(lo, last, val, comp));
+    }
+
+    template <class ForwardIt, class T>
+    pair<ForwardIt, ForwardIt> equal_range(ForwardIt first, ForwardIt last, const T& val) {
+        return equal_range(first, last, val, __iter_less());
+    }
+
+    // binary_search
+
+    template <class ForwardIt, class T, class Compare>
+    bool binary_search(ForwardIt first, ForwardIt last, const T& val, Compare comp) {
+        first = lower_bound(first, last, val, comp);
+        return first != last && !comp(val, *first);
+    }
+
+    template <class ForwardIt, class T>
+    bool binary_search(ForwardIt first, ForwardIt last, const T& val) {
+        return binary_search(first, last, val, __iter_less());
+    }
+
+    /**
+     * Merge
+     */
+
+    // merge
+
+    template <class InputIt1, class InputIt2, class OutputIterator, class Compare>
+    OutputIterator merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, 
+            InputIt2 last2, OutputIterator result, Compare comp) {
+        while (first1 != last1 && first2 != last2) {
+            // 相等时先取第一个区间的元素, 保持稳定
+            if (comp(*first2, *first1)) {
+                *result = *first2;
+                ++first2;
+            } else {
+                *result = *first1;
+                ++first1;
+            }
+            ++result;
+        }
+        return copy(first2, last2, copy(first1, last1, result));
+    }
+
+    template <class InputIt1, class InputIt2, class OutputIterator>
+    OutputIterator merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, 
+            InputIt2 last2, OutputIterator result) {
+        return merge(first1, last1, first2, last2, result, __iter_less());
+    }
+
+    // inplace_merge**
+
+    // 与 merge 相同, 但移动而不是复制元素
+    template <class InputIt1, class InputIt2, class OutputIterator, class Compare>
+    OutputIterator __move_merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, 
+            InputIt2 last2, OutputIterator result, Compare comp) {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first2, *first1)) {
+                *result = HxSTL::move(*first2);
+                ++first2;
+            } else {
+                *result = HxSTL::move(*first1);
+                ++first1;
+            }
+            ++result;
+        }
+        return HxSTL::move(first2, last2, HxSTL::move(first1, last1, result));
+    }
+
+    // 从后往前归并 [first1, last1) 与 [first2, last2), 结果的末尾是 result
+    // [first2, last2) 位于缓冲区, [first1, last1) 与结果共用同一段内存
+    template <class BidirIt1, class BidirIt2, class BidirIt3, class Compare>
+    void __move_merge_backward(BidirIt1 first1, BidirIt1 last1, BidirIt2 first2, 
+            BidirIt2 last2, BidirIt3 result, Compare comp) {
+        if (first2 == last2) {
+            return;
+        }
+        if (first1 == last1) {
+            HxSTL::move_backward(first2, last2, result);
+            return;
+        }
+        --last1;
+        --last2;
+        while (true) {
+            // 相等时先放第二个区间的元素, 保持稳定
+            if (comp(*last2, *last1)) {
+                *(--result) = HxSTL::move(*last1);
+                if (first1 == last1) {
+                    HxSTL::move_backward(first2, ++last2, result);
+                    return;
+                }
+                --last1;
+            } else {
+                *(--result) = HxSTL::move(*last2);
+                if (first2 == last2) {
+                    return;
+                }
+                --last2;
+            }
+        }
+    }
+
+    // 归并相邻的有序区间 [first, middle) 与 [middle, last)
+    // 较短一段放得进缓冲区时移出去再线性归并回来; 否则在较长一段的中点切开, 用二分找到另一段的切点,
+    // 旋转后两侧分别递归, 缓冲区为空时就是 O(nlogn) 的原地归并
+    template <class BidirIt, class Pointer, class Distance, class Compare>
+    void __merge_adaptive(BidirIt first, BidirIt middle, BidirIt last, Distance len1, 
+            Distance len2, Pointer buffer, Distance buffer_size, Compare comp) {
+        while (len1 != 0 && len2 != 0) {
+            if (len1 + len2 == 2) {
+                if (comp(*middle, *first)) {
+                    iter_swap(first, middle);
+                }
+                return;
+            }
+            if (len1 <= len2 && len1 <= buffer_size) {
+                Pointer buffer_end = HxSTL::move(first, middle, buffer);
+                __move_merge(buffer, buffer_end, middle, last, first, comp);
+                return;
+            }
+            if (len2 <= buffer_size) {
+                Pointer buffer_end = HxSTL::move(middle, last, buffer);
+                __move_merge_backward(first, middle, buffer, buffer_end, last, comp);
+                return;
+            }
+            BidirIt first_cut = first;
+            BidirIt second_cut = middle;
+            Distance len11 = 0;
+            Distance len22 = 0;
+            if (len1 > len2) {
+                len11 = len1 / 2;
+                advance(first_cut, len11);
+                second_cut = lower_bound(middle, last, *first_cut, comp);
+                len22 = static_cast<Distance>(distance(middle, second_cut));
+            } else {
+                len22 = len2 / 2;
+                advance(second_cut, len22);
+                first_cut = upper_bound(first, middle, *second_cut, comp);
+                len11 = static_cast<Distance>(distance(first, first_cut));
+            }
+            BidirIt new_middle = __rotate_adaptive(first_cut, middle, second_cut,
+                len1 - len11, len22, buffer, buffer_size);
+            // 较短的一侧递归, 较长的一侧循环, 递归深度为 O(logn)
+            if (len11 + len22 < len1 + len2 - len11 - len22) {
+                __merge_adaptive(first, first_cut, new_middle, len11, len22, buffer, buffer_size, comp);
+                first = new_middle;
+                middle = second_cut;
+                len1 = len1 - len11;
+                len2 = len2 - len22;
+            } else {
+                __merge_adaptive(new_middle, second_cut, last, len1 - len11, 
+                    len2 - len22, buffer, buffer_size, comp);
+                last = new_middle;
+                middle = first_cut;
+                len1 = len11;
+                len2 = len22;
+            }
+        }
+    }
+
+    template <class BidirIt, class Compare>
+    void inplace_merge(BidirIt first, BidirIt middle, BidirIt last, Compare comp) {
+        typedef typename iterator_traits<BidirIt>::value_type value_type;
+        typedef typename iterator_traits<BidirIt>::difference_type difference_type;
+        if (first == middle || middle == last) {
+            return;
+        }
+        difference_type len1 = distance(first, middle);
+        difference_type len2 = distance(middle, last);
+        __temporary_buffer<value_type> buf(first, len1 < len2 ? len1 : len2);
+        __merge_adaptive(first, middle, last, len1, len2, buf.begin(), 
+            static_cast<difference_type>(buf.size()), comp);
+    }
+
+    template <class BidirIt>
+    void inplace_merge(BidirIt first, BidirIt middle, BidirIt last) {
+        inplace_merge(first, middle, last, __iter_less());
+    }
+
+    // stable_sort**
+
+    // 仿照 timsort 的自适应归并排序
+    //   1. 从左到右切分自然有序段: 非降段原样保留, 严格下降段翻转 (严格才不会打乱相等元素);
+    //      短于 minrun 的段用插入排序补足到 minrun
+    //   2. 有序段压栈, 栈顶三段满足 A > B + C 且 B > C, 否则合并, 使得归并大致平衡
+    //   3. 合并前先裁掉 A 中不大于 B 首元素的前缀与 B 中不小于 A 末元素的后缀, 已有序的数据几乎不用移动
+    // 整个过程共用一块 n / 2 的缓冲区, 申请不到时退回原地归并
+    const int __stable_sort_min_merge = 32;
+
+    template <class Distance>
+    Distance __stable_sort_min_run(Distance n) {
+        // 取 n 的高 6 位, 低位非零则加一, 使 n / minrun 接近且不超过 2 的幂
+        Distance r = 0;
+        while (n >= 2 * __stable_sort_min_merge) {
+            r |= n & 1;
+            n >>= 1;
+        }
+        return n + r;
+    }
+
+    // [first, sorted) 已有序, 把 [sorted, last) 逐个插入
+    template <class RandomAccessIterator, class Compare>
+    void __stable_insertion_sort(RandomAccessIterator first, RandomAccessIterator sorted, 
+            RandomAccessIterator last, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+        for (; sorted != last; ++sorted) {
+            value_type val = HxSTL::move(*sorted);
+            RandomAccessIterator pos = upper_bound(first, sorted, val, comp);
+            HxSTL::move_backward(pos, sorted, sorted + 1);
+            *pos = HxSTL::move(val);
+        }
+    }
+
+    // 从 first 开始的自然有序段的长度, 下降段原地翻转
+    template <class RandomAccessIterator, class Compare>
+    typename iterator_traits<RandomAccessIterator>::difference_type
+    __count_run_and_make_ascending(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        RandomAccessIterator run_end = first + 1;
+        if (run_end == last) {
+            return 1;
+        }
+        if (comp(*run_end, *first)) {
+            ++run_end;
+            while (run_end != last && comp(*run_end, *(run_end - 1))) {
+                ++run_end;
+            }
+            reverse(first, run_end);
+        } else {
+            ++run_end;
+            while (run_end != last && !comp(*run_end, *(run_end - 1))) {
+                ++run_end;
+            }
+        }
+        return run_end - first;
+    }
+
+    template <class RandomAccessIterator, class Distance, class Pointer, class Compare>
+    void __stable_sort_merge_at(RandomAccessIterator first, Distance* run_base, Distance* run_len, 
+            int i, Pointer buffer, Distance buffer_size, Compare comp) {
+        RandomAccessIterator a = first + run_base[i];
+        RandomAccessIterator b = first + run_base[i + 1];
+        RandomAccessIterator b_end = b + run_len[i + 1];
+        run_len[i] += run_len[i + 1];
+        // A 中不大于 *b 的前缀已经在最终位置
+        a = upper_bound(a, b, *b, comp);
+        if (a == b) {
+            return;
+        }
+        // B 中不小于 *(b - 1) 的后缀也已经在最终位置
+        b_end = lower_bound(b, b_end, *(b - 1), comp);
+        __merge_adaptive(a, b, b_end, static_cast<Distance>(b - a), 
+            static_cast<Distance>(b_end - b), buffer, buffer_size, comp);
+    }
+
+    template <class RandomAccessIterator, class Pointer, class Distance, class Compare>
+    void __stable_sort_adaptive(RandomAccessIterator first, RandomAccessIterator last, 
+            Pointer buffer, Distance buffer_size, Compare comp) {
+        const Distance n = last - first;
+        const Distance min_run = __stable_sort_min_run(n);
+        // 段长至少按斐波那契数增长, 128 层足够任何 64 位长度
+        Distance run_base[128];
+        Distance run_len[128];
+        int stack_size = 0;
+        Distance lo = 0;
+        while (lo < n) {
+            Distance len = __count_run_and_make_ascending(first + lo, last, comp);
+            if (len < min_run) {
+                Distance force = n - lo < min_run ? n - lo : min_run;
+                __stable_insertion_sort(first + lo, first + lo + len, first + lo + force, comp);
+                len = force;
+            }
+            run_base[stack_size] = lo;
+            run_len[stack_size] = len;
+            ++stack_size;
+            lo += len;
+            while (stack_size > 1) {
+                int i = stack_size - 2;
+                if ((i > 0 && run_len[i - 1] <= run_len[i] + run_len[i + 1]) 
+                        || (i > 1 && run_len[i - 2] <= run_len[i - 1] + run_len[i])) {
+                    if (run_len[i - 1] < run_len[i + 1]) {
+                        --i;
+                    }
+                } else if (run_len[i] > run_len[i + 1]) {
+                    break;
+                }
+                __stable_sort_merge_at(first, run_base, run_len, i, buffer, buffer_size, comp);
+                for (int j = i + 1; j < stack_size - 1; ++j) {
+                    run_base[j] = run_base[j + 1];
+                    run_len[j] = run_len[j + 1];
+                }
+                --stack_size;
+            }
+        }
+        while (stack_size > 1) {
+            int i = stack_size - 2;
+            if (i > 0 && run_len[i - 1] < run_len[i + 1]) {
+                --i;
+            }
+            __stable_sort_merge_at(first, run_base, run_len, i, buffer, buffer_size, comp);
+            for (int j = i + 1; j < stack_size - 1; ++j) {
+                run_base[j] = run_base[j + 1];
+                run_len[j] = run_len[j + 1];
+            }
+            --stack_size;
+        }
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    void stable_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+        difference_type n = last - first;
+        if (n < 2) {
+            return;
+        }
+        if (n < 2 * __stable_sort_min_merge) {
+            __stable_insertion_sort(first, first + __count_run_and_make_ascending(first, last, comp), last, comp);
+            return;
+        }
+        __temporary_buffer<value_type> buf(first, (n + 1) / 2);
+        __stable_sort_adaptive(first, last, buf.begin(), static_cast<difference_type>(buf.size()), comp);
+    }
+
+    template <class RandomAccessIterator>
+    void stable_sort(RandomAccessIterator first, RandomAccessIterator last) {
+        stable_sort(first, last, __iter_less());
     }
 
     /**
@@ -1720,16 +3226,32 @@ namespace HxSTL {
     // min_element
 
     template <class ForwardIt>
-    ForwardIt min_element(ForwardIt first, ForwardIt last) {
+    ForwardIt __min_element(ForwardIt first, ForwardIt last, false_type) {
         ForwardIt result = first;
         while (first != last) {
             if (*first < *result) {
                 result = first;
             }
+            ++first;
         }
         return result;
     }
 
+    // 整数指针区间: 先向量化求出最小值, 再向量化查找它第一次出现的位置
+    template <class T>
+    T* __min_element(T* first, T* last, true_type) {
+        typedef typename remove_cv<T>::type element_type;
+        if (first == last) {
+            return last;
+        }
+        return first + (__simd_find<element_type>(first, last, __simd_min_value<element_type>(first, last)) - first);
+    }
+
+    template <class ForwardIt>
+    ForwardIt min_element(ForwardIt first, ForwardIt last) {
+        return __min_element(first, last, typename __simd_integral_dispatch<ForwardIt>::type());
+    }
+
     template <class ForwardIt, class Compare>
     ForwardIt min_element(ForwardIt first, ForwardIt last, Compare comp) {
         ForwardIt result = first;
@@ -1737,6 +3259,7 @@ namespace HxSTL {
             if (comp(*first, *result)) {
                 result = first;
             }
+            ++first;
         }
         return result;
     }
@@ -1744,16 +3267,31 @@ namespace HxSTL {
     // max_element
 
     template <class ForwardIt>
-    ForwardIt max_element(ForwardIt first, ForwardIt last) {
+    ForwardIt __max_element(ForwardIt first, ForwardIt last, false_type) {
         ForwardIt result = first;
         while (first != last) {
             if (*result < *first) {
                 result = first;
             }
+            ++first;
         }
         return result;
     }
 
+    template <class T>
+    T* __max_element(T* first, T* last, true_type) {
+        typedef typename remove_cv<T>::type element_type;
+        if (first == last) {
+            return last;
+        }
+        return first + (__simd_find<element_type>(first, last, __simd_max_value<element_type>(first, last)) - first);
+    }
+
+    template <class ForwardIt>
+    ForwardIt max_element(ForwardIt first, ForwardIt last) {
+        return __max_element(first, last, typename __simd_integral_dispatch<ForwardIt>::type());
+    }
+
     template <class ForwardIt, class Compare>
     ForwardIt max_element(ForwardIt first, ForwardIt last, Compare comp) {
         ForwardIt result = first;
@@ -1761,6 +3299,7 @@ namespace HxSTL {
             if (comp(*result, *first)) {
                 result = first;
             }
+            ++first;
         }
         return result;
     }
@@ -48,6 +48,80 @@ using __base_allocator = HxSTL::new_allocator<T>;
         allocator(const allocator<U>& alloc): __base_allocator<T>(alloc) {}
     };
 
+    // 分配器的可选扩展, 容器在编译期检测到后才会使用:
+    //   pointer reallocate(pointer p, size_type old_n, size_type new_n)
+    //       把 p 处容纳 old_n 个元素的存储扩展为 new_n 个, 可能原地扩展, 也可能按字节搬到新地址;
+    //       容器只对可平凡重定位的元素调用
+    //   pointer allocate_at_least(size_type& n)
+    //       至少分配 n 个元素, 并把 n 改为实际可用的元素个数
+    //   Alloc select_on_container_copy_construction() const
+    //       容器拷贝构造时用它的返回值代替分配器的拷贝, 缺省时直接拷贝
+
+    template <class Alloc, class = decltype(declval<Alloc&>().reallocate(
+        declval<typename Alloc::pointer>(), size_t(), size_t()))>
+    static __one __test_has_reallocate(int);
+
+    template <class Alloc>
+    static __two __test_has_reallocate(...);
+
+    template <class Alloc>
+    struct __has_reallocate:
+        public integeral_constant<bool,
+        sizeof(__test_has_reallocate<Alloc>(0)) == sizeof(__one)> {};
+
+    template <class Alloc, class = decltype(declval<Alloc&>().allocate_at_least(
+        declval<typename Alloc::size_type&>()))>
+    static __one __test_has_allocate_at_least(int);
+
+    template <class Alloc>
+    static __two __test_has_allocate_at_least(...);
+
+    template <class Alloc>
+    struct __has_allocate_at_least:
+        public integeral_constant<bool,
+        sizeof(__test_has_allocate_at_least<Alloc>(0)) == sizeof(__one)> {};
+
+    template <class Alloc>
+    inline typename Alloc::pointer __allocate_at_least(Alloc& alloc, typename Alloc::size_type& n, true_type) {
+        return alloc.allocate_at_least(n);
+    }
+
+    template <class Alloc>
+    inline typename Alloc::pointer __allocate_at_least(Alloc& alloc, typename Alloc::size_type& n, false_type) {
+        return alloc.allocate(n);
+    }
+
+    template <class Alloc>
+    inline typename Alloc::pointer allocate_at_least(Alloc& alloc, typename Alloc::size_type& n) {
+        return __allocate_at_least(alloc, n, typename __has_allocate_at_least<Alloc>::type());
+    }
+
+    template <class Alloc, class = decltype(declval<const Alloc&>().select_on_container_copy_construction())>
+    static __one __test_has_select_on_copy(int);
+
+    template <class Alloc>
+    static __two __test_has_select_on_copy(...);
+
+    template <class Alloc>
+    struct __has_select_on_copy:
+        public integeral_constant<bool,
+        sizeof(__test_has_select_on_copy<Alloc>(0)) == sizeof(__one)> {};
+
+    template <class Alloc>
+    inline Alloc __select_on_copy(const Alloc& alloc, true_type) {
+        return alloc.select_on_container_copy_construction();
+    }
+
+    template <class Alloc>
+    inline Alloc __select_on_copy(const Alloc& alloc, false_type) {
+        return alloc;
+    }
+
+    template <class Alloc>
+    inline Alloc select_on_container_copy_construction(const Alloc& alloc) {
+        return __select_on_copy(alloc, typename __has_select_on_copy<Alloc>::type());
+    }
+
     struct allocator_arg_t {};
 
     constexpr allocator_arg_t allocator_arg = allocator_arg_t();
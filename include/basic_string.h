@@ -3,13 +3,14 @@
 
 
 #include "allocator.h"
+#include "growth_policy.h"
 #include "uninitialized.h"
 #include "stdexcept.h"
 
 
 namespace HxSTL {
 
-    template <class CharT, class Alloc = allocator<CharT>>
+    template <class CharT, class Alloc = allocator<CharT>, class Growth = double_growth>
     class basic_string {
         enum { DEFAULT_SIZE = 15 };
     public:
@@ -53,8 +54,16 @@ namespace HxSTL {
         void replace_aux(iterator first, iterator last, size_type count, CharT ch, true_type);
         void resize_aux(size_type count, CharT ch);
         void destroy_and_reset(iterator new_start, iterator new_finish, iterator new_end_of_storage);
+        size_type next_capacity(size_type count) const;
+        iterator allocate_aux(size_type& cap);
+        // 分配器支持 reallocate 时, 末尾追加引起的扩容直接交给分配器
+        typedef typename HxSTL::__has_reallocate<Alloc>::type   __reallocatable;
+        bool can_reallocate() const { return __reallocatable::value && _start != nullptr; }
+        void reallocate_aux(size_type new_cap) { reallocate_aux(new_cap, __reallocatable()); }
+        void reallocate_aux(size_type new_cap, true_type);
+        void reallocate_aux(size_type, false_type) {}
         iterator REMOVE_CONST(const_iterator it) { return _start + (it - _start); }
-        const_iterator C_STR_END(const CharT* s) { while(*s) ++s; return s; }
+        const_iterator C_STR_END(const CharT* s) const { while(*s) ++s; return s; }
     public:
         explicit basic_string(const Alloc& alloc = Alloc()): _alloc(alloc) {
                 initialize_aux(0, 0, HxSTL::true_type());
@@ -104,7 +113,7 @@ namespace HxSTL {
         ~basic_string() {
             if (_start) {
                 HxSTL::destroy(_alloc, _start, _finish);
-                _alloc.deallocate(_start, capacity());
+                _alloc.deallocate(_start, capacity() + 1);
             }
         }
 
@@ -436,6 +445,14 @@ namespace HxSTL {
             resize_aux(count, ch);
         }
 
+        // 扩大时新字符不初始化, 留给调用者覆盖
+        void resize_default_init(size_type count);
+
+        // 大小先扩到 count, 调用 op(data(), count) 写入字符, 再截断为 op 的返回值
+        // 返回值不能超过 count
+        template <class Operation>
+        void resize_and_overwrite(size_type count, Operation op);
+
         void swap(basic_string& other) {
             HxSTL::swap(_start, other._start);
             HxSTL::swap(_finish, other._finish);
@@ -491,12 +508,15 @@ namespace HxSTL {
         size_type find_last_not_of(CharT ch, size_type pos = npos) const;
     };
 
-    template <class CharT, class Alloc>
-    void basic_string<CharT, Alloc>::destroy_and_reset(iterator new_start, 
+    template <class CharT, class Growth>
+    struct is_trivially_relocatable<basic_string<CharT, allocator<CharT>, Growth>>: public true_type {};
+
+    template <class CharT, class Alloc, class Growth>
+    void basic_string<CharT, Alloc, Growth>::destroy_and_reset(iterator new_start, 
             iterator new_finish, iterator new_end_of_storage) {
         if (_start) {
             HxSTL::destroy(_alloc, _start, _finish);
-            _alloc.deallocate(_start, capacity());
+            _alloc.deallocate(_start, capacity() + 1);
         }
         _start = new_start;
         _finish = new_finish;
@@ -504,9 +524,9 @@ namespace HxSTL {
         *_finish = 0;
     }
 
-    template <class CharT, class Alloc>
+    template <class CharT, class Alloc, class Growth>
     template <class InputIt>
-    void basic_string<CharT, Alloc>::initialize_aux(InputIt first, InputIt last, false_type) {
+    void basic_string<CharT, Alloc, Growth>::initialize_aux(InputIt first, InputIt last, false_type) {
         size_type count = HxSTL::distance(first, last);
         if (count < DEFAULT_SIZE) count = DEFAULT_SIZE;
         _start = _alloc.allocate(count + 1);
@@ -515,8 +535,8 @@ namespace HxSTL {
         _end_of_storage = _start + count;
     }
 
-    template <class CharT, class Alloc>
-    void basic_string<CharT, Alloc>::initialize_aux(const_iterator first, size_type count) {
+    template <class CharT, class Alloc, class Growth>
+    void basic_string<CharT, Alloc, Growth>::initialize_aux(const_iterator first, size_type count) {
         size_type sz = count > DEFAULT_SIZE ? count : DEFAULT_SIZE;
         _start = _alloc.allocate(sz + 1);
         _finish = HxSTL::uninitialized_copy_n(first, count, _start);
@@ -524,8 +544,8 @@ namespace HxSTL {
         _end_of_storage = _start + sz;
     }
  
-    template <class CharT, class Alloc>
-    void basic_string<CharT, Alloc>::initialize_aux(size_type count, CharT ch, true_type) {
+    template <class CharT, class Alloc, class Growth>
+    void basic_string<CharT, Alloc, Growth>::initialize_aux(size_type count, CharT ch, true_type) {
         size_type sz = count > DEFAULT_SIZE ? count : DEFAULT_SIZE;
         _start = _alloc.allocate(sz + 1);
         _finish = HxSTL::uninitialized_fill_n(_start, count, ch);
@@ -533,15 +553,15 @@ namespace HxSTL {
         _end_of_storage = _start + sz;
     }
 
-    template <class CharT, class Alloc>
+    template <class CharT, class Alloc, class Growth>
     template <class InputIt>
-    void basic_string<CharT, Alloc>::assign_aux(InputIt first, InputIt last, false_type) {
+    void basic_string<CharT, Alloc, Growth>::assign_aux(InputIt first, InputIt last, false_type) {
         size_type count = HxSTL::distance(first, last);
         size_type cap = capacity();
         if (count > cap) {
             // 保留空间不足
-            size_type new_sz = count > 2 * cap ? count : 2 * cap;
-            iterator new_start = _alloc.allocate(new_sz + 1);
+            size_type new_sz = next_capacity(count);
+            iterator new_start = allocate_aux(new_sz);
             iterator new_finish = HxSTL::uninitialized_copy(first, last, new_start);
             destroy_and_reset(new_start, new_finish, new_start + new_sz);
         } else if (count <= size()) {
@@ -560,13 +580,13 @@ namespace HxSTL {
         }
     }
 
-    template <class CharT, class Alloc>
-    void basic_string<CharT, Alloc>::assign_aux(size_type count, CharT ch, true_type) {
+    template <class CharT, class Alloc, class Growth>
+    void basic_string<CharT, Alloc, Growth>::assign_aux(size_type count, CharT ch, true_type) {
         size_type cap = capacity();
         if (count > cap) {
             // 保留空间不足
-            size_type new_sz = count > 2 * cap ? count : 2 * cap;
-            iterator new_start = _alloc.allocate(new_sz + 1);
+            size_type new_sz = next_capacity(count);
+            iterator new_start = allocate_aux(new_sz);
             iterator new_finish = HxSTL::uninitialized_fill_n(new_start, count, ch);
             destroy_and_reset(new_start, new_finish, new_start + new_sz);
         } else if (count <= size()) {
@@ -584,10 +604,10 @@ namespace HxSTL {
         }
     }
 
-    template <class CharT, class Alloc>
+    template <class CharT, class Alloc, class Growth>
     template <class InputIt>
-    typename basic_string<CharT, Alloc>::iterator
-    basic_string<CharT, Alloc>::insert_aux(iterator pos, InputIt first, InputIt last, false_type) {
+    typename basic_string<CharT, Alloc, Growth>::iterator
+    basic_string<CharT, Alloc, Growth>::insert_aux(iterator pos, InputIt first, InputIt last, false_type) {
         if (first == last) return pos;
 
         size_type index = pos - _start;
@@ -596,8 +616,8 @@ namespace HxSTL {
         size_type sz = size();
         if (count > cap - sz) {
             // 保留空间不足
-            size_type new_sz = 2 * cap > sz + count ? 2 * cap : sz + count;
-            iterator new_start = _alloc.allocate(new_sz + 1);
+            size_type new_sz = next_capacity(sz + count);
+            iterator new_start = allocate_aux(new_sz);
             iterator new_finish = HxSTL::uninitialized_copy(_start, pos, new_start);
             new_finish = HxSTL::uninitialized_copy(first, last, new_finish);
             new_finish = HxSTL::uninitialized_copy(pos, _finish, new_finish);
@@ -622,9 +642,9 @@ namespace HxSTL {
         return _start + index;
     }
 
-    template <class CharT, class Alloc>
-    typename basic_string<CharT, Alloc>::iterator
-    basic_string<CharT, Alloc>::insert_aux(iterator pos, size_type count, CharT ch, true_type) {
+    template <class CharT, class Alloc, class Growth>
+    typename basic_string<CharT, Alloc, Growth>::iterator
+    basic_string<CharT, Alloc, Growth>::insert_aux(iterator pos, size_type count, CharT ch, true_type) {
         if (count == 0) return pos;
 
         size_type index = pos - _start;
@@ -632,8 +652,8 @@ namespace HxSTL {
         size_type sz = size();
         if (count > cap - sz) {
             // 保留空间不足
-            size_type new_sz = 2 * cap > sz + count ? 2 * cap : sz + count;
-            iterator new_start = _alloc.allocate(new_sz + 1);
+            size_type new_sz = next_capacity(sz + count);
+            iterator new_start = allocate_aux(new_sz);
             iterator new_finish = HxSTL::uninitialized_copy(_start, pos, new_start);
             new_finish = HxSTL::uninitialized_fill_n(new_finish, count, ch);
             new_finish = HxSTL::uninitialized_copy(pos, _finish, new_finish);
@@ -657,23 +677,27 @@ namespace HxSTL {
         return _start + index;
     }
 
-    template <class CharT, class Alloc>
-    typename basic_string<CharT, Alloc>::iterator
-    basic_string<CharT, Alloc>::erase_aux(iterator first, iterator last) {
+    template <class CharT, class Alloc, class Growth>
+    typename basic_string<CharT, Alloc, Growth>::iterator
+    basic_string<CharT, Alloc, Growth>::erase_aux(iterator first, iterator last) {
         iterator old_finish = _finish;
         _finish = HxSTL::copy(last, _finish, first);
         HxSTL::destroy(_alloc, _finish, old_finish);
         return first;
     }
 
-    template <class CharT, class Alloc>
-    void basic_string<CharT, Alloc>::append_aux(size_type count, CharT ch, true_type) {
+    template <class CharT, class Alloc, class Growth>
+    void basic_string<CharT, Alloc, Growth>::append_aux(size_type count, CharT ch, true_type) {
         size_type cap = capacity();
         size_type sz = size();
-        if (count > cap - sz) {
+        if (count > cap - sz && can_reallocate()) {
+            reallocate_aux(next_capacity(sz + count));
+            _finish = HxSTL::uninitialized_fill_n(_finish, count, ch);
+            *_finish = 0;
+        } else if (count > cap - sz) {
             // 保留空间不足
-            size_type new_sz = 2 * cap > sz + count ? 2 * cap : sz + count;
-            iterator new_start = _alloc.allocate(new_sz + 1);
+            size_type new_sz = next_capacity(sz + count);
+            iterator new_start = allocate_aux(new_sz);
             iterator new_finish = HxSTL::uninitialized_copy(_start, _finish, new_start);
             new_finish = HxSTL::uninitialized_fill_n(new_finish, count, ch);
             destroy_and_reset(new_start, new_finish, new_start + new_sz);
@@ -684,16 +708,21 @@ namespace HxSTL {
         }
     }
 
-    template <class CharT, class Alloc>
+    template <class CharT, class Alloc, class Growth>
     template <class InputIt>
-    void basic_string<CharT, Alloc>::append_aux(InputIt first, InputIt last, false_type) {
+    void basic_string<CharT, Alloc, Growth>::append_aux(InputIt first, InputIt last, false_type) {
         size_type count = HxSTL::distance(first, last);
         size_type cap = capacity();
         size_type sz = size();
-        if (count > cap - sz) {
+        if (count > cap - sz && can_reallocate() && !HxSTL::__points_into(first, _start, _end_of_storage)) {
+            // 来源不在自身存储中, 原地扩容
+            reallocate_aux(next_capacity(sz + count));
+            _finish = HxSTL::uninitialized_copy(first, last, _finish);
+            *_finish = 0;
+        } else if (count > cap - sz) {
             // 保留空间不足
-            size_type new_sz = 2 * cap > sz + count ? 2 * cap : sz + count;
-            iterator new_start = _alloc.allocate(new_sz + 1);
+            size_type new_sz = next_capacity(sz + count);
+            iterator new_start = allocate_aux(new_sz);
             iterator new_finish = HxSTL::uninitialized_copy(_start, _finish, new_start);
             new_finish = HxSTL::uninitialized_copy(first, last, new_finish);
             destroy_and_reset(new_start, new_finish, new_start + new_sz);
@@ -704,8 +733,8 @@ namespace HxSTL {
         }
     }
 
-    template <class CharT, class Alloc>
-    int basic_string<CharT, Alloc>::compare_aux(const_iterator first1, const_iterator last1, 
+    template <class CharT, class Alloc, class Growth>
+    int basic_string<CharT, Alloc, Growth>::compare_aux(const_iterator first1, const_iterator last1, 
             const_iterator first2, const_iterator last2) const {
         while (first1 != last1 && first2 != last2) {
             if (*first1 != *first2) {
@@ -717,9 +746,9 @@ namespace HxSTL {
         return first1 == last1 ? first2 - last2 : last1 - first1;
     }
 
-    template <class CharT, class Alloc>
+    template <class CharT, class Alloc, class Growth>
     template <class InputIt>
-    void basic_string<CharT, Alloc>::replace_aux(iterator first1, iterator last1, 
+    void basic_string<CharT, Alloc, Growth>::replace_aux(iterator first1, iterator last1, 
             InputIt first2, InputIt last2, false_type) {
         size_type count1 = last1 - first1;
         size_type count2 = HxSTL::distance(first2, last2);
@@ -734,8 +763,8 @@ namespace HxSTL {
             size_type cap = capacity();
             if (count > cap) {
                 // 保留空间不足
-                size_type new_sz = 2 * cap > count ? 2 * cap : count;
-                iterator new_start = _alloc.allocate(new_sz + 1);
+                size_type new_sz = next_capacity(count);
+                iterator new_start = allocate_aux(new_sz);
                 iterator new_finish = HxSTL::uninitialized_copy(_start, first1, new_start);
                 new_finish = HxSTL::uninitialized_copy(first2, last2, new_finish);
                 new_finish = HxSTL::uninitialized_copy(last1, _finish, new_finish);
@@ -760,8 +789,8 @@ namespace HxSTL {
         }
     }
 
-    template <class CharT, class Alloc>
-    void basic_string<CharT, Alloc>::replace_aux(iterator first, iterator last, size_type count, CharT ch, true_type) {
+    template <class CharT, class Alloc, class Growth>
+    void basic_string<CharT, Alloc, Growth>::replace_aux(iterator first, iterator last, size_type count, CharT ch, true_type) {
         if (count <= last - first) {
             // 替换元素不大于待替换元素
             HxSTL::fill_n(first, count, ch);
@@ -772,9 +801,9 @@ namespace HxSTL {
             size_type cap = capacity();
             if (count > cap) {
                 // 保留空间不足
-                size_type new_sz = 2 * cap > count ? 2 * cap : count;
+                size_type new_sz = next_capacity(count);
                 if (new_sz < DEFAULT_SIZE) new_sz = DEFAULT_SIZE;
-                iterator new_start = _alloc.allocate(new_sz + 1);
+                iterator new_start = allocate_aux(new_sz);
                 iterator new_finish = HxSTL::uninitialized_copy(_start, first, new_start);
                 new_finish = HxSTL::uninitialized_fill_n(new_finish, count, ch);
                 new_finish = HxSTL::uninitialized_copy(last, _finish, new_finish);
@@ -798,39 +827,80 @@ namespace HxSTL {
         }
     }
 
-    template <class CharT, class Alloc>
-    void basic_string<CharT, Alloc>::resize_aux(size_type count, CharT ch) {
-        if (count <= size()) {
-            reserve();
-        } else {
-            if (count < DEFAULT_SIZE) count = DEFAULT_SIZE;
-            iterator new_start = _alloc.allocate(count + 1);
-            iterator new_finish = HxSTL::uninitialized_copy(_start, _finish, new_start);
-            new_finish = HxSTL::uninitialized_fill_n(new_finish, count - size(), ch);
-            destroy_and_reset(new_start, new_finish, new_start + count);
-        }
+    template <class CharT, class Alloc, class Growth>
+    void basic_string<CharT, Alloc, Growth>::resize_aux(size_type count, CharT ch) {
+        size_type sz = size();
+        resize_default_init(count);
+        if (count > sz) HxSTL::fill_n(_start + sz, count - sz, ch);
     }
 
-    template <class CharT, class Alloc>
-    void basic_string<CharT, Alloc>::reserve(size_type new_cap) {
+    template <class CharT, class Alloc, class Growth>
+    void basic_string<CharT, Alloc, Growth>::resize_default_init(size_type count) {
+        if (count > capacity()) reserve(count);
+        _finish = _start + count;
+        *_finish = 0;
+    }
+
+    template <class CharT, class Alloc, class Growth>
+    template <class Operation>
+    void basic_string<CharT, Alloc, Growth>::resize_and_overwrite(size_type count, Operation op) {
+        resize_default_init(count);
+        size_type n = op(_start, count);
+        if (n > count) throw HxSTL::length_error();
+        _finish = _start + n;
+        *_finish = 0;
+    }
+
+    template <class CharT, class Alloc, class Growth>
+    void basic_string<CharT, Alloc, Growth>::reserve(size_type new_cap) {
         if (new_cap > max_size()) throw HxSTL::length_error();
 
         size_type cap = capacity();
         if (new_cap > cap) {
-            if (new_cap < 2 * cap) new_cap = 2 * cap;
+            new_cap = next_capacity(new_cap);
+            if (can_reallocate()) {
+                reallocate_aux(new_cap);
+                return;
+            }
         } else { 
             if (new_cap <= size()) new_cap = size();
             if (new_cap < DEFAULT_SIZE) new_cap = DEFAULT_SIZE;
         }
 
-        iterator new_start = _alloc.allocate(new_cap + 1);
+        iterator new_start = allocate_aux(new_cap);
         iterator new_finish = HxSTL::uninitialized_copy(_start, _finish, new_start);
         destroy_and_reset(new_start, new_finish, new_start + new_cap);
     }
 
-    template <class CharT, class Alloc>
-    typename basic_string<CharT, Alloc>::size_type 
-    basic_string<CharT, Alloc>::copy(CharT* dest, size_type count, size_type pos) const {
+    template <class CharT, class Alloc, class Growth>
+    typename basic_string<CharT, Alloc, Growth>::size_type 
+    basic_string<CharT, Alloc, Growth>::next_capacity(size_type count) const {
+        if (count > max_size()) throw HxSTL::length_error();
+        size_type new_cap = Growth::next(capacity(), count, sizeof(CharT));
+        return new_cap > max_size() ? max_size() : new_cap;
+    }
+
+    template <class CharT, class Alloc, class Growth>
+    typename basic_string<CharT, Alloc, Growth>::iterator 
+    basic_string<CharT, Alloc, Growth>::allocate_aux(size_type& cap) {
+        // 末尾多留一个位置放结束符
+        size_type n = cap + 1;
+        iterator p = HxSTL::allocate_at_least(_alloc, n);
+        cap = n - 1;
+        return p;
+    }
+
+    template <class CharT, class Alloc, class Growth>
+    void basic_string<CharT, Alloc, Growth>::reallocate_aux(size_type new_cap, true_type) {
+        size_type sz = size();
+        _start = _alloc.reallocate(_start, capacity() + 1, new_cap + 1);
+        _finish = _start + sz;
+        _end_of_storage = _start + new_cap;
+    }
+
+    template <class CharT, class Alloc, class Growth>
+    typename basic_string<CharT, Alloc, Growth>::size_type 
+    basic_string<CharT, Alloc, Growth>::copy(CharT* dest, size_type count, size_type pos) const {
         if (size() - pos < count) {
             HxSTL::copy(_start + pos, _finish, dest);
             return size() - pos;
@@ -840,32 +910,32 @@ namespace HxSTL {
         }
     }
 
-    template <class CharT, class Alloc>
-    bool operator==(const basic_string<CharT, Alloc>& lhs, const basic_string<CharT, Alloc>& rhs) {
+    template <class CharT, class Alloc, class Growth>
+    bool operator==(const basic_string<CharT, Alloc, Growth>& lhs, const basic_string<CharT, Alloc, Growth>& rhs) {
         return lhs.compare(rhs) == 0;
     }
 
-    template <class CharT, class Alloc>
-    bool operator!=(const basic_string<CharT, Alloc>& lhs, const basic_string<CharT, Alloc>& rhs) {
+    template <class CharT, class Alloc, class Growth>
+    bool operator!=(const basic_string<CharT, Alloc, Growth>& lhs, const basic_string<CharT, Alloc, Growth>& rhs) {
         return !(lhs == rhs);
     }
 
-    template <class CharT, class Alloc>
-    bool operator< (const basic_string<CharT, Alloc>& lhs, const basic_string<CharT, Alloc>& rhs) {
+    template <class CharT, class Alloc, class Growth>
+    bool operator< (const basic_string<CharT, Alloc, Growth>& lhs, const basic_string<CharT, Alloc, Growth>& rhs) {
         return lhs.compare(rhs) < 0;
     }
 
-    template <class CharT, class Alloc>
-    bool operator<=(const basic_string<CharT, Alloc>& lhs, const basic_string<CharT, Alloc>& rhs) {
+    template <class CharT, class Alloc, class Growth>
+    bool operator<=(const basic_string<CharT, Alloc, Growth>& lhs, const basic_string<CharT, Alloc, Growth>& rhs) {
         return !(rhs < lhs);
     }
-    template <class CharT, class Alloc>
-    bool operator> (const basic_string<CharT, Alloc>& lhs, const basic_string<CharT, Alloc>& rhs) {
+    template <class CharT, class Alloc, class Growth>
+    bool operator> (const basic_string<CharT, Alloc, Growth>& lhs, const basic_string<CharT, Alloc, Growth>& rhs) {
         return rhs < lhs;
     }
 
-    template <class CharT, class Alloc>
-    bool operator>=(const basic_string<CharT, Alloc>& lhs, const basic_string<CharT, Alloc>& rhs) {
+    template <class CharT, class Alloc, class Growth>
+    bool operator>=(const basic_string<CharT, Alloc, Growth>& lhs, const basic_string<CharT, Alloc, Growth>& rhs) {
         return !(lhs < rhs);
     }
 
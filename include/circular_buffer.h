@@ -0,0 +1,421 @@
+#ifndef _CIRCULAR_BUFFER_H_
+#define _CIRCULAR_BUFFER_H_
+
+
+#include "allocator.h"
+#include "uninitialized.h"
+#include "utility.h"
+
+
+namespace HxSTL {
+
+    // 缓冲区已满时 push 的处理方式
+    enum overflow_policy {
+        overflow_throw,     // 抛出 length_error
+        overflow_overwrite  // 覆盖另一端最旧的元素, 适合只保留最近数据的遥测缓冲
+    };
+
+    // 迭代器保存不回绕的逻辑位置, 解引用时才与掩码相与, 比较和相减都是整数运算
+    template <class T, class Ref, class Ptr>
+    class circular_buffer_iterator {
+    public:
+        typedef random_access_iterator_tag          iterator_category;
+        typedef T                                   value_type;
+        typedef Ptr                                 pointer;
+        typedef Ref                                 reference;
+        typedef size_t                              size_type;
+        typedef ptrdiff_t                           difference_type;
+    public:
+        T* _buf;
+        size_type _mask;
+        size_type _pos;
+    public:
+        circular_buffer_iterator() noexcept: _buf(nullptr), _mask(0), _pos(0) {}
+
+        circular_buffer_iterator(T* buf, size_type mask, size_type pos) noexcept
+            : _buf(buf), _mask(mask), _pos(pos) {}
+
+        circular_buffer_iterator(const circular_buffer_iterator<T, T&, T*>& other) noexcept
+            : _buf(other._buf), _mask(other._mask), _pos(other._pos) {}
+
+        reference operator*() const noexcept { return _buf[_pos & _mask]; }
+
+        pointer operator->() const noexcept { return _buf + (_pos & _mask); }
+
+        reference operator[](difference_type n) const noexcept { return _buf[(_pos + n) & _mask]; }
+
+        circular_buffer_iterator& operator++() noexcept { ++_pos; return *this; }
+
+        circular_buffer_iterator operator++(int) noexcept {
+            circular_buffer_iterator it = *this;
+            ++_pos;
+            return it;
+        }
+
+        circular_buffer_iterator& operator--() noexcept { --_pos; return *this; }
+
+        circular_buffer_iterator operator--(int) noexcept {
+            circular_buffer_iterator it = *this;
+            --_pos;
+            return it;
+        }
+
+        circular_buffer_iterator& operator+=(difference_type n) noexcept { _pos += n; return *this; }
+
+        circular_buffer_iterator operator+(difference_type n) const noexcept {
+            circular_buffer_iterator it = *this;
+            return it += n;
+        }
+
+        circular_buffer_iterator& operator-=(difference_type n) noexcept { _pos -= n; return *this; }
+
+        circular_buffer_iterator operator-(difference_type n) const noexcept {
+            circular_buffer_iterator it = *this;
+            return it -= n;
+        }
+    };
+
+    template <class T, class RefL, class PtrL, class RefR, class PtrR>
+    inline typename circular_buffer_iterator<T, RefL, PtrL>::difference_type
+    operator- (const circular_buffer_iterator<T, RefL, PtrL>& x, const circular_buffer_iterator<T, RefR, PtrR>& y) noexcept {
+        return static_cast<ptrdiff_t>(x._pos - y._pos);
+    }
+
+    template <class T, class RefL, class PtrL, class RefR, class PtrR>
+    inline bool operator==(const circular_buffer_iterator<T, RefL, PtrL>& x, const circular_buffer_iterator<T, RefR, PtrR>& y) noexcept {
+        return x._pos == y._pos;
+    }
+
+    template <class T, class RefL, class PtrL, class RefR, class PtrR>
+    inline bool operator!=(const circular_buffer_iterator<T, RefL, PtrL>& x, const circular_buffer_iterator<T, RefR, PtrR>& y) noexcept {
+        return x._pos != y._pos;
+    }
+
+    template <class T, class RefL, class PtrL, class RefR, class PtrR>
+    inline bool operator< (const circular_buffer_iterator<T, RefL, PtrL>& x, const circular_buffer_iterator<T, RefR, PtrR>& y) noexcept {
+        return x - y < 0;
+    }
+
+    template <class T, class RefL, class PtrL, class RefR, class PtrR>
+    inline bool operator> (const circular_buffer_iterator<T, RefL, PtrL>& x, const circular_buffer_iterator<T, RefR, PtrR>& y) noexcept {
+        return y < x;
+    }
+
+    template <class T, class RefL, class PtrL, class RefR, class PtrR>
+    inline bool operator<=(const circular_buffer_iterator<T, RefL, PtrL>& x, const circular_buffer_iterator<T, RefR, PtrR>& y) noexcept {
+        return !(y < x);
+    }
+
+    template <class T, class RefL, class PtrL, class RefR, class PtrR>
+    inline bool operator>=(const circular_buffer_iterator<T, RefL, PtrL>& x, const circular_buffer_iterator<T, RefR, PtrR>& y) noexcept {
+        return !(x < y);
+    }
+
+    // 定长环形缓冲区: 容量向上取整为 2 的幂, 下标用掩码回绕, 元素连续存放在一块内存中
+    // 首尾的 push / pop 都是 O(1) 且不分配内存, 可以作为 quque / stack 的 Container
+    // _head 与 _tail 是不回绕的计数器, _tail - _head 即元素个数
+    //
+    // 用法: HxSTL::quque<int, HxSTL::circular_buffer<int>> q(HxSTL::circular_buffer<int>(1024));
+    template <class T, class Alloc = allocator<T>>
+    class circular_buffer {
+    public:
+        typedef T                                                       value_type;
+        typedef Alloc                                                   allocator_type;
+        typedef value_type&                                             reference;
+        typedef const value_type&                                       const_reference;
+        typedef value_type*                                             pointer;
+        typedef const value_type*                                       const_pointer;
+        typedef circular_buffer_iterator<T, T&, T*>                     iterator;
+        typedef circular_buffer_iterator<T, const T&, const T*>         const_iterator;
+        typedef HxSTL::reverse_iterator<iterator>                       reverse_iterator;
+        typedef HxSTL::reverse_iterator<const_iterator>                 const_reverse_iterator;
+        typedef ptrdiff_t                                               difference_type;
+        typedef size_t                                                  size_type;
+    protected:
+        pointer _buf;
+        size_type _capacity;
+        size_type _head;
+        size_type _tail;
+        overflow_policy _policy;
+        allocator_type _alloc;
+    protected:
+        static size_type round_up_capacity(size_type n);
+        size_type mask() const { return _capacity - 1; }
+        pointer slot(size_type pos) const { return _buf + (pos & mask()); }
+        void initialize_aux(size_type capacity);
+        template <class InputIt>
+        void copy_aux(InputIt first, InputIt last);
+        void steal_aux(circular_buffer& other);
+        void destroy_aux();
+        void relocate_aux(size_type new_capacity);
+    public:
+        explicit circular_buffer(const Alloc& alloc = Alloc())
+            : _buf(nullptr), _capacity(0), _head(0), _tail(0), _policy(overflow_throw), _alloc(alloc) {}
+
+        explicit circular_buffer(size_type capacity, overflow_policy policy = overflow_throw, const Alloc& alloc = Alloc())
+            : _policy(policy), _alloc(alloc) { initialize_aux(capacity); }
+
+        circular_buffer(HxSTL::initializer_list<T> init, overflow_policy policy = overflow_throw, const Alloc& alloc = Alloc())
+            : _policy(policy), _alloc(alloc) {
+                initialize_aux(init.size());
+                copy_aux(init.begin(), init.end());
+            }
+
+        circular_buffer(const circular_buffer& other): _policy(other._policy), _alloc(other._alloc) {
+            initialize_aux(other._capacity);
+            copy_aux(other.begin(), other.end());
+        }
+
+        circular_buffer(circular_buffer&& other): _alloc(HxSTL::move(other._alloc)) { steal_aux(other); }
+
+        ~circular_buffer() { destroy_aux(); }
+
+        circular_buffer& operator=(const circular_buffer& other) {
+            if (this != &other) {
+                circular_buffer(other).swap(*this);
+            }
+            return *this;
+        }
+
+        circular_buffer& operator=(circular_buffer&& other) {
+            if (this != &other) {
+                destroy_aux();
+                _alloc = HxSTL::move(other._alloc);
+                steal_aux(other);
+            }
+            return *this;
+        }
+
+        allocator_type get_allocator() const { return _alloc; }
+
+        overflow_policy policy() const { return _policy; }
+
+        reference at(size_type pos) {
+            if (pos >= size()) {
+                throw HxSTL::out_of_range();
+            }
+            return operator[](pos);
+        }
+
+        const_reference at(size_type pos) const {
+            if (pos >= size()) {
+                throw HxSTL::out_of_range();
+            }
+            return operator[](pos);
+        }
+
+        reference operator[](size_type pos) { return *slot(_head + pos); }
+
+        const_reference operator[](size_type pos) const { return *slot(_head + pos); }
+
+        reference front() { return *slot(_head); }
+
+        const_reference front() const { return *slot(_head); }
+
+        reference back() { return *slot(_tail - 1); }
+
+        const_reference back() const { return *slot(_tail - 1); }
+
+        iterator begin() noexcept { return iterator(_buf, mask(), _head); }
+
+        const_iterator begin() const noexcept { return const_iterator(_buf, mask(), _head); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        iterator end() noexcept { return iterator(_buf, mask(), _tail); }
+
+        const_iterator end() const noexcept { return const_iterator(_buf, mask(), _tail); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+        bool empty() const { return _head == _tail; }
+
+        bool full() const { return size() == _capacity; }
+
+        size_type size() const { return _tail - _head; }
+
+        size_type capacity() const { return _capacity; }
+
+        size_type max_size() const { return _alloc.max_size(); }
+
+        // 只扩大容量, 元素按原顺序搬到新缓冲区的开头
+        void reserve(size_type new_cap) {
+            if (new_cap > _capacity) relocate_aux(round_up_capacity(new_cap));
+        }
+
+        void clear() {
+            while (!empty()) pop_front();
+            _head = _tail = 0;
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+
+        void push_back(T&& value) { emplace_back(HxSTL::move(value)); }
+
+        template <class... Args>
+        void emplace_back(Args&&... args);
+
+        void pop_back() { _alloc.destroy(slot(--_tail)); }
+
+        void push_front(const T& value) { emplace_front(value); }
+
+        void push_front(T&& value) { emplace_front(HxSTL::move(value)); }
+
+        template <class... Args>
+        void emplace_front(Args&&... args);
+
+        void pop_front() { _alloc.destroy(slot(_head++)); }
+
+        void swap(circular_buffer& other) {
+            HxSTL::swap(_buf, other._buf);
+            HxSTL::swap(_capacity, other._capacity);
+            HxSTL::swap(_head, other._head);
+            HxSTL::swap(_tail, other._tail);
+            HxSTL::swap(_policy, other._policy);
+            HxSTL::swap(_alloc, other._alloc);
+        }
+    };
+
+    template <class T>
+    struct is_trivially_relocatable<circular_buffer<T, allocator<T>>>: public true_type {};
+
+    template <class T, class Alloc>
+    typename circular_buffer<T, Alloc>::size_type
+    circular_buffer<T, Alloc>::round_up_capacity(size_type n) {
+        size_type cap = 1;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    template <class T, class Alloc>
+    void circular_buffer<T, Alloc>::initialize_aux(size_type capacity) {
+        _capacity = capacity == 0 ? 0 : round_up_capacity(capacity);
+        _buf = _capacity == 0 ? nullptr : _alloc.allocate(_capacity);
+        _head = _tail = 0;
+    }
+
+    template <class T, class Alloc>
+    template <class InputIt>
+    void circular_buffer<T, Alloc>::copy_aux(InputIt first, InputIt last) {
+        for (; first != last; ++first, ++_tail) {
+            _alloc.construct(slot(_tail), *first);
+        }
+    }
+
+    template <class T, class Alloc>
+    void circular_buffer<T, Alloc>::steal_aux(circular_buffer& other) {
+        _buf = other._buf;
+        _capacity = other._capacity;
+        _head = other._head;
+        _tail = other._tail;
+        _policy = other._policy;
+        other._buf = nullptr;
+        other._capacity = other._head = other._tail = 0;
+    }
+
+    template <class T, class Alloc>
+    void circular_buffer<T, Alloc>::destroy_aux() {
+        if (_buf) {
+            clear();
+            _alloc.deallocate(_buf, _capacity);
+        }
+    }
+
+    template <class T, class Alloc>
+    void circular_buffer<T, Alloc>::relocate_aux(size_type new_capacity) {
+        pointer new_buf = _alloc.allocate(new_capacity);
+        size_type sz = size();
+
+        // 元素在旧缓冲区中最多分成两段连续区间
+        if (sz != 0) {
+            pointer first = slot(_head);
+            pointer last = slot(_tail - 1) + 1;
+            pointer result = new_buf;
+            if (first < last) {
+                HxSTL::uninitialized_relocate(first, last, result);
+                if (!HxSTL::is_trivially_relocatable<T>::value) HxSTL::destroy(_alloc, first, last);
+            } else {
+                result = HxSTL::uninitialized_relocate(first, _buf + _capacity, result);
+                HxSTL::uninitialized_relocate(_buf, last, result);
+                if (!HxSTL::is_trivially_relocatable<T>::value) {
+                    HxSTL::destroy(_alloc, first, _buf + _capacity);
+                    HxSTL::destroy(_alloc, _buf, last);
+                }
+            }
+        }
+        if (_buf) _alloc.deallocate(_buf, _capacity);
+
+        _buf = new_buf;
+        _capacity = new_capacity;
+        _head = 0;
+        _tail = sz;
+    }
+
+    template <class T, class Alloc>
+    template <class... Args>
+    void circular_buffer<T, Alloc>::emplace_back(Args&&... args) {
+        if (!full()) {
+            _alloc.construct(slot(_tail), HxSTL::forward<Args>(args)...);
+            ++_tail;
+        } else if (_policy == overflow_overwrite && _capacity != 0) {
+            // 参数可能引用即将被覆盖的元素, 先构造再替换
+            T tmp(HxSTL::forward<Args>(args)...);
+            pointer p = slot(_head);
+            _alloc.destroy(p);
+            _alloc.construct(p, HxSTL::move(tmp));
+            ++_head;
+            ++_tail;
+        } else {
+            throw HxSTL::length_error();
+        }
+    }
+
+    template <class T, class Alloc>
+    template <class... Args>
+    void circular_buffer<T, Alloc>::emplace_front(Args&&... args) {
+        if (!full()) {
+            _alloc.construct(slot(_head - 1), HxSTL::forward<Args>(args)...);
+            --_head;
+        } else if (_policy == overflow_overwrite && _capacity != 0) {
+            T tmp(HxSTL::forward<Args>(args)...);
+            pointer p = slot(_tail - 1);
+            _alloc.destroy(p);
+            _alloc.construct(p, HxSTL::move(tmp));
+            --_head;
+            --_tail;
+        } else {
+            throw HxSTL::length_error();
+        }
+    }
+
+    template <class T, class Alloc>
+    bool operator==(const circular_buffer<T, Alloc>& lhs, const circular_buffer<T, Alloc>& rhs) {
+        return lhs.size() == rhs.size() && HxSTL::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, class Alloc>
+    bool operator!=(const circular_buffer<T, Alloc>& lhs, const circular_buffer<T, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template <class T, class Alloc>
+    void swap(circular_buffer<T, Alloc>& lhs, circular_buffer<T, Alloc>& rhs) {
+        lhs.swap(rhs);
+    }
+
+}
+
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef _CONCURRENT_SET_H_
+#define _CONCURRENT_SET_H_
+
+
+#include "concurrent_skip_list.h"
+#include "functional.h"
+
+
+namespace HxSTL {
+
+    // 可以被多个线程同时读写的有序 set, 基于无锁跳表
+    template <class Key, class Compare = HxSTL::less<Key>, class Alloc = HxSTL::allocator<Key>>
+    class concurrent_set {
+    public:
+        typedef Key                                     key_type;
+        typedef Key                                     value_type;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+        typedef Compare                                 key_compare;
+        typedef Compare                                 value_compare;
+        typedef Alloc                                   allocator_type;
+        typedef const value_type&                       reference;
+        typedef const value_type&                       const_reference;
+        typedef const value_type*                       pointer;
+        typedef const value_type*                       const_pointer;
+    protected:
+        typedef HxSTL::concurrent_skip_list<key_type, value_type, __identity<value_type>, key_compare, allocator_type>      rep_type;
+    public:
+        typedef typename rep_type::const_iterator       iterator;
+        typedef typename rep_type::const_iterator       const_iterator;
+        typedef typename rep_type::guard                guard;
+    protected:
+        rep_type _rep;
+    public:
+        concurrent_set(): concurrent_set(Compare()) {}
+
+        explicit concurrent_set(const Compare& comp, const Alloc& alloc = Alloc()): _rep(comp, alloc) {}
+
+        template <class InputIt>
+        concurrent_set(InputIt first, InputIt last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : _rep(comp, alloc) { insert(first, last); }
+
+        concurrent_set(HxSTL::initializer_list<value_type> init, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : _rep(comp, alloc) { insert(init.begin(), init.end()); }
+
+        concurrent_set(const concurrent_set&) = delete;
+
+        concurrent_set& operator=(const concurrent_set&) = delete;
+
+        Alloc get_allocator() const { return _rep.get_allocator(); }
+
+        // 持有返回的 guard 期间, 迭代器和引用不会因其他线程的删除而失效
+        guard pin() const { return _rep.pin(); }
+
+        const_iterator begin() const { return _rep.begin(); }
+
+        const_iterator cbegin() const { return _rep.begin(); }
+
+        const_iterator end() const { return _rep.end(); }
+
+        const_iterator cend() const { return _rep.end(); }
+
+        bool empty() const { return _rep.empty(); }
+
+        size_type size() const { return _rep.size(); }
+
+        size_type max_size() const { return _rep.max_size(); }
+
+        // 已删除的元素在使用过程中自动回收; clear 和 reclaim 会立即释放, 不能与其他操作并发
+        void clear() { _rep.clear(); }
+
+        void reclaim() { _rep.reclaim(); }
+
+        HxSTL::pair<iterator, bool> insert(const value_type& value) {
+            return _rep.emplace_unique(value);
+        }
+
+        HxSTL::pair<iterator, bool> insert(value_type&& value) {
+            return _rep.emplace_unique(HxSTL::move(value));
+        }
+
+        template <class InputIt>
+        void insert(InputIt first, InputIt last) {
+            while (first != last) _rep.emplace_unique(*(first++));
+        }
+
+        void insert(HxSTL::initializer_list<value_type> init) {
+            insert(init.begin(), init.end());
+        }
+
+        template <class... Args>
+        HxSTL::pair<iterator, bool> emplace(Args&&... args) {
+            return _rep.emplace_unique(HxSTL::forward<Args>(args)...);
+        }
+
+        size_type erase(const Key& key) { return _rep.erase(key); }
+
+        size_type count(const Key& key) const { return _rep.count(key); }
+
+        const_iterator find(const Key& key) const { return _rep.find(key); }
+
+        HxSTL::pair<const_iterator, const_iterator> equal_range(const Key& key) const { return _rep.equal_range(key); }
+
+        const_iterator lower_bound(const Key& key) const { return _rep.lower_bound(key); }
+
+        const_iterator upper_bound(const Key& key) const { return _rep.upper_bound(key); }
+
+        template <class Function>
+        Function for_each_in_range(const Key& lo, const Key& hi, Function fn) const { return _rep.for_each_in_range(lo, hi, fn); }
+
+        key_compare key_comp() const { return _rep.get_compare(); }
+
+        value_compare value_comp() const { return _rep.get_compare(); }
+    };
+
+}
+
+
+#endif
@@ -0,0 +1,643 @@
+#ifndef _CONCURRENT_SKIP_LIST_
+#define _CONCURRENT_SKIP_LIST_
+
+
+#include <atomic>
+#include <thread>
+#include <stdint.h>
+#include "allocator.h"
+#include "iterator.h"
+#include "utility.h"
+
+
+namespace HxSTL {
+
+    // next 指针的最低位作为删除标记
+    template <class T>
+    struct __skip_list_node {
+        typedef __skip_list_node<T>*    link_type;
+
+        T value;
+        link_type retired;              // 待回收节点链表
+        std::atomic<int> owners;        // 插入者与删除者各持有一份, 最后放手的一方负责摘除并交给回收
+        int level;
+        std::atomic<uintptr_t> next[1]; // 实际长度为 level
+
+        static link_type PTR(uintptr_t x) { return reinterpret_cast<link_type>(x & ~uintptr_t(1)); }
+        static bool MARKED(uintptr_t x) { return (x & 1) != 0; }
+
+        link_type get_next(int i) const { return PTR(next[i].load(std::memory_order_acquire)); }
+    };
+
+    template <class T>
+    struct __skip_list_iterator {
+        typedef HxSTL::forward_iterator_tag             iterator_category;
+        typedef T                                       value_type;
+        typedef const T&                                reference;
+        typedef const T*                                pointer;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+        typedef __skip_list_node<T>*                    link_type;
+
+        link_type node;
+
+        __skip_list_iterator(): node(NULL) {}
+
+        explicit __skip_list_iterator(link_type x): node(x) {}
+
+        reference operator*() const { return node -> value; }
+
+        pointer operator->() const { return &(operator*()); }
+
+        // 跳过已被标记删除的节点
+        static link_type skip_marked(link_type x) {
+            while (x != NULL && __skip_list_node<T>::MARKED(x -> next[0].load(std::memory_order_acquire))) {
+                x = x -> get_next(0);
+            }
+            return x;
+        }
+
+        __skip_list_iterator& operator++() {
+            node = skip_marked(node -> get_next(0));
+            return *this;
+        }
+
+        __skip_list_iterator operator++(int) {
+            __skip_list_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const __skip_list_iterator& other) const { return node == other.node; }
+
+        bool operator!=(const __skip_list_iterator& other) const { return node != other.node; }
+    };
+
+    // 纪元槽, 0 表示空闲, 否则为 (纪元 << 1) | 1; 各槽独占一条缓存行以免伪共享
+    struct __epoch_slot {
+        std::atomic<uint64_t> value;
+        char _pad[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    // 本线程在各容器上持有的纪元槽: 已经持有时嵌套的 guard 只增加深度, 不再占用新的槽
+    // 超出缓存的容器每次占用新的槽, 仍然正确, 只是不可重入
+    struct __epoch_pin {
+        const void* owner;
+        size_t slot;
+        size_t depth;
+    };
+
+    enum { __EPOCH_PIN_CACHE = 8 };
+
+    inline __epoch_pin* __epoch_pins() {
+        static thread_local __epoch_pin pins[__EPOCH_PIN_CACHE] = {};
+        return pins;
+    }
+
+    // 无锁跳表 (Herlihy & Shavit), 插入/删除/查找可以在多个线程中同时进行
+    // 删除先标记再摘除, 已删除的节点按纪元 (epoch-based reclamation) 延迟释放:
+    //   每个操作进行期间在某个纪元槽中公布自己所处的全局纪元;
+    //   被摘除的节点按摘除时的全局纪元放入三个待回收链表之一;
+    //   所有公布的纪元都追上全局纪元时, 全局纪元才前进一步, 同时释放两个纪元之前摘除的节点
+    // 因此容器使用期间内存有界, 正在进行的操作也不会访问到已释放的内存
+    // 迭代器是弱一致的: 能看到迭代开始前已存在且未被删除的元素, 不保证看到并发插入的元素
+    // 迭代器和元素引用在该元素被删除之前有效; 其他线程可能同时删除时, 需在 pin() 返回的 guard
+    // 存活期间使用它们, 一直持有 guard 会阻止回收; guard 可以嵌套, 必须在创建它的线程中析构
+    // clear / reclaim / 析构不能与其他操作并发; 分配器需要是线程安全的 (pool_allocator 不是)
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    class concurrent_skip_list {
+    public:
+        typedef K                                                               key_type;
+        typedef V                                                               value_type;
+        typedef const V*                                                        pointer;
+        typedef const V*                                                        const_pointer;
+        typedef const V&                                                        reference;
+        typedef const V&                                                        const_reference;
+        typedef size_t                                                          size_type;
+        typedef ptrdiff_t                                                       difference_type;
+        typedef __skip_list_iterator<V>                                         iterator;
+        typedef __skip_list_iterator<V>                                         const_iterator;
+        typedef typename iterator::link_type                                    link_type;
+        typedef __skip_list_node<V>                                             node_type;
+        typedef typename Alloc::template rebind<char>::other                    byte_allocator_type;
+
+        enum { __MAX_LEVEL = 32 };
+        enum { __EPOCH_SLOTS = 64 };
+        enum { __RECLAIM_PERIOD = 64 };    // 每摘除这么多个节点尝试推进一次纪元
+
+        // 持有期间本线程得到的迭代器和引用不会被回收
+        class guard {
+            friend class concurrent_skip_list;
+        private:
+            const concurrent_skip_list* _list;
+            size_t _slot;
+
+            explicit guard(const concurrent_skip_list& list): _list(&list), _slot(list.acquire_slot()) {}
+        public:
+            guard(guard&& other): _list(other._list), _slot(other._slot) { other._list = NULL; }
+
+            guard(const guard&) = delete;
+
+            guard& operator=(const guard&) = delete;
+
+            ~guard() { if (_list != NULL) _list -> release_slot(_slot); }
+        };
+    protected:
+        link_type _head;
+        std::atomic<int> _height;
+        std::atomic<size_type> _count;
+        std::atomic<uint64_t> _epoch;
+        std::atomic<link_type> _limbo[3];
+        std::atomic<bool> _advancing;
+        std::atomic<size_type> _retire_count;
+        mutable __epoch_slot _slots[__EPOCH_SLOTS];
+        Compare _compare;
+        byte_allocator_type _alloc;
+    protected:
+        static size_t node_bytes(int level) { return sizeof(node_type) + (level - 1) * sizeof(std::atomic<uintptr_t>); }
+
+        static K KEY(link_type x) { return KOV()(x -> value); }
+
+        static int random_level();
+
+        link_type allocate_node(int level);
+        void deallocate_node(link_type x);
+
+        template <class... Args>
+        link_type create_node(int level, Args&&... args);
+        void destroy_node(link_type x);
+
+        void raise_height(int level);
+        bool find_aux(const K& key, link_type* preds, link_type* succs);
+        link_type lower_bound_aux(const K& key) const;
+        link_type upper_bound_aux(const K& key) const;
+        HxSTL::pair<link_type, bool> insert_aux(link_type x);
+        void link_upper(link_type x, link_type* preds, link_type* succs);
+
+        size_t acquire_slot() const;
+        void release_slot(size_t slot) const;
+        size_t claim_slot() const;
+        void release(link_type x);
+        void retire(link_type x);
+        void try_advance();
+        void free_retired(link_type x);
+    public:
+        explicit concurrent_skip_list(const Compare& comp = Compare(), const Alloc& alloc = Alloc());
+
+        concurrent_skip_list(const concurrent_skip_list&) = delete;
+
+        concurrent_skip_list& operator=(const concurrent_skip_list&) = delete;
+
+        ~concurrent_skip_list();
+
+        Alloc get_allocator() const { return Alloc(); }
+
+        Compare get_compare() const { return _compare; }
+
+        guard pin() const { return guard(*this); }
+
+        iterator begin() const {
+            guard g(*this);
+            return iterator(iterator::skip_marked(_head -> get_next(0)));
+        }
+
+        iterator end() const { return iterator(); }
+
+        // 并发修改时只是一个近似值
+        size_type size() const { return _count.load(std::memory_order_relaxed); }
+
+        bool empty() const { return begin() == end(); }
+
+        size_type max_size() const { return size_type(-1) / sizeof(node_type); }
+
+        void clear();
+
+        // 立即释放所有待回收节点, 调用时不能有其他线程访问容器
+        void reclaim();
+
+        template <class... Args>
+        HxSTL::pair<iterator, bool> emplace_unique(Args&&... args) {
+            guard g(*this);
+            link_type x = create_node(random_level(), HxSTL::forward<Args>(args)...);
+            HxSTL::pair<link_type, bool> pr = insert_aux(x);
+            return HxSTL::make_pair(iterator(pr.first), pr.second);
+        }
+
+        size_type erase(const K& key);
+
+        iterator find(const K& key) const {
+            guard g(*this);
+            link_type x = lower_bound_aux(key);
+            return x == NULL || _compare(key, KEY(x)) ? end() : iterator(x);
+        }
+
+        size_type count(const K& key) const { return find(key) == end() ? 0 : 1; }
+
+        iterator lower_bound(const K& key) const {
+            guard g(*this);
+            return iterator(lower_bound_aux(key));
+        }
+
+        iterator upper_bound(const K& key) const {
+            guard g(*this);
+            return iterator(upper_bound_aux(key));
+        }
+
+        HxSTL::pair<iterator, iterator> equal_range(const K& key) const {
+            guard g(*this);
+            return HxSTL::make_pair(iterator(lower_bound_aux(key)), iterator(upper_bound_aux(key)));
+        }
+
+        // 按序访问 [lo, hi) 内的元素
+        template <class Function>
+        Function for_each_in_range(const K& lo, const K& hi, Function fn) const {
+            guard g(*this);
+            for (iterator it = lower_bound(lo); it != end() && _compare(KEY(it.node), hi); ++it) {
+                fn(*it);
+            }
+            return fn;
+        }
+    };
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    concurrent_skip_list<K, V, KOV, Compare, Alloc>::concurrent_skip_list(const Compare& comp, const Alloc&)
+        : _head(NULL), _height(1), _count(0), _epoch(0), _advancing(false), _retire_count(0), _compare(comp) {
+        for (int i = 0; i != 3; ++i) {
+            _limbo[i].store(NULL, std::memory_order_relaxed);
+        }
+        for (int i = 0; i != __EPOCH_SLOTS; ++i) {
+            _slots[i].value.store(0, std::memory_order_relaxed);
+        }
+        _head = allocate_node(__MAX_LEVEL);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    concurrent_skip_list<K, V, KOV, Compare, Alloc>::~concurrent_skip_list() {
+        clear();
+        deallocate_node(_head);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    int concurrent_skip_list<K, V, KOV, Compare, Alloc>::random_level() {
+        // 每个线程一个 xorshift 状态, 层数按 1/4 的概率递增
+        static std::atomic<uint64_t> seed(0x9e3779b97f4a7c15ULL);
+        static thread_local uint64_t state = seed.fetch_add(0x9e3779b97f4a7c15ULL, std::memory_order_relaxed) | 1;
+
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        int level = 1;
+        for (uint64_t r = state; (r & 3) == 0 && level < __MAX_LEVEL; r >>= 2) ++level;
+        return level;
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto concurrent_skip_list<K, V, KOV, Compare, Alloc>::allocate_node(int level) -> link_type {
+        link_type x = reinterpret_cast<link_type>(_alloc.allocate(node_bytes(level)));
+        x -> level = level;
+        x -> retired = NULL;
+        ::new (static_cast<void*>(&(x -> owners))) std::atomic<int>(2);
+        for (int i = 0; i != level; ++i) {
+            ::new (static_cast<void*>(&(x -> next[i]))) std::atomic<uintptr_t>(0);
+        }
+        return x;
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void concurrent_skip_list<K, V, KOV, Compare, Alloc>::deallocate_node(link_type x) {
+        _alloc.deallocate(reinterpret_cast<char*>(x), node_bytes(x -> level));
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    template <class... Args>
+    auto concurrent_skip_list<K, V, KOV, Compare, Alloc>::create_node(int level, Args&&... args) -> link_type {
+        link_type x = allocate_node(level);
+        try {
+            HxSTL::construct(&(x -> value), HxSTL::forward<Args>(args)...);
+        } catch (...) {
+            deallocate_node(x);
+            throw;
+        }
+        return x;
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void concurrent_skip_list<K, V, KOV, Compare, Alloc>::destroy_node(link_type x) {
+        HxSTL::destroy(&(x -> value));
+        deallocate_node(x);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void concurrent_skip_list<K, V, KOV, Compare, Alloc>::raise_height(int level) {
+        int h = _height.load(std::memory_order_relaxed);
+        while (h < level && !_height.compare_exchange_weak(h, level, std::memory_order_relaxed)) {}
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    bool concurrent_skip_list<K, V, KOV, Compare, Alloc>::find_aux(const K& key, link_type* preds, link_type* succs) {
+        // 查找每一层中 key 的前驱和后继, 顺路摘除被标记的节点
+        int height = _height.load(std::memory_order_relaxed);
+
+    retry:
+        link_type pred = _head;
+        link_type curr = NULL;
+
+        for (int i = __MAX_LEVEL - 1; i >= height; --i) {
+            preds[i] = _head;
+            succs[i] = NULL;
+        }
+
+        for (int i = height - 1; i >= 0; --i) {
+            curr = pred -> get_next(i);
+            while (curr != NULL) {
+                uintptr_t succ = curr -> next[i].load(std::memory_order_acquire);
+                while (node_type::MARKED(succ)) {
+                    uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+                    if (!pred -> next[i].compare_exchange_strong(expected, succ & ~uintptr_t(1),
+                                std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        goto retry;
+                    }
+                    curr = node_type::PTR(succ);
+                    if (curr == NULL) break;
+                    succ = curr -> next[i].load(std::memory_order_acquire);
+                }
+
+                if (curr == NULL || !_compare(KEY(curr), key)) break;
+
+                pred = curr;
+                curr = node_type::PTR(succ);
+            }
+            preds[i] = pred;
+            succs[i] = curr;
+        }
+
+        return curr != NULL && !_compare(key, KEY(curr));
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto concurrent_skip_list<K, V, KOV, Compare, Alloc>::lower_bound_aux(const K& key) const -> link_type {
+        // 只读查找不摘除节点, 被标记的节点仍然保持有序, 可以直接跨过
+        link_type pred = _head;
+        link_type curr = NULL;
+
+        for (int i = _height.load(std::memory_order_relaxed) - 1; i >= 0; --i) {
+            curr = pred -> get_next(i);
+            while (curr != NULL && _compare(KEY(curr), key)) {
+                pred = curr;
+                curr = curr -> get_next(i);
+            }
+        }
+
+        return iterator::skip_marked(curr);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto concurrent_skip_list<K, V, KOV, Compare, Alloc>::upper_bound_aux(const K& key) const -> link_type {
+        link_type pred = _head;
+        link_type curr = NULL;
+
+        for (int i = _height.load(std::memory_order_relaxed) - 1; i >= 0; --i) {
+            curr = pred -> get_next(i);
+            while (curr != NULL && !_compare(key, KEY(curr))) {
+                pred = curr;
+                curr = curr -> get_next(i);
+            }
+        }
+
+        return iterator::skip_marked(curr);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto concurrent_skip_list<K, V, KOV, Compare, Alloc>::insert_aux(link_type x) -> HxSTL::pair<link_type, bool> {
+        link_type preds[__MAX_LEVEL];
+        link_type succs[__MAX_LEVEL];
+        const K key = KEY(x);
+        const int level = x -> level;
+
+        raise_height(level);
+
+        // 先链入最底层, 成功后元素即可见
+        for (;;) {
+            if (find_aux(key, preds, succs)) {
+                destroy_node(x);
+                return HxSTL::make_pair(succs[0], false);
+            }
+
+            for (int i = 0; i != level; ++i) {
+                x -> next[i].store(reinterpret_cast<uintptr_t>(succs[i]), std::memory_order_relaxed);
+            }
+
+            uintptr_t expected = reinterpret_cast<uintptr_t>(succs[0]);
+            if (preds[0] -> next[0].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(x),
+                        std::memory_order_acq_rel, std::memory_order_acquire)) {
+                break;
+            }
+        }
+        _count.fetch_add(1, std::memory_order_relaxed);
+
+        link_upper(x, preds, succs);
+        release(x);
+        return HxSTL::make_pair(x, true);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void concurrent_skip_list<K, V, KOV, Compare, Alloc>::link_upper(link_type x, link_type* preds, link_type* succs) {
+        // 逐层链入上层; 如果 x 已被并发删除则停止
+        // x 被标记后仍可能在这里被链入某一层, 由 release 中最后放手的一方再摘除一次
+        const K key = KEY(x);
+        for (int i = 1; i != x -> level; ++i) {
+            for (;;) {
+                uintptr_t next = x -> next[i].load(std::memory_order_acquire);
+                if (node_type::MARKED(next)) return;
+
+                if (node_type::PTR(next) != succs[i] && !x -> next[i].compare_exchange_strong(next,
+                            reinterpret_cast<uintptr_t>(succs[i]), std::memory_order_acq_rel)) {
+                    return;
+                }
+
+                uintptr_t expected = reinterpret_cast<uintptr_t>(succs[i]);
+                if (preds[i] -> next[i].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(x),
+                            std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    break;
+                }
+
+                if (!find_aux(key, preds, succs) || succs[0] != x) return;
+            }
+        }
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto concurrent_skip_list<K, V, KOV, Compare, Alloc>::erase(const K& key) -> size_type {
+        link_type preds[__MAX_LEVEL];
+        link_type succs[__MAX_LEVEL];
+        guard g(*this);
+
+        if (!find_aux(key, preds, succs)) return 0;
+        link_type x = succs[0];
+
+        // 自顶向下标记, 最底层标记成功的线程负责删除
+        for (int i = x -> level - 1; i > 0; --i) {
+            uintptr_t next = x -> next[i].load(std::memory_order_acquire);
+            while (!node_type::MARKED(next) && !x -> next[i].compare_exchange_weak(next, next | 1,
+                        std::memory_order_acq_rel, std::memory_order_acquire)) {}
+        }
+
+        uintptr_t next = x -> next[0].load(std::memory_order_acquire);
+        for (;;) {
+            if (node_type::MARKED(next)) return 0;
+            if (x -> next[0].compare_exchange_weak(next, next | 1,
+                        std::memory_order_acq_rel, std::memory_order_acquire)) {
+                break;
+            }
+        }
+
+        _count.fetch_sub(1, std::memory_order_relaxed);
+        release(x);
+        return 1;
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    size_t concurrent_skip_list<K, V, KOV, Compare, Alloc>::acquire_slot() const {
+        __epoch_pin* pins = __epoch_pins();
+        __epoch_pin* free = NULL;
+        for (int i = 0; i != __EPOCH_PIN_CACHE; ++i) {
+            if (pins[i].depth == 0) {
+                if (free == NULL) free = &pins[i];
+            } else if (pins[i].owner == this) {
+                ++pins[i].depth;
+                return pins[i].slot;
+            }
+        }
+
+        size_t slot = claim_slot();
+        if (free != NULL) {
+            free -> owner = this;
+            free -> slot = slot;
+            free -> depth = 1;
+        }
+        return slot;
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void concurrent_skip_list<K, V, KOV, Compare, Alloc>::release_slot(size_t slot) const {
+        __epoch_pin* pins = __epoch_pins();
+        for (int i = 0; i != __EPOCH_PIN_CACHE; ++i) {
+            if (pins[i].depth != 0 && pins[i].owner == this && pins[i].slot == slot) {
+                if (--pins[i].depth != 0) return;
+                break;
+            }
+        }
+        _slots[slot].value.store(0, std::memory_order_release);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    size_t concurrent_skip_list<K, V, KOV, Compare, Alloc>::claim_slot() const {
+        // 每个线程从各自的位置开始找空闲槽, 减少争用; 槽全被占用时让出时间片
+        static std::atomic<size_t> seed(0);
+        static thread_local size_t hint = seed.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t e = _epoch.load(std::memory_order_seq_cst);
+        for (size_t i = 0; ; ++i) {
+            std::atomic<uint64_t>& slot = _slots[(hint + i) % __EPOCH_SLOTS].value;
+            uint64_t expected = 0;
+            if (slot.load(std::memory_order_relaxed) == 0 &&
+                    slot.compare_exchange_strong(expected, (e << 1) | 1, std::memory_order_seq_cst)) {
+                // 公布之后全局纪元可能已经前进, 重新公布直到二者一致
+                for (uint64_t now; (now = _epoch.load(std::memory_order_seq_cst)) != e; e = now) {
+                    slot.store((now << 1) | 1, std::memory_order_seq_cst);
+                }
+                return (hint + i) % __EPOCH_SLOTS;
+            }
+            if ((i + 1) % __EPOCH_SLOTS == 0) std::this_thread::yield();
+        }
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void concurrent_skip_list<K, V, KOV, Compare, Alloc>::release(link_type x) {
+        // 插入者链入上层与删除者摘除可能交错, 最后放手的一方已看到另一方的全部修改,
+        // 此时 x 已被标记且不会再被链入, 再摘除一次后即不可达
+        if (x -> owners.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+        link_type preds[__MAX_LEVEL];
+        link_type succs[__MAX_LEVEL];
+        find_aux(KEY(x), preds, succs);
+        retire(x);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void concurrent_skip_list<K, V, KOV, Compare, Alloc>::retire(link_type x) {
+        // 调用者持有 guard, 全局纪元在其退出前至多前进一步, 不会有人同时释放这个链表
+        std::atomic<link_type>& limbo = _limbo[_epoch.load(std::memory_order_seq_cst) % 3];
+        link_type head = limbo.load(std::memory_order_relaxed);
+        do {
+            x -> retired = head;
+        } while (!limbo.compare_exchange_weak(head, x, std::memory_order_release, std::memory_order_relaxed));
+
+        if (_retire_count.fetch_add(1, std::memory_order_relaxed) % __RECLAIM_PERIOD == __RECLAIM_PERIOD - 1) {
+            try_advance();
+        }
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void concurrent_skip_list<K, V, KOV, Compare, Alloc>::try_advance() {
+        bool busy = false;
+        if (!_advancing.compare_exchange_strong(busy, true, std::memory_order_acquire)) return;
+
+        // 所有进行中的操作都已处于纪元 e 时才能前进
+        uint64_t e = _epoch.load(std::memory_order_seq_cst);
+        for (int i = 0; i != __EPOCH_SLOTS; ++i) {
+            uint64_t v = _slots[i].value.load(std::memory_order_seq_cst);
+            if (v != 0 && (v >> 1) != e) {
+                _advancing.store(false, std::memory_order_release);
+                return;
+            }
+        }
+
+        // (e + 1) % 3 中是纪元 e - 2 摘除的节点, 此时已没有操作能访问它们;
+        // 先取走再前进, 以免混入纪元 e + 1 新摘除的节点
+        link_type x = _limbo[(e + 1) % 3].exchange(NULL, std::memory_order_acquire);
+        _epoch.store(e + 1, std::memory_order_seq_cst);
+        _advancing.store(false, std::memory_order_release);
+
+        free_retired(x);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void concurrent_skip_list<K, V, KOV, Compare, Alloc>::free_retired(link_type x) {
+        while (x != NULL) {
+            link_type next = x -> retired;
+            destroy_node(x);
+            x = next;
+        }
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void concurrent_skip_list<K, V, KOV, Compare, Alloc>::reclaim() {
+        for (int i = 0; i != 3; ++i) {
+            free_retired(_limbo[i].exchange(NULL, std::memory_order_acquire));
+        }
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void concurrent_skip_list<K, V, KOV, Compare, Alloc>::clear() {
+        reclaim();
+
+        link_type x = _head -> get_next(0);
+        while (x != NULL) {
+            link_type next = x -> get_next(0);
+            destroy_node(x);
+            x = next;
+        }
+
+        for (int i = 0; i != __MAX_LEVEL; ++i) {
+            _head -> next[i].store(0, std::memory_order_relaxed);
+        }
+        _height.store(1, std::memory_order_relaxed);
+        _count.store(0, std::memory_order_relaxed);
+    }
+
+}
+
+
+#endif
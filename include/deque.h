@@ -9,12 +9,15 @@
 
 namespace HxSTL {
 
-    template <class T, class Ref, class Ptr>
+    // 每个缓冲区的元素个数: 未指定时按约 4 KiB 一块, 大对象至少 16 个
+    constexpr inline size_t __deque_buf_size(size_t size, size_t n) {
+        return n != 0 ? n : (size < 256 ? 4096 / size : 16);
+    }
+
+    template <class T, class Ref, class Ptr, size_t BufSize = 0>
     class deque_iterator {
-    protected:
-        enum {__BUFFER_BYTE = 512};
     public:
-        typedef bidirectional_iterator_tag          iterator_category;
+        typedef random_access_iterator_tag          iterator_category;
         typedef T                                   value_type;
         typedef Ptr                                 pointer;
         typedef Ref                                 reference;
@@ -29,7 +32,7 @@ namespace HxSTL {
         ele_pointer _last;
         map_pointer _node;
     public:
-        constexpr static size_t buffer_size() { return __BUFFER_BYTE / sizeof(T); }
+        constexpr static size_t buffer_size() { return __deque_buf_size(sizeof(T), BufSize); }
 
         void set_node(map_pointer node) noexcept {
             _node = node;
@@ -43,7 +46,7 @@ namespace HxSTL {
         deque_iterator(ele_pointer cur, map_pointer node) noexcept
             : _cur(cur), _first(*node), _last(*node + buffer_size()), _node(node) {}
 
-        deque_iterator(const deque_iterator<T, T&, T*>& other) noexcept
+        deque_iterator(const deque_iterator<T, T&, T*, BufSize>& other) noexcept
             : _cur(other._cur), _first(other._first), _last(other._last), _node(other._node) {}
 
         reference operator*() const noexcept { return *_cur; }
@@ -112,49 +115,91 @@ namespace HxSTL {
         }
     };
 
-    template <class T, class Ref, class Ptr>
-    inline bool operator==(const deque_iterator<T, Ref, Ptr>& x, const deque_iterator<T, Ref, Ptr>& y) noexcept {
+    template <class T, class Ref, class Ptr, size_t BufSize>
+    inline bool operator==(const deque_iterator<T, Ref, Ptr, BufSize>& x, const deque_iterator<T, Ref, Ptr, BufSize>& y) noexcept {
         return x._cur == y._cur;
     }
 
-    template <class T, class Ref, class Ptr>
-    inline bool operator!=(const deque_iterator<T, Ref, Ptr>& x, const deque_iterator<T, Ref, Ptr>& y) noexcept {
+    template <class T, class Ref, class Ptr, size_t BufSize>
+    inline bool operator!=(const deque_iterator<T, Ref, Ptr, BufSize>& x, const deque_iterator<T, Ref, Ptr, BufSize>& y) noexcept {
         return x._cur != y._cur;
     }
 
-    template <class T, class Ref, class Ptr>
-    inline bool operator< (const deque_iterator<T, Ref, Ptr>& x, const deque_iterator<T, Ref, Ptr>& y) noexcept {
-        return x._cur < y._cur;
+    template <class T, class Ref, class Ptr, size_t BufSize>
+    inline bool operator< (const deque_iterator<T, Ref, Ptr, BufSize>& x, const deque_iterator<T, Ref, Ptr, BufSize>& y) noexcept {
+        return x._node == y._node ? x._cur < y._cur : x._node < y._node;
     }
 
-    template <class T, class RefL, class PtrL, class RefR, class PtrR>
-    inline bool operator==(const deque_iterator<T, RefL, PtrL>& x, const deque_iterator<T, RefR, PtrR>& y) noexcept {
+    template <class T, class RefL, class PtrL, class RefR, class PtrR, size_t BufSize>
+    inline bool operator==(const deque_iterator<T, RefL, PtrL, BufSize>& x, const deque_iterator<T, RefR, PtrR, BufSize>& y) noexcept {
         return x._cur == y._cur;
     }
 
-    template <class T, class RefL, class PtrL, class RefR, class PtrR>
-    inline bool operator!=(const deque_iterator<T, RefL, PtrL>& x, const deque_iterator<T, RefR, PtrR>& y) noexcept {
+    template <class T, class RefL, class PtrL, class RefR, class PtrR, size_t BufSize>
+    inline bool operator!=(const deque_iterator<T, RefL, PtrL, BufSize>& x, const deque_iterator<T, RefR, PtrR, BufSize>& y) noexcept {
         return x._cur != y._cur;
     }
 
-    template <class T, class RefL, class PtrL, class RefR, class PtrR>
-    inline bool operator< (const deque_iterator<T, RefL, PtrL>& x, const deque_iterator<T, RefR, PtrR>& y) noexcept {
-        return x._cur < y._cur;
+    template <class T, class RefL, class PtrL, class RefR, class PtrR, size_t BufSize>
+    inline bool operator< (const deque_iterator<T, RefL, PtrL, BufSize>& x, const deque_iterator<T, RefR, PtrR, BufSize>& y) noexcept {
+        return x._node == y._node ? x._cur < y._cur : x._node < y._node;
     }
 
-    template <class T, class Ref, class Ptr>
-    inline typename deque_iterator<T, Ref, Ptr>::difference_type
-    operator- (const deque_iterator<T, Ref, Ptr>& x, const deque_iterator<T, Ref, Ptr>& y) noexcept {
+    template <class T, class RefL, class PtrL, class RefR, class PtrR, size_t BufSize>
+    inline bool operator> (const deque_iterator<T, RefL, PtrL, BufSize>& x, const deque_iterator<T, RefR, PtrR, BufSize>& y) noexcept {
+        return y < x;
+    }
+
+    template <class T, class RefL, class PtrL, class RefR, class PtrR, size_t BufSize>
+    inline bool operator<=(const deque_iterator<T, RefL, PtrL, BufSize>& x, const deque_iterator<T, RefR, PtrR, BufSize>& y) noexcept {
+        return !(y < x);
+    }
+
+    template <class T, class RefL, class PtrL, class RefR, class PtrR, size_t BufSize>
+    inline bool operator>=(const deque_iterator<T, RefL, PtrL, BufSize>& x, const deque_iterator<T, RefR, PtrR, BufSize>& y) noexcept {
+        return !(x < y);
+    }
+
+    template <class T, class Ref, class Ptr, size_t BufSize>
+    inline typename deque_iterator<T, Ref, Ptr, BufSize>::difference_type
+    operator- (const deque_iterator<T, Ref, Ptr, BufSize>& x, const deque_iterator<T, Ref, Ptr, BufSize>& y) noexcept {
         return x.buffer_size() * (x._node - y._node - 1) + (x._cur - x._first) + (y._last - y._cur);
     }
 
-    template <class T, class RefL, class PtrL, class RefR, class PtrR>
-    inline typename deque_iterator<T, RefL, PtrL>::difference_type
-    operator- (const deque_iterator<T, RefL, PtrL>& x, const deque_iterator<T, RefR, PtrR>& y) noexcept {
+    template <class T, class RefL, class PtrL, class RefR, class PtrR, size_t BufSize>
+    inline typename deque_iterator<T, RefL, PtrL, BufSize>::difference_type
+    operator- (const deque_iterator<T, RefL, PtrL, BufSize>& x, const deque_iterator<T, RefR, PtrR, BufSize>& y) noexcept {
         return x.buffer_size() * (x._node - y._node - 1) + (x._cur - x._first) + (y._last - y._cur);
     }
 
-    template <class T, class Alloc = allocator<T>>
+    // 每个缓冲区是一段连续内存, copy / fill / find 等算法按缓冲区逐块处理
+    template <class T, class Ref, class Ptr, size_t BufSize>
+    struct __segmented_iterator_traits<deque_iterator<T, Ref, Ptr, BufSize>> {
+        typedef deque_iterator<T, Ref, Ptr, BufSize>            iterator;
+        typedef true_type                                       is_segmented;
+        typedef typename iterator::map_pointer                  segment_iterator;
+        typedef Ptr                                             local_iterator;
+
+        static segment_iterator segment(const iterator& it) { return it._node; }
+
+        static local_iterator local(const iterator& it) { return it._cur; }
+
+        static local_iterator begin(segment_iterator seg) { return *seg; }
+
+        static local_iterator end(segment_iterator seg) { return *seg + iterator::buffer_size(); }
+
+        static iterator compose(segment_iterator seg, local_iterator local) {
+            // 落在块尾时换成下一块的开头, 与 operator+= 的结果一致
+            if (local == end(seg)) {
+                ++seg;
+                local = begin(seg);
+            }
+            return iterator(const_cast<T*>(local), seg);
+        }
+    };
+
+    // BufSize 为每个缓冲区的元素个数, 0 表示按元素大小自动选择
+    template <class T, class Alloc = allocator<T>, size_t BufSize = 0>
     class deque {
     public:
         typedef T                                                       value_type;
@@ -163,8 +208,8 @@ namespace HxSTL {
         typedef const value_type&                                       const_reference;
         typedef value_type*                                             pointer;
         typedef const value_type*                                       const_pointer;
-        typedef deque_iterator<T, T&, T*>                               iterator;
-        typedef deque_iterator<T, const T&, const T*>                   const_iterator;
+        typedef deque_iterator<T, T&, T*, BufSize>                      iterator;
+        typedef deque_iterator<T, const T&, const T*, BufSize>          const_iterator;
         typedef HxSTL::reverse_iterator<iterator>                       reverse_iterator;
         typedef HxSTL::reverse_iterator<const_iterator>                 const_reverse_iterator;
         typedef ptrdiff_t                                               difference_type;
@@ -179,6 +224,10 @@ namespace HxSTL {
         iterator _finish;
         map_pointer _map;
         size_type _map_size;
+        // 最近释放的缓冲区留作备用, 队列式的首尾进出稳定后不再访问分配器
+        enum { __SPARE_NODES = 2 };
+        pointer _spare[__SPARE_NODES];
+        size_type _num_spare;
     protected:
         template <class InputIt>
         void initialize_aux(InputIt first, InputIt last, HxSTL::false_type);
@@ -198,53 +247,56 @@ namespace HxSTL {
         void alloc_node_back(size_type count);
         void dealloc_node_front(iterator new_start);
         void dealloc_node_back(iterator new_finish);
+        pointer allocate_node();
+        void deallocate_node(pointer node);
+        void release_spare();
         void create_map(size_type count);
         void reallocate_map(size_type add_num_nodes, bool add_at_front);
         iterator REMOVE_CONST(const_iterator it) noexcept { return iterator(it._cur, it._node); }
     public:
         explicit deque(const Alloc& alloc = Alloc())
-            : _alloc(alloc), _map_alloc(map_allocator_type()) {
+            : _alloc(alloc), _map_alloc(alloc), _num_spare(0) {
                 create_map(0);
             }
 
         explicit deque(size_type count, const T& val, const Alloc& alloc = Alloc())
-            : _alloc(alloc), _map_alloc(map_allocator_type()) {
+            : _alloc(alloc), _map_alloc(alloc), _num_spare(0) {
                 initialize_aux(count, val, HxSTL::true_type());
             }
 
         explicit deque(size_type count)
-            : _alloc(Alloc()), _map_alloc(map_allocator_type()) {
+            : _alloc(Alloc()), _map_alloc(_alloc), _num_spare(0) {
                 initialize_aux(count, T(), HxSTL::true_type());
             }
 
         template <class InputIt>
         deque(InputIt first, InputIt last, const Alloc& alloc = Alloc())
-            : _alloc(alloc), _map_alloc(map_allocator_type()) {
+            : _alloc(alloc), _map_alloc(alloc), _num_spare(0) {
                 initialize_aux(first, last, typename HxSTL::is_integeral<InputIt>::type());
             }
 
-        deque(const deque& other): _alloc(other._alloc), _map_alloc(other._map_alloc) {
+        deque(const deque& other): _alloc(other._alloc), _map_alloc(other._map_alloc), _num_spare(0) {
             initialize_aux(other._start, other._finish, HxSTL::false_type());
         }
 
-        deque(const deque& other, const Alloc& alloc): _alloc(alloc), _map_alloc(map_allocator_type()) {
+        deque(const deque& other, const Alloc& alloc): _alloc(alloc), _map_alloc(alloc), _num_spare(0) {
             initialize_aux(other._start, other._finish, HxSTL::false_type());
         }
 
         deque(deque&& other): _start(other._start), _finish(other._finish), _map(other._map), 
-        _map_size(other._map_size), _alloc(HxSTL::move(other._alloc)), _map_alloc(HxSTL::move(other._map_alloc)) {
+        _map_size(other._map_size), _alloc(HxSTL::move(other._alloc)), _map_alloc(HxSTL::move(other._map_alloc)), _num_spare(0) {
             other._map = nullptr;
             other._map_size = 0;
         }
 
         deque(deque&& other, const Alloc& alloc): _start(other._start), _finish(other._finish), _map(other._map), 
-        _map_size(other._map_size), _alloc(alloc), _map_alloc(map_allocator_type()) {
+        _map_size(other._map_size), _alloc(alloc), _map_alloc(alloc), _num_spare(0) {
             other._map = nullptr;
             other._map_size = 0;
         }
 
         deque(HxSTL::initializer_list<T> init, const Alloc& alloc = Alloc())
-            : _alloc(alloc), _map_alloc(map_allocator_type()) {
+            : _alloc(alloc), _map_alloc(alloc), _num_spare(0) {
                 initialize_aux(init.begin(), init.end(), HxSTL::false_type());
             }
 
@@ -256,6 +308,7 @@ namespace HxSTL {
                 }
                 _map_alloc.deallocate(_map, _map_size);
             }
+            release_spare();
         }
 
         deque& operator=(const deque& other) {
@@ -410,106 +463,118 @@ namespace HxSTL {
         void resize(size_type count, const T& value) {
             difference_type delt = resize_aux(count);
             if (delt > 0) {
-                HxSTL::fill_n(_finish - delt, delt, value);
+                HxSTL::uninitialized_fill_n(_finish - delt, delt, value);
             }
         }
 
+        void shrink_to_fit() { release_spare(); }
+
         void swap(deque& other) {
             HxSTL::swap(_start, other._start);
             HxSTL::swap(_finish, other._finish);
             HxSTL::swap(_map, other._map);
             HxSTL::swap(_map_size, other._map_size);
+            for (size_type i = 0; i != __SPARE_NODES; ++i) {
+                HxSTL::swap(_spare[i], other._spare[i]);
+            }
+            HxSTL::swap(_num_spare, other._num_spare);
         }
     };
 
-    template <class T, class Alloc>
+    template <class T, class Alloc, size_t BufSize>
     template <class InputIt>
-    void deque<T, Alloc>::initialize_aux(InputIt first, InputIt last, HxSTL::false_type) {
+    void deque<T, Alloc, BufSize>::initialize_aux(InputIt first, InputIt last, HxSTL::false_type) {
         create_map(HxSTL::distance(first, last));
         HxSTL::uninitialized_copy(first, last, _start);
     }
 
-    template <class T, class Alloc>
-    void deque<T, Alloc>::initialize_aux(size_type count, const T& value, HxSTL::true_type) {
+    template <class T, class Alloc, size_t BufSize>
+    void deque<T, Alloc, BufSize>::initialize_aux(size_type count, const T& value, HxSTL::true_type) {
         create_map(count);
         HxSTL::uninitialized_fill_n(_start, count, value);
     }
 
-    template <class T, class Alloc>
-    typename deque<T, Alloc>::difference_type
-    deque<T, Alloc>::resize_aux(size_type count) {
+    template <class T, class Alloc, size_t BufSize>
+    typename deque<T, Alloc, BufSize>::difference_type
+    deque<T, Alloc, BufSize>::resize_aux(size_type count) {
         difference_type delt = count - size();
         if (delt > 0) {
-            size_type remain_front = _start._cur - _start._first + iterator::buffer_size() * (_start._node - _map);
-            size_type remain_back = _finish._last - _finish._cur + iterator::buffer_size() * (_map + _map_size - _finish._node);
-            if (remain_back < remain_front) {
-                alloc_node_front(delt);
-                _start -= delt;
-            } else {
-                alloc_node_back(delt);
-                _finish += delt;
-            }
+            // 新增的 delt 个位置在尾部, 尚未构造
+            alloc_node_back(delt);
+            _finish += delt;
         } else {
             erase_aux(_start + count, _finish);
         }
         return delt;
     }
 
-    template <class T, class Alloc>
+    template <class T, class Alloc, size_t BufSize>
     template <class InputIt>
-    void deque<T, Alloc>::assign_aux(InputIt first, InputIt last, HxSTL::false_type) {
+    void deque<T, Alloc, BufSize>::assign_aux(InputIt first, InputIt last, HxSTL::false_type) {
         size_type count = HxSTL::distance(first, last);
-        resize_aux(count);
-        HxSTL::copy(first, last, _start);
+        difference_type delt = resize_aux(count);
+        if (delt > 0) {
+            InputIt mid = first;
+            HxSTL::advance(mid, count - delt);
+            HxSTL::copy(first, mid, _start);
+            HxSTL::uninitialized_copy(mid, last, _finish - delt);
+        } else {
+            HxSTL::copy(first, last, _start);
+        }
     }
 
-    template <class T, class Alloc>
-    void deque<T, Alloc>::assign_aux(size_type count, const T& value, HxSTL::true_type) {
-        resize_aux(count);
-        HxSTL::fill_n(_start, count, value);
+    template <class T, class Alloc, size_t BufSize>
+    void deque<T, Alloc, BufSize>::assign_aux(size_type count, const T& value, HxSTL::true_type) {
+        difference_type delt = resize_aux(count);
+        if (delt > 0) {
+            HxSTL::fill_n(_start, count - delt, value);
+            HxSTL::uninitialized_fill_n(_finish - delt, delt, value);
+        } else {
+            HxSTL::fill_n(_start, count, value);
+        }
     }
 
-    template <class T, class Alloc>
+    template <class T, class Alloc, size_t BufSize>
     template <class Y>
-    typename deque<T, Alloc>::iterator
-    deque<T, Alloc>::insert_aux(iterator pos, Y&& value) {
+    typename deque<T, Alloc, BufSize>::iterator
+    deque<T, Alloc, BufSize>::insert_aux(iterator pos, Y&& value) {
         size_type index = pos - _start;
         if (index < size() / 2) {
             if (_start._node == _map && _start._cur == _start._first) {
                 reallocate_map(1, true);
             }
             if (_start._cur == _start._first) {
-                *(_start._node - 1) = _alloc.allocate(iterator::buffer_size());
+                *(_start._node - 1) = allocate_node();
             }
             if (pos == _start) {
                 _alloc.construct(&*(--_start), HxSTL::forward<Y>(value));
             } else {
                 _alloc.construct(&*(_start - 1), front());
                 HxSTL::copy(_start + 1, pos, _start);
-                *(--pos) = HxSTL::forward<T>(value);
+                *(--pos) = HxSTL::forward<Y>(value);
                 --_start;
             }
         } else {
-            if (_finish._cur == _finish._last - 1 && _finish._node == _map + _map_size) {
+            if (_finish._cur == _finish._last - 1 && _finish._node + 1 == _map + _map_size) {
                 reallocate_map(1, false);
             }
             if (_finish._cur == _finish._last - 1) {
-                *(_finish._node + 1) = _alloc.allocate(iterator::buffer_size());
+                *(_finish._node + 1) = allocate_node();
             }
             if (pos == _finish) {
                 _alloc.construct(&*_finish, HxSTL::forward<Y>(value));
             } else {
                 _alloc.construct(&*(_finish + 1), back());
                 HxSTL::copy_backward(pos, _finish, _finish + 1);
-                *pos = HxSTL::forward<T>(value);
+                *pos = HxSTL::forward<Y>(value);
             }
             ++_finish;
         }
         return _start + index;
     }
 
-    template <class T, class Alloc>
-    void deque<T, Alloc>::alloc_node_front(size_type count) {
+    template <class T, class Alloc, size_t BufSize>
+    void deque<T, Alloc, BufSize>::alloc_node_front(size_type count) {
         size_type remain_element =  _start._cur - _start._first;
         if (remain_element < count) {
             size_type add_num_nodes = (count - remain_element - 1) / iterator::buffer_size() + 1;
@@ -521,33 +586,34 @@ namespace HxSTL {
 
             map_pointer mp = _start._node - 1;
             for (size_type i = 0; i != add_num_nodes; ++i) {
-                mp[-i] = _alloc.allocate(iterator::buffer_size());
+                mp[-i] = allocate_node();
             }
         }
     }
 
-    template <class T, class Alloc>
-    void deque<T, Alloc>::alloc_node_back(size_type count) {
+    template <class T, class Alloc, size_t BufSize>
+    void deque<T, Alloc, BufSize>::alloc_node_back(size_type count) {
+        // _finish 不能停在缓冲区末尾, 恰好填满时也要再分配下一块
         size_type remain_element = _finish._last - _finish._cur;
-        if (remain_element < count) {
-            size_type add_num_nodes = (count - remain_element - 1) / iterator::buffer_size() + 1;
+        if (remain_element <= count) {
+            size_type add_num_nodes = (count - remain_element) / iterator::buffer_size() + 1;
 
-            size_type remain = remain_element + iterator::buffer_size() * (_map + _map_size - _finish._node);
-            if (remain < count) {
+            size_type remain = remain_element + iterator::buffer_size() * (_map + _map_size - _finish._node - 1);
+            if (remain <= count) {
                 reallocate_map(add_num_nodes, false);
             }
 
             map_pointer mp = _finish._node + 1;
             for (size_type i = 0; i != add_num_nodes; ++i) {
-                mp[i] = _alloc.allocate(iterator::buffer_size());
+                mp[i] = allocate_node();
             }
         }
     }
 
-    template <class T, class Alloc>
+    template <class T, class Alloc, size_t BufSize>
     template <class InputIt>
-    typename deque<T, Alloc>::iterator
-    deque<T, Alloc>::insert_aux(iterator pos, InputIt first, InputIt last, HxSTL::false_type) {
+    typename deque<T, Alloc, BufSize>::iterator
+    deque<T, Alloc, BufSize>::insert_aux(iterator pos, InputIt first, InputIt last, HxSTL::false_type) {
         if (first == last) return pos;
 
         size_type count = HxSTL::distance(first, last);
@@ -597,9 +663,9 @@ namespace HxSTL {
         }
     }
 
-    template <class T, class Alloc>
-    typename deque<T, Alloc>::iterator
-    deque<T, Alloc>::insert_aux(iterator pos, size_type count, const T& value, HxSTL::true_type) {
+    template <class T, class Alloc, size_t BufSize>
+    typename deque<T, Alloc, BufSize>::iterator
+    deque<T, Alloc, BufSize>::insert_aux(iterator pos, size_type count, const T& value, HxSTL::true_type) {
         size_type index = pos - _start;
         if (index < size() / 2) {
             alloc_node_front(count);
@@ -612,7 +678,7 @@ namespace HxSTL {
             } else if (index < count) {
                 HxSTL::uninitialized_copy_n(old_start, index, _start);
                 HxSTL::uninitialized_fill_n(_start + index, count - index, value);
-                HxSTL::fill_n(old_start, index, index);
+                HxSTL::fill_n(old_start, index, value);
             } else {
                 HxSTL::uninitialized_copy_n(old_start, count, _start);
                 HxSTL::copy_n(old_start + count, index - count, old_start);
@@ -644,25 +710,25 @@ namespace HxSTL {
         }
     }
 
-    template <class T, class Alloc>
-    void deque<T, Alloc>::dealloc_node_front(iterator new_start) {
+    template <class T, class Alloc, size_t BufSize>
+    void deque<T, Alloc, BufSize>::dealloc_node_front(iterator new_start) {
         for (map_pointer mp = _start._node, new_mp = new_start._node; mp != new_mp; ++mp) {
-            _alloc.deallocate(*mp, iterator::buffer_size());
+            deallocate_node(*mp);
         }
         _start = new_start;
     }
 
-    template <class T, class Alloc>
-    void deque<T, Alloc>::dealloc_node_back(iterator new_finish) {
+    template <class T, class Alloc, size_t BufSize>
+    void deque<T, Alloc, BufSize>::dealloc_node_back(iterator new_finish) {
         for (map_pointer mp = _finish._node, new_mp = new_finish._node; mp != new_mp; --mp) {
-            _alloc.deallocate(*mp, iterator::buffer_size());
+            deallocate_node(*mp);
         }
         _finish = new_finish;
     }
 
-    template <class T, class Alloc>
-    typename deque<T, Alloc>::iterator
-    deque<T, Alloc>::erase_aux(iterator pos) {
+    template <class T, class Alloc, size_t BufSize>
+    typename deque<T, Alloc, BufSize>::iterator
+    deque<T, Alloc, BufSize>::erase_aux(iterator pos) {
         size_type index = pos - _start;
         if (index < size() / 2) {
             if (pos != _start) {
@@ -674,15 +740,15 @@ namespace HxSTL {
             if (pos != _finish - 1) {
                 HxSTL::copy(pos + 1, _finish, pos);
             }
-            _alloc.destroy(&*_finish);
+            _alloc.destroy(&*(_finish - 1));
             dealloc_node_back(_finish - 1);
         }
         return _start + index;
     }
 
-    template <class T, class Alloc>
-    typename deque<T, Alloc>::iterator
-    deque<T, Alloc>::erase_aux(iterator first, iterator last) {
+    template <class T, class Alloc, size_t BufSize>
+    typename deque<T, Alloc, BufSize>::iterator
+    deque<T, Alloc, BufSize>::erase_aux(iterator first, iterator last) {
         if (first == last) return first;
 
         size_type count = last - first;
@@ -703,17 +769,17 @@ namespace HxSTL {
         return _start + index;
     }
 
-    template <class T, class Alloc>
+    template <class T, class Alloc, size_t BufSize>
     template <class... Args>
-    typename deque<T, Alloc>::iterator
-    deque<T, Alloc>::emplace(const_iterator pos, Args&&... args) {
+    typename deque<T, Alloc, BufSize>::iterator
+    deque<T, Alloc, BufSize>::emplace(const_iterator pos, Args&&... args) {
         size_type index = pos - _start;
         if (index < size() / 2) {
             if (_start._node == _map && _start._cur == _start._first) {
                 reallocate_map(1, true);
             }
             if (_start._cur == _start._first) {
-                *(_start._node - 1) = _alloc.allocate(iterator::buffer_size());
+                *(_start._node - 1) = allocate_node();
             }
             if (pos == _start) {
                 _alloc.construct(&*(--_start), HxSTL::forward<Args>(args)...);
@@ -725,11 +791,11 @@ namespace HxSTL {
                 --_start;
             }
         } else {
-            if (_finish._cur == _finish._last - 1 && _finish._node == _map + _map_size) {
+            if (_finish._cur == _finish._last - 1 && _finish._node + 1 == _map + _map_size) {
                 reallocate_map(1, false);
             }
             if (_finish._cur == _finish._last - 1) {
-                *(_finish._node + 1) = _alloc.allocate(iterator::buffer_size());
+                *(_finish._node + 1) = allocate_node();
             }
             if (pos == _finish) {
                 _alloc.construct(&*_finish, HxSTL::forward<Args>(args)...);
@@ -744,8 +810,33 @@ namespace HxSTL {
         return _start + index;
     }
 
-    template <class T, class Alloc>
-    void deque<T, Alloc>::create_map(size_type count) {
+    template <class T, class Alloc, size_t BufSize>
+    typename deque<T, Alloc, BufSize>::pointer
+    deque<T, Alloc, BufSize>::allocate_node() {
+        if (_num_spare != 0) {
+            return _spare[--_num_spare];
+        }
+        return _alloc.allocate(iterator::buffer_size());
+    }
+
+    template <class T, class Alloc, size_t BufSize>
+    void deque<T, Alloc, BufSize>::deallocate_node(pointer node) {
+        if (_num_spare != __SPARE_NODES) {
+            _spare[_num_spare++] = node;
+        } else {
+            _alloc.deallocate(node, iterator::buffer_size());
+        }
+    }
+
+    template <class T, class Alloc, size_t BufSize>
+    void deque<T, Alloc, BufSize>::release_spare() {
+        while (_num_spare != 0) {
+            _alloc.deallocate(_spare[--_num_spare], iterator::buffer_size());
+        }
+    }
+
+    template <class T, class Alloc, size_t BufSize>
+    void deque<T, Alloc, BufSize>::create_map(size_type count) {
         size_type num_nodes = count / iterator::buffer_size() + 1;
 
         _map_size = num_nodes > 6 ? num_nodes + 2 : 8;
@@ -755,7 +846,7 @@ namespace HxSTL {
         map_pointer finish = start + num_nodes - 1;
 
         for (map_pointer mp = start; mp <= finish; ++mp) {
-            *mp = _alloc.allocate(iterator::buffer_size());
+            *mp = allocate_node();
         }
 
         _start.set_node(start);
@@ -764,8 +855,8 @@ namespace HxSTL {
         _finish._cur = _finish._first + count % iterator::buffer_size();
     }
 
-    template <class T, class Alloc>
-    void deque<T, Alloc>::reallocate_map(size_type add_num_nodes, bool add_at_front) {
+    template <class T, class Alloc, size_t BufSize>
+    void deque<T, Alloc, BufSize>::reallocate_map(size_type add_num_nodes, bool add_at_front) {
         size_type old_num_nodes = _finish._node - _start._node + 1;
         size_type new_num_nodes = old_num_nodes + add_num_nodes;
 
@@ -794,13 +885,13 @@ namespace HxSTL {
         _finish._node = new_start + old_num_nodes - 1;
     }
 
-    template <class T, class Alloc>
-    bool operator==(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
+    template <class T, class Alloc, size_t BufSize>
+    bool operator==(const deque<T, Alloc, BufSize> &lhs, const deque<T, Alloc, BufSize> &rhs) {
         return lhs.size() == rhs.size() && HxSTL::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
-    template <class T, class Alloc>
-    bool operator!=(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
+    template <class T, class Alloc, size_t BufSize>
+    bool operator!=(const deque<T, Alloc, BufSize> &lhs, const deque<T, Alloc, BufSize> &rhs) {
         return !(lhs == rhs);
     }
 
@@ -0,0 +1,822 @@
+#ifndef _EXECUTION_H_
+#define _EXECUTION_H_
+
+
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+#include "algorithm.h"
+#include "allocator.h"
+#include "functional.h"
+#include "iterator.h"
+#include "thread_pool.h"
+#include "type_traits.h"
+#include "vector.h"
+
+
+namespace HxSTL {
+
+    namespace execution {
+
+        struct sequenced_policy {};
+
+        struct parallel_policy {};
+
+        // 目前与 parallel_policy 相同, 块内循环本身就是可以被向量化的普通循环
+        struct parallel_unsequenced_policy {};
+
+        constexpr sequenced_policy              seq{};
+        constexpr parallel_policy               par{};
+        constexpr parallel_unsequenced_policy   par_unseq{};
+
+    }
+
+    template <class T>
+    struct is_execution_policy: public false_type {};
+
+    template <>
+    struct is_execution_policy<execution::sequenced_policy>: public true_type {};
+
+    template <>
+    struct is_execution_policy<execution::parallel_policy>: public true_type {};
+
+    template <>
+    struct is_execution_policy<execution::parallel_unsequenced_policy>: public true_type {};
+
+    // 带执行策略的重载只在第一个参数是执行策略时参与重载决议
+    template <class ExecutionPolicy, class T>
+    struct __enable_if_execution_policy: public enable_if<
+        is_execution_policy<typename decay<ExecutionPolicy>::type>::value, T> {};
+
+    template <class ExecutionPolicy>
+    struct __is_parallel_policy: public integeral_constant<bool,
+        !is_same<typename decay<ExecutionPolicy>::type, execution::sequenced_policy>::value> {};
+
+    template <class Iterator>
+    struct __is_random_access_iterator: public is_same<
+        typename iterator_traits<Iterator>::iterator_category, random_access_iterator_tag> {};
+
+    // 并行策略并且所有迭代器都可随机访问时才并行执行, 否则退回顺序版本
+    template <class ExecutionPolicy, class Iterator1, class Iterator2 = Iterator1, class Iterator3 = Iterator1>
+    struct __parallel_dispatch: public integeral_constant<bool,
+        __is_parallel_policy<ExecutionPolicy>::value
+        && __is_random_access_iterator<Iterator1>::value
+        && __is_random_access_iterator<Iterator2>::value
+        && __is_random_access_iterator<Iterator3>::value> {};
+
+    // 小于一个粒度的区间不拆分, 拆分和调度的开销会超过收益
+    const size_t __parallel_grain = 4096;
+
+    // 分块数: 每个线程约 4 块, 用于平衡各块耗时不均
+    inline size_t __parallel_chunk_count(size_t n, size_t grain) {
+        size_t chunks = n / grain;
+        size_t limit = (thread_pool::default_pool().size() + 1) * 4;
+        if (chunks > limit) {
+            chunks = limit;
+        }
+        return chunks == 0 ? 1 : chunks;
+    }
+
+    // 第 i 块的起点, 前 n % chunks 块各多一个元素
+    inline size_t __parallel_chunk_begin(size_t n, size_t chunks, size_t i) {
+        return i * (n / chunks) + (i < n % chunks ? i : n % chunks);
+    }
+
+    // 对每块调用 fn(i, begin, end), 第 0 块在调用线程上执行
+    template <class Function>
+    void __parallel_for_chunks(size_t n, size_t chunks, Function& fn) {
+        if (chunks <= 1) {
+            fn(size_t(0), size_t(0), n);
+            return;
+        }
+        task_group group;
+        for (size_t i = 1; i < chunks; ++i) {
+            size_t b = __parallel_chunk_begin(n, chunks, i);
+            size_t e = __parallel_chunk_begin(n, chunks, i + 1);
+            Function* f = &fn;
+            group.spawn([f, i, b, e]() { (*f)(i, b, e); });
+        }
+        // 第 0 块抛出异常时, group 的析构函数会等其余任务结束, 它们引用了本栈帧
+        fn(size_t(0), size_t(0), __parallel_chunk_begin(n, chunks, 1));
+        group.wait();
+    }
+
+    // 对 [0, n) 按块调用 fn(begin, end), 块的大小不小于 grain, 由线程池对半拆分并窃取
+    template <class Function>
+    void __parallel_for(size_t n, size_t grain, Function fn) {
+        thread_pool& pool = thread_pool::default_pool();
+        size_t adaptive = n / ((pool.size() + 1) * 8);
+        parallel_for_range(pool, size_t(0), n, fn, grain > adaptive ? grain : adaptive);
+    }
+
+    /*
+     * for_each
+     */
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryFunction>
+    inline void __for_each_policy(ExecutionPolicy&&, ForwardIt first, ForwardIt last, UnaryFunction f, false_type) {
+        HxSTL::for_each(first, last, f);
+    }
+
+    template <class ExecutionPolicy, class RandomIt, class UnaryFunction>
+    void __for_each_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, UnaryFunction f, true_type) {
+        __parallel_for(last - first, __parallel_grain, [first, &f](size_t b, size_t e) {
+            HxSTL::for_each(first + b, first + e, f);
+        });
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryFunction>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, void>::type
+    for_each(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryFunction f) {
+        __for_each_policy(policy, first, last, f, typename __parallel_dispatch<ExecutionPolicy, ForwardIt>::type());
+    }
+
+    /*
+     * transform
+     */
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class UnaryOperation>
+    inline ForwardIt2 __transform_policy(ExecutionPolicy&&, ForwardIt1 first, ForwardIt1 last,
+            ForwardIt2 result, UnaryOperation op, false_type) {
+        return HxSTL::transform(first, last, result, op);
+    }
+
+    template <class ExecutionPolicy, class RandomIt1, class RandomIt2, class UnaryOperation>
+    RandomIt2 __transform_policy(ExecutionPolicy&&, RandomIt1 first, RandomIt1 last,
+            RandomIt2 result, UnaryOperation op, true_type) {
+        __parallel_for(last - first, __parallel_grain, [first, result, &op](size_t b, size_t e) {
+            HxSTL::transform(first + b, first + e, result + b, op);
+        });
+        return result + (last - first);
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class UnaryOperation>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt2>::type
+    transform(ExecutionPolicy&& policy, ForwardIt1 first, ForwardIt1 last, ForwardIt2 result, UnaryOperation op) {
+        return __transform_policy(policy, first, last, result, op,
+            typename __parallel_dispatch<ExecutionPolicy, ForwardIt1, ForwardIt2>::type());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class ForwardIt3, class BinaryOperation>
+    inline ForwardIt3 __transform_policy(ExecutionPolicy&&, ForwardIt1 first1, ForwardIt1 last1,
+            ForwardIt2 first2, ForwardIt3 result, BinaryOperation op, false_type) {
+        return HxSTL::transform(first1, last1, first2, result, op);
+    }
+
+    template <class ExecutionPolicy, class RandomIt1, class RandomIt2, class RandomIt3, class BinaryOperation>
+    RandomIt3 __transform_policy(ExecutionPolicy&&, RandomIt1 first1, RandomIt1 last1,
+            RandomIt2 first2, RandomIt3 result, BinaryOperation op, true_type) {
+        __parallel_for(last1 - first1, __parallel_grain, [first1, first2, result, &op](size_t b, size_t e) {
+            HxSTL::transform(first1 + b, first1 + e, first2 + b, result + b, op);
+        });
+        return result + (last1 - first1);
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class ForwardIt3, class BinaryOperation>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt3>::type
+    transform(ExecutionPolicy&& policy, ForwardIt1 first1, ForwardIt1 last1,
+            ForwardIt2 first2, ForwardIt3 result, BinaryOperation op) {
+        return __transform_policy(policy, first1, last1, first2, result, op,
+            typename __parallel_dispatch<ExecutionPolicy, ForwardIt1, ForwardIt2, ForwardIt3>::type());
+    }
+
+    /*
+     * fill
+     */
+
+    template <class ExecutionPolicy, class ForwardIt, class T>
+    inline void __fill_policy(ExecutionPolicy&&, ForwardIt first, ForwardIt last, const T& value, false_type) {
+        HxSTL::fill(first, last, value);
+    }
+
+    template <class ExecutionPolicy, class RandomIt, class T>
+    void __fill_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, const T& value, true_type) {
+        __parallel_for(last - first, __parallel_grain, [first, &value](size_t b, size_t e) {
+            HxSTL::fill(first + b, first + e, value);
+        });
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class T>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, void>::type
+    fill(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, const T& value) {
+        __fill_policy(policy, first, last, value, typename __parallel_dispatch<ExecutionPolicy, ForwardIt>::type());
+    }
+
+    /*
+     * copy
+     */
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2>
+    inline ForwardIt2 __copy_policy(ExecutionPolicy&&, ForwardIt1 first, ForwardIt1 last, ForwardIt2 result, false_type) {
+        return HxSTL::copy(first, last, result);
+    }
+
+    template <class ExecutionPolicy, class RandomIt1, class RandomIt2>
+    RandomIt2 __copy_policy(ExecutionPolicy&&, RandomIt1 first, RandomIt1 last, RandomIt2 result, true_type) {
+        __parallel_for(last - first, __parallel_grain, [first, result](size_t b, size_t e) {
+            HxSTL::copy(first + b, first + e, result + b);
+        });
+        return result + (last - first);
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt2>::type
+    copy(ExecutionPolicy&& policy, ForwardIt1 first, ForwardIt1 last, ForwardIt2 result) {
+        return __copy_policy(policy, first, last, result,
+            typename __parallel_dispatch<ExecutionPolicy, ForwardIt1, ForwardIt2>::type());
+    }
+
+    /*
+     * count_if
+     */
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate>
+    inline typename iterator_traits<ForwardIt>::difference_type
+    __count_if_policy(ExecutionPolicy&&, ForwardIt first, ForwardIt last, UnaryPredicate pred, false_type) {
+        return HxSTL::count_if(first, last, pred);
+    }
+
+    template <class ExecutionPolicy, class RandomIt, class UnaryPredicate>
+    typename iterator_traits<RandomIt>::difference_type
+    __count_if_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, UnaryPredicate pred, true_type) {
+        std::atomic<size_t> total(0);
+        __parallel_for(last - first, __parallel_grain, [first, &pred, &total](size_t b, size_t e) {
+            total.fetch_add(HxSTL::count_if(first + b, first + e, pred), std::memory_order_relaxed);
+        });
+        return total.load();
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate>
+    inline typename __enable_if_execution_policy<ExecutionPolicy,
+        typename iterator_traits<ForwardIt>::difference_type>::type
+    count_if(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate pred) {
+        return __count_if_policy(policy, first, last, pred, typename __parallel_dispatch<ExecutionPolicy, ForwardIt>::type());
+    }
+
+    /*
+     * find_if find_if_not find all_of any_of none_of
+     */
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate>
+    inline ForwardIt __find_if_policy(ExecutionPolicy&&, ForwardIt first, ForwardIt last, UnaryPredicate pred, false_type) {
+        return HxSTL::find_if(first, last, pred);
+    }
+
+    // 各块按小段扫描, 已找到的最小下标在本段之前时提前结束
+    template <class ExecutionPolicy, class RandomIt, class UnaryPredicate>
+    RandomIt __find_if_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, UnaryPredicate pred, true_type) {
+        const size_t n = last - first;
+        const size_t step = 1024;
+        std::atomic<size_t> found(n);
+        __parallel_for(n, __parallel_grain, [first, &pred, &found, step](size_t b, size_t e) {
+            for (; b < e && b < found.load(std::memory_order_relaxed); b += step) {
+                size_t stop = e - b < step ? e : b + step;
+                size_t pos = HxSTL::find_if(first + b, first + stop, pred) - first;
+                if (pos != stop) {
+                    size_t current = found.load(std::memory_order_relaxed);
+                    while (pos < current && !found.compare_exchange_weak(current, pos)) {}
+                    return;
+                }
+            }
+        });
+        return first + found.load();
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt>::type
+    find_if(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate pred) {
+        return __find_if_policy(policy, first, last, pred, typename __parallel_dispatch<ExecutionPolicy, ForwardIt>::type());
+    }
+
+    template <class UnaryPredicate>
+    struct __negate_predicate {
+        UnaryPredicate pred;
+
+        template <class T>
+        bool operator()(const T& value) { return !pred(value); }
+    };
+
+    template <class T>
+    struct __equal_to_value {
+        const T* value;
+
+        template <class U>
+        bool operator()(const U& x) const { return x == *value; }
+    };
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt>::type
+    find_if_not(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate pred) {
+        __negate_predicate<UnaryPredicate> not_pred = { pred };
+        return HxSTL::find_if(policy, first, last, not_pred);
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class T>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt>::type
+    find(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, const T& value) {
+        __equal_to_value<T> pred = { &value };
+        return HxSTL::find_if(policy, first, last, pred);
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, bool>::type
+    all_of(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate pred) {
+        return HxSTL::find_if_not(policy, first, last, pred) == last;
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, bool>::type
+    any_of(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate pred) {
+        return HxSTL::find_if(policy, first, last, pred) != last;
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, bool>::type
+    none_of(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate pred) {
+        return HxSTL::find_if(policy, first, last, pred) == last;
+    }
+
+    /*
+     * min_element max_element
+     */
+
+    template <class ExecutionPolicy, class ForwardIt, class Compare>
+    inline ForwardIt __min_element_policy(ExecutionPolicy&&, ForwardIt first, ForwardIt last, Compare comp, false_type) {
+        return HxSTL::min_element(first, last, comp);
+    }
+
+    // 各块的最小值再归约, 相等时取下标小的, 与顺序版本返回第一个最小值一致
+    template <class ExecutionPolicy, class RandomIt, class Compare>
+    RandomIt __min_element_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, Compare comp, true_type) {
+        const size_t n = last - first;
+        size_t best = n;
+        std::mutex mutex;
+        __parallel_for(n, __parallel_grain, [first, n, &comp, &best, &mutex](size_t b, size_t e) {
+            size_t pos = HxSTL::min_element(first + b, first + e, comp) - first;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (best == n || comp(*(first + pos), *(first + best))
+                    || (pos < best && !comp(*(first + best), *(first + pos)))) {
+                best = pos;
+            }
+        });
+        return first + best;
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class Compare>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt>::type
+    min_element(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp) {
+        return __min_element_policy(policy, first, last, comp, typename __parallel_dispatch<ExecutionPolicy, ForwardIt>::type());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt>::type
+    min_element(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last) {
+        return HxSTL::min_element(policy, first, last, HxSTL::less<typename iterator_traits<ForwardIt>::value_type>());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class Compare>
+    inline ForwardIt __max_element_policy(ExecutionPolicy&&, ForwardIt first, ForwardIt last, Compare comp, false_type) {
+        return HxSTL::max_element(first, last, comp);
+    }
+
+    template <class ExecutionPolicy, class RandomIt, class Compare>
+    RandomIt __max_element_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, Compare comp, true_type) {
+        const size_t n = last - first;
+        size_t best = n;
+        std::mutex mutex;
+        __parallel_for(n, __parallel_grain, [first, n, &comp, &best, &mutex](size_t b, size_t e) {
+            size_t pos = HxSTL::max_element(first + b, first + e, comp) - first;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (best == n || comp(*(first + best), *(first + pos))
+                    || (pos < best && !comp(*(first + pos), *(first + best)))) {
+                best = pos;
+            }
+        });
+        return first + best;
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class Compare>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt>::type
+    max_element(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp) {
+        return __max_element_policy(policy, first, last, comp, typename __parallel_dispatch<ExecutionPolicy, ForwardIt>::type());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt>::type
+    max_element(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last) {
+        return HxSTL::max_element(policy, first, last, HxSTL::less<typename iterator_traits<ForwardIt>::value_type>());
+    }
+
+    /*
+     * partition
+     */
+
+    // 若干个不相交区间首尾相接构成的序列, 用于在两组区间之间按位置一一交换
+    struct __partition_ranges {
+        HxSTL::vector<size_t> begin;
+        HxSTL::vector<size_t> prefix;   // prefix[i] 为前 i 个区间的总长度
+
+        __partition_ranges() { prefix.push_back(0); }
+
+        void push_back(size_t b, size_t e) {
+            if (b < e) {
+                begin.push_back(b);
+                prefix.push_back(prefix.back() + (e - b));
+            }
+        }
+
+        // 序列中第 k 个位置所在的区间
+        size_t range_of(size_t k) const {
+            size_t lo = 0, hi = begin.size();
+            while (hi - lo > 1) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (prefix[mid] <= k) {
+                    lo = mid;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo;
+        }
+    };
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate>
+    inline ForwardIt __partition_policy(ExecutionPolicy&&, ForwardIt first, ForwardIt last, UnaryPredicate pred, false_type) {
+        return HxSTL::partition(first, last, pred);
+    }
+
+    // 各块先各自划分, 满足条件的元素总数为 t; [0, t) 中不满足的元素与 [t, n) 中满足的元素
+    // 个数相同, 再把两者按位置并行地一一交换
+    template <class ExecutionPolicy, class RandomIt, class UnaryPredicate>
+    RandomIt __partition_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, UnaryPredicate pred, true_type) {
+        const size_t n = last - first;
+        const size_t chunks = __parallel_chunk_count(n, __parallel_grain);
+        if (chunks <= 1) {
+            return HxSTL::partition(first, last, pred);
+        }
+        HxSTL::vector<size_t> middle(chunks);
+        auto chunk = [first, &pred, &middle](size_t i, size_t b, size_t e) {
+            middle[i] = HxSTL::partition(first + b, first + e, pred) - first;
+        };
+        __parallel_for_chunks(n, chunks, chunk);
+
+        size_t t = 0;
+        for (size_t i = 0; i < chunks; ++i) {
+            t += middle[i] - __parallel_chunk_begin(n, chunks, i);
+        }
+        __partition_ranges left, right;
+        for (size_t i = 0; i < chunks; ++i) {
+            size_t b = __parallel_chunk_begin(n, chunks, i);
+            size_t e = __parallel_chunk_begin(n, chunks, i + 1);
+            left.push_back(middle[i], e < t ? e : t);
+            right.push_back(b > t ? b : t, middle[i]);
+        }
+        if (left.prefix.back() == 0) {
+            return first + t;
+        }
+        __parallel_for(left.prefix.back(), __parallel_grain, [first, &left, &right](size_t b, size_t e) {
+            size_t l = left.range_of(b), r = right.range_of(b);
+            size_t lpos = left.begin[l] + (b - left.prefix[l]);
+            size_t rpos = right.begin[r] + (b - right.prefix[r]);
+            for (size_t k = b; k < e; ++k) {
+                if (k == left.prefix[l + 1]) {
+                    lpos = left.begin[++l];
+                }
+                if (k == right.prefix[r + 1]) {
+                    rpos = right.begin[++r];
+                }
+                HxSTL::iter_swap(first + lpos++, first + rpos++);
+            }
+        });
+        return first + t;
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt>::type
+    partition(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate pred) {
+        return __partition_policy(policy, first, last, pred, typename __parallel_dispatch<ExecutionPolicy, ForwardIt>::type());
+    }
+
+    /*
+     * sort
+     */
+
+    // 归并路径划分: 返回 i, 使 a[0, i) 与 b[0, k - i) 恰为 a, b 稳定归并后的前 k 个元素
+    template <class RandomIt1, class RandomIt2, class Compare>
+    size_t __merge_path(RandomIt1 a, size_t na, RandomIt2 b, size_t nb, size_t k, Compare& comp) {
+        size_t lo = k > nb ? k - nb : 0;
+        size_t hi = k < na ? k : na;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (comp(*(b + (k - mid - 1)), *(a + mid))) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        return lo;
+    }
+
+    // 把 a[i, ia) 与 b[j, jb) 稳定地归并, 移动到 result
+    template <class RandomIt1, class RandomIt2, class OutputIt, class Compare>
+    void __move_merge(RandomIt1 a, size_t i, size_t ia, RandomIt2 b, size_t j, size_t jb,
+            OutputIt result, Compare& comp) {
+        while (i < ia && j < jb) {
+            if (comp(*(b + j), *(a + i))) {
+                *result = HxSTL::move(*(b + j++));
+            } else {
+                *result = HxSTL::move(*(a + i++));
+            }
+            ++result;
+        }
+        result = HxSTL::move(a + i, a + ia, result);
+        HxSTL::move(b + j, b + jb, result);
+    }
+
+    // 位置 pos 所在的一对待归并段 [lo, mid) [mid, hi), 每段 width 块
+    inline void __merge_pair_of(size_t n, size_t chunks, size_t width, size_t pos,
+            size_t& lo, size_t& mid, size_t& hi) {
+        size_t q = n / chunks, r = n % chunks;
+        size_t chunk = pos < (q + 1) * r ? pos / (q + 1) : r + (pos - (q + 1) * r) / q;
+        size_t pair = chunk / (2 * width) * (2 * width);
+        lo = __parallel_chunk_begin(n, chunks, pair);
+        mid = __parallel_chunk_begin(n, chunks, pair + width < chunks ? pair + width : chunks);
+        hi = __parallel_chunk_begin(n, chunks, pair + 2 * width < chunks ? pair + 2 * width : chunks);
+    }
+
+    // 一轮归并: 相邻的每 width 块为一段, 两两归并到 result
+    // 按输出位置分块并行, 每块用归并路径定出它在两段中的起止位置, 只比较和移动自己的元素;
+    // 归并会移走源元素, 所以全部划分点要在任何任务开始移动之前算好
+    template <class RandomIt1, class RandomIt2, class Compare>
+    void __parallel_merge_round(RandomIt1 first, RandomIt2 result, size_t n, size_t chunks,
+            size_t width, Compare& comp) {
+        const size_t pieces = __parallel_chunk_count(n, __parallel_grain);
+        HxSTL::vector<size_t> split(pieces + 1);
+        for (size_t p = 0; p < pieces; ++p) {
+            size_t b = __parallel_chunk_begin(n, pieces, p), lo, mid, hi;
+            __merge_pair_of(n, chunks, width, b, lo, mid, hi);
+            split[p] = __merge_path(first + lo, mid - lo, first + mid, hi - mid, b - lo, comp);
+        }
+        auto piece = [=, &comp, &split](size_t p, size_t b, size_t e) {
+            while (b < e) {
+                size_t lo, mid, hi;
+                __merge_pair_of(n, chunks, width, b, lo, mid, hi);
+                size_t stop = e < hi ? e : hi;
+                // 只有第一对可能从中间开始, 只有最后一对可能在中间结束
+                size_t i = b == lo ? 0 : split[p];
+                size_t ie = stop == hi ? mid - lo : split[p + 1];
+                __move_merge(first + lo, i, ie, first + mid, b - lo - i, stop - lo - ie, result + b, comp);
+                b = stop;
+            }
+        };
+        __parallel_for_chunks(n, pieces, piece);
+    }
+
+    // 临时缓冲区, 按块并行地从原区间移动构造
+    template <class T>
+    struct __parallel_buffer {
+        HxSTL::allocator<T> alloc;
+        T* data;
+        size_t size;
+        size_t chunks;
+        HxSTL::vector<char> built;      // 各块是否已构造
+
+        __parallel_buffer(size_t n, size_t chunks): data(alloc.allocate(n)), size(n), chunks(chunks), built(chunks, char(0)) {}
+
+        ~__parallel_buffer() {
+            for (size_t i = 0; i < chunks; ++i) {
+                if (built[i]) {
+                    HxSTL::destroy(alloc, data + __parallel_chunk_begin(size, chunks, i),
+                        data + __parallel_chunk_begin(size, chunks, i + 1));
+                }
+            }
+            alloc.deallocate(data, size);
+        }
+
+        template <class RandomIt>
+        void construct(RandomIt first) {
+            auto chunk = [this, first](size_t i, size_t b, size_t e) {
+                size_t k = b;
+                try {
+                    for (; k < e; ++k) {
+                        HxSTL::construct(data + k, HxSTL::move(*(first + k)));
+                    }
+                } catch (...) {
+                    HxSTL::destroy(alloc, data + b, data + k);
+                    throw;
+                }
+                built[i] = 1;
+            };
+            __parallel_for_chunks(size, chunks, chunk);
+        }
+    };
+
+    template <class ExecutionPolicy, class RandomIt, class Compare>
+    inline void __sort_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, Compare comp, false_type) {
+        HxSTL::sort(first, last, comp);
+    }
+
+    // 并行归并排序: 各块先用 introsort 排序, 再经过 log(chunks) 轮并行归并;
+    // 每轮在原区间与临时缓冲区之间交替, 最后若结果在缓冲区中则移回原区间
+    template <class ExecutionPolicy, class RandomIt, class Compare>
+    void __sort_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, Compare comp, true_type) {
+        typedef typename iterator_traits<RandomIt>::value_type value_type;
+        const size_t n = last - first;
+        size_t limit = __parallel_chunk_count(n, __parallel_grain);
+        size_t chunks = 1;
+        while (chunks * 2 <= limit) {
+            chunks *= 2;
+        }
+        if (chunks <= 1) {
+            HxSTL::sort(first, last, comp);
+            return;
+        }
+        auto chunk = [first, &comp](size_t, size_t b, size_t e) {
+            HxSTL::sort(first + b, first + e, comp);
+        };
+        __parallel_for_chunks(n, chunks, chunk);
+
+        __parallel_buffer<value_type> buffer(n, chunks);
+        buffer.construct(first);
+        bool in_buffer = true;
+        for (size_t width = 1; width < chunks; width *= 2) {
+            if (in_buffer) {
+                __parallel_merge_round(buffer.data, first, n, chunks, width, comp);
+            } else {
+                __parallel_merge_round(first, buffer.data, n, chunks, width, comp);
+            }
+            in_buffer = !in_buffer;
+        }
+        if (in_buffer) {
+            value_type* data = buffer.data;
+            __parallel_for(n, __parallel_grain, [data, first](size_t b, size_t e) {
+                HxSTL::move(data + b, data + e, first + b);
+            });
+        }
+    }
+
+    template <class ExecutionPolicy, class RandomIt, class Compare>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, void>::type
+    sort(ExecutionPolicy&& policy, RandomIt first, RandomIt last, Compare comp) {
+        __sort_policy(policy, first, last, comp, typename __parallel_dispatch<ExecutionPolicy, RandomIt>::type());
+    }
+
+    template <class ExecutionPolicy, class RandomIt>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, void>::type
+    sort(ExecutionPolicy&& policy, RandomIt first, RandomIt last) {
+        HxSTL::sort(policy, first, last, HxSTL::less<typename iterator_traits<RandomIt>::value_type>());
+    }
+
+
+    /*
+     * nth_element partial_sort
+     */
+
+    template <class ExecutionPolicy, class RandomIt, class Compare>
+    inline void __nth_element_policy(ExecutionPolicy&&, RandomIt first, RandomIt nth, 
+            RandomIt last, Compare comp, false_type) {
+        HxSTL::nth_element(first, nth, last, comp);
+    }
+
+    // 每轮用并行 partition 把区间分成小于 / 等于 / 大于枢轴的三段, 只进入 nth 所在的一段;
+    // 枢轴取自区间本身, 所以等于段非空, 每轮都会缩小; 区间小于几个粒度后交给顺序的 introselect
+    template <class ExecutionPolicy, class RandomIt, class Compare>
+    void __nth_element_policy(ExecutionPolicy&& policy, RandomIt first, RandomIt nth, 
+            RandomIt last, Compare comp, true_type) {
+        typedef typename iterator_traits<RandomIt>::value_type value_type;
+        size_t limit = __lg(last - first) * 2;
+        while (static_cast<size_t>(last - first) > __parallel_grain * 4 && limit > 0) {
+            --limit;
+            value_type pivot = __median(*first, *(first + (last - first) / 2), *(last - 1), comp);
+            RandomIt lo = __partition_policy(policy, first, last, 
+                [&comp, &pivot](const value_type& x) { return comp(x, pivot); }, true_type());
+            if (nth < lo) {
+                last = lo;
+                continue;
+            }
+            RandomIt hi = __partition_policy(policy, lo, last, 
+                [&comp, &pivot](const value_type& x) { return !comp(pivot, x); }, true_type());
+            if (nth < hi) {
+                return;
+            }
+            first = hi;
+        }
+        HxSTL::nth_element(first, nth, last, comp);
+    }
+
+    template <class ExecutionPolicy, class RandomIt, class Compare>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, void>::type
+    nth_element(ExecutionPolicy&& policy, RandomIt first, RandomIt nth, RandomIt last, Compare comp) {
+        if (first == last || nth == last) {
+            return;
+        }
+        __nth_element_policy(policy, first, nth, last, comp, 
+            typename __parallel_dispatch<ExecutionPolicy, RandomIt>::type());
+    }
+
+    template <class ExecutionPolicy, class RandomIt>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, void>::type
+    nth_element(ExecutionPolicy&& policy, RandomIt first, RandomIt nth, RandomIt last) {
+        HxSTL::nth_element(policy, first, nth, last, HxSTL::less<typename iterator_traits<RandomIt>::value_type>());
+    }
+
+    // 前 k 个: 先并行选出第 k 小的位置, 左侧恰好是最小的 k 个, 再并行排序左侧
+    template <class ExecutionPolicy, class RandomIt, class Compare>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, void>::type
+    partial_sort(ExecutionPolicy&& policy, RandomIt first, RandomIt middle, RandomIt last, Compare comp) {
+        if (first == middle) {
+            return;
+        }
+        HxSTL::nth_element(policy, first, middle - 1, last, comp);
+        HxSTL::sort(policy, first, middle - 1, comp);
+    }
+
+    template <class ExecutionPolicy, class RandomIt>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, void>::type
+    partial_sort(ExecutionPolicy&& policy, RandomIt first, RandomIt middle, RandomIt last) {
+        HxSTL::partial_sort(policy, first, middle, last, HxSTL::less<typename iterator_traits<RandomIt>::value_type>());
+    }
+
+    /*
+     * shuffle
+     */
+
+    template <class ExecutionPolicy, class RandomIt, class URBG>
+    inline void __shuffle_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, URBG& gen, false_type) {
+        HxSTL::shuffle(first, last, gen);
+    }
+
+    // 每个元素独立均匀地选一个桶, 按桶分发后再把各桶分别打乱: 落桶独立且均匀, 桶内又是均匀排列,
+    // 所以整体仍是均匀排列. 每块 (之后是每个桶) 一个引擎, 由 gen 生成的种子依次 jump 得到,
+    // 序列互不重叠; 结果由 gen 的状态与块数共同决定
+    template <class ExecutionPolicy, class RandomIt, class URBG>
+    void __shuffle_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, URBG& gen, true_type) {
+        typedef typename iterator_traits<RandomIt>::value_type value_type;
+        const size_t n = last - first;
+        const size_t chunks = __parallel_chunk_count(n, __parallel_grain);
+        if (chunks <= 1) {
+            HxSTL::shuffle(first, last, gen);
+            return;
+        }
+        HxSTL::vector<xoshiro256starstar> engines;
+        engines.reserve(chunks);
+        xoshiro256starstar engine(__random_u64(gen));
+        for (size_t i = 0; i < chunks; ++i) {
+            engines.push_back(engine);
+            engine.jump();
+        }
+
+        // offset[i * chunks + j] 先是第 i 块落入桶 j 的元素个数, 再变为它们在结果中的起始位置
+        HxSTL::vector<uint32_t> bucket(n);
+        HxSTL::vector<size_t> offset(chunks * chunks, size_t(0));
+        auto count = [chunks, &engines, &bucket, &offset](size_t i, size_t b, size_t e) {
+            xoshiro256starstar g = engines[i];
+            size_t* cnt = offset.begin() + i * chunks;
+            for (size_t k = b; k < e; ++k) {
+                uint32_t j = static_cast<uint32_t>(__random_below(g, chunks, integeral_constant<int, 64>()));
+                bucket[k] = j;
+                ++cnt[j];
+            }
+            engines[i] = g;
+        };
+        __parallel_for_chunks(n, chunks, count);
+
+        HxSTL::vector<size_t> bucket_begin(chunks + 1);
+        size_t pos = 0;
+        for (size_t j = 0; j < chunks; ++j) {
+            bucket_begin[j] = pos;
+            for (size_t i = 0; i < chunks; ++i) {
+                size_t c = offset[i * chunks + j];
+                offset[i * chunks + j] = pos;
+                pos += c;
+            }
+        }
+        bucket_begin[chunks] = n;
+
+        __parallel_buffer<value_type> buffer(n, chunks);
+        buffer.construct(first);
+        value_type* data = buffer.data;
+        auto scatter = [first, chunks, data, &bucket, &offset](size_t i, size_t b, size_t e) {
+            size_t* next = offset.begin() + i * chunks;
+            for (size_t k = b; k < e; ++k) {
+                *(first + next[bucket[k]]++) = HxSTL::move(data[k]);
+            }
+        };
+        __parallel_for_chunks(n, chunks, scatter);
+
+        auto shuffle_bucket = [first, &engines, &bucket_begin](size_t j, size_t, size_t) {
+            HxSTL::shuffle(first + bucket_begin[j], first + bucket_begin[j + 1], engines[j]);
+        };
+        __parallel_for_chunks(chunks, chunks, shuffle_bucket);
+    }
+
+    template <class ExecutionPolicy, class RandomIt, class URBG>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, void>::type
+    shuffle(ExecutionPolicy&& policy, RandomIt first, RandomIt last, URBG&& gen) {
+        __shuffle_policy(policy, first, last, gen, typename __parallel_dispatch<ExecutionPolicy, RandomIt>::type());
+    }
+
+}
+
+
+#endif
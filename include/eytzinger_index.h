@@ -0,0 +1,149 @@
+#ifndef _EYTZINGER_INDEX_H_
+#define _EYTZINGER_INDEX_H_
+
+
+#include <stddef.h>
+#include "vector.h"
+#include "functional.h"
+
+
+namespace HxSTL {
+
+    // 只读的有序查找表, 元素按 Eytzinger (BFS) 顺序存放: 节点 k 的孩子是 2k 与 2k + 1
+    // 经典二分的前几轮访问的位置彼此相距很远, 每一轮都是一次缓存缺失; 这里查找路径上的前几层集中在
+    // 数组开头, 始终留在缓存里, 而节点 k 往下若干层的后代挤在同一条缓存行, 可以提前预取
+    // 构造时传入有序的 vector, 查找返回元素在原 vector 中的下标, 因此可以用来索引与之平行的数据
+    template <class T, class Compare = less<T> >
+    class eytzinger_index {
+    public:
+        typedef T                   value_type;
+        typedef size_t              size_type;
+        typedef Compare             value_compare;
+
+    protected:
+        vector<T> _tree;            // _tree[k - 1] 是编号为 k 的节点
+        size_type _levels;          // 树的层数
+        size_type _last_level;      // 最后一层实际存在的节点数
+        Compare _comp;
+
+    public:
+        eytzinger_index(): _levels(0), _last_level(0) {}
+
+        explicit eytzinger_index(const vector<T>& sorted, const Compare& comp = Compare());
+
+        size_type size() const { return _tree.size(); }
+
+        bool empty() const { return _tree.empty(); }
+
+        // 第一个不小于 key 的元素在原 vector 中的下标, 不存在时返回 size()
+        size_type lower_bound(const T& key) const;
+
+        // 第一个大于 key 的元素在原 vector 中的下标, 不存在时返回 size()
+        size_type upper_bound(const T& key) const;
+
+        bool contains(const T& key) const;
+
+    protected:
+        size_type rank(size_type k) const;
+
+        size_type descend_result(size_type k) const;
+
+        static size_type prefetch_stride();
+    };
+
+    template <class T, class Compare>
+    eytzinger_index<T, Compare>::eytzinger_index(const vector<T>& sorted, const Compare& comp):
+            _levels(0), _last_level(0), _comp(comp) {
+        const size_type n = sorted.size();
+        while ((static_cast<size_type>(1) << _levels) <= n) {
+            ++_levels;
+        }
+        if (n != 0) {
+            _last_level = n - (static_cast<size_type>(1) << (_levels - 1)) + 1;
+        }
+        _tree.reserve(n);
+        for (size_type k = 1; k <= n; ++k) {
+            _tree.push_back(sorted[rank(k)]);
+        }
+    }
+
+    template <class T, class Compare>
+    typename eytzinger_index<T, Compare>::size_type eytzinger_index<T, Compare>::rank(size_type k) const {
+        // 先按满二叉树算中序位置, 再减去最后一层排在它前面的空缺
+        // 满二叉树中最后一层的第 j 个节点的中序位置是 2j, 其中 j >= _last_level 的节点不存在
+        size_type depth = 63 - __builtin_clzll(static_cast<unsigned long long>(k));
+        size_type offset = k - (static_cast<size_type>(1) << depth);
+        size_type full = ((2 * offset + 1) << (_levels - 1 - depth)) - 1;
+        size_type before = (full + 1) / 2;
+        return before > _last_level ? full - (before - _last_level) : full;
+    }
+
+    template <class T, class Compare>
+    typename eytzinger_index<T, Compare>::size_type
+    eytzinger_index<T, Compare>::descend_result(size_type k) const {
+        // 下降路径上每次向右记为 1, 最后一次向左的位置就是答案: 去掉末尾连续的 1 以及那个 0
+        unsigned long long path = k;
+        k = static_cast<size_type>(path >> (__builtin_ctzll(~path) + 1));
+        return k == 0 ? size() : rank(k);
+    }
+
+    template <class T, class Compare>
+    typename eytzinger_index<T, Compare>::size_type eytzinger_index<T, Compare>::prefetch_stride() {
+        // 一条缓存行能放下的 2 的幂个元素: 节点 k 往下 log(stride) 层的后代正好从 k * stride 开始连续存放
+        size_type stride = 1;
+        while (stride * 2 * sizeof(T) <= 64) {
+            stride *= 2;
+        }
+        return stride;
+    }
+
+    template <class T, class Compare>
+    typename eytzinger_index<T, Compare>::size_type
+    eytzinger_index<T, Compare>::lower_bound(const T& key) const {
+        const T* tree = _tree.begin();
+        const size_type n = size();
+        const size_type stride = prefetch_stride();
+        size_type k = 1;
+        while (k <= n) {
+            __builtin_prefetch(tree + (k * stride - 1));
+            k = 2 * k + (_comp(tree[k - 1], key) ? 1 : 0);
+        }
+        return descend_result(k);
+    }
+
+    template <class T, class Compare>
+    typename eytzinger_index<T, Compare>::size_type
+    eytzinger_index<T, Compare>::upper_bound(const T& key) const {
+        const T* tree = _tree.begin();
+        const size_type n = size();
+        const size_type stride = prefetch_stride();
+        size_type k = 1;
+        while (k <= n) {
+            __builtin_prefetch(tree + (k * stride - 1));
+            k = 2 * k + (_comp(key, tree[k - 1]) ? 0 : 1);
+        }
+        return descend_result(k);
+    }
+
+    template <class T, class Compare>
+    bool eytzinger_index<T, Compare>::contains(const T& key) const {
+        const T* tree = _tree.begin();
+        const size_type n = size();
+        size_type k = 1;
+        while (k <= n) {
+            if (!_comp(tree[k - 1], key)) {
+                if (!_comp(key, tree[k - 1])) {
+                    return true;
+                }
+                k = 2 * k;
+            } else {
+                k = 2 * k + 1;
+            }
+        }
+        return false;
+    }
+
+}
+
+
+#endif
@@ -59,7 +59,7 @@ namespace HxSTL {
         ~function() {}
 
         function& operator=(const function& other) {
-            assignment_aux(other);
+            assignment_aux(other, true_type());
             return *this;
         }
 
@@ -119,6 +119,21 @@ namespace HxSTL {
         return (bool) f;
     }
 
+    template <class T>
+    struct plus {
+        T operator()(const T& lhs, const T& rhs) const { return lhs + rhs; }
+    };
+
+    template <class T>
+    struct minus {
+        T operator()(const T& lhs, const T& rhs) const { return lhs - rhs; }
+    };
+
+    template <class T>
+    struct multiplies {
+        T operator()(const T& lhs, const T& rhs) const { return lhs * rhs; }
+    };
+
     template <class T>
     struct equal_to {
         bool operator()(const T& lhs, const T& rhs) const { return lhs == rhs; }
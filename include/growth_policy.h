@@ -0,0 +1,44 @@
+#ifndef _GROWTH_POLICY_H_
+#define _GROWTH_POLICY_H_
+
+
+#include <stddef.h>
+
+
+namespace HxSTL {
+
+    // 连续存储容器的扩容策略
+    // next(cap, required, elem_size) 返回扩容后的容量 (元素个数), 结果不小于 required
+
+    // 每次扩容为原来的 2 倍
+    struct double_growth {
+        static size_t next(size_t cap, size_t required, size_t) {
+            return 2 * cap > required ? 2 * cap : required;
+        }
+    };
+
+    // 每次扩容为原来的 1.5 倍, 释放掉的旧空间之和有机会被后续扩容复用
+    struct golden_growth {
+        static size_t next(size_t cap, size_t required, size_t) {
+            size_t n = cap + cap / 2;
+            return n > required ? n : required;
+        }
+    };
+
+    // 在 Base 的基础上, 缓冲区达到 Threshold 字节后按 PageSize 向上取整,
+    // 使大块内存的尾部不浪费半页, 并便于 realloc / mremap 整页扩展
+    template <class Base = double_growth, size_t PageSize = 4096, size_t Threshold = 64 * 1024>
+    struct page_growth {
+        static size_t next(size_t cap, size_t required, size_t elem_size) {
+            size_t n = Base::next(cap, required, elem_size);
+            size_t bytes = n * elem_size;
+            if (bytes < Threshold) return n;
+            bytes = (bytes + PageSize - 1) & ~(PageSize - 1);
+            return bytes / elem_size;
+        }
+    };
+
+}
+
+
+#endif
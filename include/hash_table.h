@@ -195,14 +195,18 @@ namespace HxSTL {
             }
 
         hash_table(const hash_table& other): _max_factor(other._max_factor), _count(other._count),
-            _bucket_count(other._bucket_count), _hash(other._hash), _equal(other._equal), _alloc(other._alloc) {
+            _bucket_count(other._bucket_count), _hash(other._hash), _equal(other._equal),
+            _alloc(HxSTL::select_on_container_copy_construction(other._alloc)),
+            _node_alloc(HxSTL::select_on_container_copy_construction(other._node_alloc)),
+            _bucket_alloc(HxSTL::select_on_container_copy_construction(other._bucket_alloc)) {
                 initialize_aux(_bucket_count);
                 copy_aux(other._start);
             }
 
         hash_table(hash_table&& other): _max_factor(other._max_factor), _count(other._count),
             _buckets(other._buckets), _bucket_count(other._bucket_count), _start(other._start),
-            _hash(HxSTL::move(other._hash)), _equal(HxSTL::move(other._equal)), _alloc(HxSTL::move(other._alloc)) {
+            _hash(HxSTL::move(other._hash)), _equal(HxSTL::move(other._equal)), _alloc(HxSTL::move(other._alloc)),
+            _node_alloc(HxSTL::move(other._node_alloc)), _bucket_alloc(HxSTL::move(other._bucket_alloc)) {
                 other._buckets = nullptr;
             }
 
@@ -255,6 +259,9 @@ namespace HxSTL {
             HxSTL::swap(_start, other._start);
             HxSTL::swap(_hash, other._hash);
             HxSTL::swap(_equal, other._equal);
+            HxSTL::swap(_alloc, other._alloc);
+            HxSTL::swap(_node_alloc, other._node_alloc);
+            HxSTL::swap(_bucket_alloc, other._bucket_alloc);
         }
 
         template <class T>
@@ -0,0 +1,230 @@
+#ifndef _HUGE_PAGE_ALLOCATOR_H_
+#define _HUGE_PAGE_ALLOCATOR_H_
+
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "construct.h"
+#include "stdexcept.h"
+
+
+namespace HxSTL {
+
+    // 大块内存的 NUMA 放置策略
+    enum numa_policy {
+        numa_first_touch,   // 内核默认策略, 页面落在第一次写入它的线程所在的节点, 适合按线程分块初始化
+        numa_interleave     // 在允许使用的所有节点间按页轮流放置, 多个节点的线程同时扫描时带宽叠加
+    };
+
+    // 直接向内核 mmap 大块内存: 2 MiB 以上按 2 MiB 对齐并 madvise(MADV_HUGEPAGE), 由透明大页承载以减少 TLB 缺失
+    class __huge_page_mapper {
+    public:
+        enum { __PAGE_BYTES = 4096 };
+        enum { __HUGE_PAGE_BYTES = 2 * 1024 * 1024 };
+    private:
+        // <linux/mempolicy.h> 中的常量, 不依赖 libnuma
+        enum { __MPOL_INTERLEAVE = 3 };
+        enum { __MPOL_F_MEMS_ALLOWED = 1 << 2 };
+        enum { __MAX_NODES = 1024 };
+    private:
+        static size_t round_up(size_t bytes, size_t align) { return (bytes + align - 1) & ~(align - 1); }
+
+        static void advise(void* p, size_t len, numa_policy policy) {
+#ifdef MADV_HUGEPAGE
+            if (len >= __HUGE_PAGE_BYTES) ::madvise(p, len, MADV_HUGEPAGE);
+#endif
+#if defined(SYS_mbind) && defined(SYS_get_mempolicy)
+            if (policy == numa_interleave) {
+                // 交错放置是尽力而为: 单节点机器或没有权限时 mbind 失败, 退回默认策略
+                unsigned long mask[__MAX_NODES / (8 * sizeof(unsigned long))] = { 0 };
+                int mode = 0;
+                if (::syscall(SYS_get_mempolicy, &mode, mask, (unsigned long) __MAX_NODES,
+                            (void*) 0, (unsigned long) __MPOL_F_MEMS_ALLOWED) == 0) {
+                    ::syscall(SYS_mbind, p, len, (unsigned long) __MPOL_INTERLEAVE,
+                            mask, (unsigned long) __MAX_NODES, 0u);
+                }
+            }
+#else
+            (void) policy;
+#endif
+        }
+    public:
+        // 实际映射的字节数, 分配与释放必须按同一规则计算
+        static size_t mapped_bytes(size_t bytes) {
+            return bytes >= __HUGE_PAGE_BYTES ? round_up(bytes, __HUGE_PAGE_BYTES) : round_up(bytes, __PAGE_BYTES);
+        }
+
+        // 映射 len 字节, 起始地址按 2 MiB 对齐: 多映射一个大页, 截掉首尾
+        static char* map_aligned(size_t len, int prot) {
+            size_t raw_len = len + __HUGE_PAGE_BYTES;
+            char* raw = static_cast<char*>(::mmap(NULL, raw_len, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (raw == MAP_FAILED) return NULL;
+            char* p = reinterpret_cast<char*>(round_up(reinterpret_cast<size_t>(raw), __HUGE_PAGE_BYTES));
+            if (p != raw) ::munmap(raw, p - raw);
+            if (raw + raw_len != p + len) ::munmap(p + len, raw + raw_len - (p + len));
+            return p;
+        }
+
+        static void* map(size_t bytes, numa_policy policy) {
+            size_t len = mapped_bytes(bytes);
+            if (len < __HUGE_PAGE_BYTES) {
+                void* p = ::mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (p == MAP_FAILED) throw HxSTL::bad_exception();
+                advise(p, len, policy);
+                return p;
+            }
+
+            char* p = map_aligned(len, PROT_READ | PROT_WRITE);
+            if (p == NULL) throw HxSTL::bad_exception();
+            advise(p, len, policy);
+            return p;
+        }
+
+        static void unmap(void* p, size_t bytes) {
+            ::munmap(p, mapped_bytes(bytes));
+        }
+
+        // 用 mremap 扩展映射, 只改页表不拷贝数据
+        // 先尝试原地扩展; 需要移动时内核选的地址不一定按 2 MiB 对齐, 此时先占住一段对齐的区间,
+        // 再用 MREMAP_FIXED 把映射移过去, 保持大页承载; 仍然失败则退回映射新区间并拷贝
+        static void* remap(void* p, size_t old_bytes, size_t new_bytes, numa_policy policy) {
+            size_t old_len = mapped_bytes(old_bytes);
+            size_t new_len = mapped_bytes(new_bytes);
+            if (old_len == new_len) return p;
+
+            void* q = ::mremap(p, old_len, new_len, 0);
+            if (q == MAP_FAILED) {
+                q = ::mremap(p, old_len, new_len, MREMAP_MAYMOVE);
+                if (q == MAP_FAILED) throw HxSTL::bad_exception();
+            }
+            if (new_len >= __HUGE_PAGE_BYTES && reinterpret_cast<size_t>(q) % __HUGE_PAGE_BYTES != 0) {
+                q = realign(q, new_len);
+            }
+            advise(q, new_len, policy);
+            return q;
+        }
+    private:
+        static void* realign(void* q, size_t len) {
+            char* target = map_aligned(len, PROT_NONE);
+            if (target == NULL) return q;
+#ifdef MREMAP_FIXED
+            void* r = ::mremap(q, len, len, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+            if (r != MAP_FAILED) return r;
+#endif
+            // 目标区间只是占位, 换成可读写的映射后拷贝
+            void* r2 = ::mmap(target, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+            if (r2 == MAP_FAILED) {
+                ::munmap(target, len);
+                return q;
+            }
+            memcpy(r2, q, len);
+            ::munmap(q, len);
+            return r2;
+        }
+    };
+
+    // 大块连续存储使用的分配器: 不小于 threshold 字节的申请直接 mmap (透明大页 + NUMA 策略),
+    // 更小的申请走 malloc; 支持 allocator.h 中的 reallocate / allocate_at_least 扩展,
+    // vector 对可平凡重定位的元素扩容时通过 mremap 完成
+    // 分配器的策略随拷贝 / rebind 传递, deque 的缓冲区与 map 都使用同一策略
+    //
+    // 用法: HxSTL::vector<double, HxSTL::huge_page_allocator<double>> v(HxSTL::huge_page_allocator<double>(HxSTL::numa_interleave));
+    template <class T>
+    class huge_page_allocator {
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef T&          reference;
+        typedef const T*    const_pointer;
+        typedef const T&    const_reference;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        template <class U>
+        struct rebind {
+            typedef huge_page_allocator<U> other;
+        };
+
+        template <class U>
+        friend class huge_page_allocator;
+    protected:
+        numa_policy _policy;
+        size_t _threshold;
+    protected:
+        bool is_mapped(size_type n) const { return n * sizeof(T) >= _threshold; }
+    public:
+        explicit huge_page_allocator(numa_policy policy = numa_first_touch, size_t threshold = 1024 * 1024)
+            : _policy(policy), _threshold(threshold) {}
+
+        huge_page_allocator(const huge_page_allocator& other)
+            : _policy(other._policy), _threshold(other._threshold) {}
+
+        template <class U>
+        huge_page_allocator(const huge_page_allocator<U>& other)
+            : _policy(other._policy), _threshold(other._threshold) {}
+
+        numa_policy policy() const { return _policy; }
+
+        size_t threshold() const { return _threshold; }
+
+        pointer address(reference x) const { return static_cast<pointer>(&x); }
+
+        const_pointer address(const_reference x) const { return static_cast<const_pointer>(&x); }
+
+        pointer allocate(size_type n) {
+            if (n > max_size()) throw HxSTL::bad_exception();
+            if (is_mapped(n)) return static_cast<pointer>(__huge_page_mapper::map(n * sizeof(T), _policy));
+            void* p = ::malloc(n * sizeof(T));
+            if (p == NULL && n != 0) throw HxSTL::bad_exception();
+            return static_cast<pointer>(p);
+        }
+
+        pointer allocate_at_least(size_type& n) {
+            pointer p = allocate(n);
+            // 映射按页取整, 尾部的空余也算进容量
+            if (is_mapped(n)) n = __huge_page_mapper::mapped_bytes(n * sizeof(T)) / sizeof(T);
+            return p;
+        }
+
+        pointer reallocate(pointer p, size_type old_n, size_type new_n) {
+            if (new_n > max_size()) throw HxSTL::bad_exception();
+            if (is_mapped(old_n) && is_mapped(new_n)) {
+                return static_cast<pointer>(__huge_page_mapper::remap(p, old_n * sizeof(T), new_n * sizeof(T), _policy));
+            }
+            pointer q = allocate(new_n);
+            memcpy(q, p, (old_n < new_n ? old_n : new_n) * sizeof(T));
+            deallocate(p, old_n);
+            return q;
+        }
+
+        void deallocate(pointer p, size_type n) {
+            if (is_mapped(n)) {
+                __huge_page_mapper::unmap(p, n * sizeof(T));
+            } else {
+                ::free(p);
+            }
+        }
+
+        size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args) { HxSTL::construct(p, HxSTL::forward<Args>(args)...); }
+
+        template <class U>
+        void destroy(U* p) { HxSTL::destroy(p); }
+
+        bool operator==(const huge_page_allocator& other) const {
+            return _policy == other._policy && _threshold == other._threshold;
+        }
+
+        bool operator!=(const huge_page_allocator& other) const { return !(*this == other); }
+    };
+
+}
+
+
+#endif
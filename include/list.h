@@ -140,7 +140,7 @@ namespace HxSTL {
             initialize_aux(first, last, typename HxSTL::is_integeral<InputIt>::type());
         }
 
-        list(const list& other): _alloc(other._alloc) {
+        list(const list& other): _alloc(HxSTL::select_on_container_copy_construction(other._alloc)) {
             initialize_aux(other.begin(), other.end(), HxSTL::false_type());
         }
 
@@ -301,6 +301,7 @@ namespace HxSTL {
 
         void swap(list& other) {
             HxSTL::swap(_node, other._node);
+            HxSTL::swap(_alloc, other._alloc);
         }
 
         void merge(list& other);
@@ -0,0 +1,89 @@
+#ifndef _MALLOC_ALLOCATOR_H_
+#define _MALLOC_ALLOCATOR_H_
+
+
+#include <stddef.h>
+#include <stdlib.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include "construct.h"
+#include "stdexcept.h"
+
+
+namespace HxSTL {
+
+    // 基于 malloc / realloc / free 的分配器, 提供 allocator.h 中的 reallocate / allocate_at_least 扩展
+    // vector / basic_string 对可平凡重定位的元素扩容时直接 realloc, 不再 "申请新空间 + 拷贝";
+    // glibc 对 mmap 得到的大块内存使用 mremap 扩展, 只改页表, 峰值内存不会翻倍
+    //
+    // 用法: HxSTL::vector<char, HxSTL::malloc_allocator<char>>
+    template <class T>
+    class malloc_allocator {
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef T&          reference;
+        typedef const T*    const_pointer;
+        typedef const T&    const_reference;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        template <class U>
+        struct rebind {
+            typedef malloc_allocator<U> other;
+        };
+    public:
+        malloc_allocator() {}
+
+        malloc_allocator(const malloc_allocator&) {}
+
+        template <class U>
+        malloc_allocator(const malloc_allocator<U>&) {}
+
+        pointer address(reference x) const { return static_cast<pointer>(&x); }
+
+        const_pointer address(const_reference x) const { return static_cast<const_pointer>(&x); }
+
+        pointer allocate(size_type n) {
+            if (n > max_size()) throw HxSTL::bad_exception();
+            void* p = ::malloc(n * sizeof(T));
+            if (p == NULL && n != 0) throw HxSTL::bad_exception();
+            return static_cast<pointer>(p);
+        }
+
+        pointer allocate_at_least(size_type& n) {
+            pointer p = allocate(n);
+#ifdef __GLIBC__
+            // 把 malloc 块尾部的空余也算进容量
+            if (p != NULL) n = ::malloc_usable_size(p) / sizeof(T);
+#endif
+            return p;
+        }
+
+        pointer reallocate(pointer p, size_type, size_type new_n) {
+            if (new_n > max_size()) throw HxSTL::bad_exception();
+            void* q = ::realloc(p, new_n * sizeof(T));
+            if (q == NULL && new_n != 0) throw HxSTL::bad_exception();
+            return static_cast<pointer>(q);
+        }
+
+        void deallocate(pointer p, size_type) { ::free(p); }
+
+        size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args) { HxSTL::construct(p, HxSTL::forward<Args>(args)...); }
+
+        template <class U>
+        void destroy(U* p) { HxSTL::destroy(p); }
+
+        bool operator==(const malloc_allocator&) const { return true; }
+
+        bool operator!=(const malloc_allocator&) const { return false; }
+    };
+
+}
+
+
+#endif
@@ -1,8 +1,9 @@
-#ifndef _SET_H_
-#define _SET_H_
+#ifndef _MULTISET_H_
+#define _MULTISET_H_
 
 
 #include "rb_tree.h"
+#include "rb_tree_parallel.h"
 #include "functional.h"
 
 
@@ -161,6 +162,18 @@ namespace HxSTL {
         key_compare key_comp() const { return _rep.get_compare(); }
 
         value_compare value_comp() const { return _rep.get_compare(); }
+
+        // set 的元素不可修改, 只提供 const 版本
+        template <class Function>
+        Function visit(Function fn) const { return _rep.visit(fn); }
+
+        template <class Function>
+        Function for_each_in_range(const Key& lo, const Key& hi, Function fn) const { return _rep.for_each_in_range(lo, hi, fn); }
+
+        template <class Function>
+        void parallel_for_each_in_range(const Key& lo, const Key& hi, Function fn, size_type num_threads = 0) const {
+            _rep.parallel_for_each_in_range(lo, hi, fn, num_threads);
+        }
     public:
         template <class K, class C, class A>
         friend bool operator==(const multiset<K, C, A> &lhs, const multiset<K, C, A> &rhs);
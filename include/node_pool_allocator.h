@@ -0,0 +1,188 @@
+#ifndef _NODE_POOL_ALLOCATOR_H_
+#define _NODE_POOL_ALLOCATOR_H_
+
+
+#include <stddef.h>
+#include <new>
+#include "construct.h"
+#include "stdexcept.h"
+
+
+namespace HxSTL {
+
+    // 同一尺寸节点的 slab 池, 单个节点的申请/释放只操作空闲链表
+    // 所有 slab 在池析构时一次性释放
+    template <class T>
+    class __node_pool {
+    private:
+        union obj {
+            obj* next;
+            char data[sizeof(T)];
+        };
+
+        // slab 头部, 按最大对齐方式补齐
+        union slab {
+            slab* next;
+            max_align_t align;
+        };
+
+        enum { __SLAB_BYTES = 4096 };
+        enum { __SLAB_NODES = (__SLAB_BYTES - sizeof(slab)) / sizeof(obj) > 4 ?
+            (__SLAB_BYTES - sizeof(slab)) / sizeof(obj) : 4 };
+    private:
+        obj* _free;
+        obj* _cur;      // 当前 slab 中尚未切分的部分
+        obj* _end;
+        slab* _slabs;
+        long _refs;
+    public:
+        __node_pool(): _free(NULL), _cur(NULL), _end(NULL), _slabs(NULL), _refs(1) {}
+
+        __node_pool(const __node_pool&) = delete;
+
+        __node_pool& operator=(const __node_pool&) = delete;
+
+        ~__node_pool() {
+            while (_slabs != NULL) {
+                slab* next = _slabs -> next;
+                ::operator delete(_slabs);
+                _slabs = next;
+            }
+        }
+
+        void inc_ref() { ++_refs; }
+
+        bool dec_ref() { return --_refs == 0; }
+
+        void* allocate() {
+            if (_free != NULL) {
+                obj* p = _free;
+                _free = p -> next;
+                return p;
+            }
+
+            if (_cur == _end) {
+                slab* s = static_cast<slab*>(::operator new(sizeof(slab) + __SLAB_NODES * sizeof(obj)));
+                s -> next = _slabs;
+                _slabs = s;
+                _cur = reinterpret_cast<obj*>(s + 1);
+                _end = _cur + __SLAB_NODES;
+            }
+
+            return _cur++;
+        }
+
+        void deallocate(void* p) {
+            obj* q = static_cast<obj*>(p);
+            q -> next = _free;
+            _free = q;
+        }
+    };
+
+    // 节点容器专用的分配器: 每个分配器实例 (及其拷贝) 拥有一个私有的 slab 池,
+    // allocate(1) / deallocate(p, 1) 走池, 其他尺寸直接使用 operator new
+    // 容器默认构造时得到一个新的池, 第一次申请时才创建; 拷贝构造的分配器共享同一个池,
+    // 池在最后一个共享者析构时整体释放; rebind 得到的分配器使用独立的池
+    // 容器拷贝构造时经 select_on_container_copy_construction 得到新的池, 副本与原容器互不共享
+    // 池不是线程安全的, 共享一个池的容器不能在不同线程中同时修改
+    //
+    // 用法: HxSTL::map<int, int, HxSTL::less<int>, HxSTL::node_pool_allocator<HxSTL::pair<const int, int>>>
+    template <class T>
+    class node_pool_allocator {
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef T&          reference;
+        typedef const T*    const_pointer;
+        typedef const T&    const_reference;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        template <class U>
+        struct rebind {
+            typedef node_pool_allocator<U> other;
+        };
+    protected:
+        typedef __node_pool<T>  pool_type;
+
+        template <class U>
+        friend class node_pool_allocator;
+    protected:
+        pool_type* _pool;
+    protected:
+        void reset() {
+            if (_pool != NULL && _pool -> dec_ref()) delete _pool;
+            _pool = NULL;
+        }
+    public:
+        node_pool_allocator(): _pool(NULL) {}
+
+        node_pool_allocator(const node_pool_allocator& other): _pool(other._pool) {
+            if (_pool != NULL) _pool -> inc_ref();
+        }
+
+        node_pool_allocator(node_pool_allocator&& other): _pool(other._pool) { other._pool = NULL; }
+
+        template <class U>
+        node_pool_allocator(const node_pool_allocator<U>&): _pool(NULL) {}
+
+        ~node_pool_allocator() { reset(); }
+
+        node_pool_allocator& operator=(const node_pool_allocator& other) {
+            if (_pool != other._pool) {
+                reset();
+                _pool = other._pool;
+                if (_pool != NULL) _pool -> inc_ref();
+            }
+            return *this;
+        }
+
+        node_pool_allocator& operator=(node_pool_allocator&& other) {
+            if (this != &other) {
+                reset();
+                _pool = other._pool;
+                other._pool = NULL;
+            }
+            return *this;
+        }
+
+        node_pool_allocator select_on_container_copy_construction() const { return node_pool_allocator(); }
+
+        pointer address(reference x) const { return static_cast<pointer>(&x); }
+
+        const_pointer address(const_reference x) const { return static_cast<const_pointer>(&x); }
+
+        pointer allocate(size_type n) {
+            if (n != 1) {
+                if (n > max_size()) throw HxSTL::bad_exception();
+                return static_cast<pointer>(::operator new(n * sizeof(T)));
+            }
+            if (_pool == NULL) _pool = new pool_type();
+            return static_cast<pointer>(_pool -> allocate());
+        }
+
+        void deallocate(pointer p, size_type n) {
+            if (n != 1) {
+                ::operator delete(p);
+            } else {
+                _pool -> deallocate(p);
+            }
+        }
+
+        size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args) { HxSTL::construct(p, HxSTL::forward<Args>(args)...); }
+
+        template <class U>
+        void destroy(U* p) { HxSTL::destroy(p); }
+
+        bool operator==(const node_pool_allocator& other) const { return _pool == other._pool; }
+
+        bool operator!=(const node_pool_allocator& other) const { return _pool != other._pool; }
+    };
+
+}
+
+
+#endif
@@ -0,0 +1,593 @@
+#ifndef _NUMERIC_H_
+#define _NUMERIC_H_
+
+
+#include <stddef.h>
+#include "algorithm.h"
+#include "execution.h"
+#include "functional.h"
+#include "iterator.h"
+#include "simd.h"
+#include "type_traits.h"
+#include "vector.h"
+
+
+namespace HxSTL {
+
+    // 省略运算时使用的默认运算, 与 init + *first 一样按两个操作数各自的类型求值
+    struct __plus {
+        template <class T, class U>
+        auto operator()(const T& lhs, const U& rhs) const -> decltype(lhs + rhs) { return lhs + rhs; }
+    };
+
+    struct __minus {
+        template <class T, class U>
+        auto operator()(const T& lhs, const U& rhs) const -> decltype(lhs - rhs) { return lhs - rhs; }
+    };
+
+    struct __multiplies {
+        template <class T, class U>
+        auto operator()(const T& lhs, const U& rhs) const -> decltype(lhs * rhs) { return lhs * rhs; }
+    };
+
+    template <class BinaryOperation, class T>
+    struct __is_plus: public false_type {};
+
+    template <class T>
+    struct __is_plus<__plus, T>: public true_type {};
+
+    template <class T>
+    struct __is_plus<plus<T>, T>: public true_type {};
+
+    template <class BinaryOperation, class T>
+    struct __is_multiplies: public false_type {};
+
+    template <class T>
+    struct __is_multiplies<__multiplies, T>: public true_type {};
+
+    template <class T>
+    struct __is_multiplies<multiplies<T>, T>: public true_type {};
+
+    // 指针区间按 op 求和能否走向量内核: 元素与累加值是同一种可向量化的算术类型, op 是加法
+    // 向量内核按通道分别累加, 改变了相加的顺序; 整数加法满足结合律, 结果不变, 浮点数只有
+    // 允许重排的 reduce / transform_reduce (Reorder 为 true_type) 才向量化
+    template <class Iterator, class T, class BinaryOperation, class Reorder>
+    struct __simd_sum_dispatch {
+        typedef false_type type;
+    };
+
+    template <class U, class T, class BinaryOperation, class Reorder>
+    struct __simd_sum_dispatch<U*, T, BinaryOperation, Reorder> {
+        typedef integeral_constant<bool,
+            __simd_element<T>::value &&
+            is_same<typename remove_cv<U>::type, T>::value &&
+            __is_plus<BinaryOperation, T>::value &&
+            (Reorder::value || is_integeral<T>::value)> type;
+    };
+
+    template <class Iterator1, class Iterator2, class T, class BinaryOperation1, class BinaryOperation2, class Reorder>
+    struct __simd_dot_dispatch {
+        typedef false_type type;
+    };
+
+    template <class U1, class U2, class T, class BinaryOperation1, class BinaryOperation2, class Reorder>
+    struct __simd_dot_dispatch<U1*, U2*, T, BinaryOperation1, BinaryOperation2, Reorder> {
+        typedef integeral_constant<bool,
+            __simd_sum_dispatch<U1*, T, BinaryOperation1, Reorder>::type::value &&
+            is_same<typename remove_cv<U2>::type, T>::value &&
+            __is_multiplies<BinaryOperation2, T>::value> type;
+    };
+
+    // 前缀和只对整数向量化, 输入输出是同一种元素类型的指针
+    template <class InputIt, class OutputIt, class BinaryOperation>
+    struct __simd_scan_dispatch {
+        typedef false_type type;
+    };
+
+    template <class U, class T, class BinaryOperation>
+    struct __simd_scan_dispatch<U*, T*, BinaryOperation> {
+        typedef typename __simd_sum_dispatch<U*, T, BinaryOperation, false_type>::type type;
+    };
+
+    template <class Iterator, class T>
+    struct __simd_iota_dispatch {
+        typedef false_type type;
+    };
+
+    template <class U, class T>
+    struct __simd_iota_dispatch<U*, T> {
+        typedef integeral_constant<bool,
+            __simd_element<U>::value && is_integeral<U>::value && is_same<U, T>::value> type;
+    };
+
+    // iota
+
+    template <class ForwardIt, class T>
+    inline void __iota(ForwardIt first, ForwardIt last, T value, false_type) {
+        for (; first != last; ++first, ++value) {
+            *first = value;
+        }
+    }
+
+    template <class T>
+    inline void __iota(T* first, T* last, T value, true_type) {
+        __simd_iota<T>(first, last, value);
+    }
+
+    template <class ForwardIt, class T>
+    void iota(ForwardIt first, ForwardIt last, T value) {
+        __iota(first, last, value, typename __simd_iota_dispatch<ForwardIt, T>::type());
+    }
+
+    // accumulate reduce
+
+    template <class InputIt, class T, class BinaryOperation>
+    inline T __fold(InputIt first, InputIt last, T init, BinaryOperation& op, false_type) {
+        for (; first != last; ++first) {
+            init = op(init, *first);
+        }
+        return init;
+    }
+
+    template <class U, class T, class BinaryOperation>
+    inline T __fold(U* first, U* last, T init, BinaryOperation&, true_type) {
+        return static_cast<T>(init + __simd_sum<T>(first, last));
+    }
+
+    template <class InputIt, class T, class BinaryOperation, class Reorder>
+    inline T __fold_segmented(InputIt first, InputIt last, T init, BinaryOperation& op, Reorder, false_type) {
+        return __fold(first, last, init, op, typename __simd_sum_dispatch<InputIt, T, BinaryOperation, Reorder>::type());
+    }
+
+    // deque 等分段区间逐块处理, 块内是指针区间
+    template <class SegmentedIt, class T, class BinaryOperation, class Reorder>
+    T __fold_segmented(SegmentedIt first, SegmentedIt last, T init, BinaryOperation& op, Reorder reorder, true_type) {
+        typedef __segmented_iterator_traits<SegmentedIt> traits;
+        typename traits::segment_iterator sfirst = traits::segment(first);
+        typename traits::segment_iterator slast = traits::segment(last);
+        if (sfirst == slast) {
+            return __fold_segmented(traits::local(first), traits::local(last), init, op, reorder, false_type());
+        }
+        init = __fold_segmented(traits::local(first), traits::end(sfirst), init, op, reorder, false_type());
+        for (++sfirst; sfirst != slast; ++sfirst) {
+            init = __fold_segmented(traits::begin(sfirst), traits::end(sfirst), init, op, reorder, false_type());
+        }
+        return __fold_segmented(traits::begin(slast), traits::local(last), init, op, reorder, false_type());
+    }
+
+    template <class InputIt, class T, class BinaryOperation>
+    T accumulate(InputIt first, InputIt last, T init, BinaryOperation op) {
+        return __fold_segmented(first, last, init, op, false_type(),
+            typename __segmented_iterator_traits<InputIt>::is_segmented());
+    }
+
+    template <class InputIt, class T>
+    T accumulate(InputIt first, InputIt last, T init) {
+        return HxSTL::accumulate(first, last, init, __plus());
+    }
+
+    // 与 accumulate 相同, 但不保证运算顺序, op 需要满足结合律与交换律
+    template <class InputIt, class T, class BinaryOperation>
+    T reduce(InputIt first, InputIt last, T init, BinaryOperation op) {
+        return __fold_segmented(first, last, init, op, true_type(),
+            typename __segmented_iterator_traits<InputIt>::is_segmented());
+    }
+
+    template <class InputIt, class T>
+    T reduce(InputIt first, InputIt last, T init) {
+        return HxSTL::reduce(first, last, init, __plus());
+    }
+
+    template <class InputIt>
+    typename iterator_traits<InputIt>::value_type reduce(InputIt first, InputIt last) {
+        return HxSTL::reduce(first, last, typename iterator_traits<InputIt>::value_type(), __plus());
+    }
+
+    // inner_product transform_reduce
+
+    template <class InputIt1, class InputIt2, class T, class BinaryOperation1, class BinaryOperation2>
+    inline T __inner_product(InputIt1 first1, InputIt1 last1, InputIt2 first2, T init,
+            BinaryOperation1& op1, BinaryOperation2& op2, false_type) {
+        for (; first1 != last1; ++first1, ++first2) {
+            init = op1(init, op2(*first1, *first2));
+        }
+        return init;
+    }
+
+    template <class U1, class U2, class T, class BinaryOperation1, class BinaryOperation2>
+    inline T __inner_product(U1* first1, U1* last1, U2* first2, T init,
+            BinaryOperation1&, BinaryOperation2&, true_type) {
+        return static_cast<T>(init + __simd_dot<T>(first1, last1, first2));
+    }
+
+    template <class InputIt1, class InputIt2, class T, class BinaryOperation1, class BinaryOperation2>
+    T inner_product(InputIt1 first1, InputIt1 last1, InputIt2 first2, T init,
+            BinaryOperation1 op1, BinaryOperation2 op2) {
+        return __inner_product(first1, last1, first2, init, op1, op2, typename __simd_dot_dispatch<
+            InputIt1, InputIt2, T, BinaryOperation1, BinaryOperation2, false_type>::type());
+    }
+
+    template <class InputIt1, class InputIt2, class T>
+    T inner_product(InputIt1 first1, InputIt1 last1, InputIt2 first2, T init) {
+        return HxSTL::inner_product(first1, last1, first2, init, __plus(), __multiplies());
+    }
+
+    template <class InputIt1, class InputIt2, class T, class BinaryReductionOp, class BinaryTransformOp>
+    T transform_reduce(InputIt1 first1, InputIt1 last1, InputIt2 first2, T init,
+            BinaryReductionOp reduce, BinaryTransformOp transform) {
+        return __inner_product(first1, last1, first2, init, reduce, transform, typename __simd_dot_dispatch<
+            InputIt1, InputIt2, T, BinaryReductionOp, BinaryTransformOp, true_type>::type());
+    }
+
+    template <class InputIt1, class InputIt2, class T>
+    T transform_reduce(InputIt1 first1, InputIt1 last1, InputIt2 first2, T init) {
+        return HxSTL::transform_reduce(first1, last1, first2, init, __plus(), __multiplies());
+    }
+
+    template <class InputIt, class T, class BinaryReductionOp, class UnaryTransformOp>
+    T transform_reduce(InputIt first, InputIt last, T init, BinaryReductionOp reduce, UnaryTransformOp transform) {
+        for (; first != last; ++first) {
+            init = reduce(init, transform(*first));
+        }
+        return init;
+    }
+
+    // adjacent_difference
+
+    // 先保存当前元素再写入, result 可以等于 first
+    template <class InputIt, class OutputIt, class BinaryOperation>
+    OutputIt adjacent_difference(InputIt first, InputIt last, OutputIt result, BinaryOperation op) {
+        typedef typename iterator_traits<InputIt>::value_type value_type;
+        if (first == last) {
+            return result;
+        }
+        value_type prev = *first;
+        *result = prev;
+        while (++first != last) {
+            value_type cur = *first;
+            *++result = op(cur, prev);
+            prev = HxSTL::move(cur);
+        }
+        return ++result;
+    }
+
+    template <class InputIt, class OutputIt>
+    OutputIt adjacent_difference(InputIt first, InputIt last, OutputIt result) {
+        return HxSTL::adjacent_difference(first, last, result, __minus());
+    }
+
+    // partial_sum inclusive_scan exclusive_scan
+
+    template <class InputIt, class OutputIt, class BinaryOperation, class T>
+    inline OutputIt __scan_with(InputIt first, InputIt last, OutputIt result, BinaryOperation& op, T init, false_type) {
+        for (; first != last; ++first, ++result) {
+            init = op(init, *first);
+            *result = init;
+        }
+        return result;
+    }
+
+    template <class U, class T, class BinaryOperation>
+    inline T* __scan_with(U* first, U* last, T* result, BinaryOperation&, T init, true_type) {
+        __simd_scan<T>(first, last, result, init);
+        return result + (last - first);
+    }
+
+    template <class InputIt, class OutputIt, class BinaryOperation>
+    inline OutputIt __scan(InputIt first, InputIt last, OutputIt result, BinaryOperation& op, false_type) {
+        typedef typename iterator_traits<InputIt>::value_type value_type;
+        if (first == last) {
+            return result;
+        }
+        value_type init = *first;
+        *result = init;
+        return __scan_with(++first, last, ++result, op, init, false_type());
+    }
+
+    // 整数加法的前缀和从 0 开始累加, 结果与从第一个元素开始相同
+    template <class U, class T, class BinaryOperation>
+    inline T* __scan(U* first, U* last, T* result, BinaryOperation& op, true_type) {
+        return __scan_with(first, last, result, op, T(), true_type());
+    }
+
+    template <class InputIt, class OutputIt, class BinaryOperation>
+    OutputIt partial_sum(InputIt first, InputIt last, OutputIt result, BinaryOperation op) {
+        return __scan(first, last, result, op, typename __simd_scan_dispatch<InputIt, OutputIt, BinaryOperation>::type());
+    }
+
+    template <class InputIt, class OutputIt>
+    OutputIt partial_sum(InputIt first, InputIt last, OutputIt result) {
+        return HxSTL::partial_sum(first, last, result, __plus());
+    }
+
+    template <class InputIt, class OutputIt, class BinaryOperation, class T>
+    OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt result, BinaryOperation op, T init) {
+        return __scan_with(first, last, result, op, init, typename integeral_constant<bool,
+            __simd_scan_dispatch<InputIt, OutputIt, BinaryOperation>::type::value &&
+            is_same<OutputIt, T*>::value>::type());
+    }
+
+    template <class InputIt, class OutputIt, class BinaryOperation>
+    OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt result, BinaryOperation op) {
+        return __scan(first, last, result, op, typename __simd_scan_dispatch<InputIt, OutputIt, BinaryOperation>::type());
+    }
+
+    template <class InputIt, class OutputIt>
+    OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt result) {
+        return HxSTL::inclusive_scan(first, last, result, __plus());
+    }
+
+    // 第 i 个输出是 init 与前 i 个元素的和, 不含第 i 个元素本身
+    template <class InputIt, class OutputIt, class T, class BinaryOperation>
+    OutputIt exclusive_scan(InputIt first, InputIt last, OutputIt result, T init, BinaryOperation op) {
+        for (; first != last; ++first, ++result) {
+            T next = op(init, *first);
+            *result = init;
+            init = HxSTL::move(next);
+        }
+        return result;
+    }
+
+    template <class InputIt, class OutputIt, class T>
+    OutputIt exclusive_scan(InputIt first, InputIt last, OutputIt result, T init) {
+        return HxSTL::exclusive_scan(first, last, result, init, __plus());
+    }
+
+    /*
+     * 执行策略
+     */
+
+    // reduce
+
+    template <class ExecutionPolicy, class ForwardIt, class T, class BinaryOperation>
+    inline T __reduce_policy(ExecutionPolicy&&, ForwardIt first, ForwardIt last, T init,
+            BinaryOperation op, false_type) {
+        return HxSTL::reduce(first, last, init, op);
+    }
+
+    // 各块以自己的第一个元素为初值归约, 再把各块的结果依次归约到 init
+    template <class ExecutionPolicy, class RandomIt, class T, class BinaryOperation>
+    T __reduce_policy(ExecutionPolicy&&, RandomIt first, RandomIt last, T init,
+            BinaryOperation op, true_type) {
+        const size_t n = last - first;
+        const size_t chunks = __parallel_chunk_count(n, __parallel_grain);
+        if (chunks <= 1) {
+            return HxSTL::reduce(first, last, init, op);
+        }
+        HxSTL::vector<T> partial(chunks, init);
+        auto chunk = [first, &op, &partial](size_t i, size_t b, size_t e) {
+            partial[i] = HxSTL::reduce(first + (b + 1), first + e, static_cast<T>(*(first + b)), op);
+        };
+        __parallel_for_chunks(n, chunks, chunk);
+        for (size_t i = 0; i < chunks; ++i) {
+            init = op(init, partial[i]);
+        }
+        return init;
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class T, class BinaryOperation>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, T>::type
+    reduce(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, T init, BinaryOperation op) {
+        return __reduce_policy(policy, first, last, init, op, typename __parallel_dispatch<ExecutionPolicy, ForwardIt>::type());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class T>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, T>::type
+    reduce(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, T init) {
+        return HxSTL::reduce(policy, first, last, init, __plus());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, typename iterator_traits<ForwardIt>::value_type>::type
+    reduce(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last) {
+        return HxSTL::reduce(policy, first, last, typename iterator_traits<ForwardIt>::value_type(), __plus());
+    }
+
+    // transform_reduce
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class T,
+        class BinaryReductionOp, class BinaryTransformOp>
+    inline T __transform_reduce_policy(ExecutionPolicy&&, ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2,
+            T init, BinaryReductionOp reduce, BinaryTransformOp transform, false_type) {
+        return HxSTL::transform_reduce(first1, last1, first2, init, reduce, transform);
+    }
+
+    template <class ExecutionPolicy, class RandomIt1, class RandomIt2, class T,
+        class BinaryReductionOp, class BinaryTransformOp>
+    T __transform_reduce_policy(ExecutionPolicy&&, RandomIt1 first1, RandomIt1 last1, RandomIt2 first2,
+            T init, BinaryReductionOp reduce, BinaryTransformOp transform, true_type) {
+        const size_t n = last1 - first1;
+        const size_t chunks = __parallel_chunk_count(n, __parallel_grain);
+        if (chunks <= 1) {
+            return HxSTL::transform_reduce(first1, last1, first2, init, reduce, transform);
+        }
+        HxSTL::vector<T> partial(chunks, init);
+        auto chunk = [first1, first2, &reduce, &transform, &partial](size_t i, size_t b, size_t e) {
+            partial[i] = HxSTL::transform_reduce(first1 + (b + 1), first1 + e, first2 + (b + 1),
+                static_cast<T>(transform(*(first1 + b), *(first2 + b))), reduce, transform);
+        };
+        __parallel_for_chunks(n, chunks, chunk);
+        for (size_t i = 0; i < chunks; ++i) {
+            init = reduce(init, partial[i]);
+        }
+        return init;
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class T,
+        class BinaryReductionOp, class BinaryTransformOp>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, T>::type
+    transform_reduce(ExecutionPolicy&& policy, ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2,
+            T init, BinaryReductionOp reduce, BinaryTransformOp transform) {
+        return __transform_reduce_policy(policy, first1, last1, first2, init, reduce, transform,
+            typename __parallel_dispatch<ExecutionPolicy, ForwardIt1, ForwardIt2>::type());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class T>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, T>::type
+    transform_reduce(ExecutionPolicy&& policy, ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, T init) {
+        return HxSTL::transform_reduce(policy, first1, last1, first2, init, __plus(), __multiplies());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class T, class BinaryReductionOp, class UnaryTransformOp>
+    inline T __transform_reduce_policy(ExecutionPolicy&&, ForwardIt first, ForwardIt last,
+            T init, BinaryReductionOp reduce, UnaryTransformOp transform, false_type) {
+        return HxSTL::transform_reduce(first, last, init, reduce, transform);
+    }
+
+    template <class ExecutionPolicy, class RandomIt, class T, class BinaryReductionOp, class UnaryTransformOp>
+    T __transform_reduce_policy(ExecutionPolicy&&, RandomIt first, RandomIt last,
+            T init, BinaryReductionOp reduce, UnaryTransformOp transform, true_type) {
+        const size_t n = last - first;
+        const size_t chunks = __parallel_chunk_count(n, __parallel_grain);
+        if (chunks <= 1) {
+            return HxSTL::transform_reduce(first, last, init, reduce, transform);
+        }
+        HxSTL::vector<T> partial(chunks, init);
+        auto chunk = [first, &reduce, &transform, &partial](size_t i, size_t b, size_t e) {
+            partial[i] = HxSTL::transform_reduce(first + (b + 1), first + e,
+                static_cast<T>(transform(*(first + b))), reduce, transform);
+        };
+        __parallel_for_chunks(n, chunks, chunk);
+        for (size_t i = 0; i < chunks; ++i) {
+            init = reduce(init, partial[i]);
+        }
+        return init;
+    }
+
+    template <class ExecutionPolicy, class ForwardIt, class T, class BinaryReductionOp, class UnaryTransformOp>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, T>::type
+    transform_reduce(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last,
+            T init, BinaryReductionOp reduce, UnaryTransformOp transform) {
+        return __transform_reduce_policy(policy, first, last, init, reduce, transform,
+            typename __parallel_dispatch<ExecutionPolicy, ForwardIt>::type());
+    }
+
+    // inclusive_scan exclusive_scan
+
+    // 分块的两遍前缀和: 第一遍第 0 块直接完成扫描, 其余各块只求和; 顺序算出每块的进位后,
+    // 第二遍其余各块带着进位扫描. 每块只读写自己的范围, result 可以等于 first
+    template <class RandomIt1, class RandomIt2, class BinaryOperation, class T>
+    RandomIt2 __parallel_inclusive_scan(RandomIt1 first, RandomIt1 last, RandomIt2 result,
+            BinaryOperation& op, const T* init) {
+        const size_t n = last - first;
+        const size_t chunks = __parallel_chunk_count(n, __parallel_grain);
+        if (chunks <= 1) {
+            return init ? HxSTL::inclusive_scan(first, last, result, op, *init)
+                : HxSTL::inclusive_scan(first, last, result, op);
+        }
+        HxSTL::vector<T> carry(chunks, static_cast<T>(*first));
+        auto reduce_chunk = [first, result, init, &op, &carry](size_t i, size_t b, size_t e) {
+            if (i == 0) {
+                init ? HxSTL::inclusive_scan(first, first + e, result, op, *init)
+                    : HxSTL::inclusive_scan(first, first + e, result, op);
+                carry[0] = *(result + (e - 1));
+            } else {
+                carry[i] = HxSTL::reduce(first + (b + 1), first + e, static_cast<T>(*(first + b)), op);
+            }
+        };
+        __parallel_for_chunks(n, chunks, reduce_chunk);
+        // carry[i] 变为前 i 块的总和
+        for (size_t i = 1; i < chunks; ++i) {
+            carry[i] = op(carry[i - 1], carry[i]);
+        }
+        auto scan_chunk = [first, result, &op, &carry](size_t i, size_t b, size_t e) {
+            if (i != 0) {
+                HxSTL::inclusive_scan(first + b, first + e, result + b, op, carry[i - 1]);
+            }
+        };
+        __parallel_for_chunks(n, chunks, scan_chunk);
+        return result + n;
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class BinaryOperation, class T>
+    inline ForwardIt2 __inclusive_scan_policy(ExecutionPolicy&&, ForwardIt1 first, ForwardIt1 last,
+            ForwardIt2 result, BinaryOperation op, const T* init, false_type) {
+        return init ? HxSTL::inclusive_scan(first, last, result, op, *init)
+            : HxSTL::inclusive_scan(first, last, result, op);
+    }
+
+    template <class ExecutionPolicy, class RandomIt1, class RandomIt2, class BinaryOperation, class T>
+    inline RandomIt2 __inclusive_scan_policy(ExecutionPolicy&&, RandomIt1 first, RandomIt1 last,
+            RandomIt2 result, BinaryOperation op, const T* init, true_type) {
+        return __parallel_inclusive_scan(first, last, result, op, init);
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class BinaryOperation, class T>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt2>::type
+    inclusive_scan(ExecutionPolicy&& policy, ForwardIt1 first, ForwardIt1 last, ForwardIt2 result,
+            BinaryOperation op, T init) {
+        return __inclusive_scan_policy(policy, first, last, result, op, &init,
+            typename __parallel_dispatch<ExecutionPolicy, ForwardIt1, ForwardIt2>::type());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class BinaryOperation>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt2>::type
+    inclusive_scan(ExecutionPolicy&& policy, ForwardIt1 first, ForwardIt1 last, ForwardIt2 result,
+            BinaryOperation op) {
+        typedef typename iterator_traits<ForwardIt1>::value_type value_type;
+        return __inclusive_scan_policy(policy, first, last, result, op, static_cast<const value_type*>(0),
+            typename __parallel_dispatch<ExecutionPolicy, ForwardIt1, ForwardIt2>::type());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt2>::type
+    inclusive_scan(ExecutionPolicy&& policy, ForwardIt1 first, ForwardIt1 last, ForwardIt2 result) {
+        return HxSTL::inclusive_scan(policy, first, last, result, __plus());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class T, class BinaryOperation>
+    inline ForwardIt2 __exclusive_scan_policy(ExecutionPolicy&&, ForwardIt1 first, ForwardIt1 last,
+            ForwardIt2 result, T init, BinaryOperation op, false_type) {
+        return HxSTL::exclusive_scan(first, last, result, init, op);
+    }
+
+    // 与 __parallel_inclusive_scan 相同的两遍; 第 0 块的总和要在写入前读出它的最后一个元素
+    template <class ExecutionPolicy, class RandomIt1, class RandomIt2, class T, class BinaryOperation>
+    RandomIt2 __exclusive_scan_policy(ExecutionPolicy&&, RandomIt1 first, RandomIt1 last,
+            RandomIt2 result, T init, BinaryOperation op, true_type) {
+        const size_t n = last - first;
+        const size_t chunks = __parallel_chunk_count(n, __parallel_grain);
+        if (chunks <= 1) {
+            return HxSTL::exclusive_scan(first, last, result, init, op);
+        }
+        HxSTL::vector<T> carry(chunks, init);
+        auto reduce_chunk = [first, result, &init, &op, &carry](size_t i, size_t b, size_t e) {
+            if (i == 0) {
+                T back = static_cast<T>(*(first + (e - 1)));
+                HxSTL::exclusive_scan(first, first + e, result, init, op);
+                carry[0] = op(static_cast<T>(*(result + (e - 1))), back);
+            } else {
+                carry[i] = HxSTL::reduce(first + (b + 1), first + e, static_cast<T>(*(first + b)), op);
+            }
+        };
+        __parallel_for_chunks(n, chunks, reduce_chunk);
+        for (size_t i = 1; i < chunks; ++i) {
+            carry[i] = op(carry[i - 1], carry[i]);
+        }
+        auto scan_chunk = [first, result, &op, &carry](size_t i, size_t b, size_t e) {
+            if (i != 0) {
+                HxSTL::exclusive_scan(first + b, first + e, result + b, carry[i - 1], op);
+            }
+        };
+        __parallel_for_chunks(n, chunks, scan_chunk);
+        return result + n;
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class T, class BinaryOperation>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt2>::type
+    exclusive_scan(ExecutionPolicy&& policy, ForwardIt1 first, ForwardIt1 last, ForwardIt2 result,
+            T init, BinaryOperation op) {
+        return __exclusive_scan_policy(policy, first, last, result, init, op,
+            typename __parallel_dispatch<ExecutionPolicy, ForwardIt1, ForwardIt2>::type());
+    }
+
+    template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class T>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, ForwardIt2>::type
+    exclusive_scan(ExecutionPolicy&& policy, ForwardIt1 first, ForwardIt1 last, ForwardIt2 result, T init) {
+        return HxSTL::exclusive_scan(policy, first, last, result, init, __plus());
+    }
+
+}
+
+
+#endif
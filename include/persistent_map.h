@@ -0,0 +1,188 @@
+#ifndef _PERSISTENT_MAP_H_
+#define _PERSISTENT_MAP_H_
+
+
+#include "persistent_rb_tree.h"
+#include "functional.h"
+
+
+namespace HxSTL {
+
+    // 不可变的有序 map: 拷贝 (snapshot) O(1), 修改只影响当前对象, 已有的拷贝保持不变
+    // 元素只读, 不提供 operator[] 和非 const 迭代器
+    template <class Key, class T, class Compare = HxSTL::less<Key>,
+             class Alloc = HxSTL::allocator<HxSTL::pair<const Key, T>>>
+    class persistent_map {
+    public:
+        typedef Key                                     key_type;
+        typedef T                                       mapped_type;
+        typedef HxSTL::pair<const Key, T>               value_type;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+        typedef Compare                                 key_compare;
+        typedef Alloc                                   allocator_type;
+        typedef const value_type&                       reference;
+        typedef const value_type&                       const_reference;
+        typedef const value_type*                       pointer;
+        typedef const value_type*                       const_pointer;
+    protected:
+        typedef HxSTL::persistent_rb_tree<key_type, value_type, __select1st<value_type>, key_compare, allocator_type>   rep_type;
+    public:
+        typedef typename rep_type::const_iterator                   iterator;
+        typedef typename rep_type::const_iterator                   const_iterator;
+        typedef typename HxSTL::reverse_iterator<iterator>          reverse_iterator;
+        typedef typename HxSTL::reverse_iterator<const_iterator>    const_reverse_iterator;
+
+        class value_compare {
+            friend class persistent_map;
+        protected:
+            Compare _compare;
+
+            value_compare(Compare comp): _compare(comp) {}
+        public:
+            bool operator()(const value_type& lhs, const value_type& rhs) const {
+                return _compare(lhs.first, rhs.first);
+            }
+        };
+    protected:
+        rep_type _rep;
+    public:
+        persistent_map(): persistent_map(Compare()) {}
+
+        explicit persistent_map(const Compare& comp, const Alloc& alloc = Alloc()): _rep(comp, alloc) {}
+
+        template <class InputIt>
+        persistent_map(InputIt first, InputIt last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : _rep(comp, alloc) { insert(first, last); }
+
+        persistent_map(const persistent_map& other): _rep(other._rep) {}
+
+        persistent_map(persistent_map&& other): _rep(HxSTL::move(other._rep)) {}
+
+        persistent_map(HxSTL::initializer_list<value_type> init, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : _rep(comp, alloc) { insert(init.begin(), init.end()); }
+
+        persistent_map& operator=(const persistent_map& other) {
+            _rep = other._rep;
+            return *this;
+        }
+
+        persistent_map& operator=(persistent_map&& other) {
+            _rep = HxSTL::move(other._rep);
+            return *this;
+        }
+
+        persistent_map& operator=(HxSTL::initializer_list<value_type> init) {
+            clear();
+            insert(init.begin(), init.end());
+            return *this;
+        }
+
+        Alloc get_allocator() const { return _rep.get_allocator(); }
+
+        // 当前版本的只读快照, 与 *this 共享全部节点, 之后对 *this 的修改不影响快照
+        // 它只是一次拷贝, 不能与其他线程对 *this 的修改并发调用; 取得快照后可以交给其他线程独立读取
+        persistent_map snapshot() const { return *this; }
+
+        const T& at(const Key& key) const {
+            const value_type* p = _rep.find_value(key);
+            if (p == NULL) throw HxSTL::out_of_range();
+            return p -> second;
+        }
+
+        const_iterator begin() const { return _rep.begin(); }
+
+        const_iterator cbegin() const { return _rep.begin(); }
+
+        const_iterator end() const { return _rep.end(); }
+
+        const_iterator cend() const { return _rep.end(); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(_rep.end()); }
+
+        const_reverse_iterator crbegin() const { return const_reverse_iterator(_rep.end()); }
+
+        const_reverse_iterator rend() const { return const_reverse_iterator(_rep.begin()); }
+
+        const_reverse_iterator crend() const { return const_reverse_iterator(_rep.begin()); }
+
+        bool empty() const noexcept { return _rep.empty(); }
+
+        size_type size() const noexcept { return _rep.size(); }
+
+        size_type max_size() const noexcept { return _rep.max_size(); }
+
+        void clear() { _rep.clear(); }
+
+        HxSTL::pair<iterator, bool> insert(const value_type& value) {
+            bool inserted = _rep.insert_unique(value);
+            return HxSTL::make_pair(_rep.find(value.first), inserted);
+        }
+
+        HxSTL::pair<iterator, bool> insert(value_type&& value) {
+            const Key key = value.first;
+            bool inserted = _rep.insert_unique(HxSTL::move(value));
+            return HxSTL::make_pair(_rep.find(key), inserted);
+        }
+
+        template <class InputIt>
+        void insert(InputIt first, InputIt last) {
+            while (first != last) _rep.insert_unique(*(first++));
+        }
+
+        void insert(HxSTL::initializer_list<value_type> init) {
+            insert(init.begin(), init.end());
+        }
+
+        template <class M>
+        HxSTL::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj) {
+            bool inserted = _rep.insert_or_assign_unique(value_type(key, HxSTL::forward<M>(obj)));
+            return HxSTL::make_pair(_rep.find(key), inserted);
+        }
+
+        template <class... Args>
+        HxSTL::pair<iterator, bool> emplace(Args&&... args) {
+            return insert(value_type(HxSTL::forward<Args>(args)...));
+        }
+
+        size_type erase(const Key& key) { return _rep.erase(key); }
+
+        void swap(persistent_map& other) { _rep.swap(other._rep); }
+
+        size_type count(const Key& key) const { return _rep.count(key); }
+
+        const_iterator find(const Key& key) const { return _rep.find(key); }
+
+        HxSTL::pair<const_iterator, const_iterator> equal_range(const Key& key) const { return _rep.equal_range(key); }
+
+        const_iterator lower_bound(const Key& key) const { return _rep.lower_bound(key); }
+
+        const_iterator upper_bound(const Key& key) const { return _rep.upper_bound(key); }
+
+        key_compare key_comp() const { return _rep.get_compare(); }
+
+        value_compare value_comp() const { return value_compare(_rep.get_compare()); }
+    public:
+        template <class K, class V, class C, class A>
+        friend bool operator==(const persistent_map<K, V, C, A> &lhs, const persistent_map<K, V, C, A> &rhs);
+    };
+
+    template <class Key, class T, class Compare, class Alloc>
+    bool operator==(const persistent_map<Key, T, Compare, Alloc>& lhs, const persistent_map<Key, T, Compare, Alloc>& rhs) {
+        return lhs._rep == rhs._rep;
+    }
+
+    template <class Key, class T, class Compare, class Alloc>
+    bool operator!=(const persistent_map<Key, T, Compare, Alloc>& lhs, const persistent_map<Key, T, Compare, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template <class Key, class T, class Compare, class Alloc>
+    void swap(persistent_map<Key, T, Compare, Alloc>& lhs, persistent_map<Key, T, Compare, Alloc>& rhs) {
+        lhs.swap(rhs);
+    }
+
+}
+
+
+#endif
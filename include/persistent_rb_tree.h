@@ -0,0 +1,600 @@
+#ifndef _PERSISTENT_RB_TREE_
+#define _PERSISTENT_RB_TREE_
+
+
+#include <atomic>
+#include "allocator.h"
+#include "iterator.h"
+#include "functional.h"
+#include "stdexcept.h"
+#include "rb_tree_base.h"
+
+
+namespace HxSTL {
+
+    // 节点创建后不再修改, 可以被多个版本共享
+    // 没有 parent 指针, 更新时复制根到修改点的路径 (path copying)
+    template <class T>
+    struct __persistent_rb_tree_node {
+        typedef __persistent_rb_tree_node<T>*   link_type;
+
+        __rb_tree_color color;
+        link_type left;
+        link_type right;
+        std::atomic<size_t> refs;
+        T value;
+    };
+
+    template <class T>
+    struct __persistent_rb_tree_iterator {
+        typedef HxSTL::bidirectional_iterator_tag       iterator_category;
+        typedef T                                       value_type;
+        typedef const T&                                reference;
+        typedef const T*                                pointer;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+        typedef __persistent_rb_tree_node<T>*           link_type;
+
+        // 红黑树高度不超过 2 * log(n + 1), 96 层足够容纳 2^48 个节点
+        enum { __MAX_DEPTH = 96 };
+
+        link_type root;
+        link_type path[__MAX_DEPTH];    // 根到当前节点的路径, depth 为 0 表示 end()
+        int depth;
+
+        __persistent_rb_tree_iterator(): root(NULL), depth(0) {}
+
+        explicit __persistent_rb_tree_iterator(link_type r): root(r), depth(0) {}
+
+        __persistent_rb_tree_iterator(const __persistent_rb_tree_iterator& other): root(other.root), depth(other.depth) {
+            for (int i = 0; i != depth; ++i) path[i] = other.path[i];
+        }
+
+        __persistent_rb_tree_iterator& operator=(const __persistent_rb_tree_iterator& other) {
+            root = other.root;
+            depth = other.depth;
+            for (int i = 0; i != depth; ++i) path[i] = other.path[i];
+            return *this;
+        }
+
+        link_type node() const { return depth == 0 ? NULL : path[depth - 1]; }
+
+        reference operator*() const { return path[depth - 1] -> value; }
+
+        pointer operator->() const { return &(operator*()); }
+
+        void push_leftmost(link_type x) {
+            for (; x != NULL; x = x -> left) path[depth++] = x;
+        }
+
+        void push_rightmost(link_type x) {
+            for (; x != NULL; x = x -> right) path[depth++] = x;
+        }
+
+        void increment() {
+            link_type x = path[depth - 1];
+            if (x -> right != NULL) {
+                push_leftmost(x -> right);
+                return;
+            }
+            // 回溯到第一个从左孩子上来的祖先
+            while (--depth != 0 && path[depth - 1] -> right == x) {
+                x = path[depth - 1];
+            }
+        }
+
+        void decrement() {
+            if (depth == 0) {   // end() 的前一个是最大元素
+                push_rightmost(root);
+                return;
+            }
+            link_type x = path[depth - 1];
+            if (x -> left != NULL) {
+                push_rightmost(x -> left);
+                return;
+            }
+            while (--depth != 0 && path[depth - 1] -> left == x) {
+                x = path[depth - 1];
+            }
+        }
+
+        __persistent_rb_tree_iterator& operator++() {
+            increment();
+            return *this;
+        }
+
+        __persistent_rb_tree_iterator operator++(int) {
+            __persistent_rb_tree_iterator tmp = *this;
+            increment();
+            return tmp;
+        }
+
+        __persistent_rb_tree_iterator& operator--() {
+            decrement();
+            return *this;
+        }
+
+        __persistent_rb_tree_iterator operator--(int) {
+            __persistent_rb_tree_iterator tmp = *this;
+            decrement();
+            return tmp;
+        }
+
+        bool operator==(const __persistent_rb_tree_iterator& other) const { return node() == other.node(); }
+
+        bool operator!=(const __persistent_rb_tree_iterator& other) const { return node() != other.node(); }
+    };
+
+    // 持久化红黑树: 拷贝 O(1), 与拷贝源共享全部节点
+    // 插入/删除沿用 Okasaki / Kahrs 的函数式平衡规则, 只新建 O(log n) 个节点, 其他版本不受影响
+    // 节点引用计数是原子的, 不同线程可以各自持有和释放共享同一批节点的版本
+    // 但 _root 本身不是原子的: 拷贝同一个对象与修改它 (set_root 会释放旧根) 不能同时进行, 需要外部同步
+    // 要求 Alloc 无状态, 节点可能由任意一个版本释放
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    class persistent_rb_tree {
+    public:
+        typedef K                                                                       key_type;
+        typedef V                                                                       value_type;
+        typedef const V*                                                                pointer;
+        typedef const V*                                                                const_pointer;
+        typedef const V&                                                                reference;
+        typedef const V&                                                                const_reference;
+        typedef size_t                                                                  size_type;
+        typedef ptrdiff_t                                                               difference_type;
+        typedef __persistent_rb_tree_iterator<V>                                        iterator;
+        typedef __persistent_rb_tree_iterator<V>                                        const_iterator;
+        typedef typename iterator::link_type                                            link_type;
+        typedef typename Alloc::template rebind<__persistent_rb_tree_node<V>>::other    node_allocator_type;
+    protected:
+        // 持有节点的一个引用
+        class node_ptr {
+        protected:
+            link_type _p;
+        public:
+            node_ptr(): _p(NULL) {}
+
+            explicit node_ptr(link_type p): _p(p) {}
+
+            node_ptr(const node_ptr& other): _p(acquire(other._p)) {}
+
+            node_ptr(node_ptr&& other): _p(other._p) { other._p = NULL; }
+
+            ~node_ptr() { release(_p); }
+
+            node_ptr& operator=(node_ptr other) {
+                HxSTL::swap(_p, other._p);
+                return *this;
+            }
+
+            link_type get() const { return _p; }
+
+            link_type operator->() const { return _p; }
+
+            link_type release_ptr() {
+                link_type p = _p;
+                _p = NULL;
+                return p;
+            }
+        };
+    protected:
+        link_type _root;
+        size_type _count;
+        Compare _compare;
+    protected:
+        static link_type acquire(link_type x) {
+            if (x != NULL) x -> refs.fetch_add(1, std::memory_order_relaxed);
+            return x;
+        }
+
+        static void release(link_type x);
+
+        static node_ptr share(link_type x) { return node_ptr(acquire(x)); }
+
+        template <class... Args>
+        static node_ptr make_node(__rb_tree_color color, node_ptr left, node_ptr right, Args&&... args);
+
+        static node_ptr make_node(__rb_tree_color color, node_ptr left, const V& value, node_ptr right) {
+            return make_node(color, HxSTL::move(left), HxSTL::move(right), value);
+        }
+
+        static bool is_red(link_type x) { return x != NULL && x -> color == __red; }
+        static bool is_black(link_type x) { return x != NULL && x -> color == __black; }
+
+        static K KEY(link_type x) { return KOV()(x -> value); }
+
+        static node_ptr recolor(link_type x, __rb_tree_color color);
+        static node_ptr balance(node_ptr left, const V& value, node_ptr right);
+        static node_ptr balance_left(node_ptr left, const V& value, node_ptr right);
+        static node_ptr balance_right(node_ptr left, const V& value, node_ptr right);
+        static node_ptr join_aux(link_type left, link_type right);
+
+        template <class Arg>
+        node_ptr insert_aux(link_type x, const K& key, Arg&& value, bool& inserted);
+        node_ptr erase_aux(link_type x, const K& key);
+        void set_root(node_ptr x);
+
+        link_type find_aux(const K& key) const;
+        iterator bound_aux(const K& key, bool upper) const;
+    public:
+        explicit persistent_rb_tree(const Compare& comp = Compare(), const Alloc& = Alloc())
+            : _root(NULL), _count(0), _compare(comp) {}
+
+        persistent_rb_tree(const persistent_rb_tree& other)
+            : _root(acquire(other._root)), _count(other._count), _compare(other._compare) {}
+
+        persistent_rb_tree(persistent_rb_tree&& other)
+            : _root(other._root), _count(other._count), _compare(other._compare) {
+            other._root = NULL;
+            other._count = 0;
+        }
+
+        ~persistent_rb_tree() { release(_root); }
+
+        persistent_rb_tree& operator=(const persistent_rb_tree& other) {
+            link_type old = _root;
+            _root = acquire(other._root);
+            _count = other._count;
+            _compare = other._compare;
+            release(old);
+            return *this;
+        }
+
+        persistent_rb_tree& operator=(persistent_rb_tree&& other) {
+            if (this != &other) {
+                clear();
+                swap(other);
+            }
+            return *this;
+        }
+
+        Alloc get_allocator() const { return Alloc(); }
+
+        Compare get_compare() const { return _compare; }
+
+        iterator begin() const {
+            iterator it(_root);
+            it.push_leftmost(_root);
+            return it;
+        }
+
+        iterator end() const { return iterator(_root); }
+
+        bool empty() const { return _count == 0; }
+
+        size_type size() const { return _count; }
+
+        size_type max_size() const { return size_type(-1) / sizeof(__persistent_rb_tree_node<V>); }
+
+        // 两个版本是否共享同一个根
+        bool same_root(const persistent_rb_tree& other) const { return _root == other._root; }
+
+        void clear() {
+            release(_root);
+            _root = NULL;
+            _count = 0;
+        }
+
+        void swap(persistent_rb_tree& other) {
+            HxSTL::swap(_root, other._root);
+            HxSTL::swap(_count, other._count);
+            HxSTL::swap(_compare, other._compare);
+        }
+
+        // 键已存在时不做任何修改, 也不复制路径
+        template <class Arg>
+        bool insert_unique(Arg&& value) {
+            const K key = KOV()(value);
+            if (find_aux(key) != NULL) return false;
+
+            bool inserted = false;
+            set_root(insert_aux(_root, key, HxSTL::forward<Arg>(value), inserted));
+            ++_count;
+            return true;
+        }
+
+        // 键已存在时用 value 替换原节点
+        template <class Arg>
+        bool insert_or_assign_unique(Arg&& value) {
+            const K key = KOV()(value);
+            bool inserted = false;
+            set_root(insert_aux(_root, key, HxSTL::forward<Arg>(value), inserted));
+            if (inserted) ++_count;
+            return inserted;
+        }
+
+        size_type erase(const K& key) {
+            if (find_aux(key) == NULL) return 0;
+            set_root(erase_aux(_root, key));
+            --_count;
+            return 1;
+        }
+
+        size_type count(const K& key) const { return find_aux(key) == NULL ? 0 : 1; }
+
+        iterator find(const K& key) const {
+            iterator it = lower_bound(key);
+            return it == end() || _compare(key, KOV()(*it)) ? end() : it;
+        }
+
+        iterator lower_bound(const K& key) const { return bound_aux(key, false); }
+
+        iterator upper_bound(const K& key) const { return bound_aux(key, true); }
+
+        HxSTL::pair<iterator, iterator> equal_range(const K& key) const {
+            return HxSTL::make_pair(lower_bound(key), upper_bound(key));
+        }
+
+        // 只读查找, 不构造迭代器
+        const V* find_value(const K& key) const {
+            link_type x = find_aux(key);
+            return x == NULL ? NULL : &(x -> value);
+        }
+    };
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void persistent_rb_tree<K, V, KOV, Compare, Alloc>::release(link_type x) {
+        // 左孩子递归右孩子迭代, 递归深度不超过树高
+        while (x != NULL && x -> refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            link_type right = x -> right;
+            release(x -> left);
+
+            node_allocator_type alloc;
+            alloc.destroy(&(x -> value));
+            alloc.deallocate(x, 1);
+
+            x = right;
+        }
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    template <class... Args>
+    auto persistent_rb_tree<K, V, KOV, Compare, Alloc>::make_node(__rb_tree_color color,
+            node_ptr left, node_ptr right, Args&&... args) -> node_ptr {
+        node_allocator_type alloc;
+        link_type x = alloc.allocate(1);
+        try {
+            alloc.construct(&(x -> value), HxSTL::forward<Args>(args)...);
+        } catch (...) {
+            alloc.deallocate(x, 1);
+            throw;
+        }
+        ::new (static_cast<void*>(&(x -> refs))) std::atomic<size_t>(1);
+        x -> color = color;
+        x -> left = left.release_ptr();
+        x -> right = right.release_ptr();
+        return node_ptr(x);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto persistent_rb_tree<K, V, KOV, Compare, Alloc>::recolor(link_type x, __rb_tree_color color) -> node_ptr {
+        if (x -> color == color) return share(x);
+        return make_node(color, share(x -> left), x -> value, share(x -> right));
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto persistent_rb_tree<K, V, KOV, Compare, Alloc>::balance(node_ptr a, const V& value, node_ptr b) -> node_ptr {
+        link_type l = a.get();
+        link_type r = b.get();
+
+        if (is_red(l) && is_red(r)) {
+            return make_node(__red, recolor(l, __black), value, recolor(r, __black));
+        }
+
+        if (is_red(l) && is_red(l -> left)) {
+            /*
+             *       z            y
+             *      / \          / \
+             *     y   d   ->   x   z
+             *    / \          / \ / \
+             *   x   c        a  b c  d
+             */
+            return make_node(__red, recolor(l -> left, __black), l -> value,
+                    make_node(__black, share(l -> right), value, HxSTL::move(b)));
+        }
+
+        if (is_red(l) && is_red(l -> right)) {
+            link_type m = l -> right;
+            return make_node(__red, make_node(__black, share(l -> left), l -> value, share(m -> left)), m -> value,
+                    make_node(__black, share(m -> right), value, HxSTL::move(b)));
+        }
+
+        if (is_red(r) && is_red(r -> right)) {
+            return make_node(__red, make_node(__black, HxSTL::move(a), value, share(r -> left)), r -> value,
+                    recolor(r -> right, __black));
+        }
+
+        if (is_red(r) && is_red(r -> left)) {
+            link_type m = r -> left;
+            return make_node(__red, make_node(__black, HxSTL::move(a), value, share(m -> left)), m -> value,
+                    make_node(__black, share(m -> right), r -> value, share(r -> right)));
+        }
+
+        return make_node(__black, HxSTL::move(a), value, HxSTL::move(b));
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto persistent_rb_tree<K, V, KOV, Compare, Alloc>::balance_left(node_ptr a, const V& value, node_ptr b) -> node_ptr {
+        // 左子树黑高比右子树少 1
+        link_type l = a.get();
+        link_type r = b.get();
+
+        if (is_red(l)) {
+            return make_node(__red, recolor(l, __black), value, HxSTL::move(b));
+        }
+
+        if (is_black(r)) {
+            return balance(HxSTL::move(a), value, recolor(r, __red));
+        }
+
+        if (is_red(r) && is_black(r -> left)) {
+            link_type m = r -> left;
+            return make_node(__red, make_node(__black, HxSTL::move(a), value, share(m -> left)), m -> value,
+                    balance(share(m -> right), r -> value, recolor(r -> right, __red)));
+        }
+
+        throw HxSTL::logic_error();
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto persistent_rb_tree<K, V, KOV, Compare, Alloc>::balance_right(node_ptr a, const V& value, node_ptr b) -> node_ptr {
+        // 右子树黑高比左子树少 1
+        link_type l = a.get();
+        link_type r = b.get();
+
+        if (is_red(r)) {
+            return make_node(__red, HxSTL::move(a), value, recolor(r, __black));
+        }
+
+        if (is_black(l)) {
+            return balance(recolor(l, __red), value, HxSTL::move(b));
+        }
+
+        if (is_red(l) && is_black(l -> right)) {
+            link_type m = l -> right;
+            return make_node(__red, balance(recolor(l -> left, __red), l -> value, share(m -> left)), m -> value,
+                    make_node(__black, share(m -> right), value, HxSTL::move(b)));
+        }
+
+        throw HxSTL::logic_error();
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto persistent_rb_tree<K, V, KOV, Compare, Alloc>::join_aux(link_type l, link_type r) -> node_ptr {
+        // 合并被删除节点的左右子树, l 中元素都小于 r 中元素
+        if (l == NULL) return share(r);
+        if (r == NULL) return share(l);
+
+        if (is_red(l) && is_red(r)) {
+            node_ptr m = join_aux(l -> right, r -> left);
+            if (is_red(m.get())) {
+                return make_node(__red, make_node(__red, share(l -> left), l -> value, share(m -> left)), m -> value,
+                        make_node(__red, share(m -> right), r -> value, share(r -> right)));
+            }
+            return make_node(__red, share(l -> left), l -> value,
+                    make_node(__red, HxSTL::move(m), r -> value, share(r -> right)));
+        }
+
+        if (is_black(l) && is_black(r)) {
+            node_ptr m = join_aux(l -> right, r -> left);
+            if (is_red(m.get())) {
+                return make_node(__red, make_node(__black, share(l -> left), l -> value, share(m -> left)), m -> value,
+                        make_node(__black, share(m -> right), r -> value, share(r -> right)));
+            }
+            return balance_left(share(l -> left), l -> value,
+                    make_node(__black, HxSTL::move(m), r -> value, share(r -> right)));
+        }
+
+        if (is_red(r)) {
+            return make_node(__red, join_aux(l, r -> left), r -> value, share(r -> right));
+        }
+
+        return make_node(__red, share(l -> left), l -> value, join_aux(l -> right, r));
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    template <class Arg>
+    auto persistent_rb_tree<K, V, KOV, Compare, Alloc>::insert_aux(link_type x, const K& key,
+            Arg&& value, bool& inserted) -> node_ptr {
+        if (x == NULL) {
+            inserted = true;
+            return make_node(__red, node_ptr(), node_ptr(), HxSTL::forward<Arg>(value));
+        }
+
+        if (_compare(key, KEY(x))) {
+            node_ptr l = insert_aux(x -> left, key, HxSTL::forward<Arg>(value), inserted);
+            if (x -> color == __black) return balance(HxSTL::move(l), x -> value, share(x -> right));
+            return make_node(__red, HxSTL::move(l), x -> value, share(x -> right));
+        }
+
+        if (_compare(KEY(x), key)) {
+            node_ptr r = insert_aux(x -> right, key, HxSTL::forward<Arg>(value), inserted);
+            if (x -> color == __black) return balance(share(x -> left), x -> value, HxSTL::move(r));
+            return make_node(__red, share(x -> left), x -> value, HxSTL::move(r));
+        }
+
+        return make_node(x -> color, share(x -> left), share(x -> right), HxSTL::forward<Arg>(value));
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto persistent_rb_tree<K, V, KOV, Compare, Alloc>::erase_aux(link_type x, const K& key) -> node_ptr {
+        if (x == NULL) return node_ptr();
+
+        if (_compare(key, KEY(x))) {
+            if (is_black(x -> left)) {
+                return balance_left(erase_aux(x -> left, key), x -> value, share(x -> right));
+            }
+            return make_node(__red, erase_aux(x -> left, key), x -> value, share(x -> right));
+        }
+
+        if (_compare(KEY(x), key)) {
+            if (is_black(x -> right)) {
+                return balance_right(share(x -> left), x -> value, erase_aux(x -> right, key));
+            }
+            return make_node(__red, share(x -> left), x -> value, erase_aux(x -> right, key));
+        }
+
+        return join_aux(x -> left, x -> right);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    void persistent_rb_tree<K, V, KOV, Compare, Alloc>::set_root(node_ptr x) {
+        // 根节点总是黑色
+        if (x.get() != NULL && x -> color == __red) {
+            x = recolor(x.get(), __black);
+        }
+        link_type old = _root;
+        _root = x.release_ptr();
+        release(old);
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto persistent_rb_tree<K, V, KOV, Compare, Alloc>::find_aux(const K& key) const -> link_type {
+        link_type x = _root;
+        while (x != NULL) {
+            if (_compare(key, KEY(x))) {
+                x = x -> left;
+            } else if (_compare(KEY(x), key)) {
+                x = x -> right;
+            } else {
+                return x;
+            }
+        }
+        return NULL;
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    auto persistent_rb_tree<K, V, KOV, Compare, Alloc>::bound_aux(const K& key, bool upper) const -> iterator {
+        // 下降时记录完整路径, 最后截断到最后一个满足条件的节点
+        iterator it(_root);
+        int found = 0;
+
+        for (link_type x = _root; x != NULL; ) {
+            it.path[it.depth++] = x;
+            if (upper ? _compare(key, KEY(x)) : !_compare(KEY(x), key)) {
+                found = it.depth;
+                x = x -> left;
+            } else {
+                x = x -> right;
+            }
+        }
+
+        it.depth = found;
+        return it;
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    bool operator==(const persistent_rb_tree<K, V, KOV, Compare, Alloc>& lhs,
+            const persistent_rb_tree<K, V, KOV, Compare, Alloc>& rhs) {
+        return lhs.size() == rhs.size() && (lhs.same_root(rhs) || HxSTL::equal(lhs.begin(), lhs.end(), rhs.begin()));
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    bool operator!=(const persistent_rb_tree<K, V, KOV, Compare, Alloc>& lhs,
+            const persistent_rb_tree<K, V, KOV, Compare, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+}
+
+
+#endif
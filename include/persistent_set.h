@@ -0,0 +1,156 @@
+#ifndef _PERSISTENT_SET_H_
+#define _PERSISTENT_SET_H_
+
+
+#include "persistent_rb_tree.h"
+#include "functional.h"
+
+
+namespace HxSTL {
+
+    // 不可变的有序 set: 拷贝 (snapshot) O(1), 修改只影响当前对象, 已有的拷贝保持不变
+    template <class Key, class Compare = HxSTL::less<Key>, class Alloc = HxSTL::allocator<Key>>
+    class persistent_set {
+    public:
+        typedef Key                                     key_type;
+        typedef Key                                     value_type;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+        typedef Compare                                 key_compare;
+        typedef Compare                                 value_compare;
+        typedef Alloc                                   allocator_type;
+        typedef const value_type&                       reference;
+        typedef const value_type&                       const_reference;
+        typedef const value_type*                       pointer;
+        typedef const value_type*                       const_pointer;
+    protected:
+        typedef HxSTL::persistent_rb_tree<key_type, value_type, __identity<value_type>, key_compare, allocator_type>    rep_type;
+    public:
+        typedef typename rep_type::const_iterator                   iterator;
+        typedef typename rep_type::const_iterator                   const_iterator;
+        typedef typename HxSTL::reverse_iterator<iterator>          reverse_iterator;
+        typedef typename HxSTL::reverse_iterator<const_iterator>    const_reverse_iterator;
+    protected:
+        rep_type _rep;
+    public:
+        persistent_set(): persistent_set(Compare()) {}
+
+        explicit persistent_set(const Compare& comp, const Alloc& alloc = Alloc()): _rep(comp, alloc) {}
+
+        template <class InputIt>
+        persistent_set(InputIt first, InputIt last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : _rep(comp, alloc) { insert(first, last); }
+
+        persistent_set(const persistent_set& other): _rep(other._rep) {}
+
+        persistent_set(persistent_set&& other): _rep(HxSTL::move(other._rep)) {}
+
+        persistent_set(HxSTL::initializer_list<value_type> init, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : _rep(comp, alloc) { insert(init.begin(), init.end()); }
+
+        persistent_set& operator=(const persistent_set& other) {
+            _rep = other._rep;
+            return *this;
+        }
+
+        persistent_set& operator=(persistent_set&& other) {
+            _rep = HxSTL::move(other._rep);
+            return *this;
+        }
+
+        persistent_set& operator=(HxSTL::initializer_list<value_type> init) {
+            clear();
+            insert(init.begin(), init.end());
+            return *this;
+        }
+
+        Alloc get_allocator() const { return _rep.get_allocator(); }
+
+        // 当前版本的只读快照, 与 *this 共享全部节点, 之后对 *this 的修改不影响快照
+        // 它只是一次拷贝, 不能与其他线程对 *this 的修改并发调用; 取得快照后可以交给其他线程独立读取
+        persistent_set snapshot() const { return *this; }
+
+        const_iterator begin() const { return _rep.begin(); }
+
+        const_iterator cbegin() const { return _rep.begin(); }
+
+        const_iterator end() const { return _rep.end(); }
+
+        const_iterator cend() const { return _rep.end(); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(_rep.end()); }
+
+        const_reverse_iterator crbegin() const { return const_reverse_iterator(_rep.end()); }
+
+        const_reverse_iterator rend() const { return const_reverse_iterator(_rep.begin()); }
+
+        const_reverse_iterator crend() const { return const_reverse_iterator(_rep.begin()); }
+
+        bool empty() const noexcept { return _rep.empty(); }
+
+        size_type size() const noexcept { return _rep.size(); }
+
+        size_type max_size() const noexcept { return _rep.max_size(); }
+
+        void clear() { _rep.clear(); }
+
+        HxSTL::pair<iterator, bool> insert(const value_type& value) {
+            bool inserted = _rep.insert_unique(value);
+            return HxSTL::make_pair(_rep.find(value), inserted);
+        }
+
+        template <class InputIt>
+        void insert(InputIt first, InputIt last) {
+            while (first != last) _rep.insert_unique(*(first++));
+        }
+
+        void insert(HxSTL::initializer_list<value_type> init) {
+            insert(init.begin(), init.end());
+        }
+
+        template <class... Args>
+        HxSTL::pair<iterator, bool> emplace(Args&&... args) {
+            return insert(value_type(HxSTL::forward<Args>(args)...));
+        }
+
+        size_type erase(const Key& key) { return _rep.erase(key); }
+
+        void swap(persistent_set& other) { _rep.swap(other._rep); }
+
+        size_type count(const Key& key) const { return _rep.count(key); }
+
+        const_iterator find(const Key& key) const { return _rep.find(key); }
+
+        HxSTL::pair<const_iterator, const_iterator> equal_range(const Key& key) const { return _rep.equal_range(key); }
+
+        const_iterator lower_bound(const Key& key) const { return _rep.lower_bound(key); }
+
+        const_iterator upper_bound(const Key& key) const { return _rep.upper_bound(key); }
+
+        key_compare key_comp() const { return _rep.get_compare(); }
+
+        value_compare value_comp() const { return _rep.get_compare(); }
+    public:
+        template <class K, class C, class A>
+        friend bool operator==(const persistent_set<K, C, A> &lhs, const persistent_set<K, C, A> &rhs);
+    };
+
+    template <class Key, class Compare, class Alloc>
+    bool operator==(const persistent_set<Key, Compare, Alloc>& lhs, const persistent_set<Key, Compare, Alloc>& rhs) {
+        return lhs._rep == rhs._rep;
+    }
+
+    template <class Key, class Compare, class Alloc>
+    bool operator!=(const persistent_set<Key, Compare, Alloc>& lhs, const persistent_set<Key, Compare, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template <class Key, class Compare, class Alloc>
+    void swap(persistent_set<Key, Compare, Alloc>& lhs, persistent_set<Key, Compare, Alloc>& rhs) {
+        lhs.swap(rhs);
+    }
+
+}
+
+
+#endif
@@ -0,0 +1,445 @@
+#ifndef _RADIX_SORT_H_
+#define _RADIX_SORT_H_
+
+
+#include <stdint.h>
+#include <string.h>
+#include "algorithm.h"
+#include "basic_string.h"
+#include "execution.h"
+#include "functional.h"
+#include "type_traits.h"
+#include "vector.h"
+
+
+namespace HxSTL {
+
+    template <size_t Size>
+    struct __radix_unsigned;
+
+    template <>
+    struct __radix_unsigned<1> { typedef uint8_t type; };
+
+    template <>
+    struct __radix_unsigned<2> { typedef uint16_t type; };
+
+    template <>
+    struct __radix_unsigned<4> { typedef uint32_t type; };
+
+    template <>
+    struct __radix_unsigned<8> { typedef uint64_t type; };
+
+    // 把键映射为同样宽度的无符号整数, 无符号整数的大小顺序与键的 < 一致
+    //   有符号整数: 翻转符号位
+    //   浮点数: 正数翻转符号位, 负数按位取反; -0.0 排在 +0.0 之前, NaN 按符号位排在两端
+    template <class Key,
+        bool Integral = is_integeral<Key>::value,
+        bool Floating = is_floating_point<Key>::value>
+    struct __radix_key;
+
+    template <class Key>
+    struct __radix_key<Key, true, false> {
+        typedef typename __radix_unsigned<sizeof(Key)>::type type;
+
+        static type get(Key key) {
+            type u = static_cast<type>(key);
+            if (Key(-1) < Key(0)) {
+                u ^= type(1) << (sizeof(Key) * 8 - 1);
+            }
+            return u;
+        }
+    };
+
+    template <class Key>
+    struct __radix_key<Key, false, true> {
+        typedef typename __radix_unsigned<sizeof(Key)>::type type;
+
+        static type get(Key key) {
+            type u;
+            memcpy(&u, &key, sizeof(Key));
+            const type sign = type(1) << (sizeof(Key) * 8 - 1);
+            return (u & sign) ? ~u : (u ^ sign);
+        }
+    };
+
+    // 按映射后的键比较, 用于小区间的插入排序
+    template <class KeyFn, class Key>
+    struct __radix_key_less {
+        KeyFn* key;
+
+        template <class T>
+        bool operator()(const T& x, const T& y) const {
+            return __radix_key<Key>::get((*key)(x)) < __radix_key<Key>::get((*key)(y));
+        }
+    };
+
+    // 小于这个长度的区间直接插入排序
+    const size_t __radix_insertion_threshold = 64;
+
+    // 统计 [b, e) 中第 digit 位 (从低到高, 每位 8 bit) 的直方图
+    template <class Key, class RandomIt, class KeyFn>
+    void __radix_histogram(RandomIt first, size_t b, size_t e, KeyFn& key, size_t digit, size_t* count) {
+        const size_t shift = digit * 8;
+        for (; b < e; ++b) {
+            ++count[(__radix_key<Key>::get(key(*(first + b))) >> shift) & 0xff];
+        }
+    }
+
+    // 按第 digit 位把 [b, e) 稳定地分发到 result, offset 为本块各桶的下一个写入位置
+    template <class Key, class RandomIt1, class RandomIt2, class KeyFn>
+    void __radix_scatter(RandomIt1 first, size_t b, size_t e, RandomIt2 result,
+            KeyFn& key, size_t digit, size_t* offset) {
+        const size_t shift = digit * 8;
+        // 写入位置放在局部数组中, 编译器不必担心写 result 会改变它们
+        size_t next[256];
+        memcpy(next, offset, sizeof(next));
+        for (; b < e; ++b) {
+            size_t bucket = (__radix_key<Key>::get(key(*(first + b))) >> shift) & 0xff;
+            *(result + next[bucket]++) = HxSTL::move(*(first + b));
+        }
+    }
+
+    // LSD 的辅助缓冲区, 分配时不构造元素
+    // 第一遍分发从原区间写入缓冲区 (fill), 之后各遍在二者之间赋值
+    // 可平凡复制的类型直接按赋值写入未初始化的内存
+    template <class T, bool Trivial = is_trivially_copyable<T>::value>
+    struct __radix_buffer {
+        HxSTL::allocator<T> alloc;
+        T* data;
+        size_t size;
+
+        __radix_buffer(size_t n, size_t): data(alloc.allocate(n)), size(n) {}
+
+        ~__radix_buffer() { alloc.deallocate(data, size); }
+
+        void begin_fill(const HxSTL::vector<size_t>&) {}
+
+        template <class Key, class RandomIt, class KeyFn>
+        void fill(RandomIt first, size_t, size_t b, size_t e, KeyFn& key, size_t digit, size_t* offset) {
+            __radix_scatter<Key>(first, b, e, data, key, digit, offset);
+        }
+
+        void end_fill() {}
+    };
+
+    // 其它类型在第一遍分发时移动构造到目标位置; 各块在各桶中构造出的区间为
+    // [begin[c * 256 + bucket], end[c * 256 + bucket]), 构造中途抛出异常时据此析构已构造的元素
+    template <class T>
+    struct __radix_buffer<T, false> {
+        HxSTL::allocator<T> alloc;
+        T* data;
+        size_t size;
+        size_t chunks;
+        HxSTL::vector<size_t> begin;
+        HxSTL::vector<size_t> end;
+        bool filled;
+
+        __radix_buffer(size_t n, size_t chunks): data(alloc.allocate(n)), size(n), chunks(chunks), filled(false) {}
+
+        ~__radix_buffer() {
+            if (filled) {
+                HxSTL::destroy(alloc, data, data + size);
+            } else {
+                for (size_t i = 0; i < begin.size(); ++i) {
+                    HxSTL::destroy(alloc, data + begin[i], data + end[i]);
+                }
+            }
+            alloc.deallocate(data, size);
+        }
+
+        void begin_fill(const HxSTL::vector<size_t>& offset) {
+            begin = offset;
+            end = offset;
+        }
+
+        template <class Key, class RandomIt, class KeyFn>
+        void fill(RandomIt first, size_t c, size_t b, size_t e, KeyFn& key, size_t digit, size_t*) {
+            const size_t shift = digit * 8;
+            size_t* next = &end[c * 256];
+            for (; b < e; ++b) {
+                size_t bucket = (__radix_key<Key>::get(key(*(first + b))) >> shift) & 0xff;
+                HxSTL::construct(data + next[bucket], HxSTL::move(*(first + b)));
+                ++next[bucket];
+            }
+        }
+
+        void end_fill() { filled = true; }
+    };
+
+    // LSD 基数排序: 每次按 8 bit 稳定地分发, 在原区间与缓冲区之间交替
+    // 第一遍读出各块所有位的直方图, 所有元素落在同一个桶的位直接跳过
+    // chunks > 1 时各块并行统计与分发; 分发改变了各块的内容, 之后的每一遍要重新统计本位
+    template <class RandomIt, class KeyFn>
+    void __lsd_radix_sort(RandomIt first, RandomIt last, KeyFn& key, bool parallel) {
+        typedef typename iterator_traits<RandomIt>::value_type value_type;
+        typedef typename decay<decltype(key(*first))>::type key_type;
+        const size_t n = last - first;
+        const size_t digits = sizeof(key_type);
+        if (n <= __radix_insertion_threshold) {
+            __radix_key_less<KeyFn, key_type> comp = { &key };
+            __insertion_sort(first, last, comp);
+            return;
+        }
+        const size_t chunks = parallel ? __parallel_chunk_count(n, __parallel_grain) : 1;
+        HxSTL::vector<size_t> count(chunks * digits * 256, size_t(0));
+        auto histogram = [first, &key, &count, digits](size_t c, size_t b, size_t e) {
+            size_t* h = &count[c * digits * 256];
+            for (; b < e; ++b) {
+                typename __radix_key<key_type>::type u = __radix_key<key_type>::get(key(*(first + b)));
+                for (size_t d = 0; d < digits; ++d, u >>= 8) {
+                    ++h[d * 256 + (u & 0xff)];
+                }
+            }
+        };
+        __parallel_for_chunks(n, chunks, histogram);
+
+        __radix_buffer<value_type> buffer(n, chunks);
+        HxSTL::vector<size_t> offset(chunks * 256);
+        bool in_buffer = false;
+        bool filled = false;
+        bool recount = false;
+        for (size_t d = 0; d < digits; ++d) {
+            bool trivial = false;
+            for (size_t bucket = 0; bucket < 256 && !trivial; ++bucket) {
+                size_t total = 0;
+                for (size_t c = 0; c < chunks; ++c) {
+                    total += count[(c * digits + d) * 256 + bucket];
+                }
+                trivial = total == n;
+            }
+            if (trivial) {
+                continue;
+            }
+            if (recount && chunks > 1) {
+                value_type* data = buffer.data;
+                bool from_buffer = in_buffer;
+                auto recount_chunk = [first, data, from_buffer, &key, &count, digits, d](size_t c, size_t b, size_t e) {
+                    size_t* h = &count[(c * digits + d) * 256];
+                    memset(h, 0, 256 * sizeof(size_t));
+                    if (from_buffer) {
+                        __radix_histogram<key_type>(data, b, e, key, d, h);
+                    } else {
+                        __radix_histogram<key_type>(first, b, e, key, d, h);
+                    }
+                };
+                __parallel_for_chunks(n, chunks, recount_chunk);
+            }
+            recount = true;
+            // 桶优先, 同一桶内按块的顺序排列, 保证稳定
+            size_t running = 0;
+            for (size_t bucket = 0; bucket < 256; ++bucket) {
+                for (size_t c = 0; c < chunks; ++c) {
+                    offset[c * 256 + bucket] = running;
+                    running += count[(c * digits + d) * 256 + bucket];
+                }
+            }
+            value_type* data = buffer.data;
+            bool from_buffer = in_buffer;
+            if (!filled) {
+                // 第一次写入缓冲区: 在目标位置上构造
+                buffer.begin_fill(offset);
+                auto fill = [first, &buffer, &key, &offset, d](size_t c, size_t b, size_t e) {
+                    buffer.template fill<key_type>(first, c, b, e, key, d, &offset[c * 256]);
+                };
+                __parallel_for_chunks(n, chunks, fill);
+                buffer.end_fill();
+                filled = true;
+            } else {
+                auto scatter = [first, data, from_buffer, &key, &offset, d](size_t c, size_t b, size_t e) {
+                    if (from_buffer) {
+                        __radix_scatter<key_type>(data, b, e, first, key, d, &offset[c * 256]);
+                    } else {
+                        __radix_scatter<key_type>(first, b, e, data, key, d, &offset[c * 256]);
+                    }
+                };
+                __parallel_for_chunks(n, chunks, scatter);
+            }
+            in_buffer = !in_buffer;
+        }
+        if (in_buffer) {
+            value_type* data = buffer.data;
+            auto move_back = [data, first](size_t, size_t b, size_t e) {
+                HxSTL::move(data + b, data + e, first + b);
+            };
+            __parallel_for_chunks(n, chunks, move_back);
+        }
+    }
+
+    // 字符串第 depth 个字符所在的桶, 0 表示字符串已结束
+    // 与 basic_string 的比较一致: 有符号字符类型按有符号值排序
+    template <class CharT, class Alloc, class Growth>
+    inline size_t __radix_char(const basic_string<CharT, Alloc, Growth>& s, size_t depth) {
+        if (depth >= s.size()) {
+            return 0;
+        }
+        unsigned char c = static_cast<unsigned char>(s[depth]);
+        return (CharT(-1) < CharT(0) ? c ^ 0x80 : c) + 1;
+    }
+
+    // 前 depth 个字符都相同的字符串之间, 从第 depth 个字符开始比较
+    struct __radix_suffix_less {
+        size_t depth;
+
+        template <class String>
+        bool operator()(const String& x, const String& y) const {
+            size_t n = x.size() < y.size() ? x.size() : y.size();
+            for (size_t i = depth; i < n; ++i) {
+                if (x[i] != y[i]) {
+                    return x[i] < y[i];
+                }
+            }
+            return x.size() < y.size();
+        }
+    };
+
+    // 各块并行统计第 depth 个字符的直方图, 再求和
+    template <class RandomIt>
+    void __msd_parallel_histogram(RandomIt first, size_t n, size_t depth, size_t* count) {
+        const size_t chunks = __parallel_chunk_count(n, __parallel_grain);
+        HxSTL::vector<size_t> local(chunks * 257, size_t(0));
+        auto histogram = [first, depth, &local](size_t c, size_t b, size_t e) {
+            size_t* h = &local[c * 257];
+            for (; b < e; ++b) {
+                ++h[__radix_char(*(first + b), depth)];
+            }
+        };
+        __parallel_for_chunks(n, chunks, histogram);
+        for (size_t c = 0; c < chunks; ++c) {
+            for (size_t b = 0; b < 257; ++b) {
+                count[b] += local[c * 257 + b];
+            }
+        }
+    }
+
+    // 小于这个长度的桶改用插入排序
+    const size_t __msd_insertion_threshold = 32;
+
+    // MSD 基数排序 (American flag sort): 按第 depth 个字符统计各桶大小, 原地循环置换到各自的桶,
+    // 再对每个桶按下一个字符递归; 字符串只交换, 不复制
+    // group 不为空时较大的桶作为任务并行处理
+    template <class RandomIt>
+    void __msd_radix_sort(RandomIt first, RandomIt last, size_t depth, task_group* group) {
+        for (;;) {
+            const size_t n = last - first;
+            if (n <= __msd_insertion_threshold) {
+                __radix_suffix_less comp = { depth };
+                __insertion_sort(first, last, comp);
+                return;
+            }
+            size_t count[257] = { 0 };
+            if (group != nullptr && n >= 2 * __parallel_grain) {
+                __msd_parallel_histogram(first, n, depth, count);
+            } else {
+                for (RandomIt it = first; it != last; ++it) {
+                    ++count[__radix_char(*it, depth)];
+                }
+            }
+            // 所有字符串的这个字符都相同时不用置换, 直接看下一个字符
+            size_t bucket = __radix_char(*first, depth);
+            if (count[bucket] == n) {
+                if (bucket == 0) {
+                    return;
+                }
+                ++depth;
+                continue;
+            }
+            size_t next[257], end[257];
+            size_t running = 0;
+            for (size_t b = 0; b < 257; ++b) {
+                next[b] = running;
+                running += count[b];
+                end[b] = running;
+            }
+            for (size_t b = 0; b < 257; ++b) {
+                while (next[b] < end[b]) {
+                    size_t c = __radix_char(*(first + next[b]), depth);
+                    if (c == b) {
+                        ++next[b];
+                    } else {
+                        HxSTL::iter_swap(first + next[b], first + next[c]++);
+                    }
+                }
+            }
+            for (size_t b = 1; b < 257; ++b) {
+                RandomIt lo = first + (end[b] - count[b]), hi = first + end[b];
+                if (count[b] <= 1) {
+                    continue;
+                }
+                if (group != nullptr && count[b] >= __parallel_grain) {
+                    group->spawn([lo, hi, depth, group]() { __msd_radix_sort(lo, hi, depth + 1, group); });
+                } else {
+                    __msd_radix_sort(lo, hi, depth + 1, group);
+                }
+            }
+            return;
+        }
+    }
+
+    template <class RandomIt>
+    void __string_radix_sort(RandomIt first, RandomIt last, bool parallel, true_type) {
+        if (parallel) {
+            task_group group;
+            __msd_radix_sort(first, last, 0, &group);
+            group.wait();
+        } else {
+            __msd_radix_sort(first, last, 0, static_cast<task_group*>(nullptr));
+        }
+    }
+
+    // 宽字符串的桶太多, 退回比较排序
+    template <class RandomIt>
+    void __string_radix_sort(RandomIt first, RandomIt last, bool, false_type) {
+        HxSTL::sort(first, last);
+    }
+
+    template <class T>
+    struct __is_basic_string: public false_type {};
+
+    template <class CharT, class Alloc, class Growth>
+    struct __is_basic_string<basic_string<CharT, Alloc, Growth>>: public true_type {};
+
+    template <class RandomIt>
+    void __radix_sort(RandomIt first, RandomIt last, bool parallel, true_type) {
+        typedef typename iterator_traits<RandomIt>::value_type::value_type char_type;
+        __string_radix_sort(first, last, parallel, integeral_constant<bool, sizeof(char_type) == 1>());
+    }
+
+    template <class RandomIt>
+    void __radix_sort(RandomIt first, RandomIt last, bool parallel, false_type) {
+        HxSTL::__identity<typename iterator_traits<RandomIt>::value_type> key;
+        __lsd_radix_sort(first, last, key, parallel);
+    }
+
+    // radix_sort
+    // 整数与浮点数用 LSD 基数排序, 稳定, 需要与区间等长的辅助缓冲区;
+    // basic_string 用 MSD 基数排序, 原地, 不稳定
+    // key(x) 返回整数或浮点数时按 key(x) 排序, 用于按结构体中的某个字段排序
+
+    template <class RandomIt>
+    void radix_sort(RandomIt first, RandomIt last) {
+        __radix_sort(first, last, false, typename __is_basic_string<typename iterator_traits<RandomIt>::value_type>::type());
+    }
+
+    template <class RandomIt, class KeyFn>
+    void radix_sort(RandomIt first, RandomIt last, KeyFn key) {
+        __lsd_radix_sort(first, last, key, false);
+    }
+
+    // 并行策略下各块并行统计直方图与分发, 字符串的各个桶并行递归
+    template <class ExecutionPolicy, class RandomIt>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, void>::type
+    radix_sort(ExecutionPolicy&&, RandomIt first, RandomIt last) {
+        __radix_sort(first, last, __parallel_dispatch<ExecutionPolicy, RandomIt>::value,
+            typename __is_basic_string<typename iterator_traits<RandomIt>::value_type>::type());
+    }
+
+    template <class ExecutionPolicy, class RandomIt, class KeyFn>
+    inline typename __enable_if_execution_policy<ExecutionPolicy, void>::type
+    radix_sort(ExecutionPolicy&&, RandomIt first, RandomIt last, KeyFn key) {
+        __lsd_radix_sort(first, last, key, __parallel_dispatch<ExecutionPolicy, RandomIt>::value);
+    }
+
+}
+
+
+#endif
@@ -0,0 +1,350 @@
+#ifndef _RANDOM_H_
+#define _RANDOM_H_
+
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include "type_traits.h"
+
+
+namespace HxSTL {
+
+    /*
+     * 随机数引擎
+     * 都满足 UniformRandomBitGenerator: result_type, 常量的 min() / max(), operator()
+     */
+
+    // splitmix64: 64 位状态每次加一个奇数常量再混合输出, 任意种子都能立即产生高质量的输出,
+    // 用来把一个 64 位种子展开为其它引擎的初始状态
+    class splitmix64 {
+    public:
+        typedef uint64_t result_type;
+
+        static const uint64_t default_seed = 0x9e3779b97f4a7c15ULL;
+
+    protected:
+        uint64_t _state;
+
+    public:
+        explicit splitmix64(uint64_t s = default_seed): _state(s) {}
+
+        void seed(uint64_t s = default_seed) { _state = s; }
+
+        static constexpr result_type min() { return 0; }
+
+        static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+        result_type operator()() {
+            uint64_t z = (_state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        void discard(unsigned long long n) { _state += n * 0x9e3779b97f4a7c15ULL; }
+
+        friend bool operator==(const splitmix64& x, const splitmix64& y) { return x._state == y._state; }
+
+        friend bool operator!=(const splitmix64& x, const splitmix64& y) { return x._state != y._state; }
+    };
+
+    // xoshiro256**: 256 位状态, 周期 2^256 - 1, 每次输出只需几次移位异或与两次乘法
+    // jump() 相当于调用 2^128 次, 从同一个种子出发每次 jump 得到一段互不重叠的序列, 供各线程使用
+    class xoshiro256starstar {
+    public:
+        typedef uint64_t result_type;
+
+        static const uint64_t default_seed = 0x9e3779b97f4a7c15ULL;
+
+    protected:
+        uint64_t _s[4];
+
+        static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+        void jump(const uint64_t* table);
+
+    public:
+        explicit xoshiro256starstar(uint64_t s = default_seed) { seed(s); }
+
+        // 状态不能全为 0, splitmix64 展开的 4 个输出不会全为 0
+        void seed(uint64_t s = default_seed) {
+            splitmix64 sm(s);
+            for (int i = 0; i < 4; ++i) {
+                _s[i] = sm();
+            }
+        }
+
+        static constexpr result_type min() { return 0; }
+
+        static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+        result_type operator()() {
+            const uint64_t result = rotl(_s[1] * 5, 7) * 9;
+            const uint64_t t = _s[1] << 17;
+            _s[2] ^= _s[0];
+            _s[3] ^= _s[1];
+            _s[1] ^= _s[2];
+            _s[0] ^= _s[3];
+            _s[2] ^= t;
+            _s[3] = rotl(_s[3], 45);
+            return result;
+        }
+
+        void discard(unsigned long long n) {
+            for (; n != 0; --n) {
+                (*this)();
+            }
+        }
+
+        void jump() {
+            static const uint64_t table[4] = {
+                0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+            jump(table);
+        }
+
+        // 相当于调用 2^192 次
+        void long_jump() {
+            static const uint64_t table[4] = {
+                0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+            jump(table);
+        }
+
+        friend bool operator==(const xoshiro256starstar& x, const xoshiro256starstar& y) {
+            return x._s[0] == y._s[0] && x._s[1] == y._s[1] && x._s[2] == y._s[2] && x._s[3] == y._s[3];
+        }
+
+        friend bool operator!=(const xoshiro256starstar& x, const xoshiro256starstar& y) { return !(x == y); }
+    };
+
+    // 跳跃多项式的每个为 1 的位, 把当时的状态异或进结果
+    inline void xoshiro256starstar::jump(const uint64_t* table) {
+        uint64_t s[4] = { 0, 0, 0, 0 };
+        for (int i = 0; i < 4; ++i) {
+            for (int b = 0; b < 64; ++b) {
+                if (table[i] & (static_cast<uint64_t>(1) << b)) {
+                    s[0] ^= _s[0];
+                    s[1] ^= _s[1];
+                    s[2] ^= _s[2];
+                    s[3] ^= _s[3];
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            _s[i] = s[i];
+        }
+    }
+
+    // pcg32 (PCG-XSH-RR): 64 位线性同余的状态, 输出 32 位; stream 选择不同的增量, 得到互相独立的序列
+    // 线性同余可以在 O(logn) 内前进 n 步, discard 不需要逐个生成
+    class pcg32 {
+    public:
+        typedef uint32_t result_type;
+
+        static const uint64_t default_seed = 0x853c49e6748fea9bULL;
+        static const uint64_t default_stream = 0xda3e39cb94b95bdbULL >> 1;
+
+    protected:
+        static const uint64_t multiplier = 6364136223846793005ULL;
+
+        uint64_t _state;
+        uint64_t _inc;      // 奇数
+
+    public:
+        explicit pcg32(uint64_t s = default_seed, uint64_t stream = default_stream) { seed(s, stream); }
+
+        void seed(uint64_t s = default_seed, uint64_t stream = default_stream) {
+            _state = 0;
+            _inc = (stream << 1) | 1;
+            (*this)();
+            _state += s;
+            (*this)();
+        }
+
+        static constexpr result_type min() { return 0; }
+
+        static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+        result_type operator()() {
+            uint64_t old = _state;
+            _state = old * multiplier + _inc;
+            uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+            uint32_t rot = static_cast<uint32_t>(old >> 59);
+            return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+        }
+
+        void discard(unsigned long long n);
+
+        friend bool operator==(const pcg32& x, const pcg32& y) { return x._state == y._state && x._inc == y._inc; }
+
+        friend bool operator!=(const pcg32& x, const pcg32& y) { return !(x == y); }
+    };
+
+    // 前进 n 步的变换仍是 x -> a * x + c, 按 n 的二进制位把每步的 (a, c) 平方合成
+    inline void pcg32::discard(unsigned long long n) {
+        uint64_t acc_mult = 1, acc_plus = 0;
+        uint64_t cur_mult = multiplier, cur_plus = _inc;
+        for (; n != 0; n >>= 1) {
+            if (n & 1) {
+                acc_mult *= cur_mult;
+                acc_plus = acc_plus * cur_mult + cur_plus;
+            }
+            cur_plus = (cur_mult + 1) * cur_plus;
+            cur_mult *= cur_mult;
+        }
+        _state = acc_mult * _state + acc_plus;
+    }
+
+    typedef xoshiro256starstar default_random_engine;
+
+    /*
+     * 有界整数
+     */
+
+    // 引擎输出的位数: 恰好覆盖全部 32 / 64 位时可以走快速路径, 否则为 0
+    template <class URBG>
+    struct __random_bits: public integeral_constant<int,
+        URBG::min() != 0 ? 0 :
+        static_cast<unsigned long long>(URBG::max()) == 0xffffffffffffffffULL ? 64 :
+        static_cast<unsigned long long>(URBG::max()) == 0xffffffffULL ? 32 : 0> {};
+
+    template <class URBG>
+    inline uint64_t __random_u64(URBG& g, integeral_constant<int, 64>) {
+        return static_cast<uint64_t>(g());
+    }
+
+    template <class URBG>
+    inline uint64_t __random_u64(URBG& g, integeral_constant<int, 32>) {
+        uint64_t hi = static_cast<uint64_t>(g());
+        return (hi << 32) | static_cast<uint64_t>(g());
+    }
+
+    // Lemire 的乘法映射: x * n 的高位落在 [0, n), 低位小于 2^w % n 的少数情况拒绝重来,
+    // 结果无偏, 且通常不需要除法
+    template <class URBG, int Bits>
+    uint64_t __random_lemire64(URBG& g, uint64_t n, integeral_constant<int, Bits> bits) {
+        unsigned __int128 m = static_cast<unsigned __int128>(__random_u64(g, bits)) * n;
+        uint64_t low = static_cast<uint64_t>(m);
+        if (low < n) {
+            const uint64_t threshold = (0 - n) % n;
+            while (low < threshold) {
+                m = static_cast<unsigned __int128>(__random_u64(g, bits)) * n;
+                low = static_cast<uint64_t>(m);
+            }
+        }
+        return static_cast<uint64_t>(m >> 64);
+    }
+
+    // [0, n) 内的均匀整数, n > 0
+    template <class URBG>
+    inline uint64_t __random_below(URBG& g, uint64_t n, integeral_constant<int, 64> bits) {
+        return __random_lemire64(g, n, bits);
+    }
+
+    // 32 位的引擎, n 不超过 2^32 时每次只用一个输出
+    template <class URBG>
+    uint64_t __random_below(URBG& g, uint64_t n, integeral_constant<int, 32> bits) {
+        if (n > 0xffffffffULL) {
+            return __random_lemire64(g, n, bits);
+        }
+        const uint32_t n32 = static_cast<uint32_t>(n);
+        uint64_t m = static_cast<uint64_t>(static_cast<uint32_t>(g())) * n32;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < n32) {
+            const uint32_t threshold = (0 - n32) % n32;
+            while (low < threshold) {
+                m = static_cast<uint64_t>(static_cast<uint32_t>(g())) * n32;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return m >> 32;
+    }
+
+    // [0, range] 内的均匀整数
+    template <class URBG, int Bits>
+    inline uint64_t __random_uniform(URBG& g, uint64_t range, integeral_constant<int, Bits> bits) {
+        return range == ~static_cast<uint64_t>(0) ? __random_u64(g, bits) : __random_below(g, range + 1, bits);
+    }
+
+    // 其它值域的引擎: 值域不小于 range + 1 时拒绝超出最大整倍数的输出后相除;
+    // 否则先递归取高位再拼上一次输出, 溢出或超出 range 时重来
+    template <class URBG>
+    uint64_t __random_uniform(URBG& g, uint64_t range, integeral_constant<int, 0>) {
+        const uint64_t gmin = static_cast<uint64_t>(URBG::min());
+        const uint64_t grange = static_cast<uint64_t>(URBG::max()) - gmin;
+        if (grange > range) {
+            const uint64_t scaling = grange == ~static_cast<uint64_t>(0) 
+                ? ~static_cast<uint64_t>(0) / (range + 1) : (grange + 1) / (range + 1);
+            const uint64_t limit = (range + 1) * scaling;
+            uint64_t x;
+            do {
+                x = static_cast<uint64_t>(g()) - gmin;
+            } while (x >= limit);
+            return x / scaling;
+        }
+        if (grange == range) {
+            return static_cast<uint64_t>(g()) - gmin;
+        }
+        uint64_t result, high;
+        do {
+            const uint64_t span = grange + 1;
+            high = span * __random_uniform(g, range / span, integeral_constant<int, 0>());
+            result = high + (static_cast<uint64_t>(g()) - gmin);
+        } while (result > range || result < high);
+        return result;
+    }
+
+    template <class URBG>
+    inline uint64_t __random_uniform(URBG& g, uint64_t range) {
+        return __random_uniform(g, range, integeral_constant<int, __random_bits<URBG>::value>());
+    }
+
+    template <class URBG>
+    inline uint64_t __random_u64(URBG& g) {
+        return __random_uniform(g, ~static_cast<uint64_t>(0));
+    }
+
+    // [a, b] 内均匀分布的整数
+    template <class IntType = int>
+    class uniform_int_distribution {
+    public:
+        typedef IntType result_type;
+
+    protected:
+        IntType _a;
+        IntType _b;
+
+    public:
+        explicit uniform_int_distribution(IntType a = 0, IntType b = 2147483647): _a(a), _b(b) {}
+
+        result_type a() const { return _a; }
+
+        result_type b() const { return _b; }
+
+        result_type min() const { return _a; }
+
+        result_type max() const { return _b; }
+
+        void reset() {}
+
+        // 区间长度按无符号数计算, [INT_MIN, INT_MAX] 这样的全范围也不会溢出
+        template <class URBG>
+        result_type operator()(URBG& g) const {
+            const uint64_t range = static_cast<uint64_t>(_b) - static_cast<uint64_t>(_a);
+            return static_cast<result_type>(static_cast<uint64_t>(_a) + __random_uniform(g, range));
+        }
+    };
+
+    // 每个线程一个引擎, 种子由全局计数器依次分配, 第一个线程的序列每次运行都相同; 不加锁
+    inline default_random_engine& __thread_random_engine() {
+        static std::atomic<uint64_t> seed(default_random_engine::default_seed);
+        static thread_local default_random_engine engine(
+            seed.fetch_add(0x9e3779b97f4a7c15ULL, std::memory_order_relaxed));
+        return engine;
+    }
+
+}
+
+
+#endif
@@ -77,6 +77,77 @@ namespace HxSTL {
         return lhs.node != rhs.node;
     }
 
+    template <class V, class NodeAlloc>
+    class __rb_tree_node_handle {
+    public:
+        typedef V                                       value_type;
+        typedef NodeAlloc                               allocator_type;
+        typedef __rb_tree_node<V>*                      link_type;
+    protected:
+        link_type _node;
+        allocator_type _alloc;
+    protected:
+        void reset() {
+            if (_node != NULL) {
+                _alloc.destroy(&(_node -> value));
+                _alloc.deallocate(_node, 1);
+                _node = NULL;
+            }
+        }
+    public:
+        __rb_tree_node_handle(): _node(NULL) {}
+
+        __rb_tree_node_handle(link_type node, const allocator_type& alloc): _node(node), _alloc(alloc) {}
+
+        __rb_tree_node_handle(const __rb_tree_node_handle&) = delete;
+
+        __rb_tree_node_handle(__rb_tree_node_handle&& other): _node(other._node), _alloc(HxSTL::move(other._alloc)) {
+            other._node = NULL;
+        }
+
+        ~__rb_tree_node_handle() { reset(); }
+
+        __rb_tree_node_handle& operator=(const __rb_tree_node_handle&) = delete;
+
+        __rb_tree_node_handle& operator=(__rb_tree_node_handle&& other) {
+            if (this != &other) {
+                reset();
+                _node = other._node;
+                _alloc = HxSTL::move(other._alloc);
+                other._node = NULL;
+            }
+            return *this;
+        }
+
+        bool empty() const noexcept { return _node == NULL; }
+
+        explicit operator bool() const noexcept { return _node != NULL; }
+
+        allocator_type get_allocator() const { return _alloc; }
+
+        value_type& value() const { return _node -> value; }
+
+        // 仅对 pair 类型的 value 有效 (map / multimap)
+        template <class U = V>
+        typename HxSTL::remove_const<typename U::first_type>::type& key() const {
+            return const_cast<typename HxSTL::remove_const<typename U::first_type>::type&>(_node -> value.first);
+        }
+
+        template <class U = V>
+        typename U::second_type& mapped() const { return _node -> value.second; }
+
+        link_type release() noexcept {
+            link_type node = _node;
+            _node = NULL;
+            return node;
+        }
+
+        void swap(__rb_tree_node_handle& other) {
+            HxSTL::swap(_node, other._node);
+            HxSTL::swap(_alloc, other._alloc);
+        }
+    };
+
     template <class K, class V, class KOV, class Compare, class Alloc = allocator<__rb_tree_node<V>>>
     class rb_tree {
     public:
@@ -95,6 +166,15 @@ namespace HxSTL {
         typedef typename iterator::base_link_type                               base_link_type;
         typedef __rb_tree_node_base::color_type                                 color_type;
         typedef typename Alloc::template rebind<__rb_tree_node<V>>::other       node_allocator_type;
+        typedef __rb_tree_node_handle<V, node_allocator_type>                   node_type;
+    protected:
+        // 区间切分后的片段: 整棵子树 (受 lo / hi 约束) 或单个节点
+        struct range_piece {
+            link_type node;
+            const K* lo;
+            const K* hi;
+            bool single;
+        };
     protected:
         size_type _count;
         link_type _header;
@@ -136,6 +216,17 @@ namespace HxSTL {
         HxSTL::pair<bool, link_type> get_insert_unique_pos(const V& value) const;
         HxSTL::pair<bool, link_type> get_insert_hint_equal_pos(const_iterator hint, const V& value) const;
         HxSTL::pair<bool, link_type> get_insert_hint_unique_pos(const_iterator hint, const V& value) const;
+        template <class Ref, class Function>
+        static void visit_aux(link_type x, Function& fn);
+        template <class Ref, class Function>
+        void visit_range_aux(link_type x, const K* lo, const K* hi, Function& fn) const;
+        template <class Ref, class Function>
+        void visit_piece_aux(const range_piece* first, const range_piece* last, Function& fn) const;
+        // 以下两个函数定义在 rb_tree_parallel.h 中
+        template <class Container>
+        void split_range_aux(const K* lo, const K* hi, size_type n, Container& pieces) const;
+        template <class Ref, class Function>
+        void parallel_range_aux(const K* lo, const K* hi, const Function& fn, size_type num_threads) const;
     public:
         explicit rb_tree(const Compare& comp, const Alloc& alloc)
             : _compare(comp), _alloc(alloc), _node_alloc(node_allocator_type()) {
@@ -145,7 +236,8 @@ namespace HxSTL {
             }
 
         rb_tree(const rb_tree& other): _count(other._count), _compare(other._compare), 
-            _alloc(other._alloc), _node_alloc(other._node_alloc) {
+            _alloc(HxSTL::select_on_container_copy_construction(other._alloc)),
+            _node_alloc(HxSTL::select_on_container_copy_construction(other._node_alloc)) {
                 initialize_aux(other.root());
             }
 
@@ -165,6 +257,7 @@ namespace HxSTL {
         rb_tree& operator=(const rb_tree& other) {
             if (this != &other) {
                 clear();
+                if (other._count == 0) return *this;
                 _header -> parent = copy_aux(other.root(), _header);
                 _header -> left = __rb_tree_node_base::minimum(_header -> parent);
                 _header -> right = __rb_tree_node_base::maxinum(_header -> parent);
@@ -182,6 +275,8 @@ namespace HxSTL {
 
         Compare get_compare() const noexcept { return _compare; }
 
+        node_allocator_type get_node_allocator() const noexcept { return _node_alloc; }
+
         iterator begin() const noexcept { return leftmost(); }
 
         iterator end() const noexcept { return _header; }
@@ -264,6 +359,49 @@ namespace HxSTL {
             return insert_aux(pr.first, pr.second, HxSTL::forward<T>(value));
         }
 
+        node_type extract(const_iterator pos) {
+            link_type node = static_cast<link_type>(__rb_tree_erase(pos.node, _header));
+            --_count;
+            return node_type(node, _node_alloc);
+        }
+
+        node_type extract(const K& key) {
+            iterator it = find(key);
+            return it == end() ? node_type() : extract(it);
+        }
+
+        iterator insert_node_equal(node_type&& nh) {
+            if (nh.empty()) return end();
+            link_type z = nh.release();
+            emplace_aux(get_insert_equal_pos(z -> value), z);
+            return z;
+        }
+
+        iterator insert_node_equal(const_iterator hint, node_type&& nh) {
+            if (nh.empty()) return end();
+            link_type z = nh.release();
+
+            HxSTL::pair<bool, link_type> pr = get_insert_hint_equal_pos(hint, z -> value);
+            if (pr.second == NULL) {
+                emplace_aux(get_insert_equal_pos(z -> value), z);
+            } else {
+                emplace_aux(pr.first, pr.second, z);
+            }
+
+            return z;
+        }
+
+        HxSTL::pair<iterator, bool> insert_node_unique(node_type&& nh) {
+            if (nh.empty()) return HxSTL::pair<iterator, bool>(end(), false);
+            HxSTL::pair<bool, link_type> pr = get_insert_unique_pos(nh.value());
+            if (pr.first) {
+                link_type z = nh.release();
+                emplace_aux(pr.second, z);
+                return HxSTL::pair<iterator, bool>(z, true);
+            }
+            return HxSTL::pair<iterator, bool>(pr.second, false);
+        }
+
         void clear() {
             if (_count > 0) {
                 clear_aux(root());
@@ -275,6 +413,8 @@ namespace HxSTL {
             HxSTL::swap(_count, other._count);
             HxSTL::swap(_header, other._header);
             HxSTL::swap(_compare, other._compare);
+            HxSTL::swap(_alloc, other._alloc);
+            HxSTL::swap(_node_alloc, other._node_alloc);
         }
 
         iterator erase(const_iterator pos);
@@ -303,6 +443,45 @@ namespace HxSTL {
         iterator find(const K& key);
 
         const_iterator find(const K& key) const;
+
+        // 递归中序遍历, 不经过 iterator::increment
+        template <class Function>
+        Function visit(Function fn) {
+            visit_aux<reference>(root(), fn);
+            return fn;
+        }
+
+        template <class Function>
+        Function visit(Function fn) const {
+            visit_aux<const_reference>(root(), fn);
+            return fn;
+        }
+
+        // 按序访问 [lo, hi) 内的元素
+        template <class Function>
+        Function for_each_in_range(const K& lo, const K& hi, Function fn) {
+            visit_range_aux<reference>(root(), &lo, &hi, fn);
+            return fn;
+        }
+
+        template <class Function>
+        Function for_each_in_range(const K& lo, const K& hi, Function fn) const {
+            visit_range_aux<const_reference>(root(), &lo, &hi, fn);
+            return fn;
+        }
+
+        // 将 [lo, hi) 切分为若干子树, 分成 num_threads 个任务交给默认线程池, 每个任务持有 fn 的副本
+        // 同一任务内按序访问, 任务之间无顺序保证; fn 抛出的第一个异常在全部任务结束后重新抛出
+        // num_threads 为 0 时按线程池的线程数选择, 需要包含 rb_tree_parallel.h (map / set 等已包含)
+        template <class Function>
+        void parallel_for_each_in_range(const K& lo, const K& hi, Function fn, size_type num_threads = 0) {
+            parallel_range_aux<reference>(&lo, &hi, fn, num_threads);
+        }
+
+        template <class Function>
+        void parallel_for_each_in_range(const K& lo, const K& hi, Function fn, size_type num_threads = 0) const {
+            parallel_range_aux<const_reference>(&lo, &hi, fn, num_threads);
+        }
     };
 
     template <class K, class V, class KOV, class Compare, class Alloc>
@@ -357,6 +536,10 @@ namespace HxSTL {
     void rb_tree<K, V, KOV, Compare, Alloc>::initialize_aux(link_type x) {
         _header = _node_alloc.allocate(1);
         _header -> color = __red;
+        if (x == NULL) {
+            reset();
+            return;
+        }
         _header -> parent = copy_aux(x, _header);
         _header -> left = __rb_tree_node_base::minimum(_header -> parent);
         _header -> right = __rb_tree_node_base::maxinum(_header -> parent);
@@ -382,7 +565,7 @@ namespace HxSTL {
             y -> parent = p;
 
             if (x -> right != NULL) {
-                y -> right = copy_aux(RIGHT(x), p);
+                y -> right = copy_aux(RIGHT(x), y);
             }
 
             p = y;
@@ -516,10 +699,11 @@ namespace HxSTL {
             const V& value) const -> HxSTL::pair<bool, link_type> {
         key_type k_value = KOV()(value);
 
-        if (hint.node == _header && 
-                (_count == 0 || _compare(KEY(rightmost()), k_value))) { // end
-            return HxSTL::pair<bool, link_type>(false, rightmost());
-        } else if (_compare(k_value, KEY(hint.node))) { // before
+        if (hint.node == _header) { // end
+            if (_count == 0 || !_compare(k_value, KEY(rightmost()))) {
+                return HxSTL::pair<bool, link_type>(false, rightmost());
+            }
+        } else if (!_compare(KEY(hint.node), k_value)) { // before (等值时插在 hint 之前)
             const_iterator before = hint;
 
             if (hint.node == leftmost()) {
@@ -555,9 +739,10 @@ namespace HxSTL {
         // 非叶子节点的前驱后继一定是叶子节点(不是指 NIL)
         key_type k_value = KOV()(value);
 
-        if (hint.node == _header && 
-                (_count == 0 || _compare(KEY(rightmost()), k_value))) { // end
-            return HxSTL::pair<bool, link_type>(false, rightmost());
+        if (hint.node == _header) { // end
+            if (_count == 0 || _compare(KEY(rightmost()), k_value)) {
+                return HxSTL::pair<bool, link_type>(false, rightmost());
+            }
         } else {
             if (_compare(k_value, KEY(hint.node))) { // before
                 const_iterator before = hint;
@@ -702,6 +887,60 @@ namespace HxSTL {
         return it == end() || _compare(key, KEY(it.node)) ? end() : it;
     }
 
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    template <class Ref, class Function>
+    void rb_tree<K, V, KOV, Compare, Alloc>::visit_aux(link_type x, Function& fn) {
+        // 左子树递归右子树迭代, 进入节点时预取两个孩子
+        while (x != NULL) {
+            __builtin_prefetch(x -> left);
+            __builtin_prefetch(x -> right);
+            visit_aux<Ref>(LEFT(x), fn);
+            fn(static_cast<Ref>(x -> value));
+            x = RIGHT(x);
+        }
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    template <class Ref, class Function>
+    void rb_tree<K, V, KOV, Compare, Alloc>::visit_range_aux(link_type x, 
+            const K* lo, const K* hi, Function& fn) const {
+        // lo / hi 为 NULL 表示该侧无约束, 两侧都无约束时退化为整棵子树的遍历
+        while (x != NULL) {
+            if (lo == NULL && hi == NULL) {
+                visit_aux<Ref>(x, fn);
+                return;
+            }
+
+            __builtin_prefetch(x -> left);
+            __builtin_prefetch(x -> right);
+
+            if (lo != NULL && _compare(KEY(x), *lo)) {
+                x = RIGHT(x);
+            } else if (hi != NULL && !_compare(KEY(x), *hi)) {
+                x = LEFT(x);
+            } else {
+                // x 在区间内: 左子树只受 lo 约束, 右子树只受 hi 约束
+                visit_range_aux<Ref>(LEFT(x), lo, NULL, fn);
+                fn(static_cast<Ref>(x -> value));
+                x = RIGHT(x);
+                lo = NULL;
+            }
+        }
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    template <class Ref, class Function>
+    void rb_tree<K, V, KOV, Compare, Alloc>::visit_piece_aux(const range_piece* first, 
+            const range_piece* last, Function& fn) const {
+        for (; first != last; ++first) {
+            if (first -> single) {
+                fn(static_cast<Ref>(first -> node -> value));
+            } else {
+                visit_range_aux<Ref>(first -> node, first -> lo, first -> hi, fn);
+            }
+        }
+    }
+
 }
 
 
@@ -0,0 +1,102 @@
+#ifndef _RB_TREE_PARALLEL_
+#define _RB_TREE_PARALLEL_
+
+
+#include "rb_tree.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+
+namespace HxSTL {
+
+    // 节点数少于该值时 parallel_for_each_in_range 退化为单线程遍历
+    const size_t __rb_tree_parallel_threshold = 1024;
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    template <class Container>
+    void rb_tree<K, V, KOV, Compare, Alloc>::split_range_aux(const K* lo, const K* hi, 
+            size_type n, Container& pieces) const {
+        pieces.clear();
+        if (root() != NULL) {
+            pieces.push_back(range_piece{ root(), lo, hi, false });
+        }
+
+        // 逐层展开子树, 片段保持中序, 直到数量足够或无法继续展开
+        bool expanded = true;
+        while (expanded && pieces.size() < n) {
+            Container next;
+            expanded = false;
+
+            for (size_type i = 0; i != pieces.size(); ++i) {
+                range_piece p = pieces[i];
+                if (p.single) {
+                    next.push_back(p);
+                    continue;
+                }
+
+                link_type x = p.node;
+                expanded = true;
+
+                if (p.lo != NULL && _compare(KEY(x), *p.lo)) {
+                    if (x -> right != NULL) next.push_back(range_piece{ RIGHT(x), p.lo, p.hi, false });
+                } else if (p.hi != NULL && !_compare(KEY(x), *p.hi)) {
+                    if (x -> left != NULL) next.push_back(range_piece{ LEFT(x), p.lo, p.hi, false });
+                } else {
+                    if (x -> left != NULL) next.push_back(range_piece{ LEFT(x), p.lo, NULL, false });
+                    next.push_back(range_piece{ x, NULL, NULL, true });
+                    if (x -> right != NULL) next.push_back(range_piece{ RIGHT(x), NULL, p.hi, false });
+                }
+            }
+
+            pieces.swap(next);
+        }
+    }
+
+    template <class K, class V, class KOV, class Compare, class Alloc>
+    template <class Ref, class Function>
+    void rb_tree<K, V, KOV, Compare, Alloc>::parallel_range_aux(const K* lo, const K* hi, 
+            const Function& fn, size_type num_threads) const {
+        if (num_threads == 0) {
+            num_threads = thread_pool::default_pool().size() + 1;
+        }
+
+        if (num_threads <= 1 || _count < __rb_tree_parallel_threshold) {
+            Function f(fn);
+            visit_range_aux<Ref>(root(), lo, hi, f);
+            return;
+        }
+
+        HxSTL::vector<range_piece> pieces;
+        split_range_aux(lo, hi, num_threads * 4, pieces);
+
+        if (pieces.empty()) return;
+        if (num_threads > pieces.size()) num_threads = pieces.size();
+
+        // 每个任务处理一段连续的片段, 当前线程处理第一段
+        // 提交或遍历中途抛出异常时, group 析构前会等待已提交的任务结束
+        const range_piece* first = pieces.data();
+        size_type per = pieces.size() / num_threads;
+        size_type extra = pieces.size() % num_threads;
+        task_group group;
+
+        const range_piece* cur = first + per + (extra > 0 ? 1 : 0);
+        for (size_type i = 1; i != num_threads; ++i) {
+            const range_piece* next = cur + per + (i < extra ? 1 : 0);
+            const Function* pfn = &fn;
+            group.spawn([this, cur, next, pfn] () {
+                Function f(*pfn);
+                this -> visit_piece_aux<Ref>(cur, next, f);
+            });
+            cur = next;
+        }
+
+        Function f(fn);
+        visit_piece_aux<Ref>(first, first + per + (extra > 0 ? 1 : 0), f);
+
+        group.wait();
+    }
+
+}
+
+
+#endif
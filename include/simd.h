@@ -0,0 +1,583 @@
+#ifndef _SIMD_H_
+#define _SIMD_H_
+
+
+#include <stddef.h>
+#include <string.h>
+#include "type_traits.h"
+
+
+// x86 上运行时检测 AVX2, 有则走 32 字节的内核, 否则走 16 字节 (SSE2 是 x86-64 的基线);
+// 其它平台只编译 16 字节的内核, 由编译器映射到对应的向量指令
+#if defined(__x86_64__) || defined(__i386__)
+#define _SIMD_DISPATCH_X86
+#endif
+
+
+namespace HxSTL {
+
+    // 可以按字节宽度向量化的元素: 1 / 2 / 4 / 8 字节的算术类型, 不含 bool 与 long double
+    template <class T>
+    struct __simd_element:
+        public integeral_constant<bool,
+        is_arithmetic<T>::value &&
+        !is_same<bool, typename remove_cv<T>::type>::value &&
+        (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8) &&
+        !is_same<long double, typename remove_cv<T>::type>::value> {};
+
+    // 指针区间与值 val 的比较能否换成元素类型的逐字节宽度比较:
+    // 同类型, 或者都是整数 (是否能无损转换为元素类型在运行时检查)
+    template <class Iterator, class U>
+    struct __simd_compare_dispatch {
+        typedef false_type type;
+    };
+
+    template <class T, class U>
+    struct __simd_compare_dispatch<T*, U> {
+        typedef typename remove_cv<T>::type element_type;
+        typedef integeral_constant<bool,
+            __simd_element<element_type>::value &&
+            (is_same<element_type, typename remove_cv<U>::type>::value ||
+            (is_integeral<element_type>::value && is_integeral<U>::value &&
+            !is_same<bool, typename remove_cv<U>::type>::value))> type;
+    };
+
+    // 整数指针区间, 用于 min / max 的向量化; 浮点数的 NaN 没有全序, 仍走标量
+    template <class Iterator>
+    struct __simd_integral_dispatch {
+        typedef false_type type;
+    };
+
+    template <class T>
+    struct __simd_integral_dispatch<T*> {
+        typedef integeral_constant<bool,
+            __simd_element<typename remove_cv<T>::type>::value &&
+            is_integeral<T>::value> type;
+    };
+
+    // 两个同类型算术指针区间的逐元素比较
+    template <class Iterator1, class Iterator2>
+    struct __simd_mismatch_dispatch {
+        typedef false_type type;
+    };
+
+    template <class T1, class T2>
+    struct __simd_mismatch_dispatch<T1*, T2*> {
+        typedef integeral_constant<bool,
+            __simd_element<typename remove_cv<T1>::type>::value &&
+            is_same<typename remove_cv<T1>::type, typename remove_cv<T2>::type>::value> type;
+    };
+
+    // 算术类型的指针区间填充算术类型的值
+    template <class Iterator, class U>
+    struct __simd_fill_dispatch {
+        typedef false_type type;
+    };
+
+    template <class T, class U>
+    struct __simd_fill_dispatch<T*, U> {
+        typedef integeral_constant<bool,
+            __simd_element<T>::value && is_arithmetic<U>::value> type;
+    };
+
+    // 整数 val 能否无损地表示为元素类型 T, 能则与它相等等价于与 T(val) 相等; 不能时调用者退回标量比较
+    template <class T, class U>
+    inline bool __simd_representable(const U& val) {
+        return static_cast<U>(static_cast<T>(val)) == val && (static_cast<T>(val) < 0) == (val < 0);
+    }
+
+    // 不能无损表示时的标量比较: 显式转换到通常算术转换的公共类型, 结果与内置 == 相同,
+    // 但不会在有符号与无符号之间直接比较
+    template <class T, class U>
+    inline bool __simd_equal(const T& x, const U& val) {
+        typedef decltype(true ? x : val) common_type;
+        return static_cast<common_type>(x) == static_cast<common_type>(val);
+    }
+
+    template <size_t N>
+    struct __simd_unsigned;
+
+    template <>
+    struct __simd_unsigned<1> { typedef unsigned char type; };
+
+    template <>
+    struct __simd_unsigned<2> { typedef unsigned short type; };
+
+    template <>
+    struct __simd_unsigned<4> { typedef unsigned int type; };
+
+    template <>
+    struct __simd_unsigned<8> { typedef unsigned long long type; };
+
+    // 求和类运算中整数在无符号的通道与标量中计算, 溢出时按模回绕, 与补码的结果一致且没有未定义行为
+    template <class T, bool = is_integeral<T>::value>
+    struct __simd_wrap {
+        typedef T lane;
+        typedef T scalar;
+    };
+
+    template <class T>
+    struct __simd_wrap<T, true> {
+        typedef typename __simd_unsigned<sizeof(T)>::type lane;
+        typedef unsigned long long scalar;
+    };
+
+    template <class U, size_t Bytes>
+    struct __simd_vector {
+        typedef U type __attribute__((vector_size(Bytes)));
+    };
+
+    // Bytes 字节宽的向量内核, 用 GCC 的向量扩展书写, 同一份代码按 16 / 32 字节实例化
+    // 全部强制内联: 被 target("avx2") 的入口函数内联后才会生成 AVX2 指令
+    template <class T, size_t Bytes>
+    struct __simd_kernel {
+        typedef typename __simd_vector<T, Bytes>::type vector_type;
+        typedef typename __simd_vector<typename __simd_unsigned<sizeof(T)>::type, Bytes>::type mask_type;
+        typedef typename __simd_vector<unsigned long long, Bytes>::type word_type;
+        typedef typename __simd_wrap<T>::lane lane_type;
+        typedef typename __simd_wrap<T>::scalar scalar_type;
+        typedef typename __simd_vector<lane_type, Bytes>::type wrap_type;
+
+        static const ptrdiff_t lanes = Bytes / sizeof(T);
+
+        // 向量只经引用传递, 内核内联前不会出现按值传递 32 字节向量的调用约定
+        template <class Vector>
+        __attribute__((always_inline)) static void load(Vector& v, const T* p) {
+            memcpy(&v, p, Bytes);
+        }
+
+        __attribute__((always_inline)) static void splat(vector_type& v, T val) {
+            v = vector_type{} + val;
+        }
+
+        __attribute__((always_inline)) static bool any(const mask_type& m) {
+            word_type w = reinterpret_cast<const word_type&>(m);
+            unsigned long long r = 0;
+            for (size_t j = 0; j < Bytes / 8; ++j) {
+                r |= w[j];
+            }
+            return r != 0;
+        }
+
+        // 第一个非零通道的下标, 调用前 any(m) 为真; 按 8 字节分组, 组内用末尾零的个数定位
+        __attribute__((always_inline)) static ptrdiff_t first(const mask_type& m) {
+            word_type w = reinterpret_cast<const word_type&>(m);
+            size_t j = 0;
+            while (w[j] == 0) {
+                ++j;
+            }
+            return j * (8 / sizeof(T)) + __builtin_ctzll(w[j]) / (8 * sizeof(T));
+        }
+
+        __attribute__((always_inline)) static const T* find(const T* first, const T* last, T val) {
+            vector_type target, v0, v1, v2, v3;
+            splat(target, val);
+            // 每轮检查 4 个向量, 合并后只做一次判断
+            while (last - first >= 4 * lanes) {
+                load(v0, first);
+                load(v1, first + lanes);
+                load(v2, first + 2 * lanes);
+                load(v3, first + 3 * lanes);
+                mask_type m = (mask_type)(v0 == target) | (mask_type)(v1 == target)
+                    | (mask_type)(v2 == target) | (mask_type)(v3 == target);
+                if (any(m)) {
+                    break;
+                }
+                first += 4 * lanes;
+            }
+            while (last - first >= lanes) {
+                load(v0, first);
+                mask_type m = (mask_type)(v0 == target);
+                if (any(m)) {
+                    return first + HxSTL::__simd_kernel<T, Bytes>::first(m);
+                }
+                first += lanes;
+            }
+            while (first != last && *first != val) {
+                ++first;
+            }
+            return first;
+        }
+
+        __attribute__((always_inline)) static size_t count(const T* first, const T* last, T val) {
+            vector_type target, v;
+            splat(target, val);
+            // 相等的通道为全 1, 减去它即加一; 窄通道在溢出前把计数累加到 result
+            const size_t flush = sizeof(T) == 1 ? 255 : sizeof(T) == 2 ? 65535 : 0x7fffffff;
+            size_t result = 0;
+            while (last - first >= lanes) {
+                mask_type acc = {};
+                for (size_t k = 0; k < flush && last - first >= lanes; ++k) {
+                    load(v, first);
+                    acc -= (mask_type)(v == target);
+                    first += lanes;
+                }
+                for (ptrdiff_t j = 0; j < lanes; ++j) {
+                    result += acc[j];
+                }
+            }
+            for (; first != last; ++first) {
+                if (*first == val) {
+                    ++result;
+                }
+            }
+            return result;
+        }
+
+        // 最小值与最大值, 调用前区间非空
+        __attribute__((always_inline)) static T min_value(const T* first, const T* last) {
+            T result = *first;
+            if (last - first >= lanes) {
+                vector_type cur, v;
+                load(cur, first);
+                for (first += lanes; last - first >= lanes; first += lanes) {
+                    load(v, first);
+                    cur = v < cur ? v : cur;
+                }
+                for (ptrdiff_t j = 0; j < lanes; ++j) {
+                    result = cur[j] < result ? cur[j] : result;
+                }
+            }
+            for (; first != last; ++first) {
+                result = *first < result ? *first : result;
+            }
+            return result;
+        }
+
+        __attribute__((always_inline)) static T max_value(const T* first, const T* last) {
+            T result = *first;
+            if (last - first >= lanes) {
+                vector_type cur, v;
+                load(cur, first);
+                for (first += lanes; last - first >= lanes; first += lanes) {
+                    load(v, first);
+                    cur = cur < v ? v : cur;
+                }
+                for (ptrdiff_t j = 0; j < lanes; ++j) {
+                    result = result < cur[j] ? cur[j] : result;
+                }
+            }
+            for (; first != last; ++first) {
+                result = result < *first ? *first : result;
+            }
+            return result;
+        }
+
+        // 第一个不相等的位置; 按 != 比较, 与标量版本一样 NaN 不等于自身, 0.0 等于 -0.0
+        __attribute__((always_inline)) static ptrdiff_t mismatch(const T* first1, const T* last1, const T* first2) {
+            const T* start = first1;
+            vector_type v1, v2;
+            while (last1 - first1 >= lanes) {
+                load(v1, first1);
+                load(v2, first2);
+                mask_type m = (mask_type)(v1 != v2);
+                if (any(m)) {
+                    return first1 - start + HxSTL::__simd_kernel<T, Bytes>::first(m);
+                }
+                first1 += lanes;
+                first2 += lanes;
+            }
+            while (first1 != last1 && *first1 == *first2) {
+                ++first1;
+                ++first2;
+            }
+            return first1 - start;
+        }
+
+        __attribute__((always_inline)) static void fill(T* first, T* last, T val) {
+            vector_type v;
+            splat(v, val);
+            for (; last - first >= lanes; first += lanes) {
+                memcpy(first, &v, Bytes);
+            }
+            for (; first != last; ++first) {
+                *first = val;
+            }
+        }
+
+        // value, value + 1, ... 依次写入, 返回下一个值
+        __attribute__((always_inline)) static T iota(T* first, T* last, T value) {
+            wrap_type v, step;
+            for (ptrdiff_t j = 0; j < lanes; ++j) {
+                step[j] = static_cast<lane_type>(j);
+            }
+            if (last - first >= lanes) {
+                v = step + static_cast<lane_type>(value);
+                step = wrap_type{} + static_cast<lane_type>(lanes);
+                for (; last - first >= lanes; first += lanes) {
+                    memcpy(first, &v, Bytes);
+                    v += step;
+                }
+                value = static_cast<T>(v[0]);
+            }
+            for (; first != last; ++first, ++value) {
+                *first = value;
+            }
+            return value;
+        }
+
+        // 求和与点积按通道分别累加, 4 个累加器隐藏加法的延迟; 浮点数的结果与顺序相加可能有舍入差异
+        __attribute__((always_inline)) static T sum(const T* first, const T* last) {
+            wrap_type a0 = {}, a1 = {}, a2 = {}, a3 = {}, v;
+            for (; last - first >= 4 * lanes; first += 4 * lanes) {
+                load(v, first);
+                a0 += v;
+                load(v, first + lanes);
+                a1 += v;
+                load(v, first + 2 * lanes);
+                a2 += v;
+                load(v, first + 3 * lanes);
+                a3 += v;
+            }
+            for (; last - first >= lanes; first += lanes) {
+                load(v, first);
+                a0 += v;
+            }
+            a0 = (a0 + a1) + (a2 + a3);
+            scalar_type result = scalar_type();
+            for (ptrdiff_t j = 0; j < lanes; ++j) {
+                result += a0[j];
+            }
+            for (; first != last; ++first) {
+                result += static_cast<scalar_type>(*first);
+            }
+            return static_cast<T>(result);
+        }
+
+        __attribute__((always_inline)) static T dot(const T* first1, const T* last1, const T* first2) {
+            wrap_type a0 = {}, a1 = {}, a2 = {}, a3 = {}, v, w;
+            for (; last1 - first1 >= 4 * lanes; first1 += 4 * lanes, first2 += 4 * lanes) {
+                load(v, first1);
+                load(w, first2);
+                a0 += v * w;
+                load(v, first1 + lanes);
+                load(w, first2 + lanes);
+                a1 += v * w;
+                load(v, first1 + 2 * lanes);
+                load(w, first2 + 2 * lanes);
+                a2 += v * w;
+                load(v, first1 + 3 * lanes);
+                load(w, first2 + 3 * lanes);
+                a3 += v * w;
+            }
+            for (; last1 - first1 >= lanes; first1 += lanes, first2 += lanes) {
+                load(v, first1);
+                load(w, first2);
+                a0 += v * w;
+            }
+            a0 = (a0 + a1) + (a2 + a3);
+            scalar_type result = scalar_type();
+            for (ptrdiff_t j = 0; j < lanes; ++j) {
+                result += a0[j];
+            }
+            for (; first1 != last1; ++first1, ++first2) {
+                result += static_cast<scalar_type>(*first1) * static_cast<scalar_type>(*first2);
+            }
+            return static_cast<T>(result);
+        }
+
+        // v 加上自身整体上移 K, 2K, ... 个通道的结果 (空出的低位补 0), 即通道内的前缀和
+        // K 是编译期常量, 洗牌的掩码是常量, 编译为一条移位或置换指令
+        template <ptrdiff_t K>
+        __attribute__((always_inline)) static void prefix(wrap_type& v, true_type) {
+            mask_type m;
+            for (ptrdiff_t j = 0; j < lanes; ++j) {
+                m[j] = j >= K ? lanes + j - K : 0;
+            }
+            v += __builtin_shuffle(wrap_type{}, v, m);
+            prefix<K * 2>(v, integeral_constant<bool, (K * 2 < lanes)>());
+        }
+
+        template <ptrdiff_t K>
+        __attribute__((always_inline)) static void prefix(wrap_type&, false_type) {}
+
+        // 前缀和, 结果加上 init 写到 result, 返回最后一个前缀和; result 可以等于 first
+        // 向量内做 log(lanes) 轮移位相加, 再加上前一个向量的最后一个通道
+        // 进位以广播后的向量保存, 相邻两轮之间的依赖只有一次加法和一次置换
+        __attribute__((always_inline)) static T scan(const T* first, const T* last, T* result, T init) {
+            scalar_type carry = static_cast<scalar_type>(init);
+            if (last - first >= lanes) {
+                wrap_type v;
+                wrap_type c = wrap_type{} + static_cast<lane_type>(carry);
+                mask_type back = mask_type{} + static_cast<typename __simd_unsigned<sizeof(T)>::type>(lanes - 1);
+                for (; last - first >= lanes; first += lanes, result += lanes) {
+                    load(v, first);
+                    prefix<1>(v, integeral_constant<bool, (1 < lanes)>());
+                    v += c;
+                    memcpy(result, &v, Bytes);
+                    c = __builtin_shuffle(v, back);
+                }
+                carry = c[0];
+            }
+            for (; first != last; ++first, ++result) {
+                carry += static_cast<scalar_type>(*first);
+                *result = static_cast<T>(carry);
+            }
+            return static_cast<T>(carry);
+        }
+    };
+
+#ifdef _SIMD_DISPATCH_X86
+    inline bool __simd_has_avx2() {
+        static const bool has = __builtin_cpu_supports("avx2");
+        return has;
+    }
+
+    template <class T>
+    __attribute__((target("avx2"))) const T* __simd_find_avx2(const T* first, const T* last, T val) {
+        return __simd_kernel<T, 32>::find(first, last, val);
+    }
+
+    template <class T>
+    __attribute__((target("avx2"))) size_t __simd_count_avx2(const T* first, const T* last, T val) {
+        return __simd_kernel<T, 32>::count(first, last, val);
+    }
+
+    template <class T>
+    __attribute__((target("avx2"))) T __simd_min_value_avx2(const T* first, const T* last) {
+        return __simd_kernel<T, 32>::min_value(first, last);
+    }
+
+    template <class T>
+    __attribute__((target("avx2"))) T __simd_max_value_avx2(const T* first, const T* last) {
+        return __simd_kernel<T, 32>::max_value(first, last);
+    }
+
+    template <class T>
+    __attribute__((target("avx2"))) ptrdiff_t __simd_mismatch_avx2(const T* first1, const T* last1, const T* first2) {
+        return __simd_kernel<T, 32>::mismatch(first1, last1, first2);
+    }
+
+    template <class T>
+    __attribute__((target("avx2"))) void __simd_fill_avx2(T* first, T* last, T val) {
+        __simd_kernel<T, 32>::fill(first, last, val);
+    }
+
+    template <class T>
+    __attribute__((target("avx2"))) T __simd_iota_avx2(T* first, T* last, T value) {
+        return __simd_kernel<T, 32>::iota(first, last, value);
+    }
+
+    template <class T>
+    __attribute__((target("avx2"))) T __simd_sum_avx2(const T* first, const T* last) {
+        return __simd_kernel<T, 32>::sum(first, last);
+    }
+
+    template <class T>
+    __attribute__((target("avx2"))) T __simd_dot_avx2(const T* first1, const T* last1, const T* first2) {
+        return __simd_kernel<T, 32>::dot(first1, last1, first2);
+    }
+
+    template <class T>
+    __attribute__((target("avx2"))) T __simd_scan_avx2(const T* first, const T* last, T* result, T init) {
+        return __simd_kernel<T, 32>::scan(first, last, result, init);
+    }
+#endif
+
+    // 入口: 按运行时检测的结果选择内核
+
+    template <class T>
+    const T* __simd_find(const T* first, const T* last, T val) {
+#ifdef _SIMD_DISPATCH_X86
+        if (__simd_has_avx2()) {
+            return __simd_find_avx2(first, last, val);
+        }
+#endif
+        return __simd_kernel<T, 16>::find(first, last, val);
+    }
+
+    template <class T>
+    size_t __simd_count(const T* first, const T* last, T val) {
+#ifdef _SIMD_DISPATCH_X86
+        if (__simd_has_avx2()) {
+            return __simd_count_avx2(first, last, val);
+        }
+#endif
+        return __simd_kernel<T, 16>::count(first, last, val);
+    }
+
+    template <class T>
+    T __simd_min_value(const T* first, const T* last) {
+#ifdef _SIMD_DISPATCH_X86
+        if (__simd_has_avx2()) {
+            return __simd_min_value_avx2(first, last);
+        }
+#endif
+        return __simd_kernel<T, 16>::min_value(first, last);
+    }
+
+    template <class T>
+    T __simd_max_value(const T* first, const T* last) {
+#ifdef _SIMD_DISPATCH_X86
+        if (__simd_has_avx2()) {
+            return __simd_max_value_avx2(first, last);
+        }
+#endif
+        return __simd_kernel<T, 16>::max_value(first, last);
+    }
+
+    template <class T>
+    ptrdiff_t __simd_mismatch(const T* first1, const T* last1, const T* first2) {
+#ifdef _SIMD_DISPATCH_X86
+        if (__simd_has_avx2()) {
+            return __simd_mismatch_avx2(first1, last1, first2);
+        }
+#endif
+        return __simd_kernel<T, 16>::mismatch(first1, last1, first2);
+    }
+
+    template <class T>
+    void __simd_fill(T* first, T* last, T val) {
+#ifdef _SIMD_DISPATCH_X86
+        if (__simd_has_avx2()) {
+            __simd_fill_avx2(first, last, val);
+            return;
+        }
+#endif
+        __simd_kernel<T, 16>::fill(first, last, val);
+    }
+
+    template <class T>
+    T __simd_iota(T* first, T* last, T value) {
+#ifdef _SIMD_DISPATCH_X86
+        if (__simd_has_avx2()) {
+            return __simd_iota_avx2(first, last, value);
+        }
+#endif
+        return __simd_kernel<T, 16>::iota(first, last, value);
+    }
+
+    template <class T>
+    T __simd_sum(const T* first, const T* last) {
+#ifdef _SIMD_DISPATCH_X86
+        if (__simd_has_avx2()) {
+            return __simd_sum_avx2(first, last);
+        }
+#endif
+        return __simd_kernel<T, 16>::sum(first, last);
+    }
+
+    template <class T>
+    T __simd_dot(const T* first1, const T* last1, const T* first2) {
+#ifdef _SIMD_DISPATCH_X86
+        if (__simd_has_avx2()) {
+            return __simd_dot_avx2(first1, last1, first2);
+        }
+#endif
+        return __simd_kernel<T, 16>::dot(first1, last1, first2);
+    }
+
+    template <class T>
+    T __simd_scan(const T* first, const T* last, T* result, T init) {
+#ifdef _SIMD_DISPATCH_X86
+        if (__simd_has_avx2()) {
+            return __simd_scan_avx2(first, last, result, init);
+        }
+#endif
+        return __simd_kernel<T, 16>::scan(first, last, result, init);
+    }
+
+}
+
+
+#endif
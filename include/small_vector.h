@@ -0,0 +1,585 @@
+#ifndef _SMALL_VECTOR_H_
+#define _SMALL_VECTOR_H_
+
+
+#include "allocator.h"
+#include "uninitialized.h"
+#include "utility.h"
+#include "vector.h"
+
+
+namespace HxSTL {
+
+    // 带内联缓冲区的 vector: 不超过 N 个元素时存放在对象内部, 不申请堆内存,
+    // 超过 N 个元素后整体迁移到 _alloc 申请的堆空间, 之后的行为与 vector 相同
+    // 元素位于内联缓冲区时, 移动和交换都需要逐个搬移元素, 迭代器随之失效
+    template <class T, size_t N, class Alloc = allocator<T>>
+    class small_vector {
+        static_assert(N > 0, "small_vector requires N > 0");
+    public:
+        typedef T                                       value_type;
+        typedef Alloc                                   allocator_type;
+        typedef value_type&                             reference;
+        typedef const value_type&                       const_reference;
+        typedef value_type*                             pointer;
+        typedef const value_type*                       const_pointer;
+        typedef value_type*                             iterator;
+        typedef const value_type*                       const_iterator;
+        typedef ptrdiff_t                               difference_type;
+        typedef size_t                                  size_type;
+    protected:
+        iterator _start;
+        iterator _finish;
+        iterator _end_of_storage;
+        allocator_type _alloc;
+        alignas(T) unsigned char _buffer[sizeof(T) * N];
+    protected:
+        iterator inline_storage() { return reinterpret_cast<iterator>(_buffer); }
+        bool is_inline() const { return _start == reinterpret_cast<const_iterator>(_buffer); }
+        void reset_inline() { _start = _finish = inline_storage(); _end_of_storage = _start + N; }
+        size_type next_capacity(size_type count) const;
+        template <class InputIt>
+        void initialize_aux(InputIt first, InputIt last, false_type);
+        void initialize_aux(size_type count, const value_type& value, true_type);
+        void steal_aux(small_vector&& other);
+        template <class InputIt>
+        iterator insert_aux(iterator pos, InputIt first, InputIt last, false_type);
+        iterator insert_aux(iterator pos, size_type count, const T& value, true_type);
+        template <class... Args>
+        iterator emplace_aux(iterator pos, Args&&... args);
+        iterator erase_aux(iterator first, iterator last);
+        template <class InputIt>
+        void assign_aux(InputIt first, InputIt last, false_type);
+        void assign_aux(size_type count, const T& value, true_type);
+        void resize_aux(size_type count, const T& value);
+        void deallocate_aux();
+        void destroy_and_reset(iterator new_start, iterator new_finish, iterator new_end_of_storage);
+        void relocate_and_reset(iterator new_start, iterator new_finish, iterator new_end_of_storage);
+    public:
+        small_vector(): _alloc(Alloc()) { reset_inline(); }
+
+        explicit small_vector(const Alloc& alloc): _alloc(alloc) { reset_inline(); }
+
+        explicit small_vector(size_type count, const T& value, const Alloc& alloc = Alloc())
+            : _alloc(alloc) { initialize_aux(count, value, HxSTL::true_type()); }
+
+        explicit small_vector(size_type count, const Alloc& alloc = Alloc())
+            : _alloc(alloc) { initialize_aux(count, T(), HxSTL::true_type()); }
+
+        template <class InputIt>
+        small_vector(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+            : _alloc(alloc) { initialize_aux(first, last, typename HxSTL::is_integeral<InputIt>::type()); }
+
+        small_vector(const small_vector& other): _alloc(other._alloc) {
+            initialize_aux(other.begin(), other.end(), HxSTL::false_type());
+        }
+
+        small_vector(small_vector&& other): _alloc(other._alloc) { steal_aux(HxSTL::move(other)); }
+
+        small_vector(HxSTL::initializer_list<T> init, const Alloc& alloc = Alloc())
+            : _alloc(alloc) { initialize_aux(init.begin(), init.end(), HxSTL::false_type()); }
+
+        explicit small_vector(const vector<T, Alloc>& other): _alloc(other.get_allocator()) {
+            initialize_aux(other.begin(), other.end(), HxSTL::false_type());
+        }
+
+        explicit small_vector(vector<T, Alloc>&& other): _alloc(other.get_allocator()) {
+            reset_inline();
+            reserve(other.size());
+            _finish = HxSTL::uninitialized_move(other.begin(), other.end(), _start);
+            other.clear();
+        }
+
+        ~small_vector() {
+            HxSTL::destroy(_alloc, _start, _finish);
+            deallocate_aux();
+        }
+
+        small_vector& operator=(const small_vector& other) {
+            if (this != &other) assign(other.begin(), other.end());
+            return *this;
+        }
+
+        small_vector& operator=(small_vector&& other) {
+            if (this != &other) {
+                clear();
+                deallocate_aux();
+                _alloc = other._alloc;
+                steal_aux(HxSTL::move(other));
+            }
+            return *this;
+        }
+
+        small_vector& operator=(HxSTL::initializer_list<T> init) {
+            assign(init.begin(), init.end());
+            return *this;
+        }
+
+        operator vector<T, Alloc>() const { return vector<T, Alloc>(begin(), end(), _alloc); }
+
+        template <class InputIt>
+        void assign(InputIt first, InputIt last) {
+            assign_aux(first, last, typename HxSTL::is_integeral<InputIt>::type());
+        }
+
+        void assign(size_type n, const value_type& value) {
+            assign_aux(n, value, HxSTL::true_type());
+        }
+
+        allocator_type get_allocator() const { return _alloc; }
+
+        reference at(size_type n) {
+            if (n >= size()) {
+                throw HxSTL::out_of_range();
+            }
+            return operator[](n);
+        }
+
+        const_reference at(size_type n) const {
+            if (n >= size()) {
+                throw HxSTL::out_of_range();
+            }
+            return operator[](n);
+        }
+
+        reference operator[](size_type n) { return *(begin() + n); }
+
+        const_reference operator[](size_type n) const { return *(begin() + n); }
+
+        reference front() { return *begin(); }
+
+        const_reference front() const { return *begin(); }
+
+        reference back() { return *(end() - 1);}
+
+        const_reference back() const { return *(end() - 1); }
+
+        pointer data() { return _start; }
+
+        const_pointer data() const { return _start; }
+
+        iterator begin() { return _start; }
+
+        const_iterator begin() const { return _start; }
+
+        const_iterator cbegin() const { return _start; }
+
+        iterator end() { return _finish; }
+
+        const_iterator end() const { return _finish; }
+
+        const_iterator cend() const { return _finish; }
+
+        bool empty() const { return begin() == end(); }
+
+        size_type size() const { return end() - begin(); }
+
+        size_type max_size() const { return _alloc.max_size(); }
+
+        void reserve(size_type new_cap);
+
+        size_type capacity() const { return _end_of_storage - _start; }
+
+        // 元素仍在内联缓冲区内时返回 true
+        bool is_small() const { return is_inline(); }
+
+        void shrink_to_fit();
+
+        void clear() { erase_aux(begin(), end()); }
+
+        iterator insert(const_iterator pos, const T& value) {
+            return emplace_aux(begin() + (pos - cbegin()), value);
+        }
+
+        iterator insert(const_iterator pos, T&& value) {
+            return emplace_aux(begin() + (pos - cbegin()), HxSTL::move(value));
+        }
+
+        iterator insert(const_iterator pos, size_type count, const T& value) {
+            return insert_aux(begin() + (pos - cbegin()), count, value, HxSTL::true_type());
+        }
+
+        template <class InputIt>
+        iterator insert(const_iterator pos, InputIt first, InputIt last) {
+            return insert_aux(begin() + (pos - cbegin()), first, last, typename HxSTL::is_integeral<InputIt>::type());
+        }
+
+        iterator insert(const_iterator pos, HxSTL::initializer_list<T> init) {
+            return insert_aux(begin() + (pos - cbegin()), init.begin(), init.end(), HxSTL::false_type());
+        }
+
+        template <class... Args>
+        iterator emplace(const_iterator pos, Args&&... args) {
+            return emplace_aux(begin() + (pos - cbegin()), HxSTL::forward<Args>(args)...);
+        }
+
+        iterator erase(const_iterator pos) {
+            return erase_aux(begin() + (pos - cbegin()), begin() + (pos - cbegin()) + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            return erase_aux(begin() + (first - cbegin()), begin() + (last - cbegin()));
+        }
+
+        void push_back(const T& value) {
+            emplace_aux(end(), value);
+        }
+
+        void push_back(T&& value) {
+            emplace_aux(end(), HxSTL::move(value));
+        }
+
+        template <class... Args>
+        void emplace_back(Args&&... args) {
+            emplace_aux(end(), HxSTL::forward<Args>(args)...);
+        }
+
+        void pop_back() { _alloc.destroy(--_finish); }
+
+        void resize(size_type count) { resize_aux(count, T()); }
+
+        void resize(size_type count, const T& value) { resize_aux(count, value); }
+
+        void swap(small_vector& other);
+    };
+
+    template <class T, size_t N, class Alloc>
+    void swap(small_vector<T, N, Alloc>& x, small_vector<T, N, Alloc>& y) {
+        x.swap(y);
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_vector<T, N, Alloc>::size_type
+    small_vector<T, N, Alloc>::next_capacity(size_type count) const {
+        if (count > max_size()) throw HxSTL::length_error();
+        return 2 * capacity() > count ? 2 * capacity() : count;
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class InputIt>
+    void small_vector<T, N, Alloc>::initialize_aux(InputIt first, InputIt last, false_type) {
+        reset_inline();
+        size_type count = HxSTL::distance(first, last);
+        if (count > N) {
+            _start = _alloc.allocate(count);
+            _end_of_storage = _start + count;
+        }
+        _finish = HxSTL::uninitialized_copy(first, last, _start);
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::initialize_aux(size_type count, const T& value, true_type) {
+        reset_inline();
+        if (count > N) {
+            _start = _alloc.allocate(count);
+            _end_of_storage = _start + count;
+        }
+        _finish = HxSTL::uninitialized_fill_n(_start, count, value);
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::steal_aux(small_vector&& other) {
+        if (other.is_inline()) {
+            // 内联元素只能逐个搬移
+            reset_inline();
+            _finish = HxSTL::uninitialized_relocate(other._start, other._finish, _start);
+            if (!HxSTL::is_trivially_relocatable<T>::value) {
+                HxSTL::destroy(other._alloc, other._start, other._finish);
+            }
+        } else {
+            _start = other._start;
+            _finish = other._finish;
+            _end_of_storage = other._end_of_storage;
+        }
+        other.reset_inline();
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::resize_aux(size_type count, const T& value) {
+        if (count <= size()) {
+            HxSTL::destroy(_alloc, _start + count, _finish);
+            _finish = _start + count;
+        } else if (count <= capacity()) {
+            _finish = HxSTL::uninitialized_fill_n(_finish, count - size(), value);
+        } else {
+            size_type new_cap = next_capacity(count);
+            iterator new_start = _alloc.allocate(new_cap);
+            // value 可能引用现有元素, 先填充新元素再迁移
+            HxSTL::uninitialized_fill_n(new_start + size(), count - size(), value);
+            HxSTL::uninitialized_relocate(_start, _finish, new_start);
+            relocate_and_reset(new_start, new_start + count, new_start + new_cap);
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::reserve(size_type new_cap) {
+        if (new_cap > max_size()) {
+            throw HxSTL::length_error();
+        } else if (new_cap > capacity()) {
+            iterator new_start = _alloc.allocate(new_cap);
+            iterator new_finish = HxSTL::uninitialized_relocate(_start, _finish, new_start);
+            relocate_and_reset(new_start, new_finish, new_start + new_cap);
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::shrink_to_fit() {
+        if (is_inline() || _end_of_storage == _finish) return;
+
+        if (size() <= N) {
+            // 放得回内联缓冲区
+            iterator old_start = _start;
+            iterator old_finish = _finish;
+            size_type old_cap = capacity();
+            reset_inline();
+            _finish = HxSTL::uninitialized_relocate(old_start, old_finish, _start);
+            if (!HxSTL::is_trivially_relocatable<T>::value) HxSTL::destroy(_alloc, old_start, old_finish);
+            _alloc.deallocate(old_start, old_cap);
+        } else {
+            iterator new_start = _alloc.allocate(size());
+            iterator new_finish = HxSTL::uninitialized_relocate(_start, _finish, new_start);
+            relocate_and_reset(new_start, new_finish, new_finish);
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class InputIt>
+    void small_vector<T, N, Alloc>::assign_aux(InputIt first, InputIt last, false_type) {
+        size_type count = HxSTL::distance(first, last);
+        if (count <= size()) {
+            iterator old_finish = _finish;
+            _finish = HxSTL::copy(first, last, _start);
+            HxSTL::destroy(_alloc, _finish, old_finish);
+        } else if (count <= capacity()) {
+            size_type sz = size();
+            HxSTL::copy_n(first, sz, _start);
+            HxSTL::advance(first, sz);
+            _finish = HxSTL::uninitialized_copy(first, last, _finish);
+        } else {
+            iterator new_start = _alloc.allocate(count);
+            iterator new_finish = HxSTL::uninitialized_copy(first, last, new_start);
+            destroy_and_reset(new_start, new_finish, new_finish);
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::assign_aux(size_type count, const value_type& value, true_type) {
+        if (count <= size()) {
+            iterator old_finish = _finish;
+            _finish = HxSTL::fill_n(_start, count, value);
+            HxSTL::destroy(_alloc, _finish, old_finish);
+        } else if (count <= capacity()) {
+            size_type sz = size();
+            HxSTL::fill_n(_start, sz, value);
+            _finish = HxSTL::uninitialized_fill_n(_finish, count - sz, value);
+        } else {
+            iterator new_start = _alloc.allocate(count);
+            iterator new_finish = HxSTL::uninitialized_fill_n(new_start, count, value);
+            destroy_and_reset(new_start, new_finish, new_finish);
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class... Args>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::emplace_aux(iterator pos, Args&&... args) {
+        if (_finish != _end_of_storage) {
+            if (pos == _finish) {
+                _alloc.construct(_finish, HxSTL::forward<Args>(args)...);
+            } else if (HxSTL::is_trivially_relocatable<T>::value) {
+                alignas(T) unsigned char buf[sizeof(T)];
+                _alloc.construct(reinterpret_cast<T*>(buf), HxSTL::forward<Args>(args)...);
+                HxSTL::__relocate_bytes(pos, _finish, pos + 1);
+                HxSTL::__relocate_bytes(reinterpret_cast<T*>(buf), reinterpret_cast<T*>(buf) + 1, pos);
+            } else {
+                // 参数可能引用被移动的元素, 先取出
+                T tmp(HxSTL::forward<Args>(args)...);
+                _alloc.construct(_finish, HxSTL::move(back()));
+                HxSTL::move_backward(pos, _finish - 1, _finish);
+                *pos = HxSTL::move(tmp);
+            }
+            ++_finish;
+            return pos;
+        } else {
+            size_type new_cap = next_capacity(size() + 1);
+            iterator new_start = _alloc.allocate(new_cap);
+            iterator result = new_start + (pos - _start);
+            iterator new_finish = new_start;
+            size_type done = 0;
+            try {
+                _alloc.construct(result, HxSTL::forward<Args>(args)...);
+                ++done;
+                HxSTL::uninitialized_relocate(_start, pos, new_start);
+                ++done;
+                new_finish = HxSTL::uninitialized_relocate(pos, _finish, result + 1);
+            } catch (...) {
+                // 只有逐个拷贝时搬移才会抛出, 此时原有元素仍在旧存储中, 析构新存储中已完成的部分
+                if (done == 2) HxSTL::destroy(_alloc, new_start, result);
+                if (done != 0) _alloc.destroy(result);
+                _alloc.deallocate(new_start, new_cap);
+                throw;
+            }
+            relocate_and_reset(new_start, new_finish, new_start + new_cap);
+            return result;
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class InputIt>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::insert_aux(iterator pos, InputIt first, InputIt last, false_type) {
+        if (first == last) return pos;
+
+        size_type count = HxSTL::distance(first, last);
+        if (size_type(_end_of_storage - _finish) >= count) {
+            size_type element_after = _finish - pos;
+            iterator old_finish = _finish;
+            if (count > element_after) {
+                _finish = HxSTL::uninitialized_move(pos, _finish, _finish + count - element_after);
+                HxSTL::copy_n(first, element_after, pos);
+                HxSTL::advance(first, element_after);
+                HxSTL::uninitialized_copy(first, last, old_finish);
+            } else {
+                _finish = HxSTL::uninitialized_move(_finish - count, _finish, _finish);
+                HxSTL::move_backward(pos, old_finish - count, old_finish);
+                HxSTL::copy(first, last, pos);
+            }
+            return pos;
+        } else {
+            size_type new_cap = next_capacity(size() + count);
+            iterator new_start = _alloc.allocate(new_cap);
+            iterator result = new_start + (pos - _start);
+            HxSTL::uninitialized_copy(first, last, result);
+            HxSTL::uninitialized_relocate(_start, pos, new_start);
+            iterator new_finish = HxSTL::uninitialized_relocate(pos, _finish, result + count);
+            relocate_and_reset(new_start, new_finish, new_start + new_cap);
+            return result;
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::insert_aux(iterator pos, size_type count, const value_type& value, true_type) {
+        if (count == 0) return pos;
+
+        if (size_type(_end_of_storage - _finish) >= count) {
+            // value 可能引用被移动的元素, 先取出
+            T tmp(value);
+            size_type element_after = _finish - pos;
+            iterator old_finish = _finish;
+            if (count > element_after) {
+                _finish = HxSTL::uninitialized_fill_n(_finish, count - element_after, tmp);
+                _finish = HxSTL::uninitialized_move(pos, old_finish, _finish);
+                HxSTL::fill_n(pos, element_after, tmp);
+            } else {
+                _finish = HxSTL::uninitialized_move(_finish - count, _finish, _finish);
+                HxSTL::move_backward(pos, old_finish - count, old_finish);
+                HxSTL::fill_n(pos, count, tmp);
+            }
+            return pos;
+        } else {
+            size_type new_cap = next_capacity(size() + count);
+            iterator new_start = _alloc.allocate(new_cap);
+            iterator result = new_start + (pos - _start);
+            HxSTL::uninitialized_fill_n(result, count, value);
+            HxSTL::uninitialized_relocate(_start, pos, new_start);
+            iterator new_finish = HxSTL::uninitialized_relocate(pos, _finish, result + count);
+            relocate_and_reset(new_start, new_finish, new_start + new_cap);
+            return result;
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::erase_aux(iterator first, iterator last) {
+        if (first == last) return first;
+
+        if (HxSTL::is_trivially_relocatable<T>::value) {
+            HxSTL::destroy(_alloc, first, last);
+            _finish = HxSTL::__relocate_bytes(last, _finish, first);
+        } else {
+            iterator old_finish = _finish;
+            _finish = HxSTL::move(last, _finish, first);
+            HxSTL::destroy(_alloc, _finish, old_finish);
+        }
+        return first;
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::swap(small_vector& other) {
+        if (this == &other) return;
+
+        if (!is_inline() && !other.is_inline()) {
+            HxSTL::swap(_start, other._start);
+            HxSTL::swap(_finish, other._finish);
+            HxSTL::swap(_end_of_storage, other._end_of_storage);
+            HxSTL::swap(_alloc, other._alloc);
+        } else {
+            small_vector tmp(HxSTL::move(other));
+            other = HxSTL::move(*this);
+            *this = HxSTL::move(tmp);
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::deallocate_aux() {
+        if (!is_inline()) _alloc.deallocate(_start, capacity());
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::destroy_and_reset(iterator new_start,
+            iterator new_finish, iterator new_end_of_storage) {
+        HxSTL::destroy(_alloc, _start, _finish);
+        deallocate_aux();
+
+        _start = new_start;
+        _finish = new_finish;
+        _end_of_storage = new_end_of_storage;
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::relocate_and_reset(iterator new_start,
+            iterator new_finish, iterator new_end_of_storage) {
+        // 元素已由 uninitialized_relocate 搬走, 按字节搬移的旧元素不能再析构
+        if (!HxSTL::is_trivially_relocatable<T>::value) HxSTL::destroy(_alloc, _start, _finish);
+        deallocate_aux();
+
+        _start = new_start;
+        _finish = new_finish;
+        _end_of_storage = new_end_of_storage;
+    }
+
+    template <class T, size_t N, class Alloc>
+    bool operator==(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return lhs.size() == rhs.size() && HxSTL::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, size_t N, class Alloc>
+    bool operator!=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template <class T, size_t N, class Alloc>
+    bool operator< (const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return HxSTL::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class T, size_t N, class Alloc>
+    bool operator<=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return !(rhs < lhs);
+    }
+
+    template <class T, size_t N, class Alloc>
+    bool operator> (const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return rhs < lhs;
+    }
+
+    template <class T, size_t N, class Alloc>
+    bool operator>=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return !(lhs < rhs);
+    }
+
+}
+
+
+#endif
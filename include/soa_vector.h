@@ -0,0 +1,244 @@
+#ifndef _SOA_VECTOR_H_
+#define _SOA_VECTOR_H_
+
+
+#include <stddef.h>
+#include "vector.h"
+#include "utility.h"
+
+
+namespace HxSTL {
+
+    // 一列连续元素的视图, 不拥有存储; 列上的循环就是普通指针循环, 可以被向量化
+    template <class T>
+    class soa_span {
+    public:
+        typedef T               value_type;
+        typedef T&              reference;
+        typedef T*              pointer;
+        typedef T*              iterator;
+        typedef size_t          size_type;
+        typedef ptrdiff_t       difference_type;
+    protected:
+        T* _data;
+        size_type _size;
+    public:
+        soa_span(): _data(nullptr), _size(0) {}
+
+        soa_span(T* data, size_type size): _data(data), _size(size) {}
+
+        reference operator[](size_type n) const { return _data[n]; }
+
+        pointer data() const { return _data; }
+
+        size_type size() const { return _size; }
+
+        bool empty() const { return _size == 0; }
+
+        iterator begin() const { return _data; }
+
+        iterator end() const { return _data + _size; }
+    };
+
+    // 第 I 个字段的类型
+    template <size_t I, class... Fields>
+    struct __soa_element;
+
+    template <class Head, class... Tail>
+    struct __soa_element<0, Head, Tail...> {
+        typedef Head type;
+    };
+
+    template <size_t I, class Head, class... Tail>
+    struct __soa_element<I, Head, Tail...> {
+        typedef typename __soa_element<I - 1, Tail...>::type type;
+    };
+
+    // 每个字段一个 vector, 递归展开
+    template <class... Fields>
+    struct __soa_columns;
+
+    template <>
+    struct __soa_columns<> {
+        void reserve(size_t) {}
+        void resize(size_t) {}
+        void shrink_to_fit() {}
+        void clear() {}
+        void pop_back() {}
+        void emplace_back() {}
+        void swap(__soa_columns&) {}
+    };
+
+    template <class Head, class... Tail>
+    struct __soa_columns<Head, Tail...> {
+        HxSTL::vector<Head> _head;
+        __soa_columns<Tail...> _tail;
+
+        void reserve(size_t n) { _head.reserve(n); _tail.reserve(n); }
+
+        void resize(size_t n) { _head.resize(n); _tail.resize(n); }
+
+        void shrink_to_fit() { _head.shrink_to_fit(); _tail.shrink_to_fit(); }
+
+        void clear() { _head.clear(); _tail.clear(); }
+
+        void pop_back() { _head.pop_back(); _tail.pop_back(); }
+
+        template <class Arg, class... Args>
+        void emplace_back(Arg&& arg, Args&&... args) {
+            _head.emplace_back(HxSTL::forward<Arg>(arg));
+            // 后面的列失败时撤销已追加的元素, 保持各列等长
+            try {
+                _tail.emplace_back(HxSTL::forward<Args>(args)...);
+            } catch (...) {
+                _head.pop_back();
+                throw;
+            }
+        }
+
+        void swap(__soa_columns& other) { _head.swap(other._head); _tail.swap(other._tail); }
+    };
+
+    template <size_t I>
+    struct __soa_get {
+        template <class Head, class... Tail>
+        static typename __soa_element<I, Head, Tail...>::type* data(__soa_columns<Head, Tail...>& c) {
+            return __soa_get<I - 1>::data(c._tail);
+        }
+
+        template <class Head, class... Tail>
+        static const typename __soa_element<I, Head, Tail...>::type* data(const __soa_columns<Head, Tail...>& c) {
+            return __soa_get<I - 1>::data(c._tail);
+        }
+    };
+
+    template <>
+    struct __soa_get<0> {
+        template <class Head, class... Tail>
+        static Head* data(__soa_columns<Head, Tail...>& c) { return c._head.data(); }
+
+        template <class Head, class... Tail>
+        static const Head* data(const __soa_columns<Head, Tail...>& c) { return c._head.data(); }
+    };
+
+    // soa_vector 中一行的代理引用, get<I>() 访问该行的第 I 个字段
+    template <class SoA>
+    class soa_reference {
+    protected:
+        SoA* _soa;
+        size_t _index;
+    public:
+        soa_reference(SoA* soa, size_t index): _soa(soa), _index(index) {}
+
+        template <size_t I>
+        auto get() const -> decltype(_soa->template get<I>(_index)) {
+            return _soa->template get<I>(_index);
+        }
+
+        size_t index() const { return _index; }
+    };
+
+    // 列式存储的 vector: 每个字段存放在各自的连续数组中 (内部是每个字段一个 vector),
+    // 只访问部分字段的循环不会把其余字段带进缓存, 列上的循环可以被向量化
+    // 各列始终等长; 没有行迭代器, 行通过下标访问, 批量处理使用 column<I>()
+    //
+    // 用法: HxSTL::soa_vector<float, float, int> particles;
+    //       particles.push_back(1.0f, 2.0f, 3);
+    //       for (float& x: particles.column<0>()) x += 1.0f;
+    template <class... Fields>
+    class soa_vector {
+        static_assert(sizeof...(Fields) > 0, "soa_vector requires at least one field");
+    public:
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+        typedef soa_reference<soa_vector>               reference;
+        typedef soa_reference<const soa_vector>         const_reference;
+
+        template <size_t I>
+        struct element {
+            typedef typename __soa_element<I, Fields...>::type type;
+        };
+    protected:
+        __soa_columns<Fields...> _columns;
+    public:
+        soa_vector() {}
+
+        explicit soa_vector(size_type count) { resize(count); }
+
+        reference operator[](size_type n) { return reference(this, n); }
+
+        const_reference operator[](size_type n) const { return const_reference(this, n); }
+
+        reference at(size_type n) {
+            if (n >= size()) {
+                throw HxSTL::out_of_range();
+            }
+            return operator[](n);
+        }
+
+        const_reference at(size_type n) const {
+            if (n >= size()) {
+                throw HxSTL::out_of_range();
+            }
+            return operator[](n);
+        }
+
+        template <size_t I>
+        typename element<I>::type& get(size_type n) { return data<I>()[n]; }
+
+        template <size_t I>
+        const typename element<I>::type& get(size_type n) const { return data<I>()[n]; }
+
+        template <size_t I>
+        typename element<I>::type* data() { return __soa_get<I>::data(_columns); }
+
+        template <size_t I>
+        const typename element<I>::type* data() const { return __soa_get<I>::data(_columns); }
+
+        template <size_t I>
+        soa_span<typename element<I>::type> column() {
+            return soa_span<typename element<I>::type>(data<I>(), size());
+        }
+
+        template <size_t I>
+        soa_span<const typename element<I>::type> column() const {
+            return soa_span<const typename element<I>::type>(data<I>(), size());
+        }
+
+        bool empty() const { return size() == 0; }
+
+        size_type size() const { return _columns._head.size(); }
+
+        size_type capacity() const { return _columns._head.capacity(); }
+
+        void reserve(size_type new_cap) { _columns.reserve(new_cap); }
+
+        void resize(size_type count) { _columns.resize(count); }
+
+        void shrink_to_fit() { _columns.shrink_to_fit(); }
+
+        void clear() { _columns.clear(); }
+
+        void push_back(const Fields&... values) { _columns.emplace_back(values...); }
+
+        // 每个参数构造对应的一个字段
+        template <class... Args>
+        void emplace_back(Args&&... args) {
+            static_assert(sizeof...(Args) == sizeof...(Fields), "soa_vector::emplace_back requires one argument per field");
+            _columns.emplace_back(HxSTL::forward<Args>(args)...);
+        }
+
+        void pop_back() { _columns.pop_back(); }
+
+        void swap(soa_vector& other) { _columns.swap(other._columns); }
+    };
+
+    template <class... Fields>
+    void swap(soa_vector<Fields...>& x, soa_vector<Fields...>& y) {
+        x.swap(y);
+    }
+
+}
+
+
+#endif
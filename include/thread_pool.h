@@ -0,0 +1,451 @@
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stddef.h>
+#include <stdlib.h>
+#include <thread>
+#include "deque.h"
+#include "vector.h"
+#include "functional.h"
+
+
+namespace HxSTL {
+
+    // Chase-Lev 工作窃取双端队列
+    // 所属线程在底端 push / pop (后进先出, 缓存友好), 其它线程在顶端 steal 最早放入的任务
+    // 元素是指针, 容量为 2 的幂, 满时由所属线程扩容; 旧数组可能仍被窃取者读取, 析构时才释放
+    template <class T>
+    class __work_stealing_deque {
+    protected:
+        struct array {
+            size_t mask;
+            std::atomic<T*>* slots;
+
+            explicit array(size_t capacity): mask(capacity - 1), slots(new std::atomic<T*>[capacity]) {}
+
+            ~array() { delete[] slots; }
+
+            T* get(ptrdiff_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+
+            void put(ptrdiff_t i, T* x) { slots[i & mask].store(x, std::memory_order_relaxed); }
+        };
+
+        std::atomic<ptrdiff_t> _top;
+        char _pad[64];          // top 与 bottom 分别由窃取者与所属线程频繁写入, 隔开以免伪共享
+        std::atomic<ptrdiff_t> _bottom;
+        std::atomic<array*> _array;
+        HxSTL::vector<array*> _retired;
+    protected:
+        array* grow(array* a, ptrdiff_t b, ptrdiff_t t) {
+            array* bigger = new array((a->mask + 1) * 2);
+            for (ptrdiff_t i = t; i < b; ++i) {
+                bigger->put(i, a->get(i));
+            }
+            _retired.push_back(a);
+            _array.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+    public:
+        explicit __work_stealing_deque(size_t capacity = 64): _top(0), _bottom(0), _array(new array(capacity)) {}
+
+        __work_stealing_deque(const __work_stealing_deque&) = delete;
+
+        __work_stealing_deque& operator=(const __work_stealing_deque&) = delete;
+
+        ~__work_stealing_deque() {
+            delete _array.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < _retired.size(); ++i) {
+                delete _retired[i];
+            }
+        }
+
+        // 只能由所属线程调用
+        void push(T* x) {
+            ptrdiff_t b = _bottom.load(std::memory_order_relaxed);
+            ptrdiff_t t = _top.load(std::memory_order_acquire);
+            array* a = _array.load(std::memory_order_relaxed);
+            if (b - t > static_cast<ptrdiff_t>(a->mask)) {
+                a = grow(a, b, t);
+            }
+            a->put(b, x);
+            _bottom.store(b + 1, std::memory_order_release);
+        }
+
+        // 只能由所属线程调用, 队列为空时返回 nullptr
+        T* pop() {
+            ptrdiff_t b = _bottom.load(std::memory_order_relaxed) - 1;
+            array* a = _array.load(std::memory_order_relaxed);
+            _bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            ptrdiff_t t = _top.load(std::memory_order_relaxed);
+            T* x = nullptr;
+            if (t <= b) {
+                x = a->get(b);
+                if (t == b) {
+                    // 只剩最后一个元素, 与窃取者竞争
+                    if (!_top.compare_exchange_strong(t, t + 1,
+                            std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        x = nullptr;
+                    }
+                    _bottom.store(b + 1, std::memory_order_relaxed);
+                }
+            } else {
+                _bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return x;
+        }
+
+        // 任意线程调用, 队列为空或与其它线程竞争失败时返回 nullptr
+        T* steal() {
+            ptrdiff_t t = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            ptrdiff_t b = _bottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return nullptr;
+            }
+            array* a = _array.load(std::memory_order_acquire);
+            T* x = a->get(t);
+            if (!_top.compare_exchange_strong(t, t + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return x;
+        }
+
+        bool empty() const {
+            return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+        }
+    };
+
+    // 工作窃取线程池
+    // 每个工作线程有自己的 Chase-Lev 队列: 工作线程提交的任务放入自己的队列, 空闲时从其它队列窃取;
+    // 外部线程提交的任务放入一个共享的注入队列
+    // 提交的任务不应抛出异常; 需要收集异常时使用 task_group
+    class thread_pool {
+    public:
+        typedef HxSTL::function<void()>     task_type;
+        typedef size_t                      size_type;
+    protected:
+        typedef __work_stealing_deque<task_type>    queue_type;
+
+        // 当前线程所属的线程池及其编号, 非工作线程的 pool 为空
+        struct worker_info {
+            thread_pool* pool;
+            size_type index;
+            size_t seed;
+        };
+
+        static worker_info& current() {
+            static thread_local worker_info info = { nullptr, 0, 0 };
+            return info;
+        }
+
+        HxSTL::vector<std::thread> _workers;
+        HxSTL::vector<queue_type*> _queues;
+        HxSTL::deque<task_type*> _injected;
+        std::mutex _injected_mutex;
+        std::atomic<size_type> _queued;     // 已提交尚未取走的任务数
+        std::atomic<size_type> _sleeping;
+        std::mutex _mutex;
+        std::condition_variable _cond;
+        std::atomic<bool> _stop;
+    protected:
+        void worker_loop(size_type index);
+
+        void push(task_type* task);
+
+        task_type* take();
+
+        task_type* take_injected();
+
+        task_type* steal(size_t& seed, size_type self);
+
+        void run(task_type* task) {
+            _queued.fetch_sub(1, std::memory_order_relaxed);
+            (*task)();
+            delete task;
+        }
+    public:
+        explicit thread_pool(size_type n = default_concurrency());
+
+        thread_pool(const thread_pool&) = delete;
+
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        // 执行完剩余的任务后退出
+        ~thread_pool();
+
+        void submit(task_type task) { push(new task_type(HxSTL::move(task))); }
+
+        // 在调用线程上执行一个排队的任务, 没有可执行的任务时返回 false
+        // 工作线程优先取自己队列中最近提交的任务
+        bool try_run_one();
+
+        size_type size() const { return _workers.size(); }
+
+        // 对 [first, last) 中的每个下标调用 fn(i), 调用线程也参与执行, 返回时全部完成
+        // 区间被对半拆分成任务, 拆到不超过 grain 为止; grain 为 0 时按线程数自动选择, 每个线程约 8 块,
+        // 空闲线程窃取到的是尚未拆分的大块, 负载不均时会自然地继续拆分
+        template <class Index, class Function>
+        void parallel_for(Index first, Index last, Function fn, size_type grain = 0);
+
+        // 环境变量 HXSTL_NUM_THREADS 可以指定默认的线程数
+        static size_type default_concurrency() {
+            const char* env = getenv("HXSTL_NUM_THREADS");
+            if (env != nullptr && atoi(env) > 0) {
+                return atoi(env);
+            }
+            size_type n = std::thread::hardware_concurrency();
+            return n == 0 ? 1 : n;
+        }
+
+        // 进程内共享的线程池, 并行算法默认使用它
+        static thread_pool& default_pool() {
+            static thread_pool pool;
+            return pool;
+        }
+    };
+
+    inline thread_pool::thread_pool(size_type n): _queued(0), _sleeping(0), _stop(false) {
+        _queues.reserve(n);
+        for (size_type i = 0; i < n; ++i) {
+            _queues.push_back(new queue_type());
+        }
+        _workers.reserve(n);
+        for (size_type i = 0; i < n; ++i) {
+            _workers.emplace_back(&thread_pool::worker_loop, this, i);
+        }
+    }
+
+    inline thread_pool::~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop.store(true);
+        }
+        _cond.notify_all();
+        for (size_type i = 0; i < _workers.size(); ++i) {
+            _workers[i].join();
+        }
+        for (size_type i = 0; i < _queues.size(); ++i) {
+            delete _queues[i];
+        }
+    }
+
+    inline void thread_pool::push(task_type* task) {
+        _queued.fetch_add(1, std::memory_order_seq_cst);
+        worker_info& self = current();
+        if (self.pool == this) {
+            _queues[self.index]->push(task);
+        } else {
+            std::lock_guard<std::mutex> lock(_injected_mutex);
+            _injected.push_back(task);
+        }
+        // 与 worker_loop 中先增加 _sleeping 再检查 _queued 相对, 两边至少有一边能看到对方
+        if (_sleeping.load(std::memory_order_seq_cst) != 0) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _cond.notify_one();
+        }
+    }
+
+    inline thread_pool::task_type* thread_pool::take_injected() {
+        std::lock_guard<std::mutex> lock(_injected_mutex);
+        if (_injected.empty()) {
+            return nullptr;
+        }
+        task_type* task = _injected.front();
+        _injected.pop_front();
+        return task;
+    }
+
+    // 从随机的位置开始轮流尝试每个工作线程的队列
+    inline thread_pool::task_type* thread_pool::steal(size_t& seed, size_type self) {
+        size_type n = _queues.size();
+        if (n == 0) {
+            return nullptr;
+        }
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        size_type start = seed % n;
+        for (size_type k = 0; k < n; ++k) {
+            size_type victim = (start + k) % n;
+            if (victim == self) {
+                continue;
+            }
+            task_type* task = _queues[victim]->steal();
+            if (task != nullptr) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    inline thread_pool::task_type* thread_pool::take() {
+        worker_info& self = current();
+        task_type* task = nullptr;
+        if (self.pool == this) {
+            task = _queues[self.index]->pop();
+        }
+        if (task == nullptr) {
+            task = take_injected();
+        }
+        if (task == nullptr) {
+            if (self.seed == 0) {
+                self.seed = reinterpret_cast<size_t>(&self) | 1;
+            }
+            task = steal(self.seed, self.pool == this ? self.index : _queues.size());
+        }
+        return task;
+    }
+
+    inline void thread_pool::worker_loop(size_type index) {
+        worker_info& self = current();
+        self.pool = this;
+        self.index = index;
+        self.seed = index * 2654435761u + 1;
+        for (;;) {
+            task_type* task = take();
+            if (task != nullptr) {
+                run(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(_mutex);
+            _sleeping.fetch_add(1, std::memory_order_seq_cst);
+            while (_queued.load(std::memory_order_seq_cst) == 0 && !_stop.load()) {
+                _cond.wait(lock);
+            }
+            _sleeping.fetch_sub(1, std::memory_order_relaxed);
+            if (_queued.load() == 0 && _stop.load()) {
+                return;
+            }
+        }
+    }
+
+    inline bool thread_pool::try_run_one() {
+        task_type* task = take();
+        if (task == nullptr) {
+            return false;
+        }
+        run(task);
+        return true;
+    }
+
+    // 一组任务: spawn 提交, wait 等待全部完成
+    // wait 期间调用线程也执行线程池中的任务, 因此任务内部可以再创建 task_group 并等待
+    // 任务抛出的第一个异常在 wait 中重新抛出
+    class task_group {
+    protected:
+        thread_pool* _pool;
+        std::atomic<size_t> _pending;
+        std::exception_ptr _exception;
+        std::mutex _mutex;
+    protected:
+        void set_exception(std::exception_ptr e) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_exception) {
+                _exception = e;
+            }
+        }
+
+        void wait_aux() {
+            while (_pending.load(std::memory_order_acquire) != 0) {
+                if (!_pool->try_run_one()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    public:
+        explicit task_group(thread_pool& pool = thread_pool::default_pool()): _pool(&pool), _pending(0) {}
+
+        task_group(const task_group&) = delete;
+
+        task_group& operator=(const task_group&) = delete;
+
+        ~task_group() { wait_aux(); }
+
+        template <class F>
+        void spawn(F f) {
+            _pending.fetch_add(1, std::memory_order_relaxed);
+            task_group* self = this;
+            _pool->submit([self, f]() mutable {
+                try {
+                    f();
+                } catch (...) {
+                    self->set_exception(std::current_exception());
+                }
+                // 计数归零后 wait 可能立即返回并销毁 task_group, 此后不能再访问 self
+                self->_pending.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        void wait() {
+            wait_aux();
+            if (_exception) {
+                std::exception_ptr e = _exception;
+                _exception = nullptr;
+                std::rethrow_exception(e);
+            }
+        }
+
+        thread_pool& pool() const { return *_pool; }
+    };
+
+    // 把 [first, last) 对半拆分, 右半作为任务提交, 左半继续拆分, 直到不超过 grain 后调用 fn(first, last)
+    template <class Index, class Function>
+    void __parallel_for_range(task_group& group, Index first, Index last, size_t grain, Function& fn) {
+        while (static_cast<size_t>(last - first) > grain) {
+            Index middle = first + (last - first) / 2;
+            task_group* g = &group;
+            Function* f = &fn;
+            group.spawn([g, f, middle, last, grain]() { __parallel_for_range(*g, middle, last, grain, *f); });
+            last = middle;
+        }
+        fn(first, last);
+    }
+
+    // 对 [first, last) 按块调用 fn(begin, end), grain 为 0 时自动选择
+    template <class Index, class Function>
+    void parallel_for_range(thread_pool& pool, Index first, Index last, Function fn, size_t grain = 0) {
+        if (!(first < last)) {
+            return;
+        }
+        size_t n = last - first;
+        if (grain == 0) {
+            grain = n / ((pool.size() + 1) * 8);
+        }
+        if (grain == 0) {
+            grain = 1;
+        }
+        if (n <= grain || pool.size() == 0) {
+            fn(first, last);
+            return;
+        }
+        task_group group(pool);
+        __parallel_for_range(group, first, last, grain, fn);
+        group.wait();
+    }
+
+    template <class Index, class Function>
+    void thread_pool::parallel_for(Index first, Index last, Function fn, size_type grain) {
+        parallel_for_range(*this, first, last, [&fn](Index b, Index e) {
+            for (; b < e; ++b) {
+                fn(b);
+            }
+        }, grain);
+    }
+
+    // 在默认线程池上对 [first, last) 中的每个下标调用 fn(i)
+    template <class Index, class Function>
+    void parallel_for(Index first, Index last, Function fn, size_t grain = 0) {
+        thread_pool::default_pool().parallel_for(first, last, fn, grain);
+    }
+
+}
+
+
+#endif
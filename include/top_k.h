@@ -0,0 +1,94 @@
+#ifndef _TOP_K_H_
+#define _TOP_K_H_
+
+
+#include <stddef.h>
+#include "vector.h"
+#include "functional.h"
+#include "algorithm.h"
+
+
+namespace HxSTL {
+
+    // 流式的前 k 大选择器: 逐个 push 元素, 始终只保留按 Compare 最大的 k 个
+    // 内部是大小为 k 的小顶堆, 堆顶是保留元素中最小的, 也就是新元素进入的门槛;
+    // 不超过门槛的元素只需一次比较, 处理 n 个元素共 O(nlogk), 内存只有 O(k)
+    // 多个线程可以各自维护一个选择器, 最后用 merge 合并
+    template <class T, class Compare = less<T> >
+    class top_k {
+    public:
+        typedef T                   value_type;
+        typedef const T&            const_reference;
+        typedef size_t              size_type;
+        typedef Compare             value_compare;
+
+    protected:
+        // 交换参数的比较, 让堆算法建出小顶堆
+        struct heap_compare {
+            Compare comp;
+            explicit heap_compare(const Compare& c): comp(c) {}
+            bool operator()(const T& a, const T& b) const { return comp(b, a); }
+        };
+
+        vector<T> _heap;
+        size_type _k;
+        heap_compare _comp;
+
+    public:
+        explicit top_k(size_type k, const Compare& comp = Compare()): _k(k), _comp(comp) {
+            _heap.reserve(k);
+        }
+
+        void push(const T& value);
+
+        template <class InputIt>
+        void push(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                push(*first);
+            }
+        }
+
+        void merge(const top_k& other) {
+            push(other._heap.begin(), other._heap.end());
+        }
+
+        size_type size() const { return _heap.size(); }
+
+        size_type capacity() const { return _k; }
+
+        bool empty() const { return _heap.empty(); }
+
+        bool full() const { return _heap.size() == _k; }
+
+        // 保留元素中最小的一个; 选择器满了之后, 不大于它的元素不会被保留
+        const_reference threshold() const { return _heap.front(); }
+
+        // 保留的元素, 从大到小
+        vector<T> sorted() const;
+
+        void clear() { _heap.clear(); }
+    };
+
+    template <class T, class Compare>
+    void top_k<T, Compare>::push(const T& value) {
+        if (_heap.size() < _k) {
+            _heap.push_back(value);
+            push_heap(_heap.begin(), _heap.end(), _comp);
+        } else if (_k != 0 && _comp.comp(_heap.front(), value)) {
+            _heap.front() = value;
+            __maintain_heap(_heap.begin(), static_cast<ptrdiff_t>(0),
+                static_cast<ptrdiff_t>(_heap.size()), _comp);
+        }
+    }
+
+    template <class T, class Compare>
+    vector<T> top_k<T, Compare>::sorted() const {
+        vector<T> result(_heap);
+        sort_heap(result.begin(), result.end(), _comp);
+        return result;
+    }
+
+}
+
+
+#endif
@@ -3,6 +3,7 @@
 
 
 #include <stddef.h>
+#include <new>
 
 
 namespace HxSTL {
@@ -31,6 +32,14 @@ namespace HxSTL {
         typedef T       type;
     };
 
+    template <bool Cond, class T = void>
+    struct enable_if {};
+
+    template <class T>
+    struct enable_if<true, T> {
+        typedef T       type;
+    };
+
     template <class T>
     struct remove_const {
         typedef T       type;
@@ -107,47 +116,9 @@ namespace HxSTL {
     template <class T>
     struct is_same<T, T>: public true_type {};
 
+    // 由编译器内建判断, 用户定义的 POD 结构体同样适用
     template <class T>
-    struct is_pod: public false_type {};
-
-    template <>
-    struct is_pod<char>: public true_type {};
-
-    template <>
-    struct is_pod<signed char>: public true_type {};
-
-    template <>
-    struct is_pod<unsigned char>: public true_type {};
-
-    template <>
-    struct is_pod<short>: public true_type {}; 
-
-    template <>
-    struct is_pod<unsigned short>: public true_type {};
-
-    template <>
-    struct is_pod<int>: public true_type {};
-
-    template <>
-    struct is_pod<unsigned int>: public true_type {};
-
-    template <>
-    struct is_pod<long>: public true_type {};
-
-    template <>
-    struct is_pod<unsigned long>: public true_type {};
-
-    template <>
-    struct is_pod<float>: public true_type {};
-
-    template <>
-    struct is_pod<double>: public true_type {};
-
-    template <>
-    struct is_pod<long double>: public true_type {};
-
-    template <class T>
-    struct is_pod<T*>: public true_type {};
+    struct is_pod: public integeral_constant<bool, __is_pod(T)> {};
 
     template <class T>
     struct is_function: public false_type {};
@@ -395,7 +366,7 @@ namespace HxSTL {
 
     // add_lvalue_reference 可行吗
     template <class T>
-    typename add_rvalue_reference<T>::type declval();
+    typename add_rvalue_reference<T>::type declval() noexcept;
 
     template <class T, class U, class = decltype(declval<T>() = declval<U>())>
     static __one __test_is_assignable(int);
@@ -458,6 +429,60 @@ namespace HxSTL {
         is_destructible<T>::value && 
         __has_trivial_destructor(T)> {};
 
+    template <class T>
+    struct is_trivially_copyable: 
+        public integeral_constant<bool, 
+        __is_trivially_copyable(T)> {};
+
+    // 可平凡重定位: 可以用 memcpy 把对象搬到新地址, 旧地址上的对象不再析构
+    // 默认由可平凡拷贝且可平凡析构推出; 不持有指向自身指针的类型可以特化为 true_type 主动开启
+    template <class T>
+    struct is_trivially_relocatable: 
+        public integeral_constant<bool, 
+        is_trivially_copyable<T>::value && 
+        is_trivially_destructible<T>::value> {};
+
+    template <class T, class... Args>
+    struct is_constructible: 
+        public integeral_constant<bool, 
+        __is_constructible(T, Args...)> {};
+
+    template <class T>
+    struct is_copy_constructible: 
+        public integeral_constant<bool, 
+        __is_referenable<T>::value && 
+        is_constructible<T, const T&>::value> {};
+
+    template <class T>
+    struct is_move_constructible: 
+        public integeral_constant<bool, 
+        __is_referenable<T>::value && 
+        is_constructible<T, T&&>::value> {};
+
+    // 不可构造时不能对构造表达式求 noexcept, 先分派一次
+    template <bool, class T, class... Args>
+    struct __is_nothrow_constructible_aux: public false_type {};
+
+    template <class T, class... Args>
+    struct __is_nothrow_constructible_aux<true, T, Args...>: 
+        public integeral_constant<bool, 
+        noexcept(::new (declval<void*>()) T(declval<Args>()...))> {};
+
+    template <class T, class... Args>
+    struct is_nothrow_constructible: 
+        public __is_nothrow_constructible_aux<is_constructible<T, Args...>::value, T, Args...> {};
+
+    template <class T>
+    struct is_nothrow_move_constructible: 
+        public integeral_constant<bool, 
+        __is_referenable<T>::value && 
+        is_nothrow_constructible<T, T&&>::value> {};
+
+    template <class T>
+    struct is_trivially_default_constructible: 
+        public integeral_constant<bool, 
+        __is_trivially_constructible(T)> {};
+
     template <class T>
     struct decay {
     private:
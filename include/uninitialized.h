@@ -9,6 +9,22 @@
 
 namespace HxSTL {
 
+    // 源与目标类型相同且可平凡拷贝时, 构造等价于按字节拷贝, 交给 copy / move 的 memmove 分支
+
+    template <class T, class U>
+    struct __is_bitwise_copy_constructible: 
+        public integeral_constant<bool, 
+        is_same<T, U>::value && 
+        is_trivially_copyable<T>::value && 
+        is_trivially_copy_assignable<T>::value> {};
+
+    template <class T, class U>
+    struct __is_bitwise_move_constructible: 
+        public integeral_constant<bool, 
+        is_same<T, U>::value && 
+        is_trivially_copyable<T>::value && 
+        is_trivially_move_assignable<T>::value> {};
+
     // uninitialized_copy
 
     template <bool Trivial>
@@ -17,7 +33,7 @@ namespace HxSTL {
         static ForwardIt __copy(InputIt first, InputIt last,
             ForwardIt result) {
             for (; first != last; ++first, ++result) {
-                HxSTL::construct(result, *first);
+                HxSTL::construct(&*result, *first);
             }
             return result;
         }
@@ -32,13 +48,22 @@ namespace HxSTL {
         }
     };
 
+    template <bool Trivial>
+    struct __uninitialized_copy_fn {
+        template <class InputIt, class ForwardIt>
+        ForwardIt operator()(InputIt first, InputIt last, ForwardIt result) const {
+            return __uninitialized_copy<Trivial>::__copy(first, last, result);
+        }
+    };
+
     template <class InputIt, class ForwardIt>
     inline ForwardIt uninitialized_copy(InputIt first, InputIt last,
         ForwardIt result) {
         typedef typename iterator_traits<ForwardIt>::value_type value_type1;
         typedef typename iterator_traits<InputIt>::value_type value_type2;
-        return __uninitialized_copy<HxSTL::is_pod<value_type1>::value &&
-            HxSTL::is_pod<value_type2>::value>::__copy(first, last, result);
+        // 分段迭代器 (deque) 按块拆成指针区间后再构造
+        return HxSTL::__segmented_copy(first, last, result, __uninitialized_copy_fn<
+            __is_bitwise_copy_constructible<value_type1, value_type2>::value>());
     }
 
     // uninitialized_move
@@ -49,7 +74,7 @@ namespace HxSTL {
         static ForwardIt __move(InputIt first, InputIt last,
             ForwardIt result) {
             for (; first != last; ++first, ++result) {
-                HxSTL::construct(result, HxSTL::move(*first));
+                HxSTL::construct(&*result, HxSTL::move(*first));
             }
             return result;
         }
@@ -69,10 +94,77 @@ namespace HxSTL {
         ForwardIt result) {
         typedef typename iterator_traits<ForwardIt>::value_type value_type1;
         typedef typename iterator_traits<InputIt>::value_type value_type2;
-        return __uninitialized_move<HxSTL::is_pod<value_type1>::value &&
-            HxSTL::is_pod<value_type2>::value>::__move(first, last, result);
+        return __uninitialized_move<__is_bitwise_move_constructible<value_type1,
+            value_type2>::value>::__move(first, last, result);
+    }
+
+    // uninitialized_move_if_noexcept
+    // 元素迁移时使用: 移动构造不抛出异常 (或者不能拷贝) 时移动, 否则拷贝
+
+    template <class InputIt, class ForwardIt>
+    inline ForwardIt __uninitialized_move_if_noexcept(InputIt first, InputIt last,
+        ForwardIt result, true_type) {
+        return HxSTL::uninitialized_move(first, last, result);
+    }
+
+    template <class InputIt, class ForwardIt>
+    inline ForwardIt __uninitialized_move_if_noexcept(InputIt first, InputIt last,
+        ForwardIt result, false_type) {
+        return HxSTL::uninitialized_copy(first, last, result);
+    }
+
+    template <class InputIt, class ForwardIt>
+    inline ForwardIt uninitialized_move_if_noexcept(InputIt first, InputIt last,
+        ForwardIt result) {
+        typedef typename iterator_traits<InputIt>::value_type value_type;
+        return __uninitialized_move_if_noexcept(first, last, result,
+            integeral_constant<bool, HxSTL::is_nothrow_move_constructible<value_type>::value ||
+            !HxSTL::is_copy_constructible<value_type>::value>());
+    }
+
+    // uninitialized_relocate
+    // 把 [first, last) 搬到未初始化的 result 处, 返回新区间的尾后位置
+    // 元素可平凡重定位时整体 memcpy, 源区间随即失效, 不能再析构;
+    // 否则按 uninitialized_move_if_noexcept 构造, 源区间仍由调用者析构
+
+    template <class T>
+    inline T* __relocate_bytes(T* first, T* last, T* result) {
+        // 区间可以重叠, 供容器内部平移元素使用
+        if (first == last) return result;
+        memmove(static_cast<void*>(result), static_cast<const void*>(first), sizeof(T) * (last - first));
+        return result + (last - first);
     }
 
+    template <class T>
+    inline T* __uninitialized_relocate(T* first, T* last, T* result, true_type) {
+        if (first == last) return result;
+        memcpy(static_cast<void*>(result), static_cast<const void*>(first), sizeof(T) * (last - first));
+        return result + (last - first);
+    }
+
+    template <class T>
+    inline T* __uninitialized_relocate(T* first, T* last, T* result, false_type) {
+        return HxSTL::uninitialized_move_if_noexcept(first, last, result);
+    }
+
+    template <class T>
+    inline T* uninitialized_relocate(T* first, T* last, T* result) {
+        return __uninitialized_relocate(first, last, result,
+            typename HxSTL::is_trivially_relocatable<T>::type());
+    }
+
+    // 判断 it 是否指向 [first, last) 内部, 只有原生指针可能指向容器自身的存储
+    // 容器原地扩容 (realloc) 前用来排除来源区间与自身重叠的情况
+
+    template <class It, class T>
+    inline bool __points_into(It, T*, T*) { return false; }
+
+    template <class T>
+    inline bool __points_into(T* p, T* first, T* last) { return !(p < first) && p < last; }
+
+    template <class T>
+    inline bool __points_into(const T* p, T* first, T* last) { return !(p < first) && p < last; }
+
     // uninitialized_copy_n
 
     template <bool Trivial>
@@ -81,7 +173,7 @@ namespace HxSTL {
         static ForwardIt __copy_n(InputIt first, Size n,
             ForwardIt result) {
             for (; n != 0; --n, ++first, ++result) {
-                HxSTL::construct(result, *first);
+                HxSTL::construct(&*result, *first);
             }
             return result;
         }
@@ -101,8 +193,33 @@ namespace HxSTL {
         ForwardIt result) {
         typedef typename iterator_traits<ForwardIt>::value_type value_type1;
         typedef typename iterator_traits<InputIt>::value_type value_type2;
-        return __uninitialized_copy_n<HxSTL::is_pod<value_type1>::value &&
-            HxSTL::is_pod<value_type2>::value>::__copy_n(first, n, result);
+        return __uninitialized_copy_n<__is_bitwise_copy_constructible<value_type1,
+            value_type2>::value>::__copy_n(first, n, result);
+    }
+
+    // uninitialized_default_construct_n
+    // 默认初始化 (不是值初始化), 可平凡默认构造的元素不写内存, 内容不确定
+
+    template <class ForwardIt, class Size>
+    inline ForwardIt __uninitialized_default_construct_n(ForwardIt first, Size n, true_type) {
+        HxSTL::advance(first, n);
+        return first;
+    }
+
+    template <class ForwardIt, class Size>
+    inline ForwardIt __uninitialized_default_construct_n(ForwardIt first, Size n, false_type) {
+        typedef typename iterator_traits<ForwardIt>::value_type value_type;
+        for (; n > 0; --n, ++first) {
+            ::new (static_cast<void*>(&*first)) value_type;
+        }
+        return first;
+    }
+
+    template <class ForwardIt, class Size>
+    inline ForwardIt uninitialized_default_construct_n(ForwardIt first, Size n) {
+        typedef typename iterator_traits<ForwardIt>::value_type value_type;
+        return __uninitialized_default_construct_n(first, n,
+            typename HxSTL::is_trivially_default_constructible<value_type>::type());
     }
 
     // uninitialized_fill
@@ -111,7 +228,7 @@ namespace HxSTL {
     inline void uninitialized_fill(ForwardIt first, ForwardIt last,
             const T& x) {
         typedef typename iterator_traits<ForwardIt>::value_type value_type;
-        __uninitialized_fill(first, last, x, typename is_pod<value_type>::type());
+        __uninitialized_fill(first, last, x, typename __is_bitwise_copy_constructible<value_type, value_type>::type());
     }
 
     template <class ForwardIt, class T>
@@ -124,7 +241,7 @@ namespace HxSTL {
     inline void __uninitialized_fill(ForwardIt first, ForwardIt last,
             const T& x, false_type) {
         while (first != last) {
-            construct(first, x);
+            construct(&*first, x);
             ++first;
         }
     }
@@ -134,7 +251,7 @@ namespace HxSTL {
     template <class ForwardIt, class Size, class T>
     inline ForwardIt uninitialized_fill_n(ForwardIt first, Size n, const T& x) {
         typedef typename iterator_traits<ForwardIt>::value_type value_type;
-        return __uninitialized_fill_n(first, n, x, typename is_pod<value_type>::type());
+        return __uninitialized_fill_n(first, n, x, typename __is_bitwise_copy_constructible<value_type, value_type>::type());
     }
 
     template <class ForwardIt, class Size, class T>
@@ -145,7 +262,7 @@ namespace HxSTL {
     template <class ForwardIt, class Size, class T>
     inline ForwardIt __uninitialized_fill_n(ForwardIt first, Size n, const T& x, false_type) {
         while (n > 0) {
-            construct(first, x);
+            construct(&*first, x);
             --n;
             ++first;
         }
@@ -84,6 +84,9 @@ namespace HxSTL {
         pointer operator->() const { return _ptr; }
     };
 
+    template <class T>
+    struct is_trivially_relocatable<unique_ptr<T, default_delete<T>>>: public true_type {};
+
     template <class T, class Deleter>
     class unique_ptr<T[], Deleter> {
     };
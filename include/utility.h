@@ -16,6 +16,16 @@ namespace HxSTL {
         return static_cast<typename remove_reference<T>::type&&>(t);
     }
 
+    // 移动构造可能抛出异常且可以拷贝时返回左值引用, 保证强异常安全
+    template <class T>
+    typename conditional<
+        !is_nothrow_move_constructible<T>::value && is_copy_constructible<T>::value,
+        const T&,
+        T&&
+    >::type move_if_noexcept(T& x) noexcept {
+        return HxSTL::move(x);
+    }
+
     template <class T>
     void swap(T& a, T& b) {
         T c(move(a));
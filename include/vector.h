@@ -3,13 +3,14 @@
 
 
 #include "allocator.h"
+#include "growth_policy.h"
 #include "uninitialized.h"
 #include "utility.h"
 
 
 namespace HxSTL {
 
-    template <class T, class Alloc = allocator<T>>
+    template <class T, class Alloc = allocator<T>, class Growth = double_growth>
     class vector {
     public:
         typedef T                                       value_type;
@@ -49,6 +50,16 @@ namespace HxSTL {
         void assign_aux(size_type count, const T& value, true_type);
         void resize_aux(size_type count, const T& value);
         void destroy_and_reset(iterator new_start, iterator new_finish, iterator new_end_of_storage);
+        void relocate_and_reset(iterator new_start, iterator new_finish, iterator new_end_of_storage);
+        size_type next_capacity(size_type count) const;
+        iterator allocate_aux(size_type& n) { return HxSTL::allocate_at_least(_alloc, n); }
+        // 元素可平凡重定位且分配器支持 reallocate 时, 扩容直接交给分配器
+        typedef integeral_constant<bool, HxSTL::is_trivially_relocatable<T>::value &&
+            HxSTL::__has_reallocate<Alloc>::value>                  __reallocatable;
+        bool can_reallocate() const { return __reallocatable::value && _start != nullptr; }
+        void reallocate_aux(size_type new_cap) { reallocate_aux(new_cap, __reallocatable()); }
+        void reallocate_aux(size_type new_cap, true_type);
+        void reallocate_aux(size_type, false_type) {}
     public:
         vector(): _start(nullptr), _finish(nullptr), _end_of_storage(nullptr), _alloc(Alloc()) {}
 
@@ -212,47 +223,59 @@ namespace HxSTL {
         void resize(size_type count) { resize_aux(count, T()); }
 
         void resize(size_type count, const T& value) { resize_aux(count, value); }
+
+        // 新元素只做默认初始化, 可平凡默认构造的元素 (int / char / POD 结构体) 不写内存, 留给调用者覆盖
+        void resize_default_init(size_type count);
+
+        // 大小先扩到 count, 调用 op(data(), count) 写入元素, 再截断为 op 的返回值
+        // 返回值不能超过 count, 调用者负责写好 [原大小, 返回值) 范围内的元素
+        template <class Operation>
+        void resize_and_overwrite(size_type count, Operation op);
         
         void swap(vector& other);
     };
 
-    template<class T, class Alloc>
-    void swap(vector<T, Alloc>& x, vector<T, Alloc>& y) {
+    // 只持有指向堆上存储的指针, 可以按字节搬移
+    template <class T, class Growth>
+    struct is_trivially_relocatable<vector<T, allocator<T>, Growth>>: public true_type {};
+
+    template<class T, class Alloc, class Growth>
+    void swap(vector<T, Alloc, Growth>& x, vector<T, Alloc, Growth>& y) {
         x.swap(y);
     }
 
-    template <class T, class Alloc>
+    template <class T, class Alloc, class Growth>
     template <class InputIt>
-    void vector<T, Alloc>::initialize_aux(InputIt first, InputIt last, false_type) {
+    void vector<T, Alloc, Growth>::initialize_aux(InputIt first, InputIt last, false_type) {
         _start = _alloc.allocate(HxSTL::distance(first, last));
         _finish = HxSTL::uninitialized_copy(first, last, _start);
         _end_of_storage = _finish;
     }
 
-    template <class T, class Alloc>
-    void vector<T, Alloc>::initialize_aux(size_type count, const T& value, true_type) {
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::initialize_aux(size_type count, const T& value, true_type) {
         _start = _alloc.allocate(count);
         _finish = HxSTL::uninitialized_fill_n(_start, count, value);
         _end_of_storage = _finish;
     }
 
-    template <class T, class Alloc>
-    void vector<T, Alloc>::initialize_aux(const vector& other) {
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::initialize_aux(const vector& other) {
         _start = _alloc.allocate(other.size());
         _finish = HxSTL::uninitialized_copy(other.begin(), other.end(), _start);
         _end_of_storage = _finish;
     }
     
-    template <class T, class Alloc>
-    void vector<T, Alloc>::initialize_aux(vector&& other) {
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::initialize_aux(vector&& other) {
         _start = other._start;
         _finish = other._finish;
         _end_of_storage = other._end_of_storage;
         other._start = other._finish = other._end_of_storage = nullptr;
     }
 
-    template <class T, class Alloc>
-    void vector<T, Alloc>::resize_aux(size_type count, const T& value) {
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::resize_aux(size_type count, const T& value) {
         if (count <= size()) {
             // 删除多余元素
             HxSTL::destroy(_alloc, _start + count, _finish);
@@ -260,38 +283,68 @@ namespace HxSTL {
         } else if (count <= capacity()) {
             // 填充元素
             _finish = uninitialized_fill_n(_finish, count - size(), value);
+        } else if (can_reallocate()) {
+            // value 可能引用现有元素, 先取出
+            T tmp(value);
+            reallocate_aux(count);
+            _finish = uninitialized_fill_n(_finish, count - size(), tmp);
         } else {
-            iterator new_start = _alloc.allocate(count);
+            size_type new_cap = count;
+            iterator new_start = allocate_aux(new_cap);
             iterator new_finish = new_start;
-            new_finish = uninitialized_copy(_start, _finish, new_start);
+            new_finish = HxSTL::uninitialized_relocate(_start, _finish, new_start);
             new_finish = uninitialized_fill_n(new_finish, count - size(), value);
-            destroy_and_reset(new_start, new_finish, new_finish);
+            relocate_and_reset(new_start, new_finish, new_start + new_cap);
         }
     }
 
-    template <class T, class Alloc>
-    void vector<T, Alloc>::reserve(size_type new_cap) {
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::resize_default_init(size_type count) {
+        if (count <= size()) {
+            HxSTL::destroy(_alloc, _start + count, _finish);
+            _finish = _start + count;
+        } else {
+            if (count > capacity()) reserve(next_capacity(count));
+            _finish = HxSTL::uninitialized_default_construct_n(_finish, count - size());
+        }
+    }
+
+    template <class T, class Alloc, class Growth>
+    template <class Operation>
+    void vector<T, Alloc, Growth>::resize_and_overwrite(size_type count, Operation op) {
+        resize_default_init(count);
+        size_type n = op(_start, count);
+        if (n > count) throw HxSTL::length_error();
+        resize_default_init(n);
+    }
+
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::reserve(size_type new_cap) {
         if (new_cap > max_size()) {
             throw HxSTL::length_error();
         } else if (new_cap > capacity()) {
-            iterator new_start = _alloc.allocate(new_cap);
-            iterator new_finish = HxSTL::uninitialized_copy(_start, _finish, new_start);
-            destroy_and_reset(new_start, new_finish, new_start + new_cap);
+            if (can_reallocate()) {
+                reallocate_aux(new_cap);
+                return;
+            }
+            iterator new_start = allocate_aux(new_cap);
+            iterator new_finish = HxSTL::uninitialized_relocate(_start, _finish, new_start);
+            relocate_and_reset(new_start, new_finish, new_start + new_cap);
         }
     }
 
-    template <class T, class Alloc>
-    void vector<T, Alloc>::shrink_to_fit() {
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::shrink_to_fit() {
         if (_end_of_storage != _finish) {
             iterator new_start = _alloc.allocate(size());
-            iterator new_finish = HxSTL::uninitialized_copy(_start, _finish, new_start);
-            destroy_and_reset(new_start, new_finish, new_start + size());
+            iterator new_finish = HxSTL::uninitialized_relocate(_start, _finish, new_start);
+            relocate_and_reset(new_start, new_finish, new_start + size());
         }
     }
 
-    template <class T, class Alloc>
+    template <class T, class Alloc, class Growth>
     template <class InputIt>
-    void vector<T, Alloc>::assign_aux(InputIt first, InputIt last, false_type) {
+    void vector<T, Alloc, Growth>::assign_aux(InputIt first, InputIt last, false_type) {
         size_type count = HxSTL::distance(first, last);
         if (count <= size()) {
             // 拷贝并删除多余元素
@@ -311,8 +364,8 @@ namespace HxSTL {
         }
     }
 
-    template <class T, class Alloc>
-    void vector<T, Alloc>::assign_aux(size_type count, const value_type& value, true_type) {
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::assign_aux(size_type count, const value_type& value, true_type) {
         if (count <= size()) {
             // 填充并删除多余元素
             iterator old_finish = _finish;
@@ -330,39 +383,17 @@ namespace HxSTL {
         }
     }
 
-    template <class T, class Alloc>
+    template <class T, class Alloc, class Growth>
     template <class U>
-    typename vector<T, Alloc>::iterator 
-    vector<T, Alloc>::insert_aux(iterator pos, U&& value) {
-        if (_finish != _end_of_storage) {
-            // 预留空间足够
-            if (pos == _finish) {
-                // 末尾插入
-                _alloc.construct(_finish, HxSTL::forward<U>(value));
-            } else {
-                // 非末尾插入
-                _alloc.construct(_finish, back());
-                HxSTL::copy_backward(pos, _finish - 1, _finish);
-                *pos = HxSTL::forward<U>(value);
-            }
-            ++_finish;
-            return pos;
-        } else {
-            size_type new_sz = size() ? 2 * size() : 1;
-            iterator new_start = _alloc.allocate(new_sz);
-            iterator new_finish = HxSTL::uninitialized_copy(_start, pos, new_start);
-            iterator result = new_finish;
-            _alloc.construct(new_finish++, HxSTL::forward<U>(value));
-            new_finish = HxSTL::uninitialized_copy(pos, _finish, new_finish);
-            destroy_and_reset(new_start, new_finish, new_start + new_sz);
-            return result;
-        }
+    typename vector<T, Alloc, Growth>::iterator 
+    vector<T, Alloc, Growth>::insert_aux(iterator pos, U&& value) {
+        return emplace_aux(pos, HxSTL::forward<U>(value));
     }
 
-    template <class T, class Alloc>
+    template <class T, class Alloc, class Growth>
     template <class... Args>
-    typename vector<T, Alloc>::iterator 
-    vector<T, Alloc>::emplace_aux(iterator pos, Args&&... args) {
+    typename vector<T, Alloc, Growth>::iterator 
+    vector<T, Alloc, Growth>::emplace_aux(iterator pos, Args&&... args) {
         if (_finish != _end_of_storage) {
             // 预留空间足够
             if (pos == _finish) {
@@ -370,29 +401,53 @@ namespace HxSTL {
                 _alloc.construct(_finish, HxSTL::forward<Args>(args)...);
             } else {
                 // 非末尾插入
-                _alloc.construct(_finish, back());
-                HxSTL::copy_backward(pos, _finish - 1, _finish);
-                _alloc.destroy(pos);
-                _alloc.construct(pos, HxSTL::forward<Args>(args)...);
+                if (HxSTL::is_trivially_relocatable<T>::value) {
+                    alignas(T) unsigned char buf[sizeof(T)];
+                    _alloc.construct(reinterpret_cast<T*>(buf), HxSTL::forward<Args>(args)...);
+                    HxSTL::__relocate_bytes(pos, _finish, pos + 1);
+                    HxSTL::__relocate_bytes(reinterpret_cast<T*>(buf), reinterpret_cast<T*>(buf) + 1, pos);
+                } else {
+                    T tmp(HxSTL::forward<Args>(args)...);
+                    _alloc.construct(_finish, HxSTL::move(back()));
+                    HxSTL::move_backward(pos, _finish - 1, _finish);
+                    *pos = HxSTL::move(tmp);
+                }
             }
             ++_finish;
             return pos;
+        } else if (pos == _finish && can_reallocate()) {
+            // 末尾追加时原地扩容, 参数可能引用现有元素, 新元素先构造在旁边
+            alignas(T) unsigned char buf[sizeof(T)];
+            _alloc.construct(reinterpret_cast<T*>(buf), HxSTL::forward<Args>(args)...);
+            try {
+                reallocate_aux(next_capacity(size() + 1));
+            } catch (...) {
+                _alloc.destroy(reinterpret_cast<T*>(buf));
+                throw;
+            }
+            _finish = HxSTL::__relocate_bytes(reinterpret_cast<T*>(buf), reinterpret_cast<T*>(buf) + 1, _finish);
+            return _finish - 1;
         } else {
-            size_type new_sz = size() ? 2 * size() : 1;
-            iterator new_start = _alloc.allocate(new_sz);
-            iterator new_finish = HxSTL::uninitialized_copy(_start, pos, new_start);
-            iterator result = new_finish;
-            _alloc.construct(new_finish++, HxSTL::forward<Args>(args)...);
-            new_finish = HxSTL::uninitialized_copy(pos, _finish, new_finish);
-            destroy_and_reset(new_start, new_finish, new_start + new_sz);
+            size_type new_sz = next_capacity(size() + 1);
+            iterator new_start = allocate_aux(new_sz);
+            iterator result = new_start + (pos - _start);
+            try {
+                _alloc.construct(result, HxSTL::forward<Args>(args)...);
+            } catch (...) {
+                _alloc.deallocate(new_start, new_sz);
+                throw;
+            }
+            HxSTL::uninitialized_relocate(_start, pos, new_start);
+            iterator new_finish = HxSTL::uninitialized_relocate(pos, _finish, result + 1);
+            relocate_and_reset(new_start, new_finish, new_start + new_sz);
             return result;
         }
     }
 
-    template <class T, class Alloc>
+    template <class T, class Alloc, class Growth>
     template <class InputIt>
-    typename vector<T, Alloc>::iterator 
-    vector<T, Alloc>::insert_aux(iterator pos, InputIt first, InputIt last, false_type) {
+    typename vector<T, Alloc, Growth>::iterator 
+    vector<T, Alloc, Growth>::insert_aux(iterator pos, InputIt first, InputIt last, false_type) {
         if (first == last) return pos;
 
         size_type count = HxSTL::distance(first, last);
@@ -413,21 +468,27 @@ namespace HxSTL {
                 HxSTL::copy(first, last, pos);
             }
             return pos;
+        } else if (pos == _finish && can_reallocate() && !HxSTL::__points_into(first, _start, _end_of_storage)) {
+            // 末尾追加且来源不在自身存储中, 原地扩容
+            reallocate_aux(next_capacity(size() + count));
+            iterator result = _finish;
+            _finish = HxSTL::uninitialized_copy(first, last, _finish);
+            return result;
         } else {
-            size_type new_sz = 2 * capacity() > size() + count ? 2 * capacity() : size() + count;
-            iterator new_start = _alloc.allocate(new_sz);
-            iterator new_finish = HxSTL::uninitialized_copy(_start, pos, new_start);
+            size_type new_sz = next_capacity(size() + count);
+            iterator new_start = allocate_aux(new_sz);
+            iterator new_finish = HxSTL::uninitialized_relocate(_start, pos, new_start);
             iterator result = new_finish;
             new_finish = HxSTL::uninitialized_copy(first, last, new_finish);
-            new_finish = HxSTL::uninitialized_copy(pos, _finish, new_finish);
-            destroy_and_reset(new_start, new_finish, new_start + new_sz);
+            new_finish = HxSTL::uninitialized_relocate(pos, _finish, new_finish);
+            relocate_and_reset(new_start, new_finish, new_start + new_sz);
             return result;
         }
     }
 
-    template <class T, class Alloc>
-    typename vector<T, Alloc>::iterator 
-    vector<T, Alloc>::insert_aux(iterator pos, size_type count, const value_type& value, HxSTL::true_type) {
+    template <class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::iterator 
+    vector<T, Alloc, Growth>::insert_aux(iterator pos, size_type count, const value_type& value, HxSTL::true_type) {
         if (count == 0) return pos;
 
         if (_end_of_storage - _finish >= count) {
@@ -446,42 +507,75 @@ namespace HxSTL {
                 HxSTL::fill_n(pos, count, value);
             }
             return pos;
+        } else if (pos == _finish && can_reallocate()) {
+            T tmp(value);
+            reallocate_aux(next_capacity(size() + count));
+            iterator result = _finish;
+            _finish = HxSTL::uninitialized_fill_n(_finish, count, tmp);
+            return result;
         } else {
-            size_type new_sz = 2 * capacity() > count + size() ? 2 * capacity(): count + size();
-            iterator new_start = _alloc.allocate(new_sz);
-            iterator new_finish = HxSTL::uninitialized_copy(_start, pos, new_start);
-            iterator result = new_finish;
-            new_finish = HxSTL::uninitialized_fill_n(new_finish, count, value);
-            new_finish = HxSTL::uninitialized_copy(pos, _finish, new_finish);
-            destroy_and_reset(new_start, new_finish, new_start + new_sz);
+            size_type new_sz = next_capacity(size() + count);
+            iterator new_start = allocate_aux(new_sz);
+            iterator result = new_start + (pos - _start);
+            HxSTL::uninitialized_fill_n(result, count, value);
+            HxSTL::uninitialized_relocate(_start, pos, new_start);
+            iterator new_finish = HxSTL::uninitialized_relocate(pos, _finish, result + count);
+            relocate_and_reset(new_start, new_finish, new_start + new_sz);
             return result;
         }
     }
 
-    template <class T, class Alloc>
-    typename vector<T, Alloc>::iterator vector<T, Alloc>::erase_aux(iterator pos) {
-        _finish = HxSTL::copy(pos + 1, _finish, pos);
-        _alloc.destroy(_finish);
+    template <class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::erase_aux(iterator pos) {
+        if (HxSTL::is_trivially_relocatable<T>::value) {
+            // 先析构被删除的元素, 后续元素按字节前移
+            _alloc.destroy(pos);
+            _finish = HxSTL::__relocate_bytes(pos + 1, _finish, pos);
+        } else {
+            _finish = HxSTL::move(pos + 1, _finish, pos);
+            _alloc.destroy(_finish);
+        }
         return pos;
     }
 
-    template <class T, class Alloc>
-    typename vector<T, Alloc>::iterator vector<T, Alloc>::erase_aux(iterator first, iterator last) {
-        iterator old_finish = _finish;
-        _finish = HxSTL::copy(last, _finish, first);
-        HxSTL::destroy(_alloc, _finish, old_finish);
+    template <class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::erase_aux(iterator first, iterator last) {
+        if (HxSTL::is_trivially_relocatable<T>::value) {
+            HxSTL::destroy(_alloc, first, last);
+            _finish = HxSTL::__relocate_bytes(last, _finish, first);
+        } else {
+            iterator old_finish = _finish;
+            _finish = HxSTL::move(last, _finish, first);
+            HxSTL::destroy(_alloc, _finish, old_finish);
+        }
         return first;
     }
 
-    template <class T, class Alloc>
-    void vector<T, Alloc>::swap(vector& other) {
+    template <class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::size_type 
+    vector<T, Alloc, Growth>::next_capacity(size_type count) const {
+        if (count > max_size()) throw HxSTL::length_error();
+        size_type new_cap = Growth::next(capacity(), count, sizeof(T));
+        return new_cap > max_size() ? max_size() : new_cap;
+    }
+
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::reallocate_aux(size_type new_cap, true_type) {
+        size_type sz = size();
+        _start = _alloc.reallocate(_start, capacity(), new_cap);
+        _finish = _start + sz;
+        _end_of_storage = _start + new_cap;
+    }
+
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::swap(vector& other) {
         HxSTL::swap(_start, other._start);
         HxSTL::swap(_finish, other._finish);
         HxSTL::swap(_end_of_storage, other._end_of_storage);
     }
 
-    template <class T, class Alloc>
-    void vector<T, Alloc>::destroy_and_reset(iterator new_start, 
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::destroy_and_reset(iterator new_start, 
             iterator new_finish, iterator new_end_of_storage) {
         if (_start) {
             HxSTL::destroy(_alloc, _start, _finish);
@@ -493,34 +587,48 @@ namespace HxSTL {
         _end_of_storage = new_end_of_storage;
     }
 
-    template<class U, class A>
-    bool operator==(const vector<U, A>& lhs, const vector<U, A>& rhs) {
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::relocate_and_reset(iterator new_start, 
+            iterator new_finish, iterator new_end_of_storage) {
+        // 元素已由 uninitialized_relocate 搬走, 按字节搬移的旧元素不能再析构
+        if (_start) {
+            if (!HxSTL::is_trivially_relocatable<T>::value) HxSTL::destroy(_alloc, _start, _finish);
+            _alloc.deallocate(_start, capacity());
+        }
+
+        _start = new_start;
+        _finish = new_finish;
+        _end_of_storage = new_end_of_storage;
+    }
+
+    template<class U, class A, class G>
+    bool operator==(const vector<U, A, G>& lhs, const vector<U, A, G>& rhs) {
         return lhs.size() == rhs.size() && HxSTL::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
-    template<class U, class A>
-    bool operator!=(const vector<U, A>& lhs, const vector<U, A>& rhs) {
+    template<class U, class A, class G>
+    bool operator!=(const vector<U, A, G>& lhs, const vector<U, A, G>& rhs) {
         return !(lhs == rhs);
     }
     
-    template<class U, class A>
-    bool operator< (const vector<U, A>& lhs, const vector<U, A>& rhs) {
-        // Todo
+    template<class U, class A, class G>
+    bool operator< (const vector<U, A, G>& lhs, const vector<U, A, G>& rhs) {
+        return HxSTL::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
-    template<class U, class A>
-    bool operator<=(const vector<U, A>& lhs, const vector<U, A>& rhs) {
-        return !(lhs < rhs);
+    template<class U, class A, class G>
+    bool operator<=(const vector<U, A, G>& lhs, const vector<U, A, G>& rhs) {
+        return !(rhs < lhs);
     }
 
-    template<class U, class A>
-    bool operator> (const vector<U, A>& lhs, const vector<U, A>& rhs) {
+    template<class U, class A, class G>
+    bool operator> (const vector<U, A, G>& lhs, const vector<U, A, G>& rhs) {
         return rhs < lhs;
     }
 
-    template<class U, class A>
-    bool operator>=(const vector<U, A>& lhs, const vector<U, A>& rhs) {
-        return !(rhs < lhs);
+    template<class U, class A, class G>
+    bool operator>=(const vector<U, A, G>& lhs, const vector<U, A, G>& rhs) {
+        return !(lhs < rhs);
     }
 
 }
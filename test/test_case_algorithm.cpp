@@ -0,0 +1,435 @@
+#include <cstdio>
+#include <cassert>
+#include <stdint.h>
+#include "vector.h"
+#include "deque.h"
+#include "list.h"
+#include "basic_string.h"
+#include "functional.h"
+
+typedef HxSTL::basic_string<char> string;
+
+struct record {
+    int key;
+    int order;
+};
+
+struct key_less {
+    bool operator()(const record& x, const record& y) const { return x.key < y.key; }
+};
+
+struct record_less {
+    bool operator()(const record& x, const record& y) const {
+        return x.key < y.key || (x.key == y.key && x.order < y.order);
+    }
+};
+
+struct key_even {
+    bool operator()(const record& r) const { return r.key % 2 == 0; }
+};
+
+uint64_t next_random(uint64_t& seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+HxSTL::vector<record> make_records(uint64_t& seed, int n, int keys) {
+    HxSTL::vector<record> v;
+    for (int i = 0; i < n; ++i) {
+        record r = { static_cast<int>(next_random(seed) % keys), i };
+        v.push_back(r);
+    }
+    return v;
+}
+
+// 按 key 排序后相等的 key 保持原先的 order 顺序
+bool is_stably_sorted(const HxSTL::vector<record>& v) {
+    for (size_t i = 1; i < v.size(); ++i) {
+        if (!record_less()(v[i - 1], v[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+
+    uint64_t seed = 88172645463325252ull;
+
+    { // rotate
+        for (int n = 0; n < 40; ++n) {
+            for (int k = 0; k <= n; ++k) {
+                HxSTL::vector<int> v;
+                for (int i = 0; i < n; ++i) {
+                    v.push_back(i);
+                }
+                HxSTL::rotate(v.begin(), v.begin() + k, v.end());
+                for (int i = 0; i < n; ++i) {
+                    assert(v[i] == (i + k) % n);
+                }
+            }
+        }
+    }
+
+    { // lower_bound upper_bound equal_range binary_search
+        for (int n = 0; n < 70; ++n) {
+            HxSTL::vector<int> v1;
+            for (int i = 0; i < n; ++i) {
+                v1.push_back(i / 3 * 2);        // 每个偶数出现三次
+            }
+            for (int x = -1; x <= n; ++x) {
+                int lo = 0;
+                while (lo < n && v1[lo] < x) {
+                    ++lo;
+                }
+                int hi = lo;
+                while (hi < n && v1[hi] == x) {
+                    ++hi;
+                }
+                assert(HxSTL::lower_bound(v1.begin(), v1.end(), x) - v1.begin() == lo);
+                assert(HxSTL::upper_bound(v1.begin(), v1.end(), x) - v1.begin() == hi);
+                HxSTL::pair<int*, int*> range = HxSTL::equal_range(v1.begin(), v1.end(), x);
+                assert(range.first - v1.begin() == lo && range.second - v1.begin() == hi);
+                assert(HxSTL::binary_search(v1.begin(), v1.end(), x) == (lo != hi));
+            }
+        }
+
+        // 非指针的随机访问迭代器与双向迭代器
+        HxSTL::deque<int> d1;
+        HxSTL::list<int> l1;
+        for (int i = 0; i < 1000; ++i) {
+            d1.push_back(i * 2);
+            l1.push_back(i * 2);
+        }
+        assert(HxSTL::lower_bound(d1.begin(), d1.end(), 501) - d1.begin() == 251);
+        assert(*HxSTL::upper_bound(d1.begin(), d1.end(), 500) == 502);
+        assert(*HxSTL::lower_bound(l1.begin(), l1.end(), 501) == 502);
+        assert(HxSTL::binary_search(l1.begin(), l1.end(), 1998));
+        assert(!HxSTL::binary_search(l1.begin(), l1.end(), 1999));
+
+        // 降序与自定义比较
+        record r1[] = { { 9, 0 }, { 7, 1 }, { 7, 2 }, { 3, 3 } };
+        record key = { 7, 0 };
+        auto greater_key = [](const record& x, const record& y) { return x.key > y.key; };
+        HxSTL::pair<record*, record*> range = HxSTL::equal_range(r1, r1 + 4, key, greater_key);
+        assert(range.first == r1 + 1 && range.second == r1 + 3);
+    }
+
+    { // nth_element partial_sort partial_sort_copy
+        for (int n = 1; n < 300; n += 13) {
+            HxSTL::vector<int> v1;
+            for (int i = 0; i < n; ++i) {
+                v1.push_back(static_cast<int>(next_random(seed) % 50));
+            }
+            HxSTL::vector<int> v2(v1);
+            HxSTL::sort(v2.begin(), v2.end());
+            for (int k = 0; k < n; k += 5) {
+                HxSTL::vector<int> v3(v1);
+                HxSTL::nth_element(v3.begin(), v3.begin() + k, v3.end());
+                assert(v3[k] == v2[k]);
+                for (int i = 0; i < n; ++i) {
+                    assert(i < k ? v3[i] <= v3[k] : v3[i] >= v3[k]);
+                }
+            }
+        }
+
+        // 选择降序的第 k 个, 以及枢轴很差时退回堆选择
+        HxSTL::vector<int> v4;
+        for (int i = 0; i < 100000; ++i) {
+            v4.push_back(i % 2 == 0 ? i : 100000 - i);
+        }
+        HxSTL::nth_element(v4.begin(), v4.begin() + 10, v4.end(), [](int x, int y) { return x > y; });
+        assert(v4[10] == 99989);
+        HxSTL::vector<int> v5(v4);
+        HxSTL::__introselect(v5.begin(), v5.begin() + 500, v5.end(), 0, HxSTL::__iter_less());
+        assert(v5[500] == 500);
+
+        // 带比较函数的 partial_sort
+        HxSTL::vector<int> v6(v4);
+        HxSTL::partial_sort(v6.begin(), v6.begin() + 5, v6.end(), [](int x, int y) { return x > y; });
+        assert(v6[0] == 99999 && v6[1] == 99998 && v6[4] == 99995);
+
+        int a1[] = { 5, 1, 4, 2, 3 };
+        int a2[3];
+        assert(HxSTL::partial_sort_copy(a1, a1 + 5, a2, a2 + 3) == a2 + 3);
+        assert(a2[0] == 1 && a2[1] == 2 && a2[2] == 3);
+        int a3[8];
+        HxSTL::list<int> l1(a1, a1 + 5);
+        assert(HxSTL::partial_sort_copy(l1.begin(), l1.end(), a3, a3 + 8, [](int x, int y) { return x > y; }) == a3 + 5);
+        assert(a3[0] == 5 && a3[4] == 1);
+        assert(HxSTL::partial_sort_copy(a1, a1 + 5, a3, a3) == a3);
+        HxSTL::vector<int> v7;
+        assert(HxSTL::partial_sort_copy(a1, a1 + 5, v7.begin(), v7.end()) == v7.end());
+    }
+
+    { // merge
+        int a1[] = { 1, 3, 5, 7 };
+        int a2[] = { 2, 3, 4, 8, 9 };
+        int a3[9];
+        assert(HxSTL::merge(a1, a1 + 4, a2, a2 + 5, a3) == a3 + 9);
+        int e1[] = { 1, 2, 3, 3, 4, 5, 7, 8, 9 };
+        assert(HxSTL::equal(a3, a3 + 9, e1));
+
+        // 相等时第一个区间的元素在前
+        record r1[] = { { 1, 0 }, { 2, 1 }, { 2, 2 } };
+        record r2[] = { { 1, 3 }, { 2, 4 } };
+        HxSTL::vector<record> v1(5);
+        HxSTL::merge(r1, r1 + 3, r2, r2 + 2, v1.begin(), key_less());
+        assert(is_stably_sorted(v1));
+
+        HxSTL::list<int> l1(4, 0);
+        HxSTL::merge(a1, a1 + 4, a2, a2, l1.begin());
+        assert(l1.front() == 1 && l1.back() == 7);
+    }
+
+    { // inplace_merge
+        for (int n = 0; n < 60; ++n) {
+            for (int m = 0; m <= n; m += 3) {
+                HxSTL::vector<record> v1 = make_records(seed, n, 5);
+                HxSTL::sort(v1.begin(), v1.begin() + m, record_less());
+                HxSTL::sort(v1.begin() + m, v1.end(), record_less());
+                HxSTL::vector<record> v2(v1);
+                HxSTL::inplace_merge(v1.begin(), v1.begin() + m, v1.end(), key_less());
+                assert(is_stably_sorted(v1));
+
+                // 没有缓冲区时的原地归并
+                HxSTL::__merge_adaptive(v2.begin(), v2.begin() + m, v2.end(), static_cast<ptrdiff_t>(m),
+                    static_cast<ptrdiff_t>(n - m), static_cast<record*>(nullptr), static_cast<ptrdiff_t>(0), key_less());
+                assert(is_stably_sorted(v2));
+            }
+        }
+
+        HxSTL::list<int> l1;
+        int a1[] = { 2, 4, 6, 1, 3, 5, 7 };
+        for (int i = 0; i < 7; ++i) {
+            l1.push_back(a1[i]);
+        }
+        HxSTL::list<int>::iterator it = l1.begin();
+        HxSTL::advance(it, 3);
+        HxSTL::inplace_merge(l1.begin(), it, l1.end());
+        assert(HxSTL::is_sorted(l1.begin(), l1.end()));
+
+        HxSTL::vector<string> v3;
+        v3.push_back("b");
+        v3.push_back("d");
+        v3.push_back("a");
+        v3.push_back("c");
+        HxSTL::inplace_merge(v3.begin(), v3.begin() + 2, v3.end());
+        assert(v3[0] == string("a") && v3[1] == string("b") && v3[3] == string("d"));
+    }
+
+    { // sort
+
+        { // 各种输入模式, 以 stable_sort 的结果为准
+            const int sizes[] = { 0, 1, 2, 5, 23, 24, 25, 100, 127, 128, 129, 1000, 20000 };
+            for (int s = 0; s < 13; ++s) {
+                int n = sizes[s];
+                for (int pattern = 0; pattern < 7; ++pattern) {
+                    HxSTL::vector<int> v1;
+                    for (int i = 0; i < n; ++i) {
+                        switch (pattern) {
+                            case 0: v1.push_back(static_cast<int>(next_random(seed) % 1000000)); break;
+                            case 1: v1.push_back(i); break;
+                            case 2: v1.push_back(n - i); break;
+                            case 3: v1.push_back(static_cast<int>(next_random(seed) % 4)); break;
+                            case 4: v1.push_back(i < n / 2 ? i : n - i); break;
+                            case 5: v1.push_back(i % 100 == 99 ? static_cast<int>(next_random(seed) % n) : i); break;
+                            default: v1.push_back(7); break;
+                        }
+                    }
+                    HxSTL::vector<int> v2 = v1;
+                    HxSTL::sort(v1.begin(), v1.end());
+                    HxSTL::stable_sort(v2.begin(), v2.end());
+                    assert(v1 == v2);
+
+                    HxSTL::sort(v2.begin(), v2.end(), HxSTL::greater<int>());
+                    for (int i = 0; i < n; ++i) {
+                        assert(v2[i] == v1[n - 1 - i]);
+                    }
+                }
+            }
+        }
+
+        { // 非算术类型与自定义比较走普通划分
+            HxSTL::vector<record> v1 = make_records(seed, 5000, 50);
+            HxSTL::sort(v1.begin(), v1.end(), record_less());
+            assert(is_stably_sorted(v1));
+
+            HxSTL::vector<string> v2;
+            for (int i = 0; i < 3000; ++i) {
+                string s;
+                for (int k = next_random(seed) % 6; k > 0; --k) {
+                    s += static_cast<char>('a' + next_random(seed) % 4);
+                }
+                v2.push_back(s);
+            }
+            HxSTL::vector<string> v3 = v2;
+            HxSTL::sort(v2.begin(), v2.end());
+            HxSTL::stable_sort(v3.begin(), v3.end());
+            assert(v2 == v3);
+
+            HxSTL::deque<double> d1;
+            for (int i = 0; i < 4000; ++i) {
+                d1.push_back(static_cast<double>(next_random(seed) % 1000) / 3.0);
+            }
+            HxSTL::sort(d1.begin(), d1.end());
+            assert(HxSTL::is_sorted(d1.begin(), d1.end()));
+        }
+
+        { // 比较次数保持 O(nlogn): 重复元素, 有序与逆序输入都很快结束
+            int n = 1 << 16;
+            long long count = 0;
+            auto counting_less = [&count](int x, int y) { ++count; return x < y; };
+            const int patterns = 4;
+            for (int pattern = 0; pattern < patterns; ++pattern) {
+                HxSTL::vector<int> v1;
+                for (int i = 0; i < n; ++i) {
+                    v1.push_back(pattern == 0 ? i : pattern == 1 ? n - i : pattern == 2 ? i % 3 
+                        : static_cast<int>(next_random(seed)));
+                }
+                count = 0;
+                HxSTL::sort(v1.begin(), v1.end(), counting_less);
+                assert(HxSTL::is_sorted(v1.begin(), v1.end()));
+                assert(count <= 2LL * n * 16);
+                if (pattern < 3) {
+                    assert(count <= 4LL * n);
+                }
+            }
+        }
+    }
+
+    { // stable_sort
+
+        { // 随机数据, 少量不同的 key
+            for (int n = 0; n < 300; n += 7) {
+                HxSTL::vector<record> v1 = make_records(seed, n, 10);
+                HxSTL::stable_sort(v1.begin(), v1.end(), key_less());
+                assert(is_stably_sorted(v1));
+            }
+            HxSTL::vector<record> v2 = make_records(seed, 100000, 1000);
+            HxSTL::stable_sort(v2.begin(), v2.end(), key_less());
+            assert(is_stably_sorted(v2));
+        }
+
+        { // 部分有序: 升序, 降序, 锯齿, 有序后追加随机尾部
+            HxSTL::vector<record> v1 = make_records(seed, 50000, 100000);
+            HxSTL::sort(v1.begin(), v1.end(), record_less());
+            for (int i = 0; i < 50; ++i) {
+                HxSTL::iter_swap(v1.begin() + next_random(seed) % 50000, v1.begin() + next_random(seed) % 50000);
+            }
+            for (size_t i = 0; i < v1.size(); ++i) {
+                v1[i].order = static_cast<int>(i);
+            }
+            HxSTL::stable_sort(v1.begin(), v1.end(), key_less());
+            assert(is_stably_sorted(v1));
+
+            HxSTL::vector<record> v2;
+            for (int i = 0; i < 20000; ++i) {
+                record r = { (20000 - i) / 3, i };     // 降序段里相等的 key 不能被翻转
+                v2.push_back(r);
+            }
+            HxSTL::stable_sort(v2.begin(), v2.end(), key_less());
+            assert(is_stably_sorted(v2));
+
+            HxSTL::vector<record> v3;
+            for (int i = 0; i < 30000; ++i) {
+                record r = { i % 1000, i };
+                v3.push_back(r);
+            }
+            HxSTL::vector<record> v4 = make_records(seed, 777, 1000);
+            for (size_t i = 0; i < v4.size(); ++i) {
+                v4[i].order += 30000;
+                v3.push_back(v4[i]);
+            }
+            HxSTL::stable_sort(v3.begin(), v3.end(), key_less());
+            assert(is_stably_sorted(v3));
+        }
+
+        { // 没有缓冲区
+            HxSTL::vector<record> v1 = make_records(seed, 5000, 50);
+            HxSTL::__stable_sort_adaptive(v1.begin(), v1.end(), static_cast<record*>(nullptr),
+                static_cast<ptrdiff_t>(0), key_less());
+            assert(is_stably_sorted(v1));
+        }
+
+        { // 默认比较, 非平凡类型, deque
+            HxSTL::vector<int> v1;
+            for (int i = 0; i < 10000; ++i) {
+                v1.push_back(static_cast<int>(next_random(seed) % 100));
+            }
+            HxSTL::vector<int> v2(v1);
+            HxSTL::stable_sort(v1.begin(), v1.end());
+            HxSTL::sort(v2.begin(), v2.end());
+            assert(v1 == v2);
+
+            HxSTL::vector<string> v3;
+            for (int i = 0; i < 5000; ++i) {
+                string s;
+                for (int k = next_random(seed) % 4; k > 0; --k) {
+                    s += static_cast<char>('a' + next_random(seed) % 3);
+                }
+                v3.push_back(s);
+            }
+            HxSTL::vector<string> v4(v3);
+            HxSTL::stable_sort(v3.begin(), v3.end());
+            HxSTL::sort(v4.begin(), v4.end());
+            assert(v3 == v4);
+
+            HxSTL::deque<int> d1(v2.begin(), v2.end());
+            HxSTL::reverse(d1.begin(), d1.end());
+            HxSTL::stable_sort(d1.begin(), d1.end());
+            assert(HxSTL::equal(d1.begin(), d1.end(), v2.begin()));
+        }
+    }
+
+    { // stable_partition
+        record a1[] = { { 1, 0 } };
+        assert(HxSTL::stable_partition(a1, a1, key_even()) == a1);
+
+        for (int n = 0; n < 200; n += 9) {
+            HxSTL::vector<record> v1 = make_records(seed, n, 7);
+            HxSTL::vector<record> v2(v1);
+            HxSTL::vector<record>::iterator it = HxSTL::stable_partition(v1.begin(), v1.end(), key_even());
+            assert(HxSTL::all_of(v1.begin(), it, key_even()));
+            assert(HxSTL::none_of(it, v1.end(), key_even()));
+            for (HxSTL::vector<record>::iterator p = v1.begin() + 1; p < v1.end(); ++p) {
+                assert(p == it || p[-1].order < p[0].order);
+            }
+
+            // 没有缓冲区时对半递归
+            HxSTL::vector<record>::iterator first = HxSTL::find_if_not(v2.begin(), v2.end(), key_even());
+            if (first != v2.end()) {
+                HxSTL::vector<record>::iterator mid = HxSTL::__stable_partition_adaptive(first, v2.end(), key_even(),
+                    static_cast<ptrdiff_t>(v2.end() - first), static_cast<record*>(nullptr), static_cast<ptrdiff_t>(0));
+                assert(mid - v2.begin() == it - v1.begin());
+                for (size_t i = 0; i < v1.size(); ++i) {
+                    assert(v1[i].order == v2[i].order);
+                }
+            }
+        }
+
+        HxSTL::vector<int> v3(100, 2);
+        assert(HxSTL::stable_partition(v3.begin(), v3.end(), [](int x) { return x == 2; }) == v3.end());
+        assert(HxSTL::stable_partition(v3.begin(), v3.end(), [](int x) { return x != 2; }) == v3.begin());
+
+        HxSTL::list<string> l1;
+        const char* words[] = { "a", "bb", "c", "dd", "ee", "f" };
+        for (int i = 0; i < 6; ++i) {
+            l1.push_back(words[i]);
+        }
+        HxSTL::list<string>::iterator it = HxSTL::stable_partition(l1.begin(), l1.end(),
+            [](const string& s) { return s.size() == 1; });
+        const char* expected[] = { "a", "c", "f", "bb", "dd", "ee" };
+        int i = 0;
+        for (HxSTL::list<string>::iterator p = l1.begin(); p != l1.end(); ++p, ++i) {
+            assert(*p == string(expected[i]));
+        }
+        assert(*it == string("bb"));
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
@@ -1,6 +1,7 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 #include "basic_string.h"
+#include "malloc_allocator.h"
 
 TEST_CASE("basic_string_default_constructor") {
 
@@ -928,3 +929,78 @@ TEST_CASE("basic_string_member_compare_1") {
 
 TEST_CASE("basic_string_member_compare_2") {
 }
+
+TEST_CASE("basic_string_growth_policy") {
+
+    HxSTL::basic_string<char, HxSTL::allocator<char>, HxSTL::golden_growth> s1;
+
+    s1.reserve(16);
+    REQUIRE(s1.capacity() == 22);
+
+    s1.append(30, 'a');
+    REQUIRE(s1.size() == 30);
+    REQUIRE(s1.capacity() == 33);
+
+}
+
+TEST_CASE("basic_string_reallocate") {
+
+    typedef HxSTL::basic_string<char, HxSTL::malloc_allocator<char>> string;
+
+    string s1("abc");
+
+    for (int i = 0; i != 1000; ++i) {
+        s1.append(10, 'x');
+        s1.append("0123456789");
+    }
+    s1.append(s1.begin(), s1.begin() + 3);
+
+    REQUIRE(s1.size() == 20006);
+    REQUIRE(s1.capacity() >= 20006);
+    REQUIRE(s1.compare(0, 13, string("abcxxxxxxxxxx")) == 0);
+    REQUIRE(s1.compare(20003, 3, string("abc")) == 0);
+    REQUIRE(s1.c_str()[20006] == 0);
+
+}
+
+TEST_CASE("basic_string_member_resize") {
+
+    HxSTL::basic_string<char> s1("abc");
+
+    s1.resize(5, 'x');
+    REQUIRE(s1.compare("abcxx") == 0);
+
+    s1.resize(2);
+    REQUIRE(s1.compare("ab") == 0);
+    REQUIRE(s1.c_str()[2] == 0);
+
+    s1.resize(20);
+    REQUIRE(s1.size() == 20);
+    REQUIRE(s1[19] == 0);
+
+}
+
+TEST_CASE("basic_string_member_resize_and_overwrite") {
+
+    HxSTL::basic_string<char> s1("abc");
+
+    s1.resize_default_init(64);
+    REQUIRE(s1.size() == 64);
+    REQUIRE(s1.capacity() >= 64);
+    REQUIRE(s1.c_str()[64] == 0);
+
+    s1.resize_and_overwrite(8, [] (char* p, size_t n) {
+        for (size_t i = 3; i != n; ++i) p[i] = '0' + i;
+        return n - 2;
+    });
+    REQUIRE(s1.compare("abc345") == 0);
+
+    bool except = false;
+    try {
+        s1.resize_and_overwrite(4, [] (char*, size_t n) { return n + 1; });
+    } catch (HxSTL::length_error) {
+        except = true;
+    }
+    REQUIRE(except);
+
+}
@@ -0,0 +1,226 @@
+#include <cstdio>
+#include <cassert>
+#include "circular_buffer.h"
+#include "basic_string.h"
+#include "queue.h"
+#include "stack.h"
+
+typedef HxSTL::basic_string<char> string;
+
+// 每个实例带编号, 按编号统计未归还的堆块, 堆块必须还给申请它的分配器
+int blocks[3];
+
+template <class T>
+struct tagged_allocator: public HxSTL::allocator<T> {
+    int id;
+
+    template <class U>
+    struct rebind {
+        typedef tagged_allocator<U> other;
+    };
+
+    explicit tagged_allocator(int i = 0): id(i) {}
+
+    template <class U>
+    tagged_allocator(const tagged_allocator<U>& other): id(other.id) {}
+
+    T* allocate(size_t n) {
+        ++blocks[id];
+        return HxSTL::allocator<T>::allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        assert(blocks[id] > 0);
+        --blocks[id];
+        HxSTL::allocator<T>::deallocate(p, n);
+    }
+};
+
+int main() {
+
+    { // member
+
+        { // constructor
+
+            HxSTL::circular_buffer<int> c1;
+            HxSTL::circular_buffer<int> c2(5);
+            HxSTL::circular_buffer<int> c3({ 1, 2, 3 });
+            HxSTL::circular_buffer<int> c4(c3);
+
+            assert(c1.empty() && c1.capacity() == 0);
+            assert(c2.empty() && c2.capacity() == 8);
+            assert(c3.size() == 3 && c3.capacity() == 4 && c3[2] == 3);
+            assert(c4 == c3);
+
+            HxSTL::circular_buffer<int> c5(HxSTL::move(c4));
+            assert(c4.empty() && c4.capacity() == 0);
+            assert(c5 == c3);
+
+            c1 = c5;
+            assert(c1 == c3);
+
+            c2 = HxSTL::move(c1);
+            assert(c2 == c3 && c1.empty());
+
+        }
+
+        { // push pop wraparound
+
+            HxSTL::circular_buffer<int> c1(4);
+
+            for (int i = 0; i != 100; ++i) {
+                c1.push_back(i);
+                c1.push_back(i + 1);
+                assert(c1.front() == i && c1.back() == i + 1);
+                c1.pop_front();
+                c1.pop_front();
+            }
+            assert(c1.empty());
+
+            c1.push_back(1);
+            c1.push_front(0);
+            c1.emplace_back(2);
+            c1.emplace_front(-1);
+            assert(c1.full());
+            assert(c1[0] == -1 && c1[1] == 0 && c1[2] == 1 && c1[3] == 2);
+
+            bool except = false;
+            try {
+                c1.push_back(3);
+            } catch (HxSTL::length_error) {
+                except = true;
+            }
+            assert(except && c1.size() == 4);
+
+            except = false;
+            try {
+                c1.at(4);
+            } catch (HxSTL::out_of_range) {
+                except = true;
+            }
+            assert(except);
+
+            c1.pop_back();
+            assert(c1.back() == 1 && c1.size() == 3);
+
+        }
+
+        { // overwrite
+
+            HxSTL::circular_buffer<string> c1(3, HxSTL::overflow_overwrite);
+
+            c1.push_back("a");
+            c1.push_back("b");
+            c1.push_back("c");
+            c1.push_back("d");
+            c1.push_back("e");
+            assert(c1.size() == 4 && c1.front() == string("b") && c1.back() == string("e"));
+
+            // 引用即将被覆盖的元素
+            c1.push_back(c1.front());
+            assert(c1.front() == string("c") && c1.back() == string("b"));
+
+            c1.push_front("x");
+            assert(c1.front() == string("x") && c1.back() == string("e"));
+
+        }
+
+        { // iterator
+
+            HxSTL::circular_buffer<int> c1(8);
+
+            for (int i = 0; i != 6; ++i) {
+                c1.push_back(i);
+            }
+            for (int i = 6; i != 11; ++i) {
+                c1.pop_front();
+                c1.push_back(i);
+            }
+
+            // 元素跨越缓冲区末尾
+            HxSTL::circular_buffer<int>::iterator it = c1.begin();
+            assert(c1.end() - c1.begin() == 6);
+            assert(*it == 5 && it[5] == 10 && *(it + 3) == 8);
+            assert(it < c1.end() && c1.end() > it && it + 6 == c1.end());
+
+            int expect = 5;
+            for (HxSTL::circular_buffer<int>::const_iterator cit = c1.cbegin(); cit != c1.cend(); ++cit) {
+                assert(*cit == expect++);
+            }
+            assert(*c1.rbegin() == 10 && *(c1.rend() - 1) == 5);
+
+            *it = 50;
+            assert(c1.front() == 50);
+
+        }
+
+        { // reserve
+
+            HxSTL::circular_buffer<string> c1(4);
+
+            c1.push_back("c");
+            c1.push_back("d");
+            c1.push_front("b");
+            c1.push_front("a");
+
+            c1.reserve(5);
+            assert(c1.capacity() == 8 && c1.size() == 4);
+            assert(c1[0] == string("a") && c1[3] == string("d"));
+
+            c1.push_back("e");
+            assert(c1.back() == string("e"));
+
+        }
+
+        { // swap
+
+            HxSTL::circular_buffer<int> c1({ 1, 2 });
+            HxSTL::circular_buffer<int> c2(16, HxSTL::overflow_overwrite);
+
+            HxSTL::swap(c1, c2);
+            assert(c1.empty() && c1.capacity() == 16 && c1.policy() == HxSTL::overflow_overwrite);
+            assert(c2.size() == 2 && c2[1] == 2);
+
+            // 分配器随存储一起交换和移动
+            {
+                typedef HxSTL::circular_buffer<int, tagged_allocator<int>> buffer;
+                buffer c3(4, HxSTL::overflow_throw, tagged_allocator<int>(1));
+                buffer c4(8, HxSTL::overflow_throw, tagged_allocator<int>(2));
+
+                c3.swap(c4);
+                assert(c3.get_allocator().id == 2 && c4.get_allocator().id == 1);
+
+                buffer c5(2, HxSTL::overflow_throw, tagged_allocator<int>(1));
+                c5 = HxSTL::move(c3);
+                assert(c5.get_allocator().id == 2 && c5.capacity() == 8);
+                assert(blocks[1] == 1 && blocks[2] == 1);
+            }
+            assert(blocks[1] == 0 && blocks[2] == 0);
+
+        }
+
+    }
+
+    { // adaptor
+
+        HxSTL::quque<int, HxSTL::circular_buffer<int>> q1(HxSTL::circular_buffer<int>(16));
+
+        for (int i = 0; i != 1000; ++i) {
+            q1.push(i);
+            if (q1.size() == 10) q1.pop();
+        }
+        assert(q1.size() == 9 && q1.front() == 991 && q1.back() == 999);
+
+        HxSTL::stack<int, HxSTL::circular_buffer<int>> s1(HxSTL::circular_buffer<int>(4));
+
+        s1.push(1);
+        s1.push(2);
+        s1.pop();
+        assert(s1.top() == 1 && s1.size() == 1);
+
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
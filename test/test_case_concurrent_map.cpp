@@ -0,0 +1,232 @@
+#include <cstdio>
+#include <cassert>
+#include <thread>
+#include <atomic>
+#include "concurrent_map.h"
+#include "concurrent_set.h"
+
+std::atomic<long> live_nodes(0);
+
+// 统计尚未释放的节点个数
+template <class T>
+class counting_allocator: public HxSTL::allocator<T> {
+public:
+    template <class U>
+    struct rebind {
+        typedef counting_allocator<U> other;
+    };
+
+    counting_allocator() {}
+
+    template <class U>
+    counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(size_t n) {
+        live_nodes.fetch_add(1);
+        return HxSTL::allocator<T>::allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        live_nodes.fetch_sub(1);
+        HxSTL::allocator<T>::deallocate(p, n);
+    }
+};
+
+typedef HxSTL::concurrent_set<int, HxSTL::less<int>, counting_allocator<int>> counting_set;
+
+int main() {
+
+    { // member
+        { // constructor
+            HxSTL::pair<const int, int> a1[] = { HxSTL::make_pair(2, 3), HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 4) };
+            HxSTL::concurrent_map<int, int> s1(a1, a1 + 3);
+            HxSTL::concurrent_map<int, int> s2({ HxSTL::make_pair(1, 2) });
+            HxSTL::concurrent_map<int, int> s3;
+
+            assert(s1.size() == 2 && s1.at(2) == 3);
+            assert(s2.size() == 1);
+            assert(s3.empty() && s3.begin() == s3.end());
+        }
+
+        { // at
+            HxSTL::concurrent_map<int, int> s1({ HxSTL::make_pair(1, 2) });
+            bool thrown = false;
+
+            assert(s1.at(1) == 2);
+            try {
+                s1.at(2);
+            } catch (HxSTL::out_of_range&) {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+
+        { // insert emplace
+            HxSTL::concurrent_map<int, int> s1;
+
+            assert(s1.insert(HxSTL::make_pair(1, 2)).second);
+            assert(!s1.insert(HxSTL::make_pair(1, 3)).second);
+            auto it = s1.emplace(0, 3).first;
+            assert(it == s1.begin());
+            assert(s1.at(1) == 2);
+            assert(s1.size() == 2);
+        }
+
+        { // erase clear reclaim
+            HxSTL::concurrent_map<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 3) });
+
+            assert(s1.erase(1) == 1);
+            assert(s1.erase(1) == 0);
+            assert(s1.begin() -> first == 2);
+
+            s1.reclaim();
+            assert(s1.size() == 1);
+
+            s1.clear();
+            assert(s1.empty());
+            assert(s1.insert(HxSTL::make_pair(5, 6)).second);
+        }
+
+        { // find count bounds
+            HxSTL::concurrent_map<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(3, 4) });
+
+            assert(s1.find(1) -> second == 2);
+            assert(s1.find(2) == s1.end());
+            assert(s1.count(3) == 1 && s1.count(4) == 0);
+            assert(s1.lower_bound(2) -> first == 3);
+            assert(s1.upper_bound(1) -> first == 3);
+            assert(s1.upper_bound(3) == s1.end());
+            assert(s1.equal_range(1).first == s1.begin());
+        }
+
+        { // for_each_in_range
+            HxSTL::concurrent_set<int> s1;
+
+            for (int i = 0; i != 1000; ++i) {
+                s1.insert((i * 7) % 1000);
+            }
+
+            int next = 10;
+            s1.for_each_in_range(10, 500, [&next] (int x) { assert(x == next++); });
+            assert(next == 500);
+        }
+
+        { // concurrent insert erase
+            HxSTL::concurrent_set<int> s1;
+            std::thread workers[4];
+
+            // 每个线程插入自己的 10000 个键, 再删除其中的奇数键
+            for (int t = 0; t != 4; ++t) {
+                workers[t] = std::thread([&s1, t] () {
+                    for (int i = 0; i != 10000; ++i) {
+                        assert(s1.insert(i * 4 + t).second);
+                    }
+                    for (int i = 0; i != 10000; i += 2) {
+                        assert(s1.erase((i + 1) * 4 + t) == 1);
+                    }
+                });
+            }
+            for (int t = 0; t != 4; ++t) {
+                workers[t].join();
+            }
+
+            assert(s1.size() == 20000);
+            int i = 0;
+            for (auto it = s1.begin(); it != s1.end(); ++it, ++i) {
+                assert(*it == (i / 4) * 8 + i % 4);
+            }
+            assert(i == 20000);
+        }
+
+        { // reclamation under concurrent insert erase
+            counting_set s1;
+            std::thread workers[4];
+
+            // 反复插入删除同一批键, 已删除的节点应在使用过程中被回收
+            for (int t = 0; t != 4; ++t) {
+                workers[t] = std::thread([&s1, t] () {
+                    for (int i = 0; i != 100000; ++i) {
+                        int key = (i % 100) * 4 + t;
+                        assert(s1.insert(key).second);
+                        assert(s1.erase(key) == 1);
+                    }
+                });
+            }
+            for (int t = 0; t != 4; ++t) {
+                workers[t].join();
+            }
+
+            // 被挂起的线程会暂时阻止回收; 没有操作进行时, 后续的删除会释放掉积压的节点
+            for (int i = 0; i != 1000; ++i) {
+                s1.insert(i);
+                s1.erase(i);
+            }
+            assert(s1.empty());
+            assert(live_nodes < 1000);
+
+            s1.reclaim();
+            assert(live_nodes == 1);
+        }
+
+        { // guard
+            counting_set s1;
+
+            for (int i = 0; i != 1000; ++i) {
+                s1.insert(i);
+            }
+            long live = live_nodes;
+
+            {
+                counting_set::guard g = s1.pin();
+                counting_set::iterator it = s1.find(0);
+                for (int i = 0; i != 1000; ++i) {
+                    s1.erase(i);
+                }
+                // 持有 guard 期间已删除的节点不会被释放
+                assert(live_nodes == live && *it == 0);
+            }
+
+            for (int i = 1000; i != 2000; ++i) {
+                s1.insert(i);
+                s1.erase(i);
+            }
+            assert(live_nodes < live / 2);
+        }
+
+        { // nested guard
+            HxSTL::concurrent_map<int, int> s1;
+            std::atomic<int> pinned(0);
+            std::thread workers[64];
+
+            for (int i = 0; i != 100; ++i) {
+                s1.insert(HxSTL::make_pair(i, i));
+            }
+
+            // 纪元槽与线程一样多, 每个线程已持有 guard 时再调用各操作不能再占用新的槽
+            for (int t = 0; t != 64; ++t) {
+                workers[t] = std::thread([&s1, &pinned, t] () {
+                    HxSTL::concurrent_map<int, int>::guard g1 = s1.pin();
+                    ++pinned;
+                    while (pinned != 64) std::this_thread::yield();
+
+                    HxSTL::concurrent_map<int, int>::guard g2 = s1.pin();
+                    int sum = 0;
+                    s1.for_each_in_range(0, 10, [&sum] (const HxSTL::pair<const int, int>& p) { sum += p.second; });
+                    assert(sum == 45);
+                    assert(s1.find(t) -> second == t);
+                    assert(s1.insert(HxSTL::make_pair(100 + t, t)).second);
+                    assert(s1.erase(100 + t) == 1);
+                });
+            }
+            for (int t = 0; t != 64; ++t) {
+                workers[t].join();
+            }
+
+            assert(s1.size() == 100);
+        }
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
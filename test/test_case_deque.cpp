@@ -2,6 +2,33 @@
 #include <cassert>
 #include "deque.h"
 #include "list.h"
+#include "huge_page_allocator.h"
+#include "vector.h"
+#include "basic_string.h"
+
+template <class T>
+class counting_allocator: public HxSTL::allocator<T> {
+public:
+    template <class U>
+    struct rebind {
+        typedef counting_allocator<U> other;
+    };
+
+    static int allocations;
+public:
+    counting_allocator() {}
+
+    template <class U>
+    counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(size_t n) {
+        ++allocations;
+        return HxSTL::allocator<T>::allocate(n);
+    }
+};
+
+template <class T>
+int counting_allocator<T>::allocations = 0;
 
 int main() {
 
@@ -326,6 +353,132 @@ int main() {
 
             assert(d1 == HxSTL::deque<int>({ 0, 1 }));
         }
+
+        { // block size
+            HxSTL::deque<int, HxSTL::allocator<int>, 8> d1;
+
+            assert(HxSTL::deque<int>::iterator::buffer_size() == 1024);
+            assert(decltype(d1)::iterator::buffer_size() == 8);
+
+            for (int i = 0; i != 100; ++i) {
+                d1.push_back(i);
+                d1.push_front(-i);
+            }
+
+            assert(d1.size() == 200 && d1[0] == -99 && d1[199] == 99);
+            assert(d1.end() - d1.begin() == 200 && d1.begin() + 150 - 50 == d1.begin() + 100);
+
+            d1.insert(d1.begin() + 7, 9, 1);
+            d1.erase(d1.begin() + 3, d1.begin() + 30);
+            d1.resize(16);
+            d1.resize(40, 2);
+            assert(d1.size() == 40 && d1[2] == -97 && d1[3] == -78 && d1[15] == -66 && d1[39] == 2);
+
+            HxSTL::deque<int, HxSTL::allocator<int>, 8> d2(16, 3);
+            d2.push_back(4);
+            assert(d2.size() == 17 && d2.back() == 4 && d2[15] == 3);
+        }
+
+        { // spare block
+            // 稳定的先进先出不再访问分配器
+            HxSTL::deque<int, counting_allocator<int>, 8> d1;
+
+            for (int i = 0; i != 20; ++i) {
+                d1.push_back(i);
+            }
+            for (int i = 20; i != 100; ++i) {
+                d1.push_back(i);
+                d1.pop_front();
+            }
+
+            int allocations = counting_allocator<int>::allocations;
+
+            for (int i = 100; i != 10000; ++i) {
+                d1.push_back(i);
+                d1.pop_front();
+            }
+
+            assert(counting_allocator<int>::allocations == allocations);
+            assert(d1.size() == 20 && d1.front() == 9980 && d1.back() == 9999);
+
+            d1.clear();
+            d1.shrink_to_fit();
+            assert(d1.empty());
+        }
+
+        { // segmented algorithm
+            typedef HxSTL::deque<int, HxSTL::allocator<int>, 8> deque8;
+
+            HxSTL::vector<int> v1;
+            for (int i = 0; i != 100; ++i) {
+                v1.push_back(i);
+            }
+
+            // 输入或输出跨越多个缓冲区, 起止位置不在块边界上
+            deque8 d1(v1.begin(), v1.end());
+            deque8 d2(120, -1);
+            d2.pop_front();
+            d2.pop_front();
+            d2.pop_front();
+
+            assert(HxSTL::copy(d1.begin() + 5, d1.begin() + 90, d2.begin() + 2) == d2.begin() + 87);
+            assert(d2[1] == -1 && d2[2] == 5 && d2[86] == 89 && d2[87] == -1);
+
+            HxSTL::vector<int> v2(85);
+            assert(HxSTL::copy(d1.begin() + 5, d1.begin() + 90, v2.begin()) == v2.end());
+            assert(v2.front() == 5 && v2.back() == 89);
+
+            assert(HxSTL::copy(v1.begin(), v1.begin() + 16, d2.begin() + 1) == d2.begin() + 17);
+            assert(d2[0] == -1 && d2[1] == 0 && d2[16] == 15 && d2[17] == 20);
+
+            HxSTL::fill(d2.begin() + 3, d2.end() - 3, 7);
+            assert(d2[2] == 1 && d2[3] == 7 && d2[113] == 7 && d2[114] == -1);
+
+            assert(HxSTL::find(d1.begin(), d1.end(), 42) == d1.begin() + 42);
+            assert(HxSTL::find(d1.begin() + 3, d1.begin() + 5, 4) == d1.begin() + 4);
+            assert(HxSTL::find(d1.begin(), d1.end(), 100) == d1.end());
+            assert(HxSTL::find(d1.begin() + 43, d1.end(), 42) == d1.end());
+
+            struct sum {
+                int value;
+                void operator()(int x) { value += x; }
+            };
+            sum s = { 0 };
+            assert(HxSTL::for_each(d1.begin() + 1, d1.end(), s).value == 4950);
+
+            // 闭包类型没有拷贝赋值
+            int total = 0;
+            HxSTL::for_each(d1.begin() + 3, d1.end() - 2, [&total](int x) { total += x; });
+            assert(total == 4950 - 0 - 1 - 2 - 98 - 99);
+
+            int a1[100];
+            HxSTL::uninitialized_copy(d1.begin(), d1.end(), a1);
+            assert(a1[0] == 0 && a1[99] == 99);
+
+            HxSTL::deque<HxSTL::basic_string<char>, HxSTL::allocator<HxSTL::basic_string<char>>, 4> d3(10, "abc");
+            HxSTL::deque<HxSTL::basic_string<char>, HxSTL::allocator<HxSTL::basic_string<char>>, 4> d4(d3);
+            assert(d4.size() == 10 && d4[9] == HxSTL::basic_string<char>("abc"));
+
+            assert(d1.begin() + 7 < d1.begin() + 8 && d1.begin() + 8 > d1.begin() + 7);
+            assert(d1.begin() + 9 <= d1.end() && d1.end() >= d1.begin());
+        }
+
+        { // allocator
+            // 缓冲区与 map 使用同一分配器状态
+            HxSTL::huge_page_allocator<int> a1(HxSTL::numa_interleave, 256);
+            HxSTL::deque<int, HxSTL::huge_page_allocator<int>> d1(a1);
+
+            for (int i = 0; i != 1000; ++i) {
+                d1.push_back(i);
+                d1.push_front(-i);
+            }
+
+            assert(d1.get_allocator() == a1);
+            assert(d1.size() == 2000 && d1.front() == -999 && d1.back() == 999);
+
+            d1.erase(d1.begin() + 10, d1.end() - 10);
+            assert(d1.size() == 20 && d1[10] == 990);
+        }
     }
 
     printf("\033[1;32m=================================================\033[0m\n");
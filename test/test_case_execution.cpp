@@ -0,0 +1,170 @@
+#include <cstdio>
+#include <cassert>
+#include <cstdlib>
+#include "execution.h"
+#include "deque.h"
+#include "basic_string.h"
+
+typedef HxSTL::basic_string<char> string;
+
+struct is_even {
+    bool operator()(int x) const { return x % 2 == 0; }
+};
+
+int main() {
+
+    const int n = 200000;
+    HxSTL::vector<int> v(n);
+    srand(1);
+    for (int i = 0; i < n; ++i) {
+        v[i] = rand() % 100000;
+    }
+
+    { // sort
+        HxSTL::vector<int> v1(v), v2(v), v3(v);
+        HxSTL::sort(v1.begin(), v1.end());
+        HxSTL::sort(HxSTL::execution::par, v2.begin(), v2.end());
+        HxSTL::sort(HxSTL::execution::par_unseq, v3.begin(), v3.end(), HxSTL::greater<int>());
+        assert(v1 == v2);
+        assert(HxSTL::is_sorted(v3.begin(), v3.end(), HxSTL::greater<int>()));
+
+        // 稳定归并不会打乱相等的元素, 非平凡类型经过临时缓冲区往返
+        HxSTL::vector<string> s1, s2;
+        for (int i = 0; i < 20000; ++i) {
+            string s(1, char('a' + v[i] % 26));
+            s += "xxxxx";
+            s1.push_back(s);
+        }
+        s2 = s1;
+        HxSTL::sort(s1.begin(), s1.end());
+        HxSTL::sort(HxSTL::execution::par, s2.begin(), s2.end());
+        assert(s1 == s2);
+
+        HxSTL::vector<int> v4;
+        HxSTL::sort(HxSTL::execution::par, v4.begin(), v4.end());
+        HxSTL::deque<int> d1(v.begin(), v.begin() + 10000);
+        HxSTL::sort(HxSTL::execution::seq, d1.begin(), d1.end());
+        assert(HxSTL::is_sorted(d1.begin(), d1.end()));
+    }
+
+    { // for_each transform fill copy
+        HxSTL::vector<int> v1(v), v2(n), v3(n);
+        HxSTL::for_each(HxSTL::execution::par, v1.begin(), v1.end(), [](int& x) { x += 1; });
+        for (int i = 0; i < n; ++i) {
+            assert(v1[i] == v[i] + 1);
+        }
+
+        HxSTL::deque<int> d2(v.begin(), v.end());
+        HxSTL::for_each(HxSTL::execution::par, d2.begin(), d2.end(), [](int& x) { x *= 3; });
+        for (int i = 0; i < n; ++i) {
+            assert(d2[i] == v[i] * 3);
+        }
+
+        assert(HxSTL::transform(HxSTL::execution::par, v.begin(), v.end(), v2.begin(),
+            [](int x) { return x * 2; }) == v2.end());
+        assert(HxSTL::transform(HxSTL::execution::par, v.begin(), v.end(), v1.begin(), v3.begin(),
+            [](int x, int y) { return y - x; }) == v3.end());
+        for (int i = 0; i < n; ++i) {
+            assert(v2[i] == v[i] * 2 && v3[i] == 1);
+        }
+
+        HxSTL::fill(HxSTL::execution::par, v2.begin(), v2.end(), 7);
+        assert(HxSTL::count_if(v2.begin(), v2.end(), [](int x) { return x == 7; }) == n);
+
+        assert(HxSTL::copy(HxSTL::execution::par, v.begin(), v.end(), v3.begin()) == v3.end());
+        assert(v3 == v);
+
+        HxSTL::deque<int> d1(100, 0);
+        HxSTL::fill(HxSTL::execution::par, d1.begin(), d1.end(), 3);
+        assert(d1.front() == 3 && d1.back() == 3);
+    }
+
+    { // count_if find_if all_of
+        assert(HxSTL::count_if(HxSTL::execution::par, v.begin(), v.end(), is_even())
+            == HxSTL::count_if(v.begin(), v.end(), is_even()));
+
+        HxSTL::vector<int> v1(n, 1);
+        v1[150000] = 2;
+        v1[170000] = 2;
+        assert(HxSTL::find_if(HxSTL::execution::par, v1.begin(), v1.end(), is_even()) == v1.begin() + 150000);
+        assert(HxSTL::find(HxSTL::execution::par, v1.begin(), v1.end(), 2) == v1.begin() + 150000);
+        assert(HxSTL::find(HxSTL::execution::par, v1.begin(), v1.end(), 3) == v1.end());
+        assert(!HxSTL::all_of(HxSTL::execution::par, v1.begin(), v1.end(), [](int x) { return x == 1; }));
+        assert(HxSTL::any_of(HxSTL::execution::par_unseq, v1.begin(), v1.end(), is_even()));
+        assert(HxSTL::none_of(HxSTL::execution::par, v1.begin(), v1.end(), [](int x) { return x > 2; }));
+        assert(HxSTL::find_if_not(HxSTL::execution::par, v1.begin(), v1.end(),
+            [](int x) { return x == 1; }) == v1.begin() + 150000);
+        assert(HxSTL::all_of(HxSTL::execution::seq, v1.begin(), v1.begin() + 100, [](int x) { return x == 1; }));
+    }
+
+    { // min_element max_element
+        HxSTL::vector<int> v1(n, 5);
+        v1[100] = 1;
+        v1[120000] = 1;
+        v1[3000] = 9;
+        v1[190000] = 9;
+        assert(HxSTL::min_element(HxSTL::execution::par, v1.begin(), v1.end()) == v1.begin() + 100);
+        assert(HxSTL::max_element(HxSTL::execution::par, v1.begin(), v1.end()) == v1.begin() + 3000);
+        assert(HxSTL::min_element(HxSTL::execution::par, v.begin(), v.end())
+            == HxSTL::min_element(v.begin(), v.end()));
+        assert(HxSTL::max_element(HxSTL::execution::par, v.begin(), v.end(), HxSTL::greater<int>())
+            == HxSTL::min_element(v.begin(), v.end()));
+    }
+
+    { // partition
+        HxSTL::vector<int> v1(v);
+        auto it = HxSTL::partition(HxSTL::execution::par, v1.begin(), v1.end(), is_even());
+        assert(it - v1.begin() == HxSTL::count_if(v.begin(), v.end(), is_even()));
+        assert(HxSTL::all_of(v1.begin(), it, is_even()));
+        assert(HxSTL::none_of(it, v1.end(), is_even()));
+        HxSTL::sort(v1.begin(), v1.end());
+        HxSTL::vector<int> v2(v);
+        HxSTL::sort(v2.begin(), v2.end());
+        assert(v1 == v2);
+
+        HxSTL::vector<int> v3(n, 1);
+        assert(HxSTL::partition(HxSTL::execution::par, v3.begin(), v3.end(), is_even()) == v3.begin());
+    }
+
+    { // nth_element partial_sort
+        HxSTL::vector<int> v1(v), v2(v);
+        HxSTL::sort(v2.begin(), v2.end());
+        const int ks[] = { 0, 1, n / 3, n / 2, n - 1 };
+        for (int i = 0; i < 5; ++i) {
+            HxSTL::vector<int> v3(v);
+            HxSTL::nth_element(HxSTL::execution::par, v3.begin(), v3.begin() + ks[i], v3.end());
+            assert(v3[ks[i]] == v2[ks[i]]);
+            assert(HxSTL::all_of(v3.begin(), v3.begin() + ks[i], [&](int x) { return x <= v2[ks[i]]; }));
+            assert(HxSTL::all_of(v3.begin() + ks[i], v3.end(), [&](int x) { return x >= v2[ks[i]]; }));
+        }
+
+        // 大量相等元素
+        HxSTL::vector<int> v4(n, 3);
+        v4[7] = 1;
+        HxSTL::nth_element(HxSTL::execution::par, v4.begin(), v4.begin() + 1000, v4.end());
+        assert(v4[1000] == 3 && v4[0] == 1);
+
+        HxSTL::partial_sort(HxSTL::execution::par, v1.begin(), v1.begin() + 1000, v1.end(), HxSTL::greater<int>());
+        HxSTL::vector<int> v5(v2.end() - 1000, v2.end());
+        HxSTL::reverse(v5.begin(), v5.end());
+        assert(HxSTL::equal(v5.begin(), v5.end(), v1.begin()));
+    }
+
+    { // exception
+        bool thrown = false;
+        try {
+            HxSTL::for_each(HxSTL::execution::par, v.begin(), v.end(), [](int x) {
+                if (x == 99999) {
+                    throw HxSTL::out_of_range();
+                }
+            });
+        } catch (HxSTL::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown == (HxSTL::find(v.begin(), v.end(), 99999) != v.end()));
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
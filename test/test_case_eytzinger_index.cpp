@@ -0,0 +1,59 @@
+#include <cstdio>
+#include <cassert>
+#include <stdint.h>
+#include "eytzinger_index.h"
+#include "basic_string.h"
+
+typedef HxSTL::basic_string<char> string;
+
+int main() {
+
+    { // 各种长度下与 lower_bound / upper_bound 的结果一致
+        for (size_t n = 0; n < 130; ++n) {
+            HxSTL::vector<int> v1;
+            for (size_t i = 0; i < n; ++i) {
+                v1.push_back(static_cast<int>(i / 2 * 3));  // 每个值出现两次
+            }
+            HxSTL::eytzinger_index<int> index(v1);
+            assert(index.size() == n && index.empty() == (n == 0));
+            for (int x = -1; x <= static_cast<int>(n * 2); ++x) {
+                assert(index.lower_bound(x) == static_cast<size_t>(HxSTL::lower_bound(v1.begin(), v1.end(), x) - v1.begin()));
+                assert(index.upper_bound(x) == static_cast<size_t>(HxSTL::upper_bound(v1.begin(), v1.end(), x) - v1.begin()));
+                assert(index.contains(x) == HxSTL::binary_search(v1.begin(), v1.end(), x));
+            }
+        }
+    }
+
+    { // 大表, 返回的下标可以索引平行的数据
+        HxSTL::vector<uint64_t> keys;
+        HxSTL::vector<int> payload;
+        for (uint64_t i = 0; i < 100000; ++i) {
+            keys.push_back(i * 7 + 1);
+            payload.push_back(static_cast<int>(i));
+        }
+        HxSTL::eytzinger_index<uint64_t> index(keys);
+        for (uint64_t i = 0; i < 100000; i += 97) {
+            size_t rank = index.lower_bound(i * 7 + 1);
+            assert(rank < keys.size() && keys[rank] == i * 7 + 1 && payload[rank] == static_cast<int>(i));
+            assert(index.lower_bound(i * 7 + 2) == rank + 1);
+        }
+        assert(index.lower_bound(0) == 0 && index.lower_bound(1000000) == keys.size());
+    }
+
+    { // 自定义比较, 非平凡类型
+        HxSTL::vector<string> v1;
+        const char* words[] = { "pear", "orange", "lemon", "banana", "apple" };
+        for (int i = 0; i < 5; ++i) {
+            v1.push_back(words[i]);
+        }
+        HxSTL::eytzinger_index<string, HxSTL::greater<string> > index(v1);
+        assert(index.lower_bound(string("orange")) == 1);
+        assert(index.upper_bound(string("orange")) == 2);
+        assert(index.lower_bound(string("cherry")) == 3);
+        assert(index.contains(string("apple")) && !index.contains(string("kiwi")));
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include "catch.hpp"
 #include "list.h"
+#include "node_pool_allocator.h"
 
 TEST_CASE("list_default_constructor") {
 
@@ -490,3 +491,25 @@ TEST_CASE("list_member_sort") {
     REQUIRE(HxSTL::is_sorted(l1.begin(), l1.end()));
 
 }
+
+TEST_CASE("list_node_pool_allocator") {
+
+    typedef HxSTL::list<int, HxSTL::node_pool_allocator<HxSTL::__list_node<int>>> pool_list;
+
+    pool_list l1;
+    for (int i = 0; i != 1000; ++i) {
+        l1.push_back(i);
+    }
+
+    pool_list l2(l1);
+    REQUIRE(l2.get_allocator() != l1.get_allocator());
+    pool_list l3(HxSTL::move(l1));
+
+    l2.swap(l3);
+    l3.clear();
+    l3.push_back(1);
+
+    REQUIRE(l2.size() == 1000);
+    REQUIRE(l3 == pool_list({ 1 }));
+
+}
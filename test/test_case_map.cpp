@@ -3,6 +3,7 @@
 #include <cstdio>
 #include <cassert>
 #include "map.h"
+#include "node_pool_allocator.h"
 
 int main() {
 
@@ -263,6 +264,111 @@ int main() {
             assert(s1.upper_bound(1) -> second == 3);
             assert(s1.upper_bound(2) == s1.end());
         }
+
+        { // node_pool_allocator
+            typedef HxSTL::map<int, int, HxSTL::less<int>, HxSTL::node_pool_allocator<HxSTL::pair<const int, int>>> pool_map;
+            pool_map s1;
+
+            for (int i = 0; i != 10000; ++i) {
+                s1.insert(HxSTL::make_pair(i, i));
+            }
+
+            pool_map s2(s1);
+            pool_map s3;
+
+            s3.swap(s1);
+            s1 = s2;
+            s2.clear();
+            s2.insert(HxSTL::make_pair(1, 1));
+
+            assert(s1 == s3);
+            assert(s1.size() == 10000);
+            assert(s2.size() == 1 && s2.at(1) == 1);
+        }
+
+        { // node_pool_allocator copy
+            // 拷贝构造的树使用自己的池, 不与原树共享
+            typedef HxSTL::rb_tree<int, HxSTL::pair<const int, int>, HxSTL::__select1st<HxSTL::pair<const int, int>>,
+                HxSTL::less<int>, HxSTL::node_pool_allocator<HxSTL::pair<const int, int>>> pool_tree;
+            HxSTL::less<int> comp;
+            pool_tree::allocator_type alloc;
+            pool_tree t1(comp, alloc);
+            t1.emplace_unique(1, 1);
+
+            pool_tree t2(t1);
+            t2.emplace_unique(2, 2);
+
+            assert(t1.get_node_allocator() != t2.get_node_allocator());
+            assert(t1.size() == 1 && t2.size() == 2);
+        }
+
+        { // visit
+            HxSTL::map<int, int> s1;
+            const HxSTL::map<int, int>& s2 = s1;
+
+            for (int i = 0; i != 1000; ++i) {
+                s1.insert(HxSTL::make_pair((i * 7) % 1000, i));
+            }
+
+            int next = 0;
+            s1.visit([&next] (HxSTL::pair<const int, int>& p) { assert(p.first == next++); p.second = 0; });
+            assert(next == 1000);
+
+            long sum = 0;
+            s2.visit([&sum] (const HxSTL::pair<const int, int>& p) { sum += p.second; });
+            assert(sum == 0);
+        }
+
+        { // for_each_in_range
+            HxSTL::map<int, int> s1;
+
+            for (int i = 0; i != 1000; i += 2) {
+                s1.insert(HxSTL::make_pair(i, i));
+            }
+
+            int next = 100;
+            s1.for_each_in_range(99, 201, [&next] (const HxSTL::pair<const int, int>& p) {
+                        assert(p.first == next);
+                        next += 2;
+                    });
+            assert(next == 202);
+
+            int n = 0;
+            s1.for_each_in_range(1000, 2000, [&n] (const HxSTL::pair<const int, int>&) { ++n; });
+            s1.for_each_in_range(10, 10, [&n] (const HxSTL::pair<const int, int>&) { ++n; });
+            assert(n == 0);
+        }
+
+        { // parallel_for_each_in_range
+            HxSTL::map<int, int> s1;
+
+            for (int i = 0; i != 100000; ++i) {
+                s1.insert(HxSTL::make_pair(i, 0));
+            }
+
+            s1.parallel_for_each_in_range(100, 90000, [] (HxSTL::pair<const int, int>& p) { ++p.second; }, 4);
+
+            int n = 0;
+            for (auto it = s1.begin(); it != s1.end(); ++it) {
+                assert(it -> second == (it -> first >= 100 && it -> first < 90000));
+                n += it -> second;
+            }
+            assert(n == 89900);
+
+            HxSTL::map<int, int> s2({ HxSTL::make_pair(1, 0), HxSTL::make_pair(2, 0) });
+            s2.parallel_for_each_in_range(0, 2, [] (HxSTL::pair<const int, int>& p) { ++p.second; });
+            assert(s2.find(1) -> second == 1 && s2.find(2) -> second == 0);
+
+            bool caught = false;
+            try {
+                s1.parallel_for_each_in_range(0, 100000, [] (HxSTL::pair<const int, int>& p) {
+                    if (p.first == 77777) throw p.first;
+                }, 4);
+            } catch (int k) {
+                caught = (k == 77777);
+            }
+            assert(caught);
+        }
     }
 
     { // non-member
@@ -0,0 +1,267 @@
+#include <ctime>
+#include <cstdlib>
+#include <cstdio>
+#include <cassert>
+#include "multimap.h"
+
+int main() {
+
+    { // member
+        { // default constructor
+            HxSTL::multimap<int, int> s1;
+
+            assert(s1.empty());
+            assert(s1.size() == 0);
+        }
+
+        { // range constructor
+            HxSTL::pair<const int, int> a1[] = { HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 3), HxSTL::make_pair(1, 3) };
+            HxSTL::multimap<int, int> s1(a1, a1 + 3);
+
+            assert((s1 == HxSTL::multimap<int, int>({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3), HxSTL::make_pair(2, 3) })));
+        }
+
+        { // init constructor
+            HxSTL::pair<const int, int> a1[] = { HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3), HxSTL::make_pair(2, 3) };
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 3), HxSTL::make_pair(1, 3) });
+
+            assert(s1.size() == 3);
+            assert(HxSTL::equal(s1.begin(), s1.end(), a1));
+        }
+
+        { // copy constructor
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) });
+            HxSTL::multimap<int, int> s2(s1);
+            HxSTL::multimap<int, int> s3;
+            HxSTL::multimap<int, int> s4(s3);
+
+            for (int i = 0; i != 1000; ++i) {
+                s3.insert(HxSTL::make_pair(i % 10, i));
+            }
+
+            HxSTL::multimap<int, int> s5(s3);
+
+            assert(s1 == s2);
+            assert(s4.empty());
+            assert(s3 == s5);
+            assert(s5.count(3) == 100);
+        }
+
+        { // move constructor
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) });
+            HxSTL::multimap<int, int> s2(HxSTL::move(s1));
+
+            assert((s2 == HxSTL::multimap<int, int>{ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) }));
+        }
+
+        { // copy assignment
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) });
+            HxSTL::multimap<int, int> s2;
+            HxSTL::multimap<int, int> s3;
+
+            s2 = s1;
+            s2 = s2;
+            s1 = s3;
+
+            assert((s2 == HxSTL::multimap<int, int>{ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) }));
+            assert(s1.empty());
+        }
+
+        { // move assignment
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) });
+            HxSTL::multimap<int, int> s2;
+
+            s2 = HxSTL::move(s1);
+
+            assert((s2 == HxSTL::multimap<int, int>{ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) }));
+        }
+
+        { // init assignment
+            HxSTL::multimap<int, int> s1;
+
+            assert(((s1 = { HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) }) ==
+                    HxSTL::multimap<int, int>({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) })));
+        }
+
+        { // begin end rbegin rend
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 3), HxSTL::make_pair(2, 4) });
+            const HxSTL::multimap<int, int> s2(s1);
+
+            assert(s1.begin() -> first == 1);
+            assert(s2.cbegin() -> first == 1);
+            assert((--s1.end()) -> second == 4);
+            assert((--s2.cend()) -> second == 4);
+            assert(s1.rbegin() -> second == 4);
+            assert((--s2.rend()) -> second == 2);
+        }
+
+        { // clear
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) });
+
+            s1.clear();
+
+            assert(s1.empty());
+        }
+
+        { // insert 1
+            HxSTL::multimap<int, int> s1;
+
+            assert(s1.insert(HxSTL::make_pair(1, 2)) -> first == 1);
+            assert(s1.insert(HxSTL::make_pair(1, 4)) -> second == 4);
+            auto it = s1.insert(HxSTL::make_pair(0, 3));
+            assert(it == s1.begin());
+            assert(s1.size() == 3);
+
+            HxSTL::multimap<int, int> s2;
+
+            srand((unsigned) time(NULL));
+            for (int i = 0; i != 100000; ++i) {
+                s2.insert(HxSTL::make_pair(rand() % 50000, i));
+            }
+
+            assert(s2.size() == 100000);
+            assert(HxSTL::is_sorted(s2.begin(), s2.end(), [] (const HxSTL::pair<const int, int>& lhs,
+                            const HxSTL::pair<const int, int>& rhs) { return lhs.first < rhs.first; }));
+        }
+
+        { // insert 2
+            HxSTL::multimap<int, int> s1;
+
+            for (int i = 0; i != 10; ++i) {
+                s1.insert(s1.end(), HxSTL::make_pair(i / 2, i));
+            }
+            s1.insert(s1.begin(), HxSTL::make_pair(-1, 10));
+            s1.insert(s1.end(), HxSTL::make_pair(2, 11));
+
+            int a1[] = { 10, 0, 1, 2, 3, 4, 5, 11, 6, 7, 8, 9 };
+            int i = 0;
+            for (auto it = s1.begin(); it != s1.end(); ++it, ++i) {
+                assert(it -> second == a1[i]);
+            }
+            assert(i == 12);
+        }
+
+        { // insert 3
+            HxSTL::pair<const int, int> a1[] = { HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 3), HxSTL::make_pair(1, 3) };
+            HxSTL::multimap<int, int> s1;
+
+            s1.insert(a1, a1 + 3);
+
+            assert((s1 == HxSTL::multimap<int, int>({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3), HxSTL::make_pair(2, 3) })));
+        }
+
+        { // emplace
+            HxSTL::multimap<int, int> s1;
+
+            assert(s1.emplace(1, 2) -> first == 1);
+            assert(s1.emplace(1, 4) -> second == 4);
+            assert(s1.size() == 2);
+        }
+
+        { // emplace_hint
+            HxSTL::multimap<int, int> s1;
+
+            auto it = s1.emplace_hint(s1.end(), 1, 1);
+            it = s1.emplace_hint(it, 1, 0);
+            s1.emplace_hint(s1.end(), 1, 2);
+            s1.emplace_hint(s1.begin(), 0, 0);
+
+            assert(it == ++s1.begin());
+            assert((s1 == HxSTL::multimap<int, int>{ HxSTL::make_pair(0, 0), HxSTL::make_pair(1, 0),
+                        HxSTL::make_pair(1, 1), HxSTL::make_pair(1, 2) }));
+        }
+
+        { // erase
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3), HxSTL::make_pair(2, 3) });
+
+            assert(s1.erase(1) == 2);
+            assert(s1.erase(s1.begin()) == s1.end());
+            assert(s1.empty());
+        }
+
+        { // extract
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3), HxSTL::make_pair(2, 3) });
+            HxSTL::multimap<int, int> s2;
+
+            auto nh = s1.extract(s1.begin());
+
+            assert(!nh.empty());
+            assert(nh.key() == 1 && nh.mapped() == 2);
+            assert(s1.size() == 2);
+
+            nh.key() = 3;
+            s2.insert(HxSTL::move(nh));
+
+            assert(nh.empty());
+            assert(s1.extract(4).empty());
+            assert(s2.insert(s1.extract(2)) -> second == 3);
+            assert((s2 == HxSTL::multimap<int, int>{ HxSTL::make_pair(2, 3), HxSTL::make_pair(3, 2) }));
+            assert(s1.insert(HxSTL::move(nh)) == s1.end());
+        }
+
+        { // swap
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) });
+            HxSTL::multimap<int, int> s2({ HxSTL::make_pair(0, 1) });
+
+            s1.swap(s2);
+
+            assert((s1 == HxSTL::multimap<int, int>{ HxSTL::make_pair(0, 1) }));
+            assert((s2 == HxSTL::multimap<int, int>{ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) }));
+        }
+
+        { // count
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3), HxSTL::make_pair(2, 3) });
+
+            assert(s1.count(1) == 2);
+            assert(s1.count(2) == 1);
+            assert(s1.count(3) == 0);
+        }
+
+        { // find
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3), HxSTL::make_pair(2, 3) });
+
+            assert(s1.find(1) == s1.begin());
+            assert(s1.find(2) -> second == 3);
+            assert(s1.find(3) == s1.end());
+        }
+
+        { // equal_range
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3), HxSTL::make_pair(2, 3) });
+
+            assert(s1.equal_range(1).first == s1.begin());
+            assert(s1.equal_range(1).second -> first == 2);
+            assert(s1.equal_range(2).second == s1.end());
+            assert(s1.equal_range(0).first == s1.equal_range(0).second);
+        }
+
+        { // lower_bound upper_bound
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3), HxSTL::make_pair(2, 3) });
+
+            assert(s1.lower_bound(1) -> second == 2);
+            assert(s1.upper_bound(1) -> first == 2);
+            assert(s1.upper_bound(2) == s1.end());
+        }
+
+        { // value_comp
+            HxSTL::multimap<int, int> s1;
+
+            assert(s1.value_comp()(HxSTL::make_pair(1, 3), HxSTL::make_pair(2, 0)));
+            assert(!s1.value_comp()(HxSTL::make_pair(1, 3), HxSTL::make_pair(1, 0)));
+        }
+    }
+
+    { // non-member
+        { // operator== operator!=
+            HxSTL::multimap<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) });
+            HxSTL::multimap<int, int> s2({ HxSTL::make_pair(1, 2), HxSTL::make_pair(1, 3) });
+            HxSTL::multimap<int, int> s3({ HxSTL::make_pair(1, 2) });
+
+            assert(s1 == s2);
+            assert(s1 != s3);
+        }
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
@@ -0,0 +1,265 @@
+#include <cstdio>
+#include <cassert>
+#include <stdint.h>
+#include "numeric.h"
+#include "deque.h"
+#include "list.h"
+#include "basic_string.h"
+
+typedef HxSTL::basic_string<char> string;
+
+uint64_t next_random(uint64_t& seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+// 浮点数重排求和后的误差
+bool close(double x, double y) {
+    double d = x > y ? x - y : y - x;
+    double m = x > 0 ? x : -x;
+    return d <= 1e-9 * (m > 1 ? m : 1);
+}
+
+int main() {
+
+    uint64_t seed = 88172645463325252ull;
+
+    { // iota
+        HxSTL::vector<int> v1(1000);
+        HxSTL::iota(v1.begin(), v1.end(), -10);
+        for (int i = 0; i < 1000; ++i) {
+            assert(v1[i] == i - 10);
+        }
+
+        unsigned char a1[300];
+        HxSTL::iota(a1, a1 + 300, static_cast<unsigned char>(0));
+        assert(a1[0] == 0 && a1[255] == 255 && a1[256] == 0 && a1[299] == 43);
+
+        HxSTL::list<double> l1(5);
+        HxSTL::iota(l1.begin(), l1.end(), 0.5);
+        assert(l1.front() == 0.5 && l1.back() == 4.5);
+
+        HxSTL::vector<long long> v2(7);
+        HxSTL::iota(v2.begin(), v2.end(), 5);
+        assert(v2[0] == 5 && v2[6] == 11);
+    }
+
+    { // accumulate reduce
+        for (int n = 0; n < 200; n += 13) {
+            HxSTL::vector<int> v1;
+            long long expected = 0;
+            for (int i = 0; i < n; ++i) {
+                v1.push_back(static_cast<int>(next_random(seed) % 2001) - 1000);
+                expected += v1.back();
+            }
+            assert(HxSTL::accumulate(v1.begin(), v1.end(), 7) == expected + 7);
+            assert(HxSTL::reduce(v1.begin(), v1.end(), 7) == expected + 7);
+            assert(HxSTL::reduce(v1.begin(), v1.end()) == expected);
+            assert(HxSTL::accumulate(v1.begin(), v1.end(), 7LL) == expected + 7);
+        }
+
+        // 无符号整数回绕, 向量化后结果不变
+        HxSTL::vector<uint8_t> v2(1000, 200);
+        assert(HxSTL::accumulate(v2.begin(), v2.end(), static_cast<uint8_t>(0)) == static_cast<uint8_t>(200 * 1000));
+        assert(HxSTL::accumulate(v2.begin(), v2.end(), 0) == 200000);
+
+        // 浮点数: accumulate 按顺序, reduce 允许重排
+        HxSTL::vector<double> v3;
+        double expected = 0;
+        for (int i = 0; i < 10007; ++i) {
+            v3.push_back(static_cast<double>(next_random(seed) % 1000) / 7.0);
+            expected += v3.back();
+        }
+        assert(HxSTL::accumulate(v3.begin(), v3.end(), 0.0) == expected);
+        assert(close(HxSTL::reduce(v3.begin(), v3.end(), 0.0), expected));
+
+        // accumulate 的默认运算按 init + *first 求值
+        double a1[] = { 0.5, 0.5, 0.5 };
+        assert(HxSTL::accumulate(a1, a1 + 3, 0) == 0);
+        assert(HxSTL::accumulate(a1, a1 + 3, 0.0) == 1.5);
+
+        HxSTL::deque<int> d1;
+        long long sum = 0;
+        for (int i = 0; i < 5000; ++i) {
+            d1.push_front(i);
+            sum += i;
+        }
+        assert(HxSTL::accumulate(d1.begin(), d1.end(), 0) == sum);
+        assert(HxSTL::reduce(d1.begin() + 3, d1.end() - 5, 0) == sum - 4999 - 4998 - 4997 - 10);
+
+        HxSTL::vector<int> v4(100, 2);
+        assert(HxSTL::accumulate(v4.begin(), v4.begin() + 10, 1, HxSTL::multiplies<int>()) == 1024);
+        assert(HxSTL::reduce(v4.begin(), v4.end(), 0, HxSTL::plus<int>()) == 200);
+
+        HxSTL::vector<string> v5;
+        v5.push_back("a");
+        v5.push_back("b");
+        v5.push_back("c");
+        assert(HxSTL::accumulate(v5.begin(), v5.end(), string("x"), [](string s, const string& t) {
+            s += t;
+            return s;
+        }) == string("xabc"));
+    }
+
+    { // inner_product transform_reduce
+        for (int n = 0; n < 150; n += 11) {
+            HxSTL::vector<int> v1, v2;
+            long long expected = 0;
+            for (int i = 0; i < n; ++i) {
+                v1.push_back(static_cast<int>(next_random(seed) % 201) - 100);
+                v2.push_back(static_cast<int>(next_random(seed) % 201) - 100);
+                expected += v1.back() * v2.back();
+            }
+            assert(HxSTL::inner_product(v1.begin(), v1.end(), v2.begin(), 3) == expected + 3);
+            assert(HxSTL::transform_reduce(v1.begin(), v1.end(), v2.begin(), 3) == expected + 3);
+        }
+
+        HxSTL::vector<float> v3, v4;
+        double expected = 0;
+        for (int i = 0; i < 1000; ++i) {
+            v3.push_back(static_cast<float>(i % 10));
+            v4.push_back(0.5f);
+            expected += (i % 10) * 0.5;
+        }
+        assert(HxSTL::transform_reduce(v3.begin(), v3.end(), v4.begin(), 0.0f) == static_cast<float>(expected));
+        assert(HxSTL::inner_product(v3.begin(), v3.end(), v4.begin(), 0.0f) == static_cast<float>(expected));
+
+        // 自定义运算
+        int a1[] = { 1, 2, 3, 4 };
+        int a2[] = { 1, 5, 3, 0 };
+        assert(HxSTL::inner_product(a1, a1 + 4, a2, 0, HxSTL::plus<int>(), HxSTL::equal_to<int>()) == 2);
+        assert(HxSTL::transform_reduce(a1, a1 + 4, 0, HxSTL::plus<int>(), [](int x) { return x * x; }) == 30);
+
+        HxSTL::deque<double> d1(v3.begin(), v3.end());
+        assert(close(HxSTL::transform_reduce(d1.begin(), d1.end(), v4.begin(), 0.0), expected));
+    }
+
+    { // adjacent_difference partial_sum
+        int a1[] = { 1, 4, 9, 16, 25 };
+        int r1[5];
+        HxSTL::adjacent_difference(a1, a1 + 5, r1);
+        assert(r1[0] == 1 && r1[1] == 3 && r1[2] == 5 && r1[3] == 7 && r1[4] == 9);
+        HxSTL::partial_sum(r1, r1 + 5, r1);
+        assert(HxSTL::equal(r1, r1 + 5, a1));
+
+        // 原地
+        HxSTL::adjacent_difference(a1, a1 + 5, a1, HxSTL::plus<int>());
+        assert(a1[0] == 1 && a1[1] == 5 && a1[4] == 41);
+
+        HxSTL::list<int> l1(4, 3);
+        HxSTL::vector<int> v1(4);
+        HxSTL::partial_sum(l1.begin(), l1.end(), v1.begin(), HxSTL::multiplies<int>());
+        assert(v1[0] == 3 && v1[3] == 81);
+
+        for (int n = 0; n < 100; n += 9) {
+            HxSTL::vector<short> v2, v3(n);
+            for (int i = 0; i < n; ++i) {
+                v2.push_back(static_cast<short>(next_random(seed)));
+            }
+            HxSTL::partial_sum(v2.begin(), v2.end(), v3.begin());
+            short sum = 0;
+            for (int i = 0; i < n; ++i) {
+                sum = static_cast<short>(sum + v2[i]);
+                assert(v3[i] == sum);
+            }
+        }
+    }
+
+    { // inclusive_scan exclusive_scan
+        for (int n = 0; n < 300; n += 17) {
+            HxSTL::vector<long long> v1, v2(n), v3(n), v4(n);
+            for (int i = 0; i < n; ++i) {
+                v1.push_back(static_cast<long long>(next_random(seed) % 1000));
+            }
+            HxSTL::inclusive_scan(v1.begin(), v1.end(), v2.begin());
+            HxSTL::inclusive_scan(v1.begin(), v1.end(), v3.begin(), HxSTL::plus<long long>(), 100LL);
+            HxSTL::exclusive_scan(v1.begin(), v1.end(), v4.begin(), 100LL);
+            long long sum = 0;
+            for (int i = 0; i < n; ++i) {
+                assert(v4[i] == sum + 100);
+                sum += v1[i];
+                assert(v2[i] == sum);
+                assert(v3[i] == sum + 100);
+            }
+            // 原地
+            HxSTL::exclusive_scan(v1.begin(), v1.end(), v1.begin(), 100LL);
+            assert(v1 == v4);
+        }
+
+        int a1[] = { 3, 1, 4, 1, 5 };
+        int r1[5];
+        HxSTL::inclusive_scan(a1, a1 + 5, r1, [](int x, int y) { return x > y ? x : y; });
+        assert(r1[0] == 3 && r1[1] == 3 && r1[2] == 4 && r1[4] == 5);
+        HxSTL::exclusive_scan(a1, a1 + 5, r1, 1, HxSTL::multiplies<int>());
+        assert(r1[0] == 1 && r1[1] == 3 && r1[2] == 3 && r1[3] == 12 && r1[4] == 12);
+
+        HxSTL::deque<int> d1(a1, a1 + 5);
+        HxSTL::inclusive_scan(d1.begin(), d1.end(), d1.begin());
+        assert(d1[0] == 3 && d1[4] == 14);
+    }
+
+    { // execution policy
+        const int n = 300000;
+        HxSTL::vector<int> v1(n);
+        HxSTL::vector<double> v2(n);
+        long long sum = 0;
+        for (int i = 0; i < n; ++i) {
+            v1[i] = static_cast<int>(next_random(seed) % 2001) - 1000;
+            v2[i] = static_cast<double>(v1[i]) / 4;
+            sum += v1[i];
+        }
+
+        assert(HxSTL::reduce(HxSTL::execution::par, v1.begin(), v1.end()) == sum);
+        assert(HxSTL::reduce(HxSTL::execution::seq, v1.begin(), v1.end(), 5) == sum + 5);
+        assert(HxSTL::reduce(HxSTL::execution::par_unseq, v1.begin(), v1.end(), 5LL, HxSTL::plus<long long>()) == sum + 5);
+        assert(close(HxSTL::reduce(HxSTL::execution::par, v2.begin(), v2.end(), 0.0), sum / 4.0));
+
+        long long dot = HxSTL::inner_product(v1.begin(), v1.end(), v1.begin(), 0LL);
+        assert(HxSTL::transform_reduce(HxSTL::execution::par, v1.begin(), v1.end(), v1.begin(), 0LL) == dot);
+        assert(HxSTL::transform_reduce(HxSTL::execution::par, v1.begin(), v1.end(), 0LL, HxSTL::plus<long long>(),
+            [](int x) { return static_cast<long long>(x) * x; }) == dot);
+
+        HxSTL::vector<int> s1(n), s2(n), s3(n), s4(v1);
+        HxSTL::inclusive_scan(v1.begin(), v1.end(), s1.begin());
+        HxSTL::inclusive_scan(HxSTL::execution::par, v1.begin(), v1.end(), s2.begin());
+        assert(s1 == s2);
+        HxSTL::inclusive_scan(HxSTL::execution::par, v1.begin(), v1.end(), s2.begin(), HxSTL::plus<int>(), 10);
+        for (int i = 0; i < n; ++i) {
+            assert(s2[i] == s1[i] + 10);
+        }
+        HxSTL::exclusive_scan(v1.begin(), v1.end(), s3.begin(), 10);
+        HxSTL::exclusive_scan(HxSTL::execution::par, s4.begin(), s4.end(), s4.begin(), 10);
+        assert(s3 == s4);
+        s4 = v1;
+        HxSTL::inclusive_scan(HxSTL::execution::par, s4.begin(), s4.end(), s4.begin());
+        assert(s4 == s1);
+
+        HxSTL::deque<int> d1(v1.begin(), v1.end());
+        assert(HxSTL::reduce(HxSTL::execution::par, d1.begin(), d1.end(), 0) == sum);
+        HxSTL::inclusive_scan(HxSTL::execution::par, d1.begin(), d1.end(), d1.begin());
+        assert(HxSTL::equal(d1.begin(), d1.end(), s1.begin()));
+
+        HxSTL::list<int> l1(v1.begin(), v1.begin() + 1000);
+        assert(HxSTL::reduce(HxSTL::execution::par, l1.begin(), l1.end(), 0)
+            == HxSTL::accumulate(v1.begin(), v1.begin() + 1000, 0));
+
+        // 非算术类型, 运算取较长的字符串
+        HxSTL::vector<string> v3, v4(50000);
+        for (int i = 0; i < 50000; ++i) {
+            v3.push_back(string(1 + i / 1000 + next_random(seed) % 3, 'a'));
+        }
+        HxSTL::inclusive_scan(HxSTL::execution::par, v3.begin(), v3.end(), v4.begin(),
+            [](const string& x, const string& y) { return x.size() < y.size() ? y : x; });
+        size_t longest = 0;
+        for (int i = 0; i < 50000; ++i) {
+            longest = v3[i].size() > longest ? v3[i].size() : longest;
+            assert(v4[i].size() == longest);
+        }
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
@@ -0,0 +1,172 @@
+#include <ctime>
+#include <cstdlib>
+#include <cstdio>
+#include <cassert>
+#include "persistent_map.h"
+#include "map.h"
+
+int main() {
+
+    { // member
+        { // default constructor
+            HxSTL::persistent_map<int, int> s1;
+
+            assert(s1.empty());
+            assert(s1.size() == 0);
+            assert(s1.begin() == s1.end());
+        }
+
+        { // range constructor
+            HxSTL::pair<const int, int> a1[] = { HxSTL::make_pair(2, 3), HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 4) };
+            HxSTL::persistent_map<int, int> s1(a1, a1 + 3);
+
+            assert((s1 == HxSTL::persistent_map<int, int>({ HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 3) })));
+        }
+
+        { // copy constructor snapshot
+            HxSTL::persistent_map<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 3) });
+            HxSTL::persistent_map<int, int> s2(s1);
+            HxSTL::persistent_map<int, int> s3 = s1.snapshot();
+
+            s1.insert(HxSTL::make_pair(3, 4));
+            s1.erase(1);
+
+            assert(s2 == s3);
+            assert(s2.size() == 2 && s2.at(1) == 2);
+            assert((s1 == HxSTL::persistent_map<int, int>({ HxSTL::make_pair(2, 3), HxSTL::make_pair(3, 4) })));
+        }
+
+        { // move constructor
+            HxSTL::persistent_map<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 3) });
+            HxSTL::persistent_map<int, int> s2(HxSTL::move(s1));
+
+            assert(s1.empty());
+            assert((s2 == HxSTL::persistent_map<int, int>({ HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 3) })));
+        }
+
+        { // assignment
+            HxSTL::persistent_map<int, int> s1({ HxSTL::make_pair(1, 2) });
+            HxSTL::persistent_map<int, int> s2;
+            HxSTL::persistent_map<int, int> s3;
+
+            s2 = s1;
+            s2 = s2;
+            s3 = HxSTL::move(s1);
+            s1 = { HxSTL::make_pair(5, 6) };
+
+            assert(s2 == s3);
+            assert(s1.at(5) == 6 && s1.size() == 1);
+        }
+
+        { // at
+            HxSTL::persistent_map<int, int> s1({ HxSTL::make_pair(1, 2) });
+            bool thrown = false;
+
+            assert(s1.at(1) == 2);
+            try {
+                s1.at(2);
+            } catch (HxSTL::out_of_range&) {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+
+        { // begin end rbegin rend
+            HxSTL::persistent_map<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 3), HxSTL::make_pair(3, 4) });
+
+            assert(s1.begin() -> first == 1);
+            assert((--s1.end()) -> second == 4);
+            assert(s1.rbegin() -> first == 3);
+            assert((--s1.rend()) -> first == 1);
+            assert(HxSTL::distance(s1.begin(), s1.end()) == 3);
+        }
+
+        { // insert
+            HxSTL::persistent_map<int, int> s1;
+
+            assert(s1.insert(HxSTL::make_pair(1, 2)).second);
+            assert(!s1.insert(HxSTL::make_pair(1, 3)).second);
+            auto it = s1.insert(HxSTL::make_pair(0, 3)).first;
+            assert(it == s1.begin());
+            assert(s1.at(1) == 2);
+        }
+
+        { // insert_or_assign emplace
+            HxSTL::persistent_map<int, int> s1;
+
+            assert(s1.insert_or_assign(1, 2).second);
+            HxSTL::persistent_map<int, int> s2 = s1;
+            assert(!s1.insert_or_assign(1, 3).second);
+            assert(s1.emplace(2, 4).first -> second == 4);
+
+            assert(s1.at(1) == 3);
+            assert(s2.at(1) == 2 && s2.size() == 1);
+        }
+
+        { // erase
+            HxSTL::persistent_map<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(2, 3) });
+
+            assert(s1.erase(1) == 1);
+            assert(s1.erase(1) == 0);
+            assert(s1.erase(2) == 1);
+            assert(s1.empty());
+        }
+
+        { // find count bounds
+            HxSTL::persistent_map<int, int> s1({ HxSTL::make_pair(1, 2), HxSTL::make_pair(3, 4) });
+
+            assert(s1.find(1) -> second == 2);
+            assert(s1.find(2) == s1.end());
+            assert(s1.count(3) == 1 && s1.count(4) == 0);
+            assert(s1.lower_bound(2) -> first == 3);
+            assert(s1.upper_bound(1) -> first == 3);
+            assert(s1.upper_bound(3) == s1.end());
+            assert(s1.equal_range(1).first == s1.begin());
+        }
+
+        { // versions
+            HxSTL::persistent_map<int, int> s1;
+            HxSTL::map<int, int> m1;
+            HxSTL::persistent_map<int, int> versions[10];
+            HxSTL::map<int, int> expected[10];
+
+            srand((unsigned) time(NULL));
+            for (int i = 0; i != 10000; ++i) {
+                int k = rand() % 1000;
+                if (rand() % 3 != 0) {
+                    assert(s1.insert_or_assign(k, i).second == m1.insert(HxSTL::make_pair(k, i)).second);
+                    m1.find(k) -> second = i;
+                } else {
+                    assert(s1.erase(k) == m1.erase(k));
+                }
+                if (i % 1000 == 0) {
+                    versions[i / 1000] = s1.snapshot();
+                    expected[i / 1000] = m1;
+                }
+            }
+
+            for (int i = 0; i != 10; ++i) {
+                assert(versions[i].size() == expected[i].size());
+                assert(HxSTL::equal(versions[i].begin(), versions[i].end(), expected[i].begin()));
+            }
+        }
+    }
+
+    { // non-member
+        { // operator== operator!= swap
+            HxSTL::persistent_map<int, int> s1({ HxSTL::make_pair(1, 2) });
+            HxSTL::persistent_map<int, int> s2({ HxSTL::make_pair(1, 2) });
+            HxSTL::persistent_map<int, int> s3;
+
+            assert(s1 == s2);
+            assert(s1 != s3);
+
+            HxSTL::swap(s1, s3);
+            assert(s1.empty() && s3 == s2);
+        }
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
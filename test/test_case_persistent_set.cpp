@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <cassert>
+#include "persistent_set.h"
+
+int main() {
+
+    { // member
+        { // constructor
+            int a1[] = { 3, 1, 2, 1 };
+            HxSTL::persistent_set<int> s1(a1, a1 + 4);
+            HxSTL::persistent_set<int> s2({ 1, 2, 3 });
+            HxSTL::persistent_set<int> s3;
+
+            assert(s1 == s2);
+            assert(s3.empty());
+        }
+
+        { // snapshot
+            HxSTL::persistent_set<int> s1({ 1, 2, 3 });
+            HxSTL::persistent_set<int> s2 = s1.snapshot();
+
+            s1.erase(2);
+            s1.insert(4);
+
+            assert((s1 == HxSTL::persistent_set<int>{ 1, 3, 4 }));
+            assert((s2 == HxSTL::persistent_set<int>{ 1, 2, 3 }));
+        }
+
+        { // insert emplace erase
+            HxSTL::persistent_set<int> s1;
+
+            assert(s1.insert(2).second);
+            assert(!s1.insert(2).second);
+            assert(*s1.emplace(1).first == 1);
+            assert(s1.erase(2) == 1);
+            assert(s1.erase(2) == 0);
+            assert(s1.size() == 1);
+        }
+
+        { // iterator find bounds
+            HxSTL::persistent_set<int> s1;
+
+            for (int i = 0; i != 1000; ++i) {
+                s1.insert((i * 7) % 1000);
+            }
+
+            int i = 0;
+            for (auto it = s1.begin(); it != s1.end(); ++it) {
+                assert(*it == i++);
+            }
+            for (auto it = s1.rbegin(); it != s1.rend(); ++it) {
+                assert(*it == --i);
+            }
+
+            assert(*s1.find(10) == 10);
+            assert(s1.find(1000) == s1.end());
+            assert(*s1.lower_bound(-1) == 0);
+            assert(s1.upper_bound(999) == s1.end());
+            assert(s1.count(500) == 1);
+        }
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
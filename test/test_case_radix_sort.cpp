@@ -0,0 +1,260 @@
+#include <cstdio>
+#include <cassert>
+#include <cstdlib>
+#include <stdint.h>
+#include "radix_sort.h"
+#include "deque.h"
+
+typedef HxSTL::basic_string<char> string;
+
+struct record {
+    int key;
+    int order;
+};
+
+struct record_key {
+    int operator()(const record& r) const { return r.key; }
+};
+
+struct record_less {
+    bool operator()(const record& x, const record& y) const {
+        return x.key < y.key || (x.key == y.key && x.order < y.order);
+    }
+};
+
+// 负载不可平凡复制
+struct named_record {
+    int key;
+    string name;
+};
+
+struct named_record_key {
+    int operator()(const named_record& r) const { return r.key; }
+};
+
+// 第 limit 次移动构造时抛出异常, live 统计存活的对象个数
+struct throwing_record {
+    static int live;
+    static int moves;
+    static int limit;
+
+    int key;
+
+    throwing_record(int key): key(key) { ++live; }
+    throwing_record(const throwing_record& other): key(other.key) { ++live; }
+    throwing_record(throwing_record&& other): key(other.key) {
+        if (++moves == limit) throw 0;
+        ++live;
+    }
+    throwing_record& operator=(const throwing_record& other) = default;
+    throwing_record& operator=(throwing_record&& other) = default;
+    ~throwing_record() { --live; }
+};
+
+int throwing_record::live = 0;
+int throwing_record::moves = 0;
+int throwing_record::limit = 0;
+
+uint64_t next_random(uint64_t& seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+int main() {
+
+    uint64_t seed = 88172645463325252ull;
+
+    { // integral
+
+        { // unsigned
+            HxSTL::vector<uint64_t> v1, v2;
+            for (int i = 0; i < 100000; ++i) {
+                v1.push_back(next_random(seed));
+            }
+            v2 = v1;
+            HxSTL::radix_sort(v1.begin(), v1.end());
+            HxSTL::sort(v2.begin(), v2.end());
+            assert(v1 == v2);
+        }
+
+        { // signed, 只有低位变化的键跳过高位
+            HxSTL::vector<int> v1, v2;
+            for (int i = 0; i < 50000; ++i) {
+                v1.push_back(static_cast<int>(next_random(seed) % 2001) - 1000);
+            }
+            v1.push_back(-2147483647 - 1);
+            v1.push_back(2147483647);
+            v2 = v1;
+            HxSTL::radix_sort(v1.begin(), v1.end());
+            HxSTL::sort(v2.begin(), v2.end());
+            assert(v1 == v2);
+        }
+
+        { // small char short
+            signed char a1[] = { 3, -1, 127, -128, 0, 5, -7 };
+            HxSTL::radix_sort(a1, a1 + 7);
+            assert(HxSTL::is_sorted(a1, a1 + 7));
+
+            HxSTL::vector<short> v1;
+            for (int i = 0; i < 1000; ++i) {
+                v1.push_back(static_cast<short>(next_random(seed)));
+            }
+            HxSTL::radix_sort(v1.begin(), v1.end());
+            assert(HxSTL::is_sorted(v1.begin(), v1.end()));
+
+            HxSTL::vector<int> v2;
+            HxSTL::radix_sort(v2.begin(), v2.end());
+            assert(v2.empty());
+        }
+
+        { // deque
+            HxSTL::deque<unsigned> d1;
+            for (int i = 0; i < 5000; ++i) {
+                d1.push_back(static_cast<unsigned>(next_random(seed)));
+            }
+            HxSTL::radix_sort(d1.begin(), d1.end());
+            assert(HxSTL::is_sorted(d1.begin(), d1.end()));
+        }
+    }
+
+    { // floating point
+        HxSTL::vector<double> v1, v2;
+        for (int i = 0; i < 20000; ++i) {
+            v1.push_back((static_cast<double>(next_random(seed) % 2000000) - 1000000) / 7.0);
+        }
+        v1.push_back(-1e300);
+        v1.push_back(1e300);
+        v1.push_back(0.0);
+        v2 = v1;
+        HxSTL::radix_sort(v1.begin(), v1.end());
+        HxSTL::sort(v2.begin(), v2.end());
+        assert(v1 == v2);
+
+        float a1[] = { 1.5f, -2.25f, 0.0f, -0.5f, 3.0f, -100.0f };
+        HxSTL::radix_sort(a1, a1 + 6);
+        assert(a1[0] == -100.0f && a1[1] == -2.25f && a1[2] == -0.5f && a1[5] == 3.0f);
+    }
+
+    { // key function, 稳定
+        HxSTL::vector<record> v1, v2;
+        for (int i = 0; i < 30000; ++i) {
+            record r = { static_cast<int>(next_random(seed) % 100) - 50, i };
+            v1.push_back(r);
+        }
+        v2 = v1;
+        HxSTL::radix_sort(v1.begin(), v1.end(), record_key());
+        HxSTL::sort(v2.begin(), v2.end(), record_less());
+        for (size_t i = 0; i < v1.size(); ++i) {
+            assert(v1[i].key == v2[i].key && v1[i].order == v2[i].order);
+        }
+
+        HxSTL::vector<record> v3(v2.begin(), v2.begin() + 40);
+        HxSTL::radix_sort(v3.begin(), v3.end(), [](const record& r) { return -r.key; });
+        for (size_t i = 1; i < v3.size(); ++i) {
+            assert(v3[i - 1].key > v3[i].key || (v3[i - 1].key == v3[i].key && v3[i - 1].order < v3[i].order));
+        }
+    }
+
+    { // 不可平凡复制的负载
+        HxSTL::vector<named_record> v1;
+        for (int i = 0; i < 2000; ++i) {
+            named_record r = { static_cast<int>(next_random(seed) % 100000), string("name") };
+            r.name += static_cast<char>('a' + r.key % 26);
+            v1.push_back(r);
+        }
+        HxSTL::vector<named_record> v2(v1);
+        HxSTL::radix_sort(v1.begin(), v1.end(), named_record_key());
+        HxSTL::radix_sort(HxSTL::execution::par, v2.begin(), v2.end(), named_record_key());
+        for (size_t i = 0; i < v1.size(); ++i) {
+            assert(i == 0 || v1[i - 1].key <= v1[i].key);
+            assert(v1[i].name.size() == 5 && v1[i].name[4] == 'a' + v1[i].key % 26);
+            assert(v2[i].key == v1[i].key && v2[i].name == v1[i].name);
+        }
+
+        // 移动构造到缓冲区的中途抛出异常, 已构造的元素都被析构
+        {
+            HxSTL::vector<throwing_record> v3;
+            for (int i = 0; i < 1000; ++i) {
+                v3.push_back(throwing_record(static_cast<int>(next_random(seed) % 1000)));
+            }
+            int live = throwing_record::live;
+            throwing_record::moves = 0;
+            throwing_record::limit = 500;
+            bool thrown = false;
+            try {
+                HxSTL::radix_sort(v3.begin(), v3.end(), [](const throwing_record& r) { return r.key; });
+            } catch (int) {
+                thrown = true;
+            }
+            throwing_record::limit = 0;
+            assert(thrown && throwing_record::live == live);
+        }
+        assert(throwing_record::live == 0);
+    }
+
+    { // string
+        HxSTL::vector<string> v1, v2;
+        const char* words[] = { "", "a", "ab", "abc", "abd", "b", "ba", "\xe9t\xe9", "zzz", "prefix_common_" };
+        for (int i = 0; i < 20000; ++i) {
+            string s(words[next_random(seed) % 10]);
+            for (int k = next_random(seed) % 4; k > 0; --k) {
+                s += static_cast<char>('a' + next_random(seed) % 3);
+            }
+            v1.push_back(s);
+        }
+        v2 = v1;
+        HxSTL::radix_sort(v1.begin(), v1.end());
+        HxSTL::sort(v2.begin(), v2.end());
+        assert(v1 == v2);
+
+        HxSTL::vector<string> v3(100, string("same"));
+        HxSTL::radix_sort(v3.begin(), v3.end());
+        assert(v3[0] == string("same") && v3[99] == string("same"));
+    }
+
+    { // execution policy
+        HxSTL::vector<uint32_t> v1, v2;
+        for (int i = 0; i < 300000; ++i) {
+            v1.push_back(static_cast<uint32_t>(next_random(seed)));
+        }
+        v2 = v1;
+        HxSTL::radix_sort(HxSTL::execution::par, v1.begin(), v1.end());
+        HxSTL::sort(v2.begin(), v2.end());
+        assert(v1 == v2);
+
+        HxSTL::vector<record> v3, v4;
+        for (int i = 0; i < 100000; ++i) {
+            record r = { static_cast<int>(next_random(seed) % 1000), i };
+            v3.push_back(r);
+        }
+        v4 = v3;
+        HxSTL::radix_sort(HxSTL::execution::par, v3.begin(), v3.end(), record_key());
+        HxSTL::sort(v4.begin(), v4.end(), record_less());
+        for (size_t i = 0; i < v3.size(); ++i) {
+            assert(v3[i].key == v4[i].key && v3[i].order == v4[i].order);
+        }
+
+        HxSTL::vector<string> v5, v6;
+        for (int i = 0; i < 50000; ++i) {
+            string s;
+            for (int k = next_random(seed) % 8; k > 0; --k) {
+                s += static_cast<char>('a' + next_random(seed) % 26);
+            }
+            v5.push_back(s);
+        }
+        v6 = v5;
+        HxSTL::radix_sort(HxSTL::execution::par, v5.begin(), v5.end());
+        HxSTL::sort(v6.begin(), v6.end());
+        assert(v5 == v6);
+
+        HxSTL::deque<int> d1(v1.begin(), v1.begin() + 1000);
+        HxSTL::radix_sort(HxSTL::execution::seq, d1.begin(), d1.end());
+        assert(HxSTL::is_sorted(d1.begin(), d1.end()));
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
@@ -0,0 +1,292 @@
+#include <cstdio>
+#include <cassert>
+#include <stdint.h>
+#include "random.h"
+#include "execution.h"
+#include "deque.h"
+#include "list.h"
+#include "basic_string.h"
+
+typedef HxSTL::basic_string<char> string;
+
+// 值域不是 2 的幂的引擎 (minstd_rand), 走通用路径
+struct minstd {
+    typedef uint32_t result_type;
+    uint64_t state;
+    explicit minstd(uint64_t s = 1): state(s) {}
+    static constexpr result_type min() { return 1; }
+    static constexpr result_type max() { return 2147483646; }
+    result_type operator()() {
+        state = state * 48271 % 2147483647;
+        return static_cast<result_type>(state);
+    }
+};
+
+// 只能遍历一次的迭代器
+struct input_counter {
+    typedef HxSTL::input_iterator_tag iterator_category;
+    typedef int value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const int* pointer;
+    typedef const int& reference;
+    int value;
+    explicit input_counter(int v): value(v) {}
+    const int& operator*() const { return value; }
+    input_counter& operator++() { ++value; return *this; }
+    bool operator!=(const input_counter& other) const { return value != other.value; }
+    bool operator==(const input_counter& other) const { return value == other.value; }
+};
+
+// counts 中每一项与期望的偏差都在 6 个标准差以内
+bool roughly_uniform(const HxSTL::vector<long>& counts, double p, long trials) {
+    double expected = p * trials;
+    double sigma = __builtin_sqrt(trials * p * (1 - p));
+    for (size_t i = 0; i < counts.size(); ++i) {
+        double d = counts[i] - expected;
+        if (d > 6 * sigma || d < -6 * sigma) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+
+    { // engines
+        HxSTL::splitmix64 s1(0);
+        assert(s1() == 0xe220a8397b1dcdafULL);
+        assert(s1() == 0x6e789e6aa1b965f4ULL);
+        HxSTL::splitmix64 s2(0);
+        s2.discard(2);
+        assert(s1 == s2);
+
+        HxSTL::xoshiro256starstar x1(12345);
+        assert(x1() == 0xbe6a36374160d49bULL);
+        assert(x1() == 0x214aaa0637a688c6ULL);
+        assert(x1() == 0xf69d16de9954d388ULL);
+
+        HxSTL::xoshiro256starstar x2(12345), x3(12345);
+        x2.jump();
+        assert(x2 != x3);
+        x3.jump();
+        assert(x2 == x3 && x2() == x3());
+        x3.long_jump();
+        assert(x2 != x3);
+        x2.discard(5);
+        x3.seed(12345);
+        x3.discard(3);
+        x3.seed(12345);
+        assert(x3() == 0xbe6a36374160d49bULL);
+
+        // pcg32-demo 的参考输出
+        HxSTL::pcg32 p1(42, 54);
+        const uint32_t expected[] = { 0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e };
+        for (int i = 0; i < 6; ++i) {
+            assert(p1() == expected[i]);
+        }
+        HxSTL::pcg32 p2(42, 54), p3(42, 54);
+        for (int i = 0; i < 100000; ++i) {
+            p2();
+        }
+        p3.discard(100000);
+        assert(p2 == p3 && p2() == p3());
+        assert(HxSTL::pcg32(42, 54) != HxSTL::pcg32(42, 55));
+
+        HxSTL::default_random_engine e1, e2;
+        assert(e1() == e2());
+    }
+
+    { // uniform_int_distribution
+        HxSTL::xoshiro256starstar x1(1);
+        HxSTL::pcg32 p1(1);
+        minstd m1(1);
+
+        HxSTL::uniform_int_distribution<int> d1(-3, 3);
+        HxSTL::vector<long> c1(7, 0), c2(7, 0), c3(7, 0);
+        const long trials = 70000;
+        for (long i = 0; i < trials; ++i) {
+            int a = d1(x1), b = d1(p1), c = d1(m1);
+            assert(a >= -3 && a <= 3 && b >= -3 && b <= 3 && c >= -3 && c <= 3);
+            ++c1[a + 3];
+            ++c2[b + 3];
+            ++c3[c + 3];
+        }
+        assert(roughly_uniform(c1, 1.0 / 7, trials));
+        assert(roughly_uniform(c2, 1.0 / 7, trials));
+        assert(roughly_uniform(c3, 1.0 / 7, trials));
+
+        HxSTL::uniform_int_distribution<int> d2(5, 5);
+        assert(d2(x1) == 5 && d2(p1) == 5 && d2(m1) == 5);
+
+        // 全范围
+        HxSTL::uniform_int_distribution<long long> d3(-9223372036854775807LL - 1, 9223372036854775807LL);
+        bool negative = false, positive = false;
+        for (int i = 0; i < 100; ++i) {
+            long long a = d3(x1), b = d3(p1), c = d3(m1);
+            negative = negative || a < 0 || b < 0 || c < 0;
+            positive = positive || a > 0 || b > 0 || c > 0;
+        }
+        assert(negative && positive);
+
+        // 32 位与非 2 的幂的引擎拼出超过 2^32 的值域, 高位也均匀
+        HxSTL::uniform_int_distribution<uint64_t> d4(0, (1ULL << 40) - 1);
+        HxSTL::vector<long> c4(4, 0), c5(4, 0);
+        for (long i = 0; i < 40000; ++i) {
+            uint64_t a = d4(p1), b = d4(m1);
+            assert(a < (1ULL << 40) && b < (1ULL << 40));
+            ++c4[a >> 38];
+            ++c5[b >> 38];
+        }
+        assert(roughly_uniform(c4, 0.25, 40000));
+        assert(roughly_uniform(c5, 0.25, 40000));
+
+        HxSTL::uniform_int_distribution<unsigned char> d5(250, 255);
+        for (int i = 0; i < 100; ++i) {
+            unsigned char v = d5(x1);
+            assert(v >= 250);
+        }
+    }
+
+    { // shuffle random_shuffle
+        HxSTL::xoshiro256starstar g(7);
+
+        HxSTL::vector<int> v1;
+        for (int i = 0; i < 10000; ++i) {
+            v1.push_back(i);
+        }
+        HxSTL::vector<int> v2(v1);
+        HxSTL::shuffle(v2.begin(), v2.end(), g);
+        assert(v1 != v2);
+        HxSTL::sort(v2.begin(), v2.end());
+        assert(v1 == v2);
+
+        HxSTL::random_shuffle(v2.begin(), v2.end());
+        assert(v1 != v2);
+        HxSTL::sort(v2.begin(), v2.end());
+        assert(v1 == v2);
+
+        HxSTL::pcg32 p(3);
+        HxSTL::random_shuffle(v2.begin(), v2.end(), [&p](ptrdiff_t n) {
+            return static_cast<ptrdiff_t>(HxSTL::__random_uniform(p, n - 1));
+        });
+        HxSTL::sort(v2.begin(), v2.end());
+        assert(v1 == v2);
+
+        // 3 个元素的 6 种排列出现的次数相近
+        HxSTL::vector<long> counts(6, 0);
+        const long trials = 60000;
+        for (long t = 0; t < trials; ++t) {
+            int a[] = { 0, 1, 2 };
+            HxSTL::shuffle(a, a + 3, p);
+            ++counts[a[0] * 2 + (a[1] > a[2] ? 1 : 0)];
+        }
+        assert(roughly_uniform(counts, 1.0 / 6, trials));
+
+        HxSTL::deque<string> d1;
+        for (int i = 0; i < 1000; ++i) {
+            d1.push_back(string(1 + i % 5, static_cast<char>('a' + i % 26)));
+        }
+        HxSTL::deque<string> d2(d1);
+        HxSTL::shuffle(d2.begin(), d2.end(), HxSTL::xoshiro256starstar(1));
+        HxSTL::sort(d1.begin(), d1.end());
+        HxSTL::sort(d2.begin(), d2.end());
+        assert(d1 == d2);
+
+        int e[1];
+        HxSTL::shuffle(e, e, g);
+        HxSTL::random_shuffle(e, e);
+    }
+
+    { // sample
+        HxSTL::xoshiro256starstar g(11);
+        HxSTL::list<int> l1;
+        for (int i = 0; i < 20; ++i) {
+            l1.push_back(i);
+        }
+        HxSTL::vector<long> counts(20, 0);
+        const long trials = 20000;
+        for (long t = 0; t < trials; ++t) {
+            int out[5];
+            int* end = HxSTL::sample(l1.begin(), l1.end(), out, 5, g);
+            assert(end == out + 5);
+            // 选择抽样保持原有顺序
+            for (int k = 1; k < 5; ++k) {
+                assert(out[k - 1] < out[k]);
+            }
+            for (int k = 0; k < 5; ++k) {
+                ++counts[out[k]];
+            }
+        }
+        assert(roughly_uniform(counts, 0.25, trials));
+
+        HxSTL::vector<long> counts2(20, 0);
+        for (long t = 0; t < trials; ++t) {
+            HxSTL::vector<int> out(5);
+            HxSTL::vector<int>::iterator end = HxSTL::sample(input_counter(0), input_counter(20), out.begin(), 5, g);
+            assert(end == out.end());
+            HxSTL::sort(out.begin(), out.end());
+            for (int k = 1; k < 5; ++k) {
+                assert(out[k - 1] < out[k]);
+            }
+            for (int k = 0; k < 5; ++k) {
+                ++counts2[out[k]];
+            }
+        }
+        assert(roughly_uniform(counts2, 0.25, trials));
+
+        // 名额多于元素时全部取出
+        HxSTL::vector<int> out(30, -1);
+        assert(HxSTL::sample(l1.begin(), l1.end(), out.begin(), 30, g) == out.begin() + 20);
+        assert(out[0] == 0 && out[19] == 19 && out[20] == -1);
+        assert(HxSTL::sample(input_counter(0), input_counter(3), out.begin(), 30, g) == out.begin() + 3);
+        assert(HxSTL::sample(l1.begin(), l1.end(), out.begin(), 0, g) == out.begin());
+    }
+
+    { // execution policy
+        const int n = 300000;
+        HxSTL::vector<int> v1;
+        for (int i = 0; i < n; ++i) {
+            v1.push_back(i);
+        }
+        HxSTL::vector<int> v2(v1), v3(v1);
+        HxSTL::shuffle(HxSTL::execution::par, v2.begin(), v2.end(), HxSTL::xoshiro256starstar(5));
+        HxSTL::shuffle(HxSTL::execution::par, v3.begin(), v3.end(), HxSTL::xoshiro256starstar(5));
+        assert(v2 == v3);
+        assert(v1 != v2);
+        HxSTL::sort(v2.begin(), v2.end());
+        assert(v1 == v2);
+
+        // 第一个元素的去向在 10 个区段之间均匀
+        HxSTL::pcg32 p(9);
+        HxSTL::vector<long> counts(10, 0);
+        const long trials = 200;
+        HxSTL::vector<int> v4(50000);
+        for (long t = 0; t < trials; ++t) {
+            for (int i = 0; i < 50000; ++i) {
+                v4[i] = i;
+            }
+            HxSTL::shuffle(HxSTL::execution::par_unseq, v4.begin(), v4.end(), p);
+            ++counts[(HxSTL::find(v4.begin(), v4.end(), 0) - v4.begin()) / 5000];
+        }
+        assert(roughly_uniform(counts, 0.1, trials));
+
+        HxSTL::vector<string> s1;
+        for (int i = 0; i < 20000; ++i) {
+            s1.push_back(string(1 + i % 7, static_cast<char>('a' + i % 26)));
+        }
+        HxSTL::vector<string> s2(s1);
+        HxSTL::shuffle(HxSTL::execution::par, s2.begin(), s2.end(), p);
+        HxSTL::sort(s1.begin(), s1.end());
+        HxSTL::sort(s2.begin(), s2.end());
+        assert(s1 == s2);
+
+        HxSTL::deque<int> d1(v1.begin(), v1.begin() + 10000);
+        HxSTL::shuffle(HxSTL::execution::seq, d1.begin(), d1.end(), p);
+        HxSTL::sort(d1.begin(), d1.end());
+        assert(HxSTL::equal(d1.begin(), d1.end(), v1.begin()));
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
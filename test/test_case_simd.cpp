@@ -0,0 +1,114 @@
+#include <cstdio>
+#include <cassert>
+#include <stdint.h>
+#include "vector.h"
+#include "deque.h"
+
+// 每种长度, 目标出现在每个位置上, 结果与逐个比较一致
+template <class T>
+void check_type() {
+    for (int n = 0; n < 140; ++n) {
+        HxSTL::vector<T> v(n, T(1));
+        T* first = v.begin();
+        T* last = v.end();
+        assert(HxSTL::find(first, last, T(2)) == last);
+        assert(HxSTL::count(first, last, T(1)) == n);
+        assert(HxSTL::min_element(first, last) == first);
+        assert(HxSTL::max_element(first, last) == first);
+        for (int i = 0; i < n; ++i) {
+            v[i] = T(2);
+            assert(HxSTL::find(first, last, T(2)) == first + i);
+            assert(HxSTL::count(first, last, T(2)) == 1);
+            assert(HxSTL::max_element(first, last) == first + i);
+            HxSTL::vector<T> w(v);
+            w[n - 1 - i / 2] = T(3);
+            HxSTL::pair<T*, T*> p = HxSTL::mismatch(first, last, w.begin());
+            assert(p.first - first == (v[n - 1 - i / 2] == T(3) ? n : n - 1 - i / 2));
+            assert(HxSTL::equal(first, last, w.begin()) == (p.first == last));
+            v[i] = T(0);
+            assert(HxSTL::min_element(first, last) == first + i);
+            v[i] = T(1);
+        }
+        HxSTL::fill(first, last, T(5));
+        assert(HxSTL::count(first, last, T(5)) == n);
+    }
+
+    // 最小值多次出现时返回第一个
+    HxSTL::vector<T> v(1000, T(7));
+    v[300] = T(4);
+    v[700] = T(4);
+    v[500] = T(9);
+    v[900] = T(9);
+    const HxSTL::vector<T>& cv = v;
+    assert(HxSTL::min_element(cv.begin(), cv.end()) == cv.begin() + 300);
+    assert(HxSTL::max_element(cv.begin(), cv.end()) == cv.begin() + 500);
+    assert(HxSTL::find(cv.begin(), cv.end(), T(9)) == cv.begin() + 500);
+}
+
+int main() {
+
+    { // 各种元素类型
+        check_type<char>();
+        check_type<signed char>();
+        check_type<unsigned char>();
+        check_type<short>();
+        check_type<unsigned short>();
+        check_type<int>();
+        check_type<unsigned>();
+        check_type<long long>();
+        check_type<uint64_t>();
+        check_type<float>();
+        check_type<double>();
+    }
+
+    { // 窄通道的计数超过 255
+        HxSTL::vector<char> v(100000, 'a');
+        v[5] = 'b';
+        assert(HxSTL::count(v.begin(), v.end(), 'a') == 99999);
+        HxSTL::vector<short> w(200000, 3);
+        assert(HxSTL::count(w.begin(), w.end(), short(3)) == 200000);
+    }
+
+    { // 值与元素类型不同: 按原来的转换规则比较
+        HxSTL::vector<unsigned char> v(100, 44);
+        assert(HxSTL::find(v.begin(), v.end(), 300) == v.end());    // 300 不能表示为 unsigned char
+        assert(HxSTL::count(v.begin(), v.end(), 44L) == 100);
+
+        HxSTL::vector<unsigned> w(100, 0xFFFFFFFFu);
+        assert(HxSTL::count(w.begin(), w.end(), -1) == 100);       // -1 转换为 unsigned
+        HxSTL::vector<int> x(100, -1);
+        assert(HxSTL::find(x.begin(), x.end(), 0xFFFFFFFFu) == x.begin());
+        assert(HxSTL::find(x.begin(), x.end(), -1LL) == x.begin());
+        assert(HxSTL::find(x.begin(), x.end(), 4294967295LL) == x.end());
+
+        HxSTL::vector<double> d(100, 0.0);
+        HxSTL::fill(d.begin(), d.end(), 3);
+        assert(d[0] == 3.0 && d[99] == 3.0);
+        HxSTL::vector<char> c(50, 0);
+        HxSTL::fill(c.begin(), c.end(), 'z');
+        assert(c[0] == 'z' && c[49] == 'z');
+    }
+
+    { // 浮点数: 0.0 等于 -0.0, NaN 不等于自身
+        HxSTL::vector<double> v1(100, 0.0), v2(100, -0.0);
+        assert(HxSTL::equal(v1.begin(), v1.end(), v2.begin()));
+        assert(HxSTL::find(v2.begin(), v2.end(), 0.0) == v2.begin());
+        v1[60] = v2[60] = 0.0 / 0.0;
+        assert(!HxSTL::equal(v1.begin(), v1.end(), v2.begin()));
+        assert(HxSTL::mismatch(v1.begin(), v1.end(), v2.begin()).first == v1.begin() + 60);
+        assert(HxSTL::find(v1.begin(), v1.end(), v1[60]) == v1.end());
+        assert(HxSTL::count(v1.begin(), v1.end(), 0.0) == 99);
+    }
+
+    { // 非指针迭代器不受影响
+        HxSTL::deque<int> d(1000, 1);
+        d[777] = 0;
+        assert(HxSTL::find(d.begin(), d.end(), 0) - d.begin() == 777);
+        assert(HxSTL::min_element(d.begin(), d.end()) - d.begin() == 777);
+        assert(HxSTL::count(d.begin(), d.end(), 1) == 999);
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
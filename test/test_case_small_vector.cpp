@@ -0,0 +1,264 @@
+#include <cstdio>
+#include <cassert>
+#include "small_vector.h"
+#include "basic_string.h"
+
+typedef HxSTL::basic_string<char> string;
+
+// 记录未归还的堆块数
+int blocks = 0;
+
+template <class T>
+struct counting_allocator: public HxSTL::allocator<T> {
+    template <class U>
+    struct rebind {
+        typedef counting_allocator<U> other;
+    };
+
+    T* allocate(size_t n) {
+        ++blocks;
+        return HxSTL::allocator<T>::allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        --blocks;
+        HxSTL::allocator<T>::deallocate(p, n);
+    }
+};
+
+// 构造参数为负数时抛出
+struct fragile {
+    int v;
+    fragile(int x): v(x) { if (x < 0) throw x; }
+};
+
+int main() {
+
+    { // member
+
+        { // constructor
+
+            HxSTL::small_vector<int, 4> v1;
+            HxSTL::small_vector<int, 4> v2(3, 7);
+            HxSTL::small_vector<int, 4> v3(10, 1);
+            HxSTL::small_vector<int, 4> v4({ 1, 2, 3 });
+            HxSTL::small_vector<int, 4> v5(v3);
+
+            assert(v1.empty() && v1.capacity() == 4 && v1.is_small());
+            assert(v2.size() == 3 && v2[2] == 7 && v2.is_small());
+            assert(v3.size() == 10 && !v3.is_small());
+            assert(v4.size() == 3 && v4[0] == 1 && v4[2] == 3);
+            assert(v5 == v3);
+
+        }
+
+        { // move constructor
+
+            HxSTL::small_vector<string, 2> v1({ "a", "b" });
+            HxSTL::small_vector<string, 2> v2(HxSTL::move(v1));
+
+            assert(v1.empty() && v1.is_small());
+            assert(v2.size() == 2 && v2[1] == string("b") && v2.is_small());
+
+            HxSTL::small_vector<string, 2> v3({ "a", "b", "c" });
+            const string* p = v3.data();
+            HxSTL::small_vector<string, 2> v4(HxSTL::move(v3));
+
+            assert(v3.empty() && v3.is_small());
+            assert(v4.data() == p && v4[2] == string("c"));
+
+        }
+
+        { // assignment
+
+            HxSTL::small_vector<int, 4> v1({ 1, 2 });
+            HxSTL::small_vector<int, 4> v2({ 1, 2, 3, 4, 5, 6 });
+
+            v1 = v2;
+            assert(v1 == v2);
+
+            v2 = { 9 };
+            assert(v2.size() == 1 && v2[0] == 9);
+
+            v1 = HxSTL::move(v2);
+            assert(v1.size() == 1 && v1[0] == 9);
+
+            v1.assign(6, 3);
+            assert(v1.size() == 6 && v1[5] == 3);
+
+        }
+
+        { // vector conversion
+
+            HxSTL::vector<int> a1({ 1, 2, 3, 4, 5 });
+            HxSTL::small_vector<int, 8> v1(a1);
+            HxSTL::vector<int> a2 = v1;
+
+            assert(v1.size() == 5 && v1.is_small());
+            assert(a1 == a2);
+
+            HxSTL::small_vector<int, 2> v2(HxSTL::move(a1));
+
+            assert(a1.empty());
+            assert(v2.size() == 5 && v2[4] == 5);
+
+        }
+
+        { // at front back
+
+            HxSTL::small_vector<int, 4> v1({ 1, 2, 3 });
+
+            assert(v1.front() == 1 && v1.back() == 3 && v1.at(1) == 2);
+
+            bool except = false;
+            try {
+                v1.at(3);
+            } catch (HxSTL::out_of_range) {
+                except = true;
+            }
+            assert(except);
+
+        }
+
+        { // push_back emplace_back pop_back
+
+            HxSTL::small_vector<int, 8> v1;
+
+            for (int i = 0; i != 8; ++i) {
+                v1.push_back(i);
+            }
+            assert(v1.is_small() && v1.capacity() == 8);
+
+            v1.emplace_back(8);
+            assert(!v1.is_small() && v1.size() == 9);
+
+            for (int i = 0; i != 9; ++i) {
+                assert(v1[i] == i);
+            }
+
+            v1.pop_back();
+            assert(v1.size() == 8 && v1.back() == 7);
+
+            // 引用自身元素
+            HxSTL::small_vector<string, 2> v2({ "x", "y" });
+            v2.push_back(v2[0]);
+            assert(v2.size() == 3 && v2[2] == string("x"));
+
+            // 扩容时元素构造抛出, 新申请的堆块需要归还
+            {
+                HxSTL::small_vector<fragile, 2, counting_allocator<fragile>> v3;
+                v3.emplace_back(1);
+                v3.emplace_back(2);
+                for (int k = 0; k != 2; ++k) {
+                    bool caught = false;
+                    try {
+                        v3.emplace_back(-1);
+                    } catch (int) {
+                        caught = true;
+                    }
+                    assert(caught && blocks == 0);
+                    assert(v3.size() == 2 && v3[1].v == 2 && v3.is_small());
+                }
+
+                HxSTL::small_vector<string, 2, counting_allocator<string>> v4({ "a", "b" });
+                assert(blocks == 0);
+                v4.emplace(v4.begin() + 1, "c");
+                assert(blocks == 1 && v4.size() == 3 && v4[1] == string("c"));
+            }
+            assert(blocks == 0);
+
+        }
+
+        { // insert
+
+            HxSTL::small_vector<int, 4> v1({ 1, 4 });
+
+            v1.insert(v1.begin() + 1, 2);
+            v1.insert(v1.begin() + 2, 3);
+            assert((v1 == HxSTL::small_vector<int, 4>({ 1, 2, 3, 4 })));
+
+            v1.insert(v1.begin(), 2, 0);
+            assert((v1 == HxSTL::small_vector<int, 4>({ 0, 0, 1, 2, 3, 4 })));
+
+            int a1[] = { 7, 8, 9 };
+            v1.insert(v1.end(), a1, a1 + 3);
+            assert(v1.size() == 9 && v1[8] == 9);
+
+            v1.insert(v1.begin() + 1, { 5, 5 });
+            assert(v1.size() == 11 && v1[1] == 5 && v1[3] == 0);
+
+            HxSTL::small_vector<string, 4> v2({ "a", "c" });
+            v2.insert(v2.begin() + 1, "b");
+            v2.insert(v2.begin(), 2, v2[2]);
+            assert(v2.size() == 5 && v2[0] == string("c") && v2[1] == string("c") && v2[3] == string("b"));
+
+        }
+
+        { // erase clear
+
+            HxSTL::small_vector<string, 2> v1({ "a", "b", "c", "d" });
+
+            assert(*v1.erase(v1.begin()) == string("b"));
+            assert(v1.erase(v1.begin() + 1, v1.end()) == v1.end());
+            assert(v1.size() == 1 && v1[0] == string("b"));
+
+            v1.clear();
+            assert(v1.empty());
+
+        }
+
+        { // reserve shrink_to_fit resize
+
+            HxSTL::small_vector<int, 4> v1({ 1, 2 });
+
+            v1.reserve(100);
+            assert(v1.capacity() == 100 && !v1.is_small());
+
+            v1.shrink_to_fit();
+            assert(v1.is_small() && v1.size() == 2 && v1[1] == 2);
+
+            v1.resize(10, 5);
+            assert(v1.size() == 10 && v1[9] == 5);
+
+            v1.resize(3);
+            assert(v1.size() == 3 && v1[2] == 5);
+
+        }
+
+        { // swap
+
+            HxSTL::small_vector<string, 2> v1({ "a" });
+            HxSTL::small_vector<string, 2> v2({ "b", "c", "d" });
+            HxSTL::small_vector<string, 2> v3({ "e", "f", "g" });
+
+            v1.swap(v2);
+            assert(v1.size() == 3 && v1[0] == string("b"));
+            assert(v2.size() == 1 && v2[0] == string("a"));
+
+            HxSTL::swap(v1, v3);
+            assert(v1[0] == string("e") && v3[2] == string("d"));
+
+        }
+
+    }
+
+    { // non-member
+
+        { // operator== operator< ...
+
+            HxSTL::small_vector<int, 2> v1({ 1, 2, 3 });
+            HxSTL::small_vector<int, 2> v2({ 1, 2, 4 });
+
+            assert(v1 != v2);
+            assert(v1 < v2 && v1 <= v2);
+            assert(v2 > v1 && v2 >= v1);
+            assert(!(v1 >= v2));
+
+        }
+
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
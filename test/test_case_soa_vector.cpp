@@ -0,0 +1,141 @@
+#include <cstdio>
+#include <cassert>
+#include "soa_vector.h"
+#include "basic_string.h"
+
+typedef HxSTL::basic_string<char> string;
+
+struct throw_on_copy {
+    throw_on_copy() {}
+    throw_on_copy(const throw_on_copy&) { throw 1; }
+};
+
+int main() {
+
+    { // member
+
+        { // push_back emplace_back
+
+            HxSTL::soa_vector<float, int, string> v1;
+
+            assert(v1.empty());
+
+            v1.push_back(1.5f, 1, string("a"));
+            v1.emplace_back(2.5f, 2, "b");
+            v1.emplace_back(3.5f, 3, "cc");
+
+            assert(v1.size() == 3);
+            assert(v1.get<0>(0) == 1.5f && v1.get<1>(1) == 2 && v1.get<2>(2) == string("cc"));
+
+            v1.pop_back();
+            assert(v1.size() == 2 && v1.get<2>(1) == string("b"));
+
+        }
+
+        { // operator[] at
+
+            HxSTL::soa_vector<int, double> v1;
+
+            v1.push_back(1, 0.5);
+            v1.push_back(2, 1.5);
+
+            HxSTL::soa_vector<int, double>::reference r = v1[1];
+            r.get<0>() = 20;
+            assert(v1.get<0>(1) == 20 && r.get<1>() == 1.5 && r.index() == 1);
+
+            const HxSTL::soa_vector<int, double>& cv = v1;
+            assert(cv[0].get<1>() == 0.5);
+            assert(cv.at(1).get<0>() == 20);
+
+            bool except = false;
+            try {
+                v1.at(2);
+            } catch (HxSTL::out_of_range) {
+                except = true;
+            }
+            assert(except);
+
+        }
+
+        { // column
+
+            HxSTL::soa_vector<float, float, int> v1;
+
+            for (int i = 0; i != 1000; ++i) {
+                v1.push_back(float(i), 1.0f, i);
+            }
+
+            HxSTL::soa_span<float> x = v1.column<0>();
+            HxSTL::soa_span<float> dx = v1.column<1>();
+            assert(x.size() == 1000 && x.data() == v1.data<0>());
+
+            for (size_t i = 0; i != x.size(); ++i) {
+                x[i] += dx[i];
+            }
+
+            float sum = 0;
+            for (float f: v1.column<0>()) {
+                sum += f;
+            }
+            assert(sum == 500500.0f);
+
+            const HxSTL::soa_vector<float, float, int>& cv = v1;
+            HxSTL::soa_span<const int> id = cv.column<2>();
+            assert(id[999] == 999 && *(id.end() - 1) == 999);
+
+        }
+
+        { // reserve resize clear shrink_to_fit
+
+            HxSTL::soa_vector<int, string> v1(3);
+
+            assert(v1.size() == 3 && v1.get<1>(2).empty());
+
+            v1.reserve(100);
+            assert(v1.capacity() >= 100 && v1.size() == 3);
+
+            v1.resize(10);
+            assert(v1.size() == 10 && v1.get<0>(9) == 0);
+
+            v1.resize(2);
+            assert(v1.size() == 2);
+
+            v1.clear();
+            v1.shrink_to_fit();
+            assert(v1.empty());
+
+        }
+
+        { // swap
+
+            HxSTL::soa_vector<int, char> v1;
+            HxSTL::soa_vector<int, char> v2;
+
+            v1.push_back(1, 'a');
+            HxSTL::swap(v1, v2);
+            assert(v1.empty() && v2.size() == 1 && v2.get<1>(0) == 'a');
+
+        }
+
+        { // exception
+
+            // 后面的列构造失败时各列仍然等长
+            HxSTL::soa_vector<int, throw_on_copy> v1;
+            throw_on_copy t;
+
+            bool except = false;
+            try {
+                v1.push_back(1, t);
+            } catch (int) {
+                except = true;
+            }
+            assert(except && v1.empty() && v1.column<0>().empty());
+
+        }
+
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
@@ -0,0 +1,191 @@
+#include <cstdio>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include "thread_pool.h"
+
+long fib(HxSTL::thread_pool& pool, int n) {
+    if (n < 12) {
+        return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    }
+    long x = 0, y = 0;
+    HxSTL::task_group group(pool);
+    group.spawn([&pool, &x, n]() { x = fib(pool, n - 1); });
+    y = fib(pool, n - 2);
+    group.wait();
+    return x + y;
+}
+
+int main() {
+
+    { // work stealing deque
+
+        { // push pop steal
+            HxSTL::__work_stealing_deque<int> q(2);
+            int a[100];
+
+            assert(q.empty() && q.pop() == nullptr && q.steal() == nullptr);
+            for (int i = 0; i < 100; ++i) {
+                q.push(a + i);
+            }
+            assert(!q.empty());
+            assert(q.pop() == a + 99);      // 所属线程后进先出
+            assert(q.steal() == a);         // 窃取者先进先出
+            assert(q.steal() == a + 1);
+            for (int i = 98; i >= 2; --i) {
+                assert(q.pop() == a + i);
+            }
+            assert(q.pop() == nullptr && q.empty());
+        }
+
+        { // 所属线程 push / pop 的同时其它线程 steal, 每个元素恰好被取走一次
+            const int n = 200000;
+            HxSTL::__work_stealing_deque<int> q(4);
+            HxSTL::vector<int> items(n, 0);
+            HxSTL::vector<std::atomic<int>*> taken;
+            for (int i = 0; i < n; ++i) {
+                taken.push_back(new std::atomic<int>(0));
+            }
+            std::atomic<bool> done(false);
+            auto take = [&](int* x) { taken[x - items.data()]->fetch_add(1); };
+
+            HxSTL::vector<std::thread> thieves;
+            for (int t = 0; t < 3; ++t) {
+                thieves.push_back(std::thread([&]() {
+                    while (!done.load()) {
+                        int* x = q.steal();
+                        if (x != nullptr) {
+                            take(x);
+                        }
+                    }
+                }));
+            }
+            for (int i = 0; i < n; ++i) {
+                q.push(items.data() + i);
+                if (i % 3 == 0) {
+                    int* x = q.pop();
+                    if (x != nullptr) {
+                        take(x);
+                    }
+                }
+            }
+            for (int* x = q.pop(); x != nullptr; x = q.pop()) {
+                take(x);
+            }
+            done.store(true);
+            for (size_t t = 0; t < thieves.size(); ++t) {
+                thieves[t].join();
+            }
+            for (int i = 0; i < n; ++i) {
+                assert(taken[i]->load() == 1);
+                delete taken[i];
+            }
+        }
+    }
+
+    { // thread_pool
+
+        { // submit
+            std::atomic<int> count(0);
+            {
+                HxSTL::thread_pool pool(4);
+                assert(pool.size() == 4);
+                for (int i = 0; i < 1000; ++i) {
+                    pool.submit([&count]() { count.fetch_add(1); });
+                }
+            }
+            assert(count.load() == 1000);   // 析构前执行完所有任务
+        }
+
+        { // zero workers: 任务由等待的线程执行
+            HxSTL::thread_pool pool(0);
+            HxSTL::task_group group(pool);
+            int x = 0;
+            group.spawn([&x]() { x = 1; });
+            group.wait();
+            assert(x == 1);
+        }
+
+        { // try_run_one
+            HxSTL::thread_pool pool(0);
+            int x = 0;
+            pool.submit([&x]() { ++x; });
+            assert(pool.try_run_one() && x == 1);
+            assert(!pool.try_run_one());
+        }
+    }
+
+    { // task_group
+
+        { // nested spawn wait
+            HxSTL::thread_pool pool(4);
+            assert(fib(pool, 25) == 75025);
+        }
+
+        { // exception
+            HxSTL::thread_pool pool(2);
+            HxSTL::task_group group(pool);
+            std::atomic<int> count(0);
+            for (int i = 0; i < 100; ++i) {
+                group.spawn([&count, i]() {
+                    count.fetch_add(1);
+                    if (i == 50) {
+                        throw HxSTL::out_of_range();
+                    }
+                });
+            }
+            bool thrown = false;
+            try {
+                group.wait();
+            } catch (HxSTL::out_of_range&) {
+                thrown = true;
+            }
+            assert(thrown && count.load() == 100);
+            group.wait();   // 异常只抛出一次
+        }
+    }
+
+    { // parallel_for
+
+        { // 每个下标恰好访问一次
+            HxSTL::thread_pool pool(3);
+            const int n = 100000;
+            HxSTL::vector<int> v(n, 0);
+            pool.parallel_for(0, n, [&v](int i) { v[i] += i % 7; });
+            for (int i = 0; i < n; ++i) {
+                assert(v[i] == i % 7);
+            }
+
+            std::atomic<long> sum(0);
+            pool.parallel_for(size_t(10), size_t(1010), [&sum](size_t i) { sum.fetch_add(i); }, 16);
+            assert(sum.load() == (10 + 1009) * 1000 / 2);
+
+            int calls = 0;
+            pool.parallel_for(5, 5, [&calls](int) { ++calls; });
+            assert(calls == 0);
+        }
+
+        { // parallel_for_range 的块不小于 grain
+            HxSTL::thread_pool pool(2);
+            std::atomic<int> chunks(0);
+            std::atomic<int> total(0);
+            HxSTL::parallel_for_range(pool, 0, 1000, [&](int b, int e) {
+                assert(e - b >= 62 && e - b <= 125);
+                chunks.fetch_add(1);
+                total.fetch_add(e - b);
+            }, 125);
+            assert(chunks.load() == 8 && total.load() == 1000);
+        }
+
+        { // default pool
+            std::atomic<int> count(0);
+            HxSTL::parallel_for(0, 5000, [&count](int) { count.fetch_add(1); });
+            assert(count.load() == 5000);
+            assert(HxSTL::thread_pool::default_pool().size() == HxSTL::thread_pool::default_concurrency());
+        }
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
@@ -0,0 +1,84 @@
+#include <cstdio>
+#include <cassert>
+#include <stdint.h>
+#include "top_k.h"
+#include "thread_pool.h"
+#include "basic_string.h"
+
+typedef HxSTL::basic_string<char> string;
+
+uint64_t next_random(uint64_t& seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+int main() {
+
+    uint64_t seed = 88172645463325252ull;
+
+    { // 与排序后的前 k 个一致
+        HxSTL::vector<int> v1;
+        for (int i = 0; i < 100000; ++i) {
+            v1.push_back(static_cast<int>(next_random(seed) % 1000000));
+        }
+        HxSTL::vector<int> v2(v1);
+        HxSTL::sort(v2.begin(), v2.end(), HxSTL::greater<int>());
+
+        HxSTL::top_k<int> top(100);
+        assert(top.empty() && top.capacity() == 100);
+        top.push(v1.begin(), v1.end());
+        assert(top.size() == 100 && top.full());
+        assert(top.threshold() == v2[99]);
+        HxSTL::vector<int> v3 = top.sorted();
+        assert(HxSTL::equal(v3.begin(), v3.end(), v2.begin()));
+
+        // 自定义比较: 最小的 k 个
+        HxSTL::top_k<int, HxSTL::greater<int> > bottom(10);
+        bottom.push(v1.begin(), v1.end());
+        HxSTL::vector<int> v4 = bottom.sorted();
+        for (int i = 0; i < 10; ++i) {
+            assert(v4[i] == v2[v2.size() - 1 - i]);
+        }
+    }
+
+    { // 元素不足 k 个, k 为 0
+        HxSTL::top_k<string> top(5);
+        top.push(string("b"));
+        top.push(string("a"));
+        top.push(string("c"));
+        HxSTL::vector<string> v1 = top.sorted();
+        assert(v1.size() == 3 && v1[0] == string("c") && v1[2] == string("a"));
+        assert(!top.full() && top.threshold() == string("a"));
+        top.clear();
+        assert(top.empty());
+
+        HxSTL::top_k<int> none(0);
+        none.push(1);
+        assert(none.empty() && none.sorted().empty());
+    }
+
+    { // 各线程各自选择后合并
+        HxSTL::vector<int> v1;
+        for (int i = 0; i < 200000; ++i) {
+            v1.push_back(static_cast<int>(next_random(seed) % 1000000));
+        }
+        HxSTL::vector<HxSTL::top_k<int> > parts(8, HxSTL::top_k<int>(50));
+        HxSTL::thread_pool pool(4);
+        pool.parallel_for(0, 8, [&](int i) {
+            parts[i].push(v1.begin() + i * 25000, v1.begin() + (i + 1) * 25000);
+        });
+        HxSTL::top_k<int> all(50);
+        for (int i = 0; i < 8; ++i) {
+            all.merge(parts[i]);
+        }
+        HxSTL::partial_sort(v1.begin(), v1.begin() + 50, v1.end(), HxSTL::greater<int>());
+        HxSTL::vector<int> v2 = all.sorted();
+        assert(HxSTL::equal(v2.begin(), v2.end(), v1.begin()));
+    }
+
+    printf("\033[1;32m=================================================\033[0m\n");
+    printf("\033[1;32mAll tests passed\033[0m\n");
+
+}
@@ -341,3 +341,62 @@ TEST_CASE("type_traits_is_trivially_destructible") {
     REQUIRE(!HxSTL::is_trivially_destructible<int()>::value);
 
 }
+
+TEST_CASE("type_traits_is_pod") {
+
+    struct A { int x; double y; };
+    class B {
+    public:
+        B() {}
+    };
+
+    REQUIRE(HxSTL::is_pod<int>::value);
+    REQUIRE(HxSTL::is_pod<int*>::value);
+    REQUIRE(HxSTL::is_pod<A>::value);
+    REQUIRE(!HxSTL::is_pod<B>::value);
+
+}
+
+TEST_CASE("type_traits_is_trivially_copyable") {
+
+    struct A { int x; char buf[16]; };
+    class B {
+    public:
+        B(const B&);
+    };
+    class C {
+    public:
+        ~C();
+    };
+
+    REQUIRE(HxSTL::is_trivially_copyable<int>::value);
+    REQUIRE(HxSTL::is_trivially_copyable<A>::value);
+    REQUIRE(!HxSTL::is_trivially_copyable<B>::value);
+    REQUIRE(!HxSTL::is_trivially_copyable<C>::value);
+
+}
+
+struct relocatable_handle {
+    int* p;
+    ~relocatable_handle() { delete p; }
+};
+
+namespace HxSTL {
+    template <>
+    struct is_trivially_relocatable<relocatable_handle>: public true_type {};
+}
+
+TEST_CASE("type_traits_is_trivially_relocatable") {
+
+    struct A { int x; double y; };
+    class B {
+    public:
+        B(B&&);
+    };
+
+    REQUIRE(HxSTL::is_trivially_relocatable<int>::value);
+    REQUIRE(HxSTL::is_trivially_relocatable<A>::value);
+    REQUIRE(!HxSTL::is_trivially_relocatable<B>::value);
+    REQUIRE(HxSTL::is_trivially_relocatable<relocatable_handle>::value);
+
+}
@@ -1,6 +1,60 @@
 #include <cstdio>
 #include <cassert>
 #include "vector.h"
+#include "malloc_allocator.h"
+#include "huge_page_allocator.h"
+
+// 统计拷贝和移动次数
+template <bool NothrowMove>
+struct counter {
+    static int copies;
+    static int moves;
+
+    int value;
+
+    counter(int v = 0): value(v) {}
+
+    counter(const counter& other): value(other.value) { ++copies; }
+
+    counter(counter&& other) noexcept(NothrowMove): value(other.value) { other.value = -1; ++moves; }
+
+    counter& operator=(const counter& other) { value = other.value; ++copies; return *this; }
+
+    counter& operator=(counter&& other) noexcept(NothrowMove) { value = other.value; other.value = -1; ++moves; return *this; }
+};
+
+template <bool NothrowMove>
+int counter<NothrowMove>::copies = 0;
+
+template <bool NothrowMove>
+int counter<NothrowMove>::moves = 0;
+
+// 构造参数为负数时抛出
+struct fragile {
+    int v;
+    fragile(int x): v(x) { if (x < 0) throw x; }
+};
+
+// 统计未归还的堆块数
+int blocks = 0;
+
+template <class T>
+struct counting_allocator: public HxSTL::allocator<T> {
+    template <class U>
+    struct rebind {
+        typedef counting_allocator<U> other;
+    };
+
+    T* allocate(size_t n) {
+        ++blocks;
+        return HxSTL::allocator<T>::allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        --blocks;
+        HxSTL::allocator<T>::deallocate(p, n);
+    }
+};
 
 int main() {
 
@@ -419,6 +473,19 @@ int main() {
                 assert(v1[i] == a1[i]);
             }
 
+            // 扩容时元素构造抛出, 新申请的存储需要归还
+            {
+                HxSTL::vector<fragile, counting_allocator<fragile>> v2(2, fragile(1));
+                bool caught = false;
+                try {
+                    v2.emplace(v2.begin(), -1);
+                } catch (int) {
+                    caught = true;
+                }
+                assert(caught && blocks == 1 && v2.size() == 2);
+            }
+            assert(blocks == 0);
+
         }
 
         { // erase 1
@@ -579,6 +646,168 @@ int main() {
 
         }
 
+        { // move_if_noexcept
+
+            HxSTL::vector<counter<true>> v1;
+            HxSTL::vector<counter<false>> v2;
+
+            for (int i = 0; i != 100; ++i) {
+                v1.emplace_back(i);
+                v2.emplace_back(i);
+            }
+            v1.reserve(1000);
+            v2.reserve(1000);
+            v1.shrink_to_fit();
+
+            assert(counter<true>::copies == 0);
+            assert(counter<true>::moves > 0);
+            assert(counter<false>::moves == 0);
+            assert(counter<false>::copies > 0);
+
+            v1.insert(v1.begin(), v1.back());
+            v1.emplace(v1.begin() + 1, v1[0]);
+            v1.insert(v1.end(), 10, v1[1]);
+
+            assert(v1.size() == 112);
+            assert(v1[0].value == 99 && v1[1].value == 99);
+            assert(v1[2].value == 0 && v1[101].value == 99);
+            assert(v1[111].value == 99);
+
+        }
+
+        { // trivially relocatable
+
+            struct message { int id; double price; char tag[8]; };
+
+            HxSTL::vector<message> v1;
+            for (int i = 0; i != 100; ++i) {
+                message m = { i, i * 0.5, "msg" };
+                v1.push_back(m);
+            }
+            message m = { -1, 0, "head" };
+            v1.insert(v1.begin() + 10, m);
+            v1.erase(v1.begin(), v1.begin() + 5);
+
+            assert(v1.size() == 96);
+            assert(v1[5].id == -1 && v1[6].id == 10);
+            assert(v1[95].id == 99 && v1[95].price == 49.5);
+
+            // 元素本身持有堆内存, 按字节搬移后不能重复释放
+            HxSTL::vector<HxSTL::vector<int>> v2;
+            for (int i = 0; i != 100; ++i) {
+                v2.emplace_back(i, i);
+            }
+            v2.insert(v2.begin(), v2[99]);
+            v2.emplace(v2.begin() + 1, 3, 7);
+            v2.erase(v2.begin() + 2);
+            v2.erase(v2.begin() + 50, v2.end());
+            v2.shrink_to_fit();
+
+            assert(v2.size() == 50);
+            assert(v2[0].size() == 99 && v2[0][98] == 99);
+            assert(v2[1].size() == 3 && v2[1][2] == 7);
+            assert(v2[2].size() == 1 && v2[49].size() == 48);
+
+        }
+
+        { // growth policy
+
+            HxSTL::vector<int, HxSTL::allocator<int>, HxSTL::golden_growth> v1;
+            for (int i = 0; i != 9; ++i) {
+                v1.push_back(i);
+            }
+            assert(v1.capacity() == 9);
+            v1.push_back(9);
+            assert(v1.capacity() == 13);
+
+            HxSTL::vector<char, HxSTL::allocator<char>, HxSTL::page_growth<>> v2(64 * 1024, 'a');
+            v2.push_back('b');
+            assert(v2.capacity() % 4096 == 0 && v2.capacity() >= 128 * 1024);
+            assert(v2.back() == 'b');
+
+        }
+
+        { // reallocate
+
+            HxSTL::vector<int, HxSTL::malloc_allocator<int>> v1;
+            for (int i = 0; i != 10000; ++i) {
+                v1.push_back(i);
+            }
+            v1.push_back(v1[0]);
+            v1.insert(v1.end(), 3, v1[1]);
+            v1.insert(v1.end(), v1.begin(), v1.begin() + 5000);
+            v1.resize(v1.capacity() + 1, v1[2]);
+
+            assert(v1[10000] == 0 && v1[10003] == 1);
+            assert(v1[10004] == 0 && v1[15003] == 4999);
+            assert(v1.back() == 2);
+            for (int i = 0; i != 10000; ++i) {
+                assert(v1[i] == i);
+            }
+
+        }
+
+        { // huge_page_allocator
+
+            // 阈值以下走 malloc, 以上 mmap, 扩容经过 mremap
+            HxSTL::huge_page_allocator<long> a1(HxSTL::numa_interleave, 64 * 1024);
+            HxSTL::vector<long, HxSTL::huge_page_allocator<long>> v1(a1);
+            for (long i = 0; i != 1000000; ++i) {
+                v1.push_back(i);
+            }
+            assert(v1.get_allocator() == a1);
+            assert(v1.capacity() * sizeof(long) % 4096 == 0);
+            assert(reinterpret_cast<size_t>(v1.data()) % (2 * 1024 * 1024) == 0);
+            for (long i = 0; i != 1000000; ++i) {
+                assert(v1[i] == i);
+            }
+
+            HxSTL::vector<long, HxSTL::huge_page_allocator<long>> v2(v1);
+            v1.clear();
+            v1.shrink_to_fit();
+            assert(v2.size() == 1000000 && v2.back() == 999999);
+
+            // 小映射只按页对齐; 在它后面留出空闲区间, mremap 原地扩展到 2 MiB 以上后起始地址未对齐,
+            // 应被移到 2 MiB 对齐的位置
+            const size_t huge = HxSTL::__huge_page_mapper::__HUGE_PAGE_BYTES;
+            char* area = static_cast<char*>(HxSTL::__huge_page_mapper::map(8 * huge, HxSTL::numa_first_touch));
+            HxSTL::__huge_page_mapper::unmap(area, 8 * huge);
+            char* p1 = static_cast<char*>(mmap(area + 4096, 64 * 1024, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0));
+            assert(p1 == area + 4096);
+            p1[0] = 1;
+            p1[64 * 1024 - 1] = 2;
+            char* p2 = static_cast<char*>(HxSTL::__huge_page_mapper::remap(p1, 64 * 1024, 4 * huge, HxSTL::numa_first_touch));
+            assert(reinterpret_cast<size_t>(p2) % huge == 0);
+            assert(p2[0] == 1 && p2[64 * 1024 - 1] == 2);
+            p2[4 * huge - 1] = 3;
+            HxSTL::__huge_page_mapper::unmap(p2, 4 * huge);
+
+        }
+
+        { // resize_default_init resize_and_overwrite
+
+            HxSTL::vector<char> v1(4, 'a');
+
+            v1.resize_default_init(100);
+            assert(v1.size() == 100 && v1[3] == 'a');
+
+            v1.resize_default_init(2);
+            assert(v1.size() == 2 && v1.capacity() >= 100);
+
+            v1.resize_and_overwrite(10, [] (char* p, size_t n) {
+                for (size_t i = 2; i != n; ++i) p[i] = 'b';
+                return n / 2;
+            });
+            assert(v1.size() == 5 && v1[1] == 'a' && v1[4] == 'b');
+
+            HxSTL::vector<HxSTL::vector<int>> v2(1, HxSTL::vector<int>(3, 1));
+
+            v2.resize_default_init(3);
+            assert(v2.size() == 3 && v2[0].size() == 3 && v2[2].empty());
+
+        }
+
         { // swap
 
             HxSTL::vector<int> v1(10);
@@ -597,6 +826,25 @@ int main() {
             assert(v2.capacity() == 10);
 
         }
+
+        { // comparison
+
+            HxSTL::vector<int> v1({ 1, 2, 3 });
+            HxSTL::vector<int> v2({ 1, 2, 4 });
+            HxSTL::vector<int> v3({ 1, 2 });
+
+            // lhs < rhs
+            assert(v1 < v2 && v1 <= v2 && !(v1 > v2) && !(v1 >= v2));
+            assert(v3 < v1 && v3 <= v1 && !(v3 > v1) && !(v3 >= v1));
+
+            // lhs > rhs
+            assert(v2 > v1 && v2 >= v1 && !(v2 < v1) && !(v2 <= v1));
+            assert(v1 > v3 && v1 >= v3 && !(v1 < v3) && !(v1 <= v3));
+
+            // lhs == rhs
+            assert(v1 <= v1 && v1 >= v1 && !(v1 < v1) && !(v1 > v1));
+
+        }
     }
 
     printf("\033[1;32m=================================================\033[0m\n");